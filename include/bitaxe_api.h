@@ -2,48 +2,66 @@
 #include <Arduino.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
+#include "fixed_string.h"
+#include "miner_schema.h"
+#include "rtt_estimator.h"
+#include "fleet_storage.h"
 
-struct BitaxeStats {
-    // System info
-    String hostname;
-    String version;
-    float temp;
-    
-    // Mining stats
-    float hashrate;          // GH/s
-    float power;             // Watts
-    float efficiency;        // J/TH
-    uint32_t bestDiff;
-    uint32_t shares;
-    
-    // Pool info
-    String poolUrl;
-    String poolUser;
-    bool poolConnected;
-    
-    // Uptime
-    uint32_t uptimeSeconds;
-    
-    bool valid;
-};
+// Taille max d'une réponse parsée sans filtre
+#define BITAXE_MAX_UNFILTERED_RESPONSE 4096
+
+#define BITAXE_RTT_EXTRA_SLOTS  8     // RTT suivis en plus de la flotte (tests du portail)
 
 class BitaxeAPI {
 private:
     HTTPClient http;
-    String baseUrl;
+    WiFiClient client;    // Connexion non partagée si le pool est plein
+    WiFiClient* conn;     // Connexion de la requête en cours (pool ou client)
+    bool pooled;
+    bool counted;         // client (hors pool) tient un socket du SocketBudget
+    bool reused;          // conn était déjà ouverte (keep-alive)
+    FixedString<BITAXE_HOST_LEN> host;
+    String url;           // "http://<host>" construit par setDevice(), l'endpoint est ajouté sur place
+    size_t urlBaseLen;
+    RttEstimator rtt;     // Copie locale, republiée dans la table partagée
+    uint32_t requestStart;
     
-    bool makeRequest(const char* endpoint, JsonDocument& doc);
+    // Connexion TCP non bloquante avec un délai court : un mineur éteint est
+    // détecté en quelques dizaines de ms au lieu du timeout HTTP complet
+    bool probe();
+    // Emprunte une connexion au pool (probe() si elle est fermée) et prépare http
+    bool open(const char* endpoint, uint32_t timeoutMs);
+    // open() + envoi, avec une nouvelle tentative si la connexion réutilisée
+    // avait été fermée par le mineur. Met à jour le RTT.
+    int execute(const char* method, const char* endpoint, uint32_t timeoutMs, const String& payload = String());
+    // Termine la requête et rend la connexion au pool
+    void close();
+    uint32_t timeoutFor(float factor, uint32_t minMs, uint32_t maxMs) const;
+    
+    // filter != nullptr : parse en flux depuis le socket, ne garde que les champs du filtre
+    bool fetch(const char* endpoint, JsonDocument& doc, const JsonDocument* filter);
+    // fetch() mutualisé : rejoint une requête identique en vol ou lit un résultat
+    // récent, en place dans le document du coalesceur. Renvoie le document à lire
+    // (celui du slot, ou scratch sans mutualisation), nullptr en cas d'échec.
+    // lease est rendu par MinerRequestCoalescer::release() après la lecture.
+    JsonDocument* makeRequest(const char* endpoint, JsonDocument& scratch, const JsonDocument* filter, int& lease);
 
 public:
     BitaxeAPI();
     ~BitaxeAPI();
     
     // Set the Bitaxe IP address
-    void setDevice(String ip);
+    void setDevice(const char* ip);
+    
+    const RttEstimator& getRtt() const { return rtt; }
     
     // Fetch stats from Bitaxe API
     // Endpoints: /api/system/info and /api/system/stats
-    bool getStats(BitaxeStats& stats);
+    // plan : plan d'extraction mémorisé pour ce mineur (nullptr = détection à chaque appel)
+    // scratch : document réutilisé d'un poll à l'autre (arène du worker), pour
+    // les requêtes que le coalesceur ne peut pas prendre en charge
+    bool getStats(BitaxeStats& stats, BitaxeFieldMap* plan, JsonDocument& scratch);
+    bool getStats(BitaxeStats& stats, BitaxeFieldMap* plan = nullptr);
     
     // Test if device is reachable
     bool testConnection();
@@ -55,8 +73,10 @@ public:
     bool startMining();     // Start mining
     
     // Configuration
-    bool getConfig(JsonDocument& config);  // Get current config
-    bool setConfig(JsonDocument& config);  // Update config
+    // AxeOS n'a pas d'endpoint de config : les réglages sont lus dans
+    // /api/system/info (filtrés) et modifiés par PATCH /api/system
+    bool getConfig(JsonDocument& config, const JsonDocument& filter);
+    bool setConfig(JsonDocument& config);
     
     // Firmware update
     bool updateFirmware(String url);       // Update firmware from URL
@@ -2,16 +2,39 @@
 #define BITCOIN_API_H
 
 #include <Arduino.h>
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "coroutine.h"
+#include "block_decoder.h"
+
+// Données de bloc pilotées par la hauteur du tip : seul /blocks/tip/height
+// (quelques octets) est interrogé à chaque appel. Au changement de hauteur,
+// /v1/blocks est lu élément par élément depuis le flux dans des structs fixes
+// (les derniers blocs, retrouvés par hash). Les fees et les blocs projetés
+// (/v1/fees/mempool-blocks) ont leur propre cadence.
+//
+// Les requêtes partent vers une tâche du cœur 0 : elle décode dans des
+// tampons "flow*" et loop() attend sa fin (CO_AWAIT) avant de les copier
+// dans l'état affiché. Aucune requête ne bloque LVGL ni le tactile.
+#define FEES_REFRESH_MS         120000  // Fees et blocs projetés (changent aussi à chaque bloc)
+#define PRICE_STALE_MS          300000  // Dernier prix gardé au-delà : affiché comme ancien
+#define BITCOIN_WORKER_STACK    8192    // Poignée de main TLS dans la tâche
+#define BITCOIN_WORKER_CORE     0
 
 class BitcoinAPI {
 public:
     static BitcoinAPI& getInstance();
-    
+
     void begin();
-    bool fetchPrice();
-    bool fetchBlockData();
+    // Flux non bloquants, à reprendre depuis loop() tant que CO_RUNNING
+    CoStatus stepPrice();
+    CoStatus stepBlockData();
     float getPrice() const { return price; }
     bool isPriceValid() const { return priceValid; }
+    // Prix gardé alors que toutes les sources échouent depuis PRICE_STALE_MS
+    bool isPriceStale() const { return priceValid && millis() - lastPriceAt > PRICE_STALE_MS; }
+    const char* getPriceSource() const { return priceSource; }
     uint32_t getBlockHeight() const { return blockHeight; }
     float getAvgFee() const { return avgFee; }
     uint32_t getBlockAgeMinutes() const { return blockAgeMinutes; }
@@ -19,12 +42,86 @@ public:
     float getMaxFee() const { return maxFee; }
     String getPoolName() const { return poolName; }
     bool isBlockDataValid() const { return blockDataValid; }
-    
+
+    uint32_t getBlockCacheHits() const { return blockCacheHits; }
+
+    // Derniers blocs minés (index 0 = tip) et blocs projetés (index 0 = prochain bloc)
+    int getRecentBlockCount() const { return recentCount; }
+    const BlockInfo& getRecentBlock(int index) const { return recentBlocks[index]; }
+    int getProjectedBlockCount() const { return projectedCount; }
+    const ProjectedBlock& getProjectedBlock(int index) const { return projectedBlocks[index]; }
+
+    // Données poussées par ChainFeed (WebSocket), appliquées depuis loop() sans requête
+    void applyPrice(float value);
+    void applyBlock(const BlockInfo& block);
+    void applyFees(float minimum, float fastest);
+    void applyProjectedBlocks(const ProjectedBlock* blocks, int count);
+    void refreshBlockAge();
+
 private:
-    BitcoinAPI() : price(0.0), priceValid(false), blockHeight(0), avgFee(0.0), blockAgeMinutes(0), minFee(0.0), maxFee(0.0), poolName(""), blockDataValid(false) {}
-    
+    BitcoinAPI() : worker(nullptr), flowJob(nullptr), flowDone(true), flowOk(false),
+                   blockFlowOk(false), flowHeight(0), flowNewBlock(false), flowHave(false), flowKnownHeight(0),
+                   flowBlockCount(0), flowProjectedCount(0), flowMinFee(0.0), flowMaxFee(0.0), flowAvgFee(0.0),
+                   flowFeesUnchanged(false), flowPrice(0.0), flowPriceSource(""),
+                   price(0.0), priceValid(false), lastPriceAt(0), priceSource(""), blockHeight(0), avgFee(0.0), blockAgeMinutes(0), minFee(0.0), maxFee(0.0), poolName(""), blockDataValid(false),
+                   blockTimestamp(0), lastFeesFetch(0), feesValid(false), recentCount(0), blockCacheHits(0), projectedCount(0) {
+        flowHash[0] = '\0';
+        memset(recentBlocks, 0, sizeof(recentBlocks));
+        memset(projectedBlocks, 0, sizeof(projectedBlocks));
+    }
+
+    // Requêtes exécutées par la tâche worker : n'écrivent que les tampons flow*
+    typedef bool (BitcoinAPI::*FlowJob)();
+    bool fetchPrice();
+    bool fetchTipHeight();
+    bool fetchTipHash();
+    bool fetchRecentBlocks();
+    bool fetchProjectedBlocks();
+    bool fetchFees();
+    static void workerEntry(void* arg);
+    // Confie job au worker ; flowDone passe à true quand flowOk est prêt
+    void post(FlowJob job);
+
+    // Appliqués depuis loop() une fois la requête terminée
+    void applyFlowPrice();
+    void applyFlowBlocks();
+    void applyFlowFees();
+    void applyFlowProjected();
+    bool applyFlowTip();
+    void setTip(const BlockInfo& block);
+    const BlockInfo* findBlock(const char* hash) const;
+    static void onRecentBlock(JsonVariantConst block, int index, void* ctx);
+    static void onProjectedBlock(JsonVariantConst block, int index, void* ctx);
+
+    TaskHandle_t worker;
+    FlowJob flowJob;
+    volatile bool flowDone;
+    volatile bool flowOk;
+
+    // État des flux entre deux reprises et tampons remplis par le worker
+    CoState priceFlow;
+    CoState blockFlow;
+    bool blockFlowOk;
+    uint32_t flowHeight;
+    bool flowNewBlock;
+    bool flowHave;              // haveResult de la requête, capturé par loop() avant post()
+    uint32_t flowKnownHeight;   // Hauteur affichée, reprise sur un 304
+    char flowHash[BLOCK_HASH_LEN];
+    BlockInfo flowBlocks[RECENT_BLOCKS_COUNT];
+    int flowBlockCount;
+    ProjectedBlock flowProjected[PROJECTED_BLOCKS_COUNT];
+    int flowProjectedCount;
+    float flowMinFee;
+    float flowMaxFee;
+    float flowAvgFee;           // 0 = pas d'estimation halfHourFee
+    bool flowFeesUnchanged;
+    float flowPrice;
+    const char* flowPriceSource;
+
     float price;
     bool priceValid;
+    uint32_t lastPriceAt;
+    const char* priceSource;
     uint32_t blockHeight;
     float avgFee;
     uint32_t blockAgeMinutes;
@@ -32,6 +129,16 @@ private:
     float maxFee;
     String poolName;
     bool blockDataValid;
+
+    uint32_t blockTimestamp;   // Pour recalculer l'âge sans requête
+    uint32_t lastFeesFetch;
+    bool feesValid;
+
+    BlockInfo recentBlocks[RECENT_BLOCKS_COUNT];
+    int recentCount;
+    uint32_t blockCacheHits;
+    ProjectedBlock projectedBlocks[PROJECTED_BLOCKS_COUNT];
+    int projectedCount;
 };
 
 #endif // BITCOIN_API_H
@@ -0,0 +1,41 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Blocs minés (/v1/blocks, message "block" du WebSocket) et blocs projetés
+// (/v1/fees/mempool-blocks, "mempool-blocks") de mempool.space décodés dans
+// des structs fixes. Partagé entre BitcoinAPI et ChainFeed, et compilé dans
+// [env:native] pour le benchmark du parsing élément par élément.
+#define RECENT_BLOCKS_COUNT     6       // Blocs minés gardés (bandeau de l'écran Clock)
+#define PROJECTED_BLOCKS_COUNT  8       // Blocs projetés du mempool (histogramme)
+#define BLOCK_HASH_LEN          65      // 64 hex + '\0'
+#define BLOCK_POOL_NAME_LEN     32
+
+struct BlockInfo {
+    char hash[BLOCK_HASH_LEN];  // "" = entrée libre
+    uint32_t height;
+    uint32_t timestamp;
+    uint32_t txCount;
+    float avgFee;
+    float feeMin;               // Extrêmes de extras.feeRange
+    float feeMax;
+    char poolName[BLOCK_POOL_NAME_LEN];
+};
+
+struct ProjectedBlock {
+    float medianFee;
+    float feeMin;
+    float feeMax;
+    uint32_t txCount;
+    uint32_t vsize;
+};
+
+class BlockDecoder {
+public:
+    // Filtres d'un élément : seuls les champs des structs sont gardés
+    static const JsonDocument& blockFilter();
+    static const JsonDocument& projectedFilter();
+
+    static void decodeBlock(JsonVariantConst element, BlockInfo& block);
+    static void decodeProjectedBlock(JsonVariantConst element, ProjectedBlock& block);
+};
@@ -0,0 +1,144 @@
+#pragma once
+#include <Arduino.h>
+#include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "ws_client.h"
+#include "bitcoin_api.h"
+#include "json_key_scanner.h"
+
+// Flux poussés pour l'écran Clock : un WebSocket vers mempool.space (nouveaux
+// blocs, fees, blocs projetés) et un vers le ticker Coinbase (prix). Tant
+// qu'un flux est vivant, loop() ne fait plus les requêtes REST
+// correspondantes ; dès qu'il tombe ou se tait, le polling reprend.
+//
+// Les messages de mempool.space dépassent souvent 20 Ko (la liste initiale
+// des blocs) : ils sont lus au fil de l'eau et seuls les champs de premier
+// niveau utiles ("block", "mempool-blocks", "fees") sont gardés, chacun
+// borné par CHAIN_FEED_CAPTURE_MAX. Les sockets TLS remplacent les connexions
+// keep-alive de ExternalHttp vers ces hôtes, qui expirent faute de requêtes ;
+// ils sont réservés dans le SocketBudget tant que le flux est activé.
+#define CHAIN_FEED_SOCKETS           2       // mempool.space + ticker
+// Hôtes, ports et TLS remplaçables à la compilation pour viser
+// test/standin/chain_standin.py, ex. -D CHAIN_FEED_MEMPOOL_HOST=\"192.168.1.10\"
+// -D CHAIN_FEED_MEMPOOL_PORT=8998 -D CHAIN_FEED_TICKER_HOST=\"192.168.1.10\"
+// -D CHAIN_FEED_TICKER_PORT=8999 -D CHAIN_FEED_TLS=false
+#ifndef CHAIN_FEED_MEMPOOL_HOST
+#define CHAIN_FEED_MEMPOOL_HOST      "mempool.space"
+#endif
+#ifndef CHAIN_FEED_MEMPOOL_PORT
+#define CHAIN_FEED_MEMPOOL_PORT      443
+#endif
+#define CHAIN_FEED_MEMPOOL_PATH      "/api/v1/ws"
+#define CHAIN_FEED_MEMPOOL_WANT      "{\"action\":\"want\",\"data\":[\"blocks\",\"stats\",\"mempool-blocks\"]}"
+#ifndef CHAIN_FEED_TICKER_HOST
+#define CHAIN_FEED_TICKER_HOST       "ws-feed.exchange.coinbase.com"
+#endif
+#ifndef CHAIN_FEED_TICKER_PORT
+#define CHAIN_FEED_TICKER_PORT       443
+#endif
+#ifndef CHAIN_FEED_TLS
+#define CHAIN_FEED_TLS               true
+#endif
+#define CHAIN_FEED_TICKER_PATH       "/"
+// ticker_batch : au plus un message toutes les 5 s au lieu d'un par transaction
+#define CHAIN_FEED_TICKER_SUBSCRIBE  "{\"type\":\"subscribe\",\"product_ids\":[\"BTC-USD\"],\"channels\":[\"ticker_batch\"]}"
+#define CHAIN_FEED_CONNECT_MS        5000
+#define CHAIN_FEED_TICK_MS           50      // Lecture des sockets
+#define CHAIN_FEED_SILENT_MS         60000   // Aucun message : flux considéré mort
+#define CHAIN_FEED_RETRY_MIN_MS      5000
+#define CHAIN_FEED_RETRY_MAX_MS      120000
+#define CHAIN_FEED_CAPTURE_MAX       4096    // Un bloc avec extras fait ~2-3 Ko
+#define CHAIN_FEED_TASK_CORE         0
+#define CHAIN_FEED_TASK_STACK        8192    // Poignée de main TLS dans la tâche
+
+struct FeedLink {
+    const char* name;
+    const char* host;
+    uint16_t port;
+    const char* path;
+    const char* subscribe;
+    WsClient ws;
+    bool open;
+    bool live;                  // Ouvert et a parlé depuis moins de CHAIN_FEED_SILENT_MS
+    uint32_t connectedAt;
+    uint32_t lastMessageAt;
+    uint32_t retryAt;
+    uint32_t retryDelayMs;
+    uint32_t messages;
+    uint32_t reconnects;
+};
+
+struct ChainFeedStatus {
+    bool enabled;
+    bool chainLive;
+    bool priceLive;
+    uint32_t chainMessages;
+    uint32_t priceMessages;
+    uint32_t blocks;            // Nouveaux blocs reçus par le flux
+    uint32_t dropped;           // Champs trop gros pour CHAIN_FEED_CAPTURE_MAX
+    uint32_t reconnects;
+};
+
+class ChainFeed {
+private:
+    static ChainFeed* instance;
+    SemaphoreHandle_t mutex;    // Protège les mises à jour en attente et les compteurs
+    TaskHandle_t task;
+    Preferences prefs;
+    volatile bool enabled;
+
+    FeedLink chain;
+    FeedLink ticker;
+
+    // Valeurs des clés "block", "mempool-blocks" et "fees" des messages de mempool.space
+    char capture[CHAIN_FEED_CAPTURE_MAX];
+    JsonKeyScanner scanner;
+
+    // Dernières valeurs reçues, appliquées à BitcoinAPI depuis loop()
+    bool pendingPrice;
+    float price;
+    bool pendingBlock;
+    BlockInfo block;
+    bool pendingFees;
+    float minFee;
+    float maxFee;
+    bool pendingProjected;
+    ProjectedBlock projected[PROJECTED_BLOCKS_COUNT];
+    int projectedCount;
+    bool resyncBlocks;          // Bloc annoncé mais illisible : un poll REST le rattrape
+
+    uint32_t blocks;
+    uint32_t dropped;
+
+    ChainFeed();
+
+    static void taskEntry(void* arg);
+    void service(FeedLink& link, uint32_t now);
+    void connectLink(FeedLink& link);
+    void dropLink(FeedLink& link, const char* reason);
+    void setLive(FeedLink& link, bool live);
+
+    static void onChainFragment(void* ctx, const uint8_t* data, size_t len, bool start, bool end);
+    static void onTickerMessage(void* ctx, const char* data, size_t len);
+    void handleCapture(int target);
+
+public:
+    static ChainFeed* getInstance();
+
+    // Lit l'option (NVS) et crée la tâche (cœur 0)
+    void begin();
+
+    void setEnabled(bool on);
+    bool isEnabled() const { return enabled; }
+
+    // true tant que le flux remplace le polling correspondant
+    bool isChainLive();
+    bool isPriceLive();
+
+    // Applique ce qui est arrivé depuis le dernier appel (thread de loop()).
+    // true si l'écran Clock doit être rafraîchi. resync : un bloc annoncé n'a
+    // pas pu être lu, la chaîne REST (BitcoinAPI::stepBlockData) doit le rattraper.
+    bool applyTo(BitcoinAPI& api, bool& resync);
+    bool getStatus(ChainFeedStatus& out);
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include <Arduino.h>
+
+// Décodage d'un corps HTTP/1.1 "Transfer-Encoding: chunked" au fil de la
+// lecture : HTTPClient::getStream() rend le flux brut, en-têtes de chunks
+// compris. Le corps n'est jamais copié en mémoire, ArduinoJson (ou tout
+// autre lecteur) lit directement depuis le socket à travers l'adaptateur.
+//
+// Les lignes de taille sont lues avec le timeout du flux source ; read()
+// ne bloque pas pendant les données (Stream::timedRead() attend pour lui).
+#define CHUNKED_LINE_LEN   24    // Taille hexa + extensions éventuelles
+
+class ChunkedStream : public Stream {
+public:
+    // limit : octets de corps acceptés (0 = pas de limite)
+    explicit ChunkedStream(Stream& source, size_t limit = 0);
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t) override { return 0; }
+    void flush() override {}
+
+    // Lit la fin du corps et le trailer pour que la connexion reste
+    // réutilisable. false si le flux est invalide ou coupé
+    bool drain();
+
+    // Chunk final (taille 0) et trailer lus
+    bool finished() const { return done; }
+    // En-tête de chunk invalide ou flux coupé pendant un en-tête
+    bool failed() const { return error; }
+    // Corps plus grand que la limite : lecture arrêtée
+    bool overflowed() const { return overflow; }
+    size_t bodyBytes() const { return total; }
+
+private:
+    Stream& source;
+    size_t limit;
+    size_t remaining;      // Octets restants dans le chunk courant
+    size_t total;
+    bool started;          // Un chunk a déjà été lu : son CRLF final précède l'en-tête suivant
+    bool done;
+    bool error;
+    bool overflow;
+
+    bool nextChunk();
+    bool readLine(char* line, size_t capacity);
+};
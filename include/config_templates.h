@@ -0,0 +1,39 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <Preferences.h>
+
+// Modèles de configuration des mineurs (fréquence, tension, pool, ventilateur)
+// enregistrés en NVS et appliqués par la FleetCommandQueue. Pour chaque
+// mineur on lit la config actuelle et on n'envoie que les champs qui
+// diffèrent : un mineur déjà conforme ne reçoit rien (pas de redémarrage).
+#define CONFIG_TEMPLATE_MAX        8
+#define CONFIG_TEMPLATE_NAME_LEN   24
+
+class ConfigTemplates {
+private:
+    static ConfigTemplates* instance;
+    Preferences prefs;
+    JsonDocument templates;   // { "nom": { "frequency": 525, ... }, ... }
+    bool loaded;
+
+    ConfigTemplates();
+    void load();
+    bool persist();
+
+public:
+    static ConfigTemplates* getInstance();
+
+    // Ne garde que les clés AxeOS connues ; error explique un refus
+    bool save(const char* name, JsonVariantConst config, String& error);
+    bool remove(const char* name);
+    bool get(const char* name, JsonDocument& out);
+    void list(JsonDocument& out);
+
+    // Champs du modèle absents ou différents dans current, copiés dans out.
+    // Renvoie le nombre de champs à envoyer (0 = mineur déjà conforme).
+    static int diff(JsonVariantConst tpl, JsonVariantConst current, JsonDocument& out);
+    static bool isTemplateKey(const char* key);
+    // Filtre de /api/system/info réduit aux clés de modèle
+    static const JsonDocument& configFilter();
+};
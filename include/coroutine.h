@@ -0,0 +1,52 @@
+#pragma once
+#include <Arduino.h>
+
+// Coroutines sans pile (style protothreads) pour les flux réseau en
+// plusieurs étapes, reprises depuis loop() : le corps reste écrit comme une
+// suite d'étapes, mais chaque attente rend la main au lieu d'appeler delay().
+// CO_BEGIN reprend au dernier point d'attente (switch sur __LINE__).
+//
+// Règles du corps :
+//  - les variables locales ne survivent pas à une attente : les garder en
+//    membres, et ne pas en déclarer dans une portée qui contient une attente ;
+//  - pas d'attente à l'intérieur d'un switch ;
+//  - un CoState par flux, remis à zéro par CO_END / CO_EXIT.
+//
+// La chaîne d'outils (GCC 8, gnu++11) n'a pas co_await : c'est la forme
+// C++11 la plus proche. Un appel bloquant (ExternalHttp) ne doit pas être
+// fait dans le corps : il est confié à une tâche du cœur 0 et le flux attend
+// son indicateur de fin avec CO_AWAIT (voir BitcoinAPI::post).
+enum CoStatus {
+    CO_RUNNING,
+    CO_DONE
+};
+
+struct CoState {
+    uint16_t line;          // 0 = pas démarré ou terminé
+    uint32_t waitStart;     // Début de l'attente en cours (CO_SLEEP, CO_AWAIT_TIMEOUT)
+
+    CoState() : line(0), waitStart(0) {}
+    void reset() { line = 0; }
+    bool running() const { return line != 0; }
+};
+
+#define CO_BEGIN(state)     CoState& co__ = (state); switch (co__.line) { case 0:
+
+// Rend la main une fois ; reprise à l'appel suivant
+#define CO_YIELD()          do { co__.line = __LINE__; return CO_RUNNING; case __LINE__:; } while (0)
+
+// Rend la main tant que cond est fausse
+#define CO_AWAIT(cond)      do { co__.line = __LINE__; case __LINE__: if (!(cond)) return CO_RUNNING; } while (0)
+
+// Attente sans bloquer loop()
+#define CO_SLEEP(ms)        do { co__.waitStart = millis(); co__.line = __LINE__; case __LINE__: \
+                                 if (millis() - co__.waitStart < (uint32_t)(ms)) return CO_RUNNING; } while (0)
+
+// Attend cond au plus ms ; la condition est à retester ensuite pour savoir lequel des deux est arrivé
+#define CO_AWAIT_TIMEOUT(cond, ms) do { co__.waitStart = millis(); co__.line = __LINE__; case __LINE__: \
+                                 if (!(cond) && millis() - co__.waitStart < (uint32_t)(ms)) return CO_RUNNING; } while (0)
+
+// Fin anticipée du flux
+#define CO_EXIT()           do { co__.line = 0; return CO_DONE; } while (0)
+
+#define CO_END()            } co__.line = 0; return CO_DONE
@@ -0,0 +1,135 @@
+#pragma once
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include <WiFiClientSecure.h>
+#include <HTTPClient.h>
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// Couche HTTP partagée pour les API externes (mempool.space, CoinGecko,
+// open-meteo, ip-api). Une connexion keep-alive est gardée par hôte : tant
+// que le serveur ne la ferme pas, les requêtes suivantes ne refont ni la
+// résolution DNS ni la poignée de main TLS. Les adresses résolues sont
+// gardées EXT_DNS_TTL_MS.
+//
+// Chaque connexion TLS ouverte coûte plusieurs dizaines de Ko de tas et un
+// socket lwIP, réservé dans le SocketBudget : le pool est petit et l'hôte
+// inactif le plus ancien cède sa place.
+//
+// Cache de réponses par URL : validateurs (ETag, Last-Modified) et expiration
+// (Cache-Control max-age). Le résultat déjà décodé reste chez l'appelant ; il
+// indique qu'il l'a (haveResult) et reçoit EXT_HTTP_CACHE_FRESH sans requête
+// tant que la réponse est fraîche, ou 304 après revalidation, sans rien à relire.
+#define EXT_HTTP_MAX_CONNECTIONS   3
+#define EXT_HTTP_IDLE_TIMEOUT_MS   90000   // > cadence prix/blocs (30-60 s)
+#define EXT_HTTP_TIMEOUT_MS        10000
+#define EXT_HTTP_HOST_LEN          40
+#define EXT_DNS_CACHE_SIZE         6
+#define EXT_DNS_TTL_MS             600000  // lwIP ne remonte pas le TTL réel
+#define EXT_CACHE_SIZE             12
+#define EXT_CACHE_ETAG_LEN         64
+#define EXT_CACHE_DATE_LEN         32      // "Wed, 21 Oct 2015 07:28:00 GMT"
+#define EXT_CACHE_MAX_AGE_S        86400   // Plafond d'un max-age annoncé
+#define EXT_HTTP_CACHE_FRESH       1       // Code retourné sans requête (réponse fraîche)
+
+struct ExternalConnection {
+    char host[EXT_HTTP_HOST_LEN];  // Vide = slot libre
+    uint16_t port;
+    bool secure;
+    bool busy;
+    bool counted;                 // Socket ouvert et décompté du SocketBudget
+    uint32_t lastUsed;
+    WiFiClient plain;
+    WiFiClientSecure tls;
+    HTTPClient http;              // Gardé avec la connexion : son destructeur la fermerait
+
+    WiFiClient& client() { return secure ? (WiFiClient&)tls : plain; }
+};
+
+struct ExternalHttpStats {
+    uint32_t requests;
+    uint32_t errors;
+    uint32_t reused;          // Requêtes servies sur une connexion déjà ouverte
+    uint32_t handshakes;      // Connexions TLS ouvertes
+    uint32_t handshakesLastHour;
+    uint32_t tlsMs;           // Temps total passé à ouvrir des connexions TLS
+    uint32_t dnsLookups;
+    uint32_t dnsHits;
+    uint32_t cacheHits;       // Servies fraîches sans requête
+    uint32_t cacheMisses;     // Corps complet téléchargé et décodé
+    uint32_t notModified;     // 304 : validateurs acceptés, rien à décoder
+};
+
+class ExternalHttp {
+private:
+    static ExternalHttp* instance;
+    SemaphoreHandle_t mutex;
+    ExternalConnection slots[EXT_HTTP_MAX_CONNECTIONS];
+
+    struct DnsEntry {
+        char host[EXT_HTTP_HOST_LEN];  // Vide = libre
+        IPAddress ip;
+        uint32_t resolvedAt;
+    };
+    DnsEntry dnsCache[EXT_DNS_CACHE_SIZE];
+
+    struct CacheEntry {
+        uint32_t urlHash;          // 0 = libre
+        char etag[EXT_CACHE_ETAG_LEN];
+        char lastModified[EXT_CACHE_DATE_LEN];
+        uint32_t storedAt;
+        uint32_t maxAgeMs;         // 0 = toujours revalider
+    };
+    CacheEntry cache[EXT_CACHE_SIZE];
+
+    ExternalHttpStats stats;
+    uint16_t handshakeBuckets[60];  // Par minute sur l'heure glissante
+    uint32_t handshakeMinute;
+
+    ExternalHttp();
+
+    // Lit le corps d'une réponse 200 ; false si illisible
+    typedef bool (*BodyReader)(HTTPClient& http, void* ctx);
+    int request(const String& url, uint32_t timeoutMs, BodyReader reader, void* ctx, bool haveResult);
+    CacheEntry* findCacheLocked(uint32_t urlHash);
+    void storeCache(uint32_t urlHash, HTTPClient& http, bool keep);
+    ExternalConnection* acquire(const char* host, uint16_t port, bool secure);
+    void release(ExternalConnection* conn);
+    bool connect(ExternalConnection* conn);
+    void closeLocked(ExternalConnection& slot);
+    bool resolve(const char* host, IPAddress& ip);
+    void forgetHost(const char* host);
+    void noteHandshake(uint32_t ms);
+    void rollHandshakeBucketsLocked();
+
+public:
+    static ExternalHttp* getInstance();
+
+    // GET sur une connexion du pool. Retourne le code HTTP (négatif si erreur
+    // réseau) ; payload n'est rempli que pour un 200.
+    int get(const String& url, String& payload, uint32_t timeoutMs = EXT_HTTP_TIMEOUT_MS, bool haveResult = false);
+
+    // GET + désérialisation (filtre optionnel). Le JSON est lu directement
+    // depuis le flux sans copie, que le corps soit chunked ou non.
+    int getJson(const String& url, JsonDocument& doc, const JsonDocument* filter = nullptr,
+                uint32_t timeoutMs = EXT_HTTP_TIMEOUT_MS, bool haveResult = false);
+
+    // GET avec lecture du corps par l'appelant (réponse 200 uniquement).
+    // Un corps chunked est décodé au fil de la lecture (ChunkedStream), sans copie.
+    typedef bool (*StreamReader)(Stream& body, void* ctx);
+    int getStream(const String& url, StreamReader reader, void* ctx, uint32_t timeoutMs = EXT_HTTP_TIMEOUT_MS,
+                  bool haveResult = false);
+
+    // GET d'un tableau JSON lu élément par élément depuis le flux : handler
+    // reçoit chaque élément filtré, la mémoire reste celle d'un seul élément
+    typedef void (*ElementHandler)(JsonVariantConst element, int index, void* ctx);
+    int getJsonArray(const String& url, const JsonDocument* filter, ElementHandler handler, void* ctx,
+                     uint32_t timeoutMs = EXT_HTTP_TIMEOUT_MS, bool haveResult = false);
+
+    // Réponse inchangée (fraîche ou 304) : le résultat déjà décodé reste valable
+    static bool unchanged(int httpCode) { return httpCode == EXT_HTTP_CACHE_FRESH || httpCode == HTTP_CODE_NOT_MODIFIED; }
+
+    bool getStats(ExternalHttpStats& out);
+    void printStats();
+};
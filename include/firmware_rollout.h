@@ -0,0 +1,108 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <ESPAsyncWebServer.h>
+#include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "esp_partition.h"
+#include "bitaxe_api.h"
+
+// Mise à jour du firmware de la flotte : l'image est téléchargée une seule
+// fois dans la partition OTA inutilisée de TouchAxe, servie aux mineurs par
+// notre AsyncWebServer, puis déployée par vagues. Une vague ne démarre que
+// si le hashrate de la précédente est revenu.
+#define FIRMWARE_LOCAL_PATH            "/fw/miner.bin"
+#define FIRMWARE_TASK_CORE             0
+#define FIRMWARE_TASK_STACK            8192
+#define FIRMWARE_CHUNK_SIZE            4096
+#define FIRMWARE_DOWNLOAD_TIMEOUT_MS   15000   // Sans octet reçu
+#define FIRMWARE_DEFAULT_WAVE_SIZE     4
+#define FIRMWARE_DEFAULT_RECOVERY      0.8f    // Part du hashrate d'avant la mise à jour
+#define FIRMWARE_SETTLE_MS             30000   // Le mineur redémarre : pas de vérification avant
+#define FIRMWARE_RECOVERY_TIMEOUT_MS   600000  // 10 min par vague
+#define FIRMWARE_CHECK_INTERVAL_MS     10000
+
+enum FirmwareRolloutState : uint8_t {
+    FIRMWARE_IDLE,
+    FIRMWARE_DOWNLOADING,
+    FIRMWARE_ROLLING,
+    FIRMWARE_DONE,
+    FIRMWARE_FAILED,
+    FIRMWARE_ABORTED
+};
+
+enum FirmwareTargetState : uint8_t {
+    FIRMWARE_TARGET_PENDING,
+    FIRMWARE_TARGET_UPDATING,   // Commande envoyée, attente du retour du hashrate
+    FIRMWARE_TARGET_RECOVERED,
+    FIRMWARE_TARGET_FAILED
+};
+
+struct FirmwareTarget {
+    uint16_t id;
+    FirmwareTargetState state;
+    float baselineHashrate;     // GH/s avant la mise à jour (0 si offline)
+};
+
+struct FirmwareRolloutStatus {
+    FirmwareRolloutState state;
+    uint32_t imageSize;
+    uint32_t downloaded;
+    int wave;                   // Vague en cours (1..waveCount)
+    int waveCount;
+    int total;
+    int recovered;
+    int failed;
+    uint32_t served;            // Téléchargements de l'image par les mineurs
+    char error[64];
+};
+
+class FirmwareRollout {
+private:
+    static FirmwareRollout* instance;
+    SemaphoreHandle_t mutex;
+    TaskHandle_t task;
+    Preferences prefs;
+
+    // Image en cache (survit au redémarrage, URL et taille en NVS)
+    const esp_partition_t* partition;
+    String imageUrl;
+    uint32_t imageSize;
+
+    // Déploiement en cours
+    String requestedUrl;
+    FirmwareTarget* targets;    // fleetCapacity() entrées
+    int capacity;
+    int waveSize;
+    float recoveryRatio;
+    volatile bool abortRequested;
+    FirmwareRolloutStatus status;
+
+    FirmwareRollout();
+
+    static void taskEntry(void* arg);
+    void run();
+    bool downloadImage(const String& url);
+    bool runWave(int first, int count, const String& localUrl, BitaxeAPI& api);
+    bool waitRecovery(int first, int count, uint32_t sentAt);
+    void fail(FirmwareRolloutState state, const char* error);
+
+public:
+    static FirmwareRollout* getInstance();
+
+    // Lance un déploiement (ids ou toute la flotte). false + error si refusé.
+    bool start(const char* url, JsonArrayConst ids, bool all, int waveSize, float recoveryRatio, String& error);
+    // Arrête après l'étape en cours ; les mineurs déjà lancés finissent leur mise à jour
+    void abort();
+
+    bool getStatus(FirmwareRolloutStatus& out);
+    bool getTarget(int index, FirmwareTarget& out);
+    bool isRunning() const { return task != nullptr; }
+
+    // Route GET FIRMWARE_LOCAL_PATH : lit l'image directement en flash
+    void handleImageRequest(AsyncWebServerRequest* request);
+
+    static const char* stateName(FirmwareRolloutState state);
+    static const char* targetStateName(FirmwareTargetState state);
+};
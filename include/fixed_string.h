@@ -0,0 +1,51 @@
+#pragma once
+#include <Arduino.h>
+#include <string.h>
+
+// Chaîne à capacité fixe stockée dans l'objet : pas d'allocation sur le tas,
+// copie = memcpy. N inclut le '\0'. Une valeur trop longue est tronquée (sans
+// couper un caractère UTF-8), assign() renvoie alors false.
+template <size_t N>
+class FixedString {
+private:
+    char buf[N];
+    uint16_t len;
+
+public:
+    FixedString() : len(0) { buf[0] = '\0'; }
+    FixedString(const char* value) { assign(value); }
+
+    bool assign(const char* value, size_t valueLen) {
+        bool fits = valueLen < N;
+        if (!fits) {
+            valueLen = N - 1;
+            while (valueLen > 0 && (value[valueLen] & 0xC0) == 0x80) valueLen--;
+        }
+        memmove(buf, value, valueLen);
+        buf[valueLen] = '\0';
+        len = valueLen;
+        return fits;
+    }
+    bool assign(const char* value) {
+        if (value == nullptr) {
+            clear();
+            return true;
+        }
+        return assign(value, strlen(value));
+    }
+
+    FixedString& operator=(const char* value) { assign(value); return *this; }
+    FixedString& operator=(const String& value) { assign(value.c_str(), value.length()); return *this; }
+
+    void clear() { buf[0] = '\0'; len = 0; }
+
+    const char* c_str() const { return buf; }
+    size_t length() const { return len; }
+    bool isEmpty() const { return len == 0; }
+    static size_t capacity() { return N - 1; }
+
+    bool operator==(const char* other) const { return strcmp(buf, other != nullptr ? other : "") == 0; }
+    bool operator!=(const char* other) const { return !(*this == other); }
+    bool operator==(const FixedString& other) const { return len == other.len && memcmp(buf, other.buf, len) == 0; }
+    bool operator!=(const FixedString& other) const { return !(*this == other); }
+};
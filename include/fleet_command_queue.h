@@ -0,0 +1,93 @@
+#pragma once
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <ArduinoJson.h>
+#include "bitaxe_api.h"
+
+// Commandes envoyées aux mineurs (boutons de l'UI, portail web) : mises en
+// file puis exécutées sur le cœur 0 par quelques workers, l'UI ne fait que
+// lire l'avancement. Les commandes soumises pendant qu'un lot tourne
+// s'ajoutent à ce lot ; un nouveau lot commence quand le précédent est fini.
+#define FLEET_CMD_WORKERS        3      // Commandes simultanées (le pool garde des connexions pour le poller)
+#define FLEET_CMD_TASK_CORE      0
+#define FLEET_CMD_WORKER_STACK   6144
+
+enum FleetCommand : uint8_t {
+    FLEET_CMD_RESTART,
+    FLEET_CMD_REBOOT,
+    FLEET_CMD_STOP,
+    FLEET_CMD_START,
+    FLEET_CMD_APPLY_CONFIG     // Modèle du lot (voir submitConfig), seuls les champs différents sont envoyés
+};
+
+enum FleetCommandState : uint8_t {
+    FLEET_CMD_QUEUED,
+    FLEET_CMD_RUNNING,
+    FLEET_CMD_OK,
+    FLEET_CMD_FAILED,
+    FLEET_CMD_UNCHANGED        // Config déjà conforme au modèle, rien envoyé
+};
+
+struct FleetCommandResult {
+    uint16_t id;               // ID stable du mineur
+    FleetCommand command;
+    FleetCommandState state;
+    uint32_t durationMs;
+};
+
+// Avancement du lot en cours
+struct FleetProgress {
+    uint32_t batch;            // Numéro du lot (0 = aucun lot depuis le démarrage)
+    int total;
+    int done;
+    int succeeded;             // Inclut les mineurs déjà conformes
+    int failed;
+    int unchanged;
+};
+
+class FleetCommandQueue {
+private:
+    static FleetCommandQueue* instance;
+
+    QueueHandle_t jobs;            // Index dans results[]
+    SemaphoreHandle_t mutex;
+    TaskHandle_t workers[FLEET_CMD_WORKERS];
+
+    FleetCommandResult* results;   // Une entrée par commande du lot (fleetCapacity())
+    int capacity;
+    FleetProgress progress;
+    volatile uint32_t generation;  // Incrémenté à chaque changement d'état
+    JsonDocument batchConfig;      // Modèle appliqué par les FLEET_CMD_APPLY_CONFIG du lot
+    bool batchHasConfig;
+
+    FleetCommandQueue();
+
+    static void workerTaskEntry(void* arg);
+    void run(int index, BitaxeAPI& api);
+    bool enqueueLocked(uint16_t id, FleetCommand command);
+    bool applyConfig(BitaxeAPI& api, const JsonDocument& config, bool& changed);
+
+public:
+    static FleetCommandQueue* getInstance();
+
+    // Crée les workers (cœur 0)
+    void begin();
+
+    // Met une commande en file, non bloquant. false si la file est pleine.
+    bool submit(uint16_t id, FleetCommand command);
+    // Tous les mineurs configurés (onlineOnly : seulement ceux vus online). Nombre mis en file.
+    int submitAll(FleetCommand command, bool onlineOnly);
+    // Applique un modèle de config aux mineurs ids (ou à tous). Refusé (-1)
+    // si le lot en cours applique déjà un modèle différent.
+    int submitConfig(JsonVariantConst config, JsonArrayConst ids, bool all);
+
+    bool getProgress(FleetProgress& out);
+    bool getResult(int index, FleetCommandResult& out);
+    uint32_t getGeneration() const { return generation; }
+
+    static const char* commandName(FleetCommand command);
+    static bool parseCommand(const char* name, FleetCommand& out);
+    static const char* stateName(FleetCommandState state);
+};
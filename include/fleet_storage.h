@@ -0,0 +1,58 @@
+#pragma once
+#include <Arduino.h>
+#include <new>
+#include "esp_heap_caps.h"
+#include "miner_schema.h"
+
+// Taille de la flotte fixée au démarrage selon la mémoire disponible. Les
+// tableaux par mineur (config, registre, planning du poller) sont alloués une
+// fois à cette taille, en PSRAM quand la carte en a.
+#define MAX_BITAXE_DEVICES            128   // Avec PSRAM (blob NVS ~9,5 Ko)
+#define MAX_BITAXE_DEVICES_NO_PSRAM   16
+
+#define BITAXE_NAME_LEN    32
+#define MINER_ID_NONE      0     // Slot libre / aucun mineur
+
+// Configuration d'un mineur. Les statistiques (online, hashrate, power...)
+// vivent dans le MinerRegistry, indexées par id.
+struct BitaxeDevice {
+    uint16_t id;              // ID stable, ne change pas quand la liste est réordonnée
+    FixedString<BITAXE_NAME_LEN> name;
+    FixedString<BITAXE_HOST_LEN> ip;
+};
+
+// Enregistrement d'un mineur dans le blob NVS "devices" (un seul blob pour
+// toute la flotte au lieu de trois clés par mineur)
+#define BITAXE_RECORD_VERSION 1
+
+struct BitaxeRecord {
+    uint16_t id;
+    char name[BITAXE_NAME_LEN];
+    char ip[BITAXE_HOST_LEN];
+};
+
+inline int fleetCapacity() {
+    return psramFound() ? MAX_BITAXE_DEVICES : MAX_BITAXE_DEVICES_NO_PSRAM;
+}
+
+// Tableau de count éléments construits par défaut, jamais libéré.
+// PSRAM si disponible, sinon tas interne ; nullptr si la mémoire manque.
+template <typename T>
+T* fleetAllocArray(size_t count) {
+    void* mem = nullptr;
+    if (psramFound()) {
+        mem = heap_caps_malloc(sizeof(T) * count, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+    if (mem == nullptr) {
+        mem = malloc(sizeof(T) * count);
+    }
+    if (mem == nullptr) {
+        Serial.printf("[Fleet] Out of memory for %u x %u bytes\n", (unsigned)count, (unsigned)sizeof(T));
+        return nullptr;
+    }
+    T* items = (T*)mem;
+    for (size_t i = 0; i < count; i++) {
+        new (&items[i]) T();
+    }
+    return items;
+}
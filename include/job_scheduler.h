@@ -0,0 +1,69 @@
+#pragma once
+#include <Arduino.h>
+
+// Planificateur des tâches périodiques de loop() : un tas binaire d'échéances
+// (comparées modulo 2^32, sans souci au passage à zéro de millis()). Une
+// passe exécute les tâches échues par ordre d'échéance puis de priorité et
+// rend la main dès que SCHED_PASS_BUDGET_MS est dépassé : LVGL et le tactile
+// tournent entre deux requêtes réseau au lieu d'attendre toute la chaîne.
+//
+// Chaque tâche a un budget de durée (dépassements comptés et journalisés) et
+// un espacement minimal qui borne les déclenchements anticipés (trigger) :
+// une tâche qui appelle une API externe ne peut pas être relancée en rafale.
+#define SCHED_MAX_JOBS          10
+#define SCHED_NAME_LEN          12
+#define SCHED_PASS_BUDGET_MS    20      // Au-delà, la passe s'arrête (loop() continue)
+#define SCHED_USE_PERIOD        0       // Retour d'une tâche : prochaine exécution après sa période
+
+// Retourne le délai avant la prochaine exécution, ou SCHED_USE_PERIOD
+typedef uint32_t (*JobFunction)(void* ctx);
+
+struct Job {
+    char name[SCHED_NAME_LEN];
+    JobFunction run;
+    void* ctx;
+    uint32_t periodMs;
+    uint8_t priority;           // 0 = la plus urgente à échéance égale
+    uint32_t budgetMs;
+    uint32_t minSpacingMs;      // Limite de débit (0 = aucune)
+    uint32_t nextRun;
+    uint32_t lastRun;
+    uint32_t lastDurationMs;
+    uint32_t maxDurationMs;
+    uint32_t runs;
+    uint32_t overruns;
+};
+
+class JobScheduler {
+private:
+    static JobScheduler* instance;
+    Job jobs[SCHED_MAX_JOBS];
+    int jobCount;
+    uint8_t heap[SCHED_MAX_JOBS];   // Indices dans jobs, échéance la plus proche en tête
+    int heapSize;
+    uint32_t passesCut;             // Passes arrêtées par SCHED_PASS_BUDGET_MS
+
+    JobScheduler();
+
+    static bool due(uint32_t deadline, uint32_t now) { return (int32_t)(now - deadline) >= 0; }
+    bool before(int a, int b) const;
+    void siftUp(int pos);
+    void siftDown(int pos);
+    void push(int id);
+    int pop();
+    void remove(int id);
+
+public:
+    static JobScheduler* getInstance();
+
+    // Retourne l'identifiant de la tâche, -1 si la table est pleine
+    int addJob(const char* name, JobFunction run, void* ctx, uint32_t periodMs, uint8_t priority,
+               uint32_t budgetMs, uint32_t minSpacingMs = 0, uint32_t firstDelayMs = 0);
+
+    // Exécution anticipée, au plus tôt minSpacingMs après la précédente
+    void trigger(int id);
+
+    // Appelé à chaque tour de loop()
+    void runDue();
+    void printJobs();
+};
@@ -0,0 +1,38 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Allocator ArduinoJson sur un tampon fixe fourni à la construction : les
+// blocs sont pris à la suite (pile), rien ne passe par le tas. Un document
+// lié à une arène peut être parsé à chaque poll sans allocation : quand tous
+// ses blocs sont libérés (clear(), nouveau deserializeJson()), l'arène repart
+// de zéro. Un bloc qui ne tient plus fait échouer l'allocation (NoMemory),
+// sans repli sur le tas. Une arène sert un seul document, donc une seule tâche.
+#define JSON_ARENA_ALIGN   8
+
+class JsonArena : public ArduinoJson::Allocator {
+public:
+    JsonArena(void* buffer = nullptr, size_t capacity = 0);
+
+    // Tampon alloué après la construction (PSRAM au démarrage)
+    void attach(void* buffer, size_t capacity);
+
+    void* allocate(size_t size) override;
+    void deallocate(void* ptr) override;
+    void* reallocate(void* ptr, size_t newSize) override;
+
+    size_t capacity() const { return size; }
+    size_t used() const { return offset; }
+    size_t peak() const { return peakOffset; }
+    // Allocations refusées faute de place
+    uint32_t failures() const { return failed; }
+
+private:
+    uint8_t* base;
+    size_t size;
+    size_t offset;
+    size_t peakOffset;
+    size_t lastBlock;     // Offset de l'en-tête du dernier bloc (agrandi sur place)
+    uint16_t live;        // Blocs non libérés
+    uint32_t failed;
+};
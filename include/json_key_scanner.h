@@ -0,0 +1,45 @@
+#pragma once
+#include <Arduino.h>
+
+// Lecteur incrémental d'un objet JSON reçu par morceaux : suit la
+// profondeur et les chaînes, et capture telle quelle la valeur (objet ou
+// tableau) des clés de premier niveau recherchées. Le message complet n'est
+// jamais gardé : seule la valeur capturée, bornée par le tampon fourni, est
+// ensuite décodée par ArduinoJson. Utilisé par ChainFeed pour les messages
+// de mempool.space (souvent plus de 20 Ko).
+#define JSON_SCANNER_KEY_LEN    16    // Clés plus longues : tronquées, donc jamais reconnues
+
+class JsonKeyScanner {
+public:
+    // keys : clés recherchées ; buffer/capacity : tampon de capture ('\0' compris)
+    JsonKeyScanner(const char* const* keys, int keyCount, char* buffer, size_t capacity);
+
+    // Début d'un nouveau message
+    void reset();
+    // Un octet du message. Renvoie l'index de la clé dont la valeur vient
+    // de se terminer (valeur dans buffer), -1 sinon.
+    int feed(char c);
+
+    size_t valueLen() const { return captureLen; }
+    // Valeur plus grande que le tampon : capture tronquée, à ignorer
+    bool overflowed() const { return overflow; }
+
+private:
+    const char* const* keys;
+    int keyCount;
+    char* buffer;
+    size_t capacity;
+
+    int depth;
+    bool inString;
+    bool escape;
+    bool readingKey;
+    bool keyDone;
+    bool expectKey;
+    char key[JSON_SCANNER_KEY_LEN];
+    int keyLen;
+    int target;             // Clé reconnue dont la valeur va suivre (-1 = aucune)
+    bool capturing;
+    bool overflow;
+    size_t captureLen;
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// Connexions HTTP/1.1 keep-alive vers les mineurs, partagées par toutes les
+// instances de BitaxeAPI (poller, boutons de l'UI, portail). Une connexion
+// est empruntée pour une requête puis rendue ouverte ; celles restées
+// inutilisées trop longtemps sont fermées. Les slots sont réservés dans le
+// SocketBudget (16 sockets lwIP pour tout le firmware), d'où un pool
+// volontairement petit.
+#define POOL_MAX_CONNECTIONS    6
+#define POOL_MAX_PER_HOST       2      // Poller + une action UI simultanée
+#define POOL_IDLE_TIMEOUT_MS    45000  // > cadence normale du poller (30 s ± jitter)
+
+struct PooledConnection {
+    char host[40];        // Vide = slot libre
+    WiFiClient client;
+    bool busy;
+    bool counted;         // Socket ouvert et décompté du SocketBudget
+    uint32_t lastUsed;
+};
+
+class MinerConnectionPool {
+private:
+    static MinerConnectionPool* instance;
+    SemaphoreHandle_t mutex;
+    PooledConnection slots[POOL_MAX_CONNECTIONS];
+
+    uint32_t opened;      // Nouvelles connexions TCP
+    uint32_t reused;      // Requêtes servies par une connexion déjà ouverte
+    uint32_t stale;       // Connexions fermées par le mineur, détectées à l'usage
+    uint32_t evicted;     // Fermées après POOL_IDLE_TIMEOUT_MS
+
+    MinerConnectionPool();
+    void evictIdleLocked(uint32_t now);
+    void closeSlotLocked(PooledConnection& slot);
+
+public:
+    static MinerConnectionPool* getInstance();
+
+    // Emprunte une connexion vers host : ouverte si possible, sinon un slot à
+    // connecter. nullptr si le pool est plein (l'appelant utilise alors une
+    // connexion non partagée).
+    WiFiClient* acquire(const char* host);
+
+    // Rend la connexion ; elle reste dans le pool si elle est encore ouverte
+    void release(WiFiClient* client);
+
+    // Compteurs (appelés par BitaxeAPI)
+    // Connexion ouverte par probe() : son socket est rendu au budget à sa fermeture
+    void markOpened(WiFiClient* client);
+    void countReused() { reused++; }
+    void countStale() { stale++; }
+
+    void printStats();
+};
@@ -0,0 +1,120 @@
+#pragma once
+#include <Arduino.h>
+#include <ESPAsyncWebServer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include "bitaxe_api.h"
+
+// Découverte des mineurs AxeOS sur le réseau local : balayage du sous-réseau
+// de la station avec des connect() non bloquants en parallèle, puis
+// identification des hôtes qui répondent sur le port 80 via /api/system/info.
+// Les résultats partent vers le portail (SSE) au fur et à mesure : les
+// tâches de découverte les déposent dans une file, vidée par la tâche
+// async_tcp (AsyncEventSource n'est pas sûr depuis une autre tâche).
+#define DISCOVERY_MAX_SOCKETS        8      // Plafond : 1 réservé, le reste pris au partagé du SocketBudget
+#define DISCOVERY_CONNECT_TIMEOUT_MS 250    // ARP + SYN/ACK sur le réseau local : un hôte présent répond bien avant
+#define DISCOVERY_SELECT_MS          20
+#define DISCOVERY_PROGRESS_MS        500    // Fréquence des événements "progress" (= poll AsyncTCP)
+#define DISCOVERY_TASK_CORE          0
+#define DISCOVERY_TASK_STACK         4096
+#define DISCOVERY_WORKER_STACK       6144
+#define DISCOVERY_QUEUE_LEN          32
+#define DISCOVERY_PROBE_SLOTS        4      // Tests /api/bitaxe/test simultanés
+#define DISCOVERY_PROBE_TTL_MS       10000  // Résultat d'un test resservi pendant ce délai
+#define DISCOVERY_EVENTS_PATH        "/api/discovery/events"
+#define DISCOVERY_EVENT_QUEUE_LEN    16
+#define DISCOVERY_EVENT_LEN          256
+
+// Événement SSE en attente d'envoi par async_tcp
+struct DiscoveryEvent {
+    char name[12];
+    char data[DISCOVERY_EVENT_LEN];
+};
+
+struct DiscoveredMiner {
+    uint32_t ip;                // Ordre réseau (IPAddress)
+    uint16_t connectMs;         // Temps de connexion TCP pendant le balayage
+    FixedString<BITAXE_HOSTNAME_LEN> hostname;
+    FixedString<BITAXE_VERSION_LEN> version;
+    float hashrate;
+};
+
+enum MinerProbeState : uint8_t {
+    PROBE_FREE,
+    PROBE_PENDING,
+    PROBE_DONE
+};
+
+// Résultat d'un test ponctuel (/api/bitaxe/test)
+struct MinerProbe {
+    uint32_t ip;
+    MinerProbeState state;
+    bool ok;
+    uint32_t latencyMs;         // Durée de la requête /api/system/info
+    uint32_t finishedAt;
+    BitaxeStats stats;
+};
+
+struct DiscoveryProgress {
+    bool running;
+    uint32_t scan;              // Numéro du balayage (0 = jamais lancé)
+    int scanned;
+    int total;
+    int responders;             // Port 80 ouvert
+    int found;                  // Mineurs AxeOS identifiés
+    uint32_t durationMs;
+};
+
+class MinerDiscovery {
+private:
+    static MinerDiscovery* instance;
+    SemaphoreHandle_t mutex;
+    TaskHandle_t sweepTask;
+    TaskHandle_t worker;
+    QueueHandle_t jobs;         // DiscoveryJob : identification ou test
+    AsyncEventSource* events;   // Touché uniquement depuis async_tcp
+    QueueHandle_t eventQueue;   // DiscoveryEvent, des tâches vers async_tcp
+    uint32_t droppedEvents;
+
+    DiscoveredMiner* found;     // fleetCapacity() entrées
+    int capacity;
+    DiscoveryProgress progress;
+    bool sweepDone;
+    int pendingJobs;            // Identifications en attente du worker
+    uint32_t startedAt;
+
+    MinerProbe probes[DISCOVERY_PROBE_SLOTS];
+
+    MinerDiscovery();
+
+    static void sweepTaskEntry(void* arg);
+    static void workerTaskEntry(void* arg);
+    void sweep();
+    void identify(uint32_t ip, uint16_t connectMs, BitaxeAPI& api);
+    void runProbe(uint32_t ip, BitaxeAPI& api);
+    void finishIfIdleLocked();
+    void sendProgress(bool force);
+    void postEvent(const char* name, const char* data);
+
+public:
+    static MinerDiscovery* getInstance();
+
+    // Crée le worker d'identification (cœur 0)
+    void begin();
+
+    // Source SSE du portail (nullptr quand le serveur web s'arrête)
+    void setEventSource(AsyncEventSource* source);
+    // Envoie les événements en attente ; tâche async_tcp uniquement
+    void flushEvents();
+
+    // Lance un balayage du sous-réseau. false si déjà en cours ou hors ligne.
+    bool start();
+    bool getProgress(DiscoveryProgress& out);
+    bool getFound(int index, DiscoveredMiner& out);
+
+    // Test asynchrone d'un mineur : PROBE_PENDING tant que la mesure n'est pas
+    // terminée (rappeler plus tard), PROBE_DONE avec le résultat dans out,
+    // PROBE_FREE si la file est pleine
+    MinerProbeState probe(uint32_t ip, MinerProbe& out);
+};
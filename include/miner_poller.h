@@ -0,0 +1,72 @@
+#pragma once
+#include <Arduino.h>
+#include "bitaxe_api.h"
+#include "wifi_manager.h"
+#include "miner_registry.h"
+#include "poll_scheduler.h"
+
+// Moteur de polling des mineurs : une tâche FreeRTOS sur le cœur 0 lance les
+// requêtes HTTP en parallèle pour que loop() (cœur 1) ne bloque jamais
+// lv_timer_handler() ni la lecture du tactile. Les résultats sont publiés
+// dans le MinerRegistry.
+//
+// Chaque mineur a sa propre échéance : cadence normale, cadence rapide si ses
+// stats bougent ou s'il est affiché, backoff exponentiel (avec jitter) s'il ne
+// répond pas. Un budget global de requêtes/seconde borne le tout : quand la
+// flotte ne tient plus dans la cadence normale avec ce budget, la cadence
+// normale s'allonge au lieu de laisser les échéances dériver sans fin. La
+// planification elle-même est dans PollScheduler (testée sur l'hôte).
+#define POLLER_TASK_CORE          0
+#define POLLER_TASK_STACK         4096
+#define POLLER_WORKER_STACK       8192
+
+class MinerPoller {
+private:
+    static MinerPoller* instance;
+
+    TaskHandle_t pollerTask;
+    TaskHandle_t workerTasks[POLLER_MAX_IN_FLIGHT];
+    QueueHandle_t jobQueue;       // Slots des mineurs à interroger
+    SemaphoreHandle_t schedMutex; // Protège scheduler (hors ip/fieldMap, propres au worker en vol)
+
+    PollScheduler scheduler;       // fleetCapacity() slots (PSRAM)
+    uint32_t syncedGeneration;     // Génération de la config WifiManager déjà appliquée
+
+    volatile uint16_t focusedId;   // Mineur affiché à l'écran (cadence rapide)
+    volatile bool pollAllRequested;
+
+    uint32_t startedAt;
+
+    MinerPoller();
+
+    static void pollerTaskEntry(void* arg);
+    static void workerTaskEntry(void* arg);
+    void syncTargets();
+    void dispatchDue();
+    void pollOne(int slot, BitaxeAPI& api, JsonDocument& scratch);
+
+public:
+    static MinerPoller* getInstance();
+
+    // Crée la tâche de planification et les workers (cœur 0)
+    void begin(uint8_t inFlight = POLLER_DEFAULT_IN_FLIGHT);
+
+    // Interroge tous les mineurs dès que possible (bouton refresh), non bloquant
+    void requestCycle();
+    // Interroge ce mineur dès que possible (dans le budget global), non bloquant
+    void requestPoll(uint16_t id);
+
+    // Mineur affiché dans le carousel (MINER_ID_NONE si aucun)
+    void setFocusedMiner(uint16_t id) { focusedId = id; }
+    uint16_t getFocusedMiner() const { return focusedId; }
+
+    uint8_t getInFlight() const { return scheduler.getInFlight(); }
+    uint8_t getMaxInFlight() const { return scheduler.getMaxInFlight(); }
+    uint32_t getTotalPolls() const { return scheduler.getTotalPolls(); }
+    // Durée d'un cycle complet sur les mineurs joignables (dernier, moyenne)
+    uint32_t getLastCycle() const { return scheduler.getLastCycle(); }
+    uint32_t getAvgCycle() const { return scheduler.getAvgCycle(); }
+
+    // Commande série "sched" : planning et coût de chaque mineur
+    void printSchedule();
+};
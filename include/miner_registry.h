@@ -0,0 +1,122 @@
+#pragma once
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "bitaxe_api.h"
+#include "wifi_manager.h"
+
+// Registre unique des statistiques de la flotte, indexé par l'ID stable du
+// mineur (BitaxeDevice::id) et non par sa position dans la liste : supprimer
+// un mineur ne décale plus les résultats des autres. Le MinerPoller écrit,
+// l'horloge, le carousel et l'API web lisent le même registre.
+
+// Bits de changement du dernier résultat publié (MinerView::changed)
+#define MINER_CHANGED_ONLINE    (1 << 0)
+#define MINER_CHANGED_HASHRATE  (1 << 1)
+#define MINER_CHANGED_TEMP      (1 << 2)
+#define MINER_CHANGED_POWER     (1 << 3)
+#define MINER_CHANGED_BESTDIFF  (1 << 4)
+#define MINER_CHANGED_SHARES    (1 << 5)
+#define MINER_CHANGED_POOL      (1 << 6)
+#define MINER_CHANGED_INFO      (1 << 7)  // hostname / version
+
+// Copie d'une entrée du registre
+struct MinerView {
+    uint16_t id;
+    bool online;
+    bool polled;          // false tant que le mineur n'a jamais été interrogé
+    uint32_t seq;         // Incrémenté à chaque résultat publié pour ce mineur
+    uint16_t changed;     // Bits MINER_CHANGED_* du dernier résultat
+    uint32_t timestamp;   // millis() à la fin de la requête
+    uint32_t latencyMs;   // Durée de la requête HTTP
+    BitaxeStats stats;
+};
+
+// Agrégats de la flotte (mineurs online uniquement)
+struct FleetTotals {
+    int configured;
+    int online;
+    float hashrate;
+    float power;
+    uint32_t bestDiff;
+};
+
+class MinerRegistry {
+private:
+    static MinerRegistry* instance;
+    SemaphoreHandle_t mutex;
+
+    // Struct-of-arrays de fleetCapacity() slots (PSRAM) : les agrégats ne
+    // parcourent que les colonnes utiles, les chaînes (rarement lues) restent
+    // à part. Un slot est libre si ids[slot] == MINER_ID_NONE ; l'ordre des
+    // slots n'a pas d'importance.
+    int capacity;
+    uint16_t* ids;
+    uint8_t* flags;
+    uint32_t* seqs;
+    uint16_t* changed;
+    uint32_t* timestamps;
+    uint32_t* latencies;
+    float* hashrates;
+    float* temps;
+    float* powers;
+    float* efficiencies;
+    uint32_t* bestDiffs;
+    uint32_t* shares;
+    uint32_t* uptimes;
+    FixedString<BITAXE_HOSTNAME_LEN>* hostnames;
+    FixedString<BITAXE_VERSION_LEN>* versions;
+    FixedString<BITAXE_POOL_URL_LEN>* poolUrls;
+    FixedString<BITAXE_POOL_USER_LEN>* poolUsers;
+
+    // Index id -> slot (adressage ouvert, reconstruit par sync()) : read() et
+    // publish() ne parcourent pas la flotte
+    int16_t* slotIndex;
+    uint16_t indexMask;
+
+    // Agrégats tenus à jour par publish() : getTotals() ne parcourt pas la flotte
+    int configuredCount;
+    int onlineCount;
+    double hashrateSum;    // double : pas de dérive après des milliers de mises à jour
+    double powerSum;
+    uint32_t bestDiffMax;
+
+    volatile uint32_t generation;  // Incrémenté à chaque écriture
+
+    MinerRegistry();
+
+    int slotOf(uint16_t id) const;
+    void clearSlot(int slot, uint16_t id);
+    void indexSlotLocked(int slot);
+    void rebuildIndexLocked();
+    void recomputeTotalsLocked();
+    int onlineSlotLocked(uint16_t id) const;
+    uint16_t setHashrateLocked(int slot, float hashrate);
+    uint16_t raiseBestDiffLocked(int slot, uint32_t bestDiff);
+    void commitLocked(int slot, uint16_t mask);
+
+public:
+    static MinerRegistry* getInstance();
+
+    // Aligne le registre sur la liste configurée : les IDs conservés gardent
+    // leurs données, les nouveaux partent vides, les supprimés sont oubliés
+    void sync(const BitaxeDevice* devices, int count);
+
+    // Publie le résultat d'un poll (appelé par les workers du poller)
+    void publish(uint16_t id, const BitaxeStats& stats, bool success, uint32_t latencyMs);
+    // Hashrate et meilleure difficulté vus par le pool (PoolStatsSource). Ne
+    // change ni le statut online ni l'horodatage, qui restent ceux du poll direct.
+    void publishPoolStats(uint16_t id, float hashrate, uint32_t bestDiff);
+    // Évènements du journal du mineur (MinerTelemetry), mêmes règles que publishPoolStats.
+    // Un nonce sous la difficulté du pool (submitted = false) ne compte que pour bestDiff.
+    void publishHashrate(uint16_t id, float hashrate);
+    void publishShare(uint16_t id, uint32_t difficulty, bool submitted);
+
+    // Copie une entrée (attente max 2 ms : l'UI ne doit jamais rester bloquée)
+    bool read(uint16_t id, MinerView& out);
+    bool isOnline(uint16_t id);
+
+    // Agrégats de la flotte (O(1)), même attente max que read()
+    bool getTotals(FleetTotals& out);
+    uint32_t getGeneration() const { return generation; }
+};
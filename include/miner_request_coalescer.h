@@ -0,0 +1,75 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/event_groups.h>
+#include "json_arena.h"
+#include "miner_schema.h"
+
+// Requêtes GET "single-flight" vers les mineurs : si une requête pour le même
+// mineur et le même endpoint est déjà en vol (poller, bouton de l'UI,
+// portail web), l'appelant l'attend et reçoit le même résultat au lieu de
+// refaire l'aller-retour. Les réponses réussies restent valables
+// COALESCE_TTL_MS, ce qui sert aussi les appels arrivés juste après.
+//
+// La réponse est parsée directement dans le document du slot (adossé à une
+// arène fixe) et lue en place par tous les appelants : aucune copie de
+// document, aucune allocation par requête.
+#define COALESCE_SLOTS         8       // Requêtes en vol + résultats en cache
+#define COALESCE_TTL_MS        1500    // < POLL_FAST_INTERVAL_MS : le poller reste à jour
+#define COALESCE_WAIT_MS       6000    // Attente max d'une requête en vol (connexion + RTO max)
+
+#define COALESCE_NO_SLOT       -1      // Échec déjà connu (requête en vol échouée ou trop longue)
+#define COALESCE_BYPASS        -2      // Pas de slot disponible : requête directe
+
+struct CoalescedRequest {
+    char host[40];                 // Vide = slot libre
+    char endpoint[32];
+    const JsonDocument* filter;    // Même endpoint, filtre différent = autre résultat
+    bool inFlight;
+    bool ok;
+    uint8_t readers;               // Appelants qui attendent ou lisent result
+    uint32_t completedAt;
+    JsonArena arena;
+    JsonDocument result;           // Sur arena : parsé sur place, jamais copié
+
+    CoalescedRequest() : result(&arena) {}
+};
+
+class MinerRequestCoalescer {
+private:
+    static MinerRequestCoalescer* instance;
+    SemaphoreHandle_t mutex;
+    EventGroupHandle_t doneBits;   // Un bit par slot, levé quand la requête se termine
+    CoalescedRequest slots[COALESCE_SLOTS];
+    bool arenas;                   // Tampons des slots alloués (sinon tout passe en direct)
+
+    uint32_t fetches;      // Requêtes réellement envoyées
+    uint32_t coalesced;    // Appels rattachés à une requête en vol
+    uint32_t cacheHits;    // Appels servis par un résultat encore valide
+
+    MinerRequestCoalescer();
+    int findLocked(const char* host, const char* endpoint, const JsonDocument* filter) const;
+    int claimLocked(uint32_t now);
+
+public:
+    static MinerRequestCoalescer* getInstance();
+
+    // COALESCE_NO_SLOT : échec, rien à lire.
+    // COALESCE_BYPASS : requête directe dans le document de l'appelant.
+    // Sinon le slot est emprunté : si leader, l'appelant parse la réponse dans
+    // document(slot) puis appelle complete() ; sinon le résultat est déjà là.
+    // Dans les deux cas release() une fois la lecture terminée.
+    int acquire(const char* host, const char* endpoint, const JsonDocument* filter,
+                bool& leader, bool& ok);
+    JsonDocument& document(int slot) { return slots[slot].result; }
+    void complete(int slot, bool ok);
+    void release(int slot);
+
+    // Après une commande (restart, setConfig...) les résultats en cache de ce mineur sont périmés
+    void invalidate(const char* host);
+
+    uint32_t getCoalesced() const { return coalesced; }
+    void printStats();
+};
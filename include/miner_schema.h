@@ -0,0 +1,82 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "fixed_string.h"
+
+// Capacités des champs texte (stockés dans les structures, sans tas)
+#define BITAXE_HOST_LEN         40    // IP ou nom d'hôte du mineur
+#define BITAXE_HOSTNAME_LEN     32
+#define BITAXE_VERSION_LEN      32
+#define BITAXE_POOL_URL_LEN     64
+#define BITAXE_POOL_USER_LEN    128   // Adresse BTC + nom du worker
+
+// Arène d'un document de réponse filtrée (/api/system/info) : un pool de
+// slots ArduinoJson et les chaînes gardées. 4 Ko sur l'ESP32 ; les slots sont
+// deux fois plus gros sur un hôte 64 bits (tests natifs).
+#define MINER_JSON_ARENA_BYTES  (1024 * sizeof(void*))
+
+struct BitaxeStats {
+    // System info
+    FixedString<BITAXE_HOSTNAME_LEN> hostname;
+    FixedString<BITAXE_VERSION_LEN> version;
+    float temp;
+    
+    // Mining stats
+    float hashrate;          // GH/s
+    float power;             // Watts
+    float efficiency;        // J/TH
+    uint32_t bestDiff;
+    uint32_t shares;
+    
+    // Pool info
+    FixedString<BITAXE_POOL_URL_LEN> poolUrl;
+    FixedString<BITAXE_POOL_USER_LEN> poolUser;
+    bool poolConnected;
+    
+    // Uptime
+    uint32_t uptimeSeconds;
+    
+    bool valid;
+};
+
+// Plan d'extraction résolu au premier poll réussi d'un mineur : pour chaque
+// statistique, la clé JSON utilisée par sa variante de firmware (AxeOS,
+// ESP-Miner...). Les polls suivants font des lectures directes sans sonder
+// les variantes ; le plan est re-détecté si une clé attendue disparaît.
+struct BitaxeFieldMap {
+    bool resolved = false;
+    const char* schemaName = "unknown";
+
+    const char* hostname = nullptr;  // nullptr = champ absent, valeur par défaut
+    const char* version = nullptr;
+    const char* temp = nullptr;
+    const char* power = nullptr;
+    bool powerFromVoltageCurrent = false;
+    const char* hashrate = nullptr;
+    bool hashrateInHs = false;       // currentHashrate est toujours en H/s
+    const char* bestDiff = nullptr;
+    bool bestDiffIsString = false;   // "72.6G" ou nombre brut
+    const char* shares = nullptr;
+    const char* poolUrl = nullptr;
+    const char* poolUser = nullptr;
+    const char* uptime = nullptr;
+};
+
+// Lecture des statistiques d'un payload /api/system/info, sans réseau :
+// BitaxeAPI s'en sert après la requête, les tests natifs directement.
+class MinerSchema {
+public:
+    // Filtre ArduinoJson des seuls champs lus (lecture seule, partagé par les workers)
+    static const JsonDocument& infoFilter();
+
+    // Sonde toutes les variantes une seule fois et mémorise les clés trouvées
+    static void detect(JsonDocument& doc, BitaxeFieldMap& plan);
+    // Applique le plan : aucune sonde. false si une clé attendue a disparu
+    static bool extract(JsonDocument& doc, const BitaxeFieldMap& plan, BitaxeStats& stats);
+    // Plan résolu (ou re-détecté) + extraction + champs calculés (efficacité, pool).
+    // plan == nullptr : détection à chaque appel. host ne sert qu'aux logs.
+    static bool parse(JsonDocument& doc, BitaxeFieldMap* plan, BitaxeStats& stats, const char* host);
+
+    // Difficulté formatée ("997.30 M", "72.6G") en valeur brute
+    static uint32_t parseDiff(const char* diffStr);
+};
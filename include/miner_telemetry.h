@@ -0,0 +1,92 @@
+#pragma once
+#include <Arduino.h>
+#include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "ws_client.h"
+#include "bitaxe_api.h"
+
+// Télémétrie poussée par les mineurs : abonnement au WebSocket /api/ws
+// d'AxeOS, qui diffuse le journal du mineur. Les lignes de shares et de
+// hashrate sont décodées au fil de l'eau et publiées dans le MinerRegistry
+// en moins d'une seconde. Un mineur abonné n'est plus interrogé qu'en
+// réconciliation lente (température, puissance) ; le polling normal reprend
+// dès que son socket tombe.
+//
+// Les abonnements n'ont pas de réserve dans le SocketBudget : ils prennent
+// les sockets partagés restants, au plus TELEMETRY_MAX_SOCKETS. Le mineur
+// affiché passe en premier, les autres restent en polling.
+#define TELEMETRY_MAX_SOCKETS        4
+#define TELEMETRY_WS_PATH            "/api/ws"
+#define TELEMETRY_CONNECT_MS         1000
+#define TELEMETRY_TICK_MS            20      // Lecture des sockets
+#define TELEMETRY_RESELECT_MS        5000    // Choix des mineurs abonnés
+#define TELEMETRY_RETRY_MIN_MS       5000    // Reconnexion après une coupure
+#define TELEMETRY_RETRY_MAX_MS       120000
+#define TELEMETRY_SILENT_MS          90000   // Aucun message : socket considéré mort
+#define TELEMETRY_TASK_CORE          0
+#define TELEMETRY_TASK_STACK         6144
+
+struct TelemetryLink {
+    uint16_t id;                // MINER_ID_NONE = libre
+    FixedString<BITAXE_HOST_LEN> ip;
+    WsClient ws;
+    bool live;
+    uint32_t connectedAt;
+    uint32_t lastMessageAt;
+    uint32_t messages;
+    uint32_t shares;
+};
+
+struct TelemetryStatus {
+    bool enabled;
+    int live;
+    uint32_t messages;
+    uint32_t shares;
+    uint32_t reconnects;
+};
+
+class MinerTelemetry {
+private:
+    static MinerTelemetry* instance;
+    SemaphoreHandle_t mutex;    // Protège les id/live des liens (lus par le poller)
+    TaskHandle_t task;
+    Preferences prefs;
+
+    TelemetryLink links[TELEMETRY_MAX_SOCKETS];
+    volatile bool enabled;
+    uint32_t lastSelect;
+    uint32_t reconnects;
+
+    // Mineurs dont la connexion a échoué récemment : pas de nouvel essai avant retryAt
+    struct RetryEntry {
+        uint16_t id;
+        uint32_t retryAt;
+        uint32_t delayMs;
+    };
+    RetryEntry retries[TELEMETRY_MAX_SOCKETS * 2];
+
+    MinerTelemetry();
+
+    static void taskEntry(void* arg);
+    static void onMessage(void* ctx, const char* data, size_t len);
+    void selectTargets();
+    void connectLink(TelemetryLink& link);
+    void dropLink(TelemetryLink& link, const char* reason);
+    void handleLine(TelemetryLink& link, const char* line);
+    bool canRetry(uint16_t id);
+    void noteFailure(uint16_t id);
+
+public:
+    static MinerTelemetry* getInstance();
+
+    // Lit l'option (NVS) et crée la tâche (cœur 0)
+    void begin();
+
+    void setEnabled(bool on);
+    bool isEnabled() const { return enabled; }
+
+    // true si le WebSocket de ce mineur est ouvert : le poller peut espacer ses requêtes
+    bool isLive(uint16_t id);
+    bool getStatus(TelemetryStatus& out);
+};
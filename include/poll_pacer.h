@@ -0,0 +1,63 @@
+#pragma once
+#include <Arduino.h>
+#include "miner_schema.h"
+
+// Cadence et planning du polling des mineurs, séparés de MinerPoller pour
+// être testés sur la machine hôte ([env:native]).
+#define POLL_INTERVAL_MS          30000   // Cadence normale
+#define POLL_FAST_INTERVAL_MS     5000    // Stats qui bougent ou mineur affiché
+#define POLL_BACKOFF_MAX_MS       300000  // Plafond du backoff d'un mineur injoignable
+#define POLL_POOL_COVERED_MS      180000  // Hashrate fourni par le pool (PoolStatsSource) : temp/power seulement
+#define POLL_PUSH_RECONCILE_MS    120000  // WebSocket ouvert (MinerTelemetry) : temp/power seulement
+#define POLL_JITTER_PERCENT       20      // ±20% pour désynchroniser les mineurs
+#define POLL_MAX_RPS              4       // Budget global (requêtes/seconde)
+#define POLL_NORMAL_BUDGET_PERCENT 75     // Part du budget pour la cadence normale (reste : rapide, retries)
+#define POLL_HASHRATE_DELTA       0.05f   // Variation relative jugée significative
+#define POLL_TEMP_DELTA           2.0f    // °C
+
+// Planning d'un mineur. Le slot reste attribué au même ID tant que le mineur
+// existe, les workers peuvent donc le lire sans copie.
+struct MinerSchedule {
+    uint16_t id;             // MINER_ID_NONE = slot libre
+    FixedString<BITAXE_HOST_LEN> ip;
+    BitaxeFieldMap fieldMap; // Schéma détecté
+    bool inFlight;
+    bool removed;            // Supprimé pendant une requête, libéré à la fin
+    uint32_t nextDue;        // millis() de la prochaine requête
+    uint32_t interval;       // Dernier délai appliqué
+    uint8_t failures;        // Échecs consécutifs
+    bool fast;               // Cadence rapide (stats qui bougent)
+    float lastHashrate;
+    float lastTemp;
+    uint32_t polls;
+    uint32_t errors;
+    uint32_t busyMs;         // Temps total passé en requêtes pour ce mineur
+    uint32_t srttMs;         // RTT lissé et délai courant (BitaxeAPI)
+    uint32_t rtoMs;
+    bool cycled;             // Déjà interrogé pendant le cycle en cours
+};
+
+// Seau à jetons du budget global (POLL_MAX_RPS, rafale = nombre de workers)
+// et calcul des intervalles. Pas de verrou : MinerPoller l'utilise sous schedMutex.
+class PollPacer {
+private:
+    float tokens;
+    uint32_t lastRefill;
+    uint8_t burst;
+
+public:
+    PollPacer();
+
+    void begin(uint8_t burst, uint32_t now);
+    void refill(uint32_t now);
+    // Consomme un jeton. false : budget épuisé, réessayer au prochain tick
+    bool take();
+    float available() const { return tokens; }
+
+    // Cadence normale tenable pour cette flotte avec sa part du budget
+    static uint32_t normalInterval(int activeMiners);
+    // Backoff exponentiel : normal, x2, x4... plafonné à POLL_BACKOFF_MAX_MS
+    static uint32_t backoffInterval(uint32_t normal, uint8_t failures);
+    // ±POLL_JITTER_PERCENT pour que les mineurs ne retombent pas sur le même tick
+    static uint32_t withJitter(uint32_t interval);
+};
@@ -0,0 +1,99 @@
+#pragma once
+#include <Arduino.h>
+#include "fleet_storage.h"
+#include "poll_pacer.h"
+
+// Planification du MinerPoller sans FreeRTOS ni réseau : choix des mineurs à
+// lancer (dispatchDue) et mise à jour du planning à la fin d'une requête
+// (complete). MinerPoller l'appelle sous son mutex depuis ses tâches ; les
+// tests natifs la pilotent directement avec de faux mineurs en temps virtuel.
+//
+// Les requêtes partent en parallèle jusqu'à maxInFlight : une passe sur 10
+// mineurs injoignables coûte un seul timeout avec le réglage par défaut.
+#define POLLER_MAX_IN_FLIGHT      10    // Plafond de requêtes HTTP simultanées
+#define POLLER_DEFAULT_IN_FLIGHT  10
+#define POLLER_TICK_MS            250   // Réveil max du planificateur
+
+// Issue d'une requête, remise par le worker
+struct PollOutcome {
+    bool success;
+    float hashrate;
+    float temp;
+    uint32_t latencyMs;
+    uint32_t srttMs;         // RTT lissé et délai courant (BitaxeAPI)
+    uint32_t rtoMs;
+    // Sources qui décident de la cadence, lues par MinerPoller hors verrou
+    bool focused;            // Affiché dans le carousel
+    bool pushLive;           // Stats reçues par le WebSocket (MinerTelemetry)
+    bool poolCovered;        // Hashrate fourni par le pool (PoolStatsSource)
+};
+
+class PollScheduler {
+private:
+    MinerSchedule* schedule;
+    int capacity;
+    uint8_t maxInFlight;
+    uint8_t inFlightCount;
+    uint32_t earliestDue;          // Prochaine échéance connue : rien à parcourir avant
+    uint32_t normalIntervalMs;     // POLL_INTERVAL_MS, allongé si la flotte dépasse le budget
+    uint32_t lagMs;                // Retard moyen des requêtes lancées (moyenne glissante)
+    uint32_t maxLagMs;
+    PollPacer pacer;               // Budget global et intervalles
+    uint32_t totalPolls;
+    uint32_t totalBusyMs;
+
+    // Cycle : durée murale pour que chaque mineur joignable réponde une fois
+    // (les mineurs en backoff n'en font pas partie, sauf au refresh)
+    bool cycleActive;
+    uint32_t cycleStart;
+    int cyclePending;              // Mineurs du cycle pas encore interrogés
+    uint32_t cycles;
+    uint32_t lastCycleMs;
+    uint32_t avgCycleMs;           // Moyenne glissante
+
+    uint32_t nextInterval(const MinerSchedule& entry, const PollOutcome& outcome) const;
+    void startCycle(uint32_t now, bool all);
+
+public:
+    PollScheduler();
+
+    // slots : capacity entrées construites par défaut (fleetAllocArray)
+    void begin(MinerSchedule* slots, int capacity, uint8_t maxInFlight, uint32_t now);
+
+    int getCapacity() const { return capacity; }
+    MinerSchedule& at(int slot) { return schedule[slot]; }
+    const MinerSchedule& at(int slot) const { return schedule[slot]; }
+
+    // Slot du mineur (-1 s'il n'est pas planifié)
+    int find(uint16_t id) const;
+    // Nouveau mineur, interrogé tout de suite. false si la flotte est pleine
+    bool add(uint16_t id, const char* ip, uint32_t now);
+    // Retire le mineur ; s'il est en vol, le slot est libéré à la fin de la requête
+    void remove(int slot);
+    // Cadence normale tenable avec la part du budget ; true si elle change
+    bool updateNormalInterval();
+
+    // Ce mineur dès que possible (dans le budget global)
+    void requestPoll(uint16_t id, uint32_t now);
+    // false : aucune échéance atteinte, rien à parcourir (lu sans verrou)
+    bool hasDue(uint32_t now) const;
+
+    // Slots à lancer maintenant, les plus en retard d'abord, dans la limite des
+    // requêtes en vol et du budget global. pollAll : toute la flotte est échue.
+    // Les slots rendus sont marqués en vol ; renvoie leur nombre.
+    int dispatchDue(uint32_t now, bool pollAll, int* launch, int maxLaunch);
+    // Fin de la requête du slot : compteurs, cadence suivante, slot libéré
+    void complete(int slot, const PollOutcome& outcome, uint32_t now);
+
+    uint8_t getInFlight() const { return inFlightCount; }
+    uint8_t getMaxInFlight() const { return maxInFlight; }
+    uint32_t getNormalInterval() const { return normalIntervalMs; }
+    uint32_t getLag() const { return lagMs; }
+    uint32_t getMaxLag() const { return maxLagMs; }
+    uint32_t getTotalPolls() const { return totalPolls; }
+    uint32_t getTotalBusyMs() const { return totalBusyMs; }
+    uint32_t getCycles() const { return cycles; }
+    uint32_t getLastCycle() const { return lastCycleMs; }
+    uint32_t getAvgCycle() const { return avgCycleMs; }
+    float getTokens() const { return pacer.available(); }
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "fleet_storage.h"
+#include "pool_workers.h"
+
+// Source optionnelle : les stats de tous les workers d'une adresse lues en
+// une seule requête sur l'API du pool (ckpool /users/<adresse>, public-pool
+// /api/client/<adresse>). Les workers sont associés aux mineurs par le nom
+// de worker de BitaxeStats::poolUser. Tant que ces données sont fraîches, le
+// MinerPoller espace ses requêtes directes vers les mineurs couverts.
+#define POOL_SOURCE_INTERVAL_MS      60000   // Les pools agrègent à la minute
+#define POOL_SOURCE_FRESH_MS         150000  // Au-delà, le polling direct reprend
+#define POOL_SOURCE_TIMEOUT_MS       10000
+#define POOL_SOURCE_TASK_CORE        0
+#define POOL_SOURCE_TASK_STACK       8192    // TLS
+#define POOL_SOURCE_MAX_ADDRESSES    4       // Une requête par adresse de paiement
+#define POOL_SOURCE_ADDRESS_LEN      96
+#define POOL_SOURCE_URL_LEN          160
+#define POOL_SOURCE_ADDRESS_TOKEN    "{address}"
+
+struct PoolSourceStatus {
+    bool enabled;
+    uint32_t fetches;
+    uint32_t errors;
+    uint32_t lastFetchAt;       // millis() du dernier succès (0 = jamais)
+    int workers;                // Workers renvoyés par le pool
+    int matched;                // Mineurs couverts
+};
+
+class PoolStatsSource {
+private:
+    static PoolStatsSource* instance;
+    SemaphoreHandle_t mutex;
+    TaskHandle_t task;
+    Preferences prefs;
+
+    String urlTemplate;         // Vide = source désactivée
+    uint16_t* coveredIds;       // Mineurs associés à un worker actif au dernier fetch
+    uint16_t* scratchIds;       // Rempli par refresh() puis copié dans coveredIds
+    int coveredCount;
+    int capacity;
+    PoolSourceStatus status;
+
+    PoolStatsSource();
+
+    static void taskEntry(void* arg);
+    void refresh();
+    bool fetchAddress(const char* address, JsonDocument& doc);
+    // Associe les workers d'une adresse aux mineurs, renvoie le nouveau nombre de couverts
+    int applyWorkers(const char* address, JsonVariantConst doc, uint16_t* covered, int count);
+
+public:
+    static PoolStatsSource* getInstance();
+
+    // Charge l'URL (NVS) et crée la tâche (cœur 0)
+    void begin();
+
+    // URL avec {address}, ex. https://solo.ckpool.org/users/{address}. "" désactive.
+    bool setUrlTemplate(const String& url);
+    String getUrlTemplate();
+
+    // true si le pool a récemment rapporté ce mineur : le poller peut espacer ses requêtes
+    bool covers(uint16_t id);
+    bool getStatus(PoolSourceStatus& out);
+};
@@ -0,0 +1,32 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Lecture de la liste des workers renvoyée par l'API d'un pool, séparée de
+// PoolStatsSource pour être testée sur la machine hôte ([env:native]).
+//   ckpool      : {"worker":[{"workername":"adresse.bitaxe1","hashrate1m":"1.2T","bestshare":123.4}]}
+//   public-pool : {"workers":[{"name":"bitaxe1","hashRate":1.2e12,"bestDifficulty":"123.4"}]}
+struct PoolWorkerList {
+    JsonArrayConst list;
+    const char* nameKey;
+    const char* hashrateKey;
+    const char* bestKey;
+};
+
+class PoolWorkers {
+public:
+    // Filtre de désérialisation : seuls les champs des workers sont gardés
+    static const JsonDocument& filter();
+
+    // Reconnaît le format de la réponse. false : format inconnu
+    static bool open(JsonVariantConst doc, PoolWorkerList& out);
+
+    // Worker associé à poolUser ("adresse.worker") ; hashrate en GH/s
+    static bool find(const PoolWorkerList& workers, const char* poolUser, float& hashrate, uint32_t& bestDiff);
+
+    // Nombre éventuellement en chaîne avec suffixe SI ("1.21T", "345.6 G")
+    static double parseScaled(JsonVariantConst value);
+
+    // ckpool renvoie "adresse.worker", public-pool seulement "worker"
+    static bool workerMatches(const char* workerName, const char* poolUser);
+};
@@ -0,0 +1,103 @@
+#pragma once
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/queue.h>
+
+// Sources du prix BTC/USD. Chaque fournisseur a un score de santé (moyenne
+// glissante des succès), un budget de requêtes par heure et l'historique de
+// ses latences. fetch() interroge le meilleur fournisseur sur une tâche
+// dédiée ; s'il n'a pas répondu dans son p95 observé, le suivant part sur
+// la seconde tâche (requête couverte) et la première réponse valide gagne.
+// Un échec libère sa tâche pour le fournisseur suivant. fetch() rend la
+// main au plus tard après PRICE_FETCH_DEADLINE_MS.
+// Un fournisseur qui renvoie 429 est mis de côté PRICE_RATE_LIMIT_BACKOFF_MS.
+#define PRICE_PROVIDER_COUNT          3
+#define PRICE_LATENCY_SAMPLES         16      // Fenêtre du p95 par fournisseur
+#define PRICE_HEDGE_DEFAULT_MS        2000    // Pas encore de latence mesurée
+#define PRICE_HEDGE_MIN_MS            500
+#define PRICE_HEDGE_MAX_MS            5000
+#define PRICE_HEALTH_ALPHA            0.2f    // Poids du dernier résultat dans la santé
+#define PRICE_BUDGET_WINDOW_MS        3600000
+#define PRICE_RATE_LIMIT_BACKOFF_MS   300000
+#define PRICE_WORKER_STACK            8192    // Poignée de main TLS dans la tâche
+#define PRICE_WORKER_CORE             0
+#define PRICE_WORKER_COUNT            2       // Principal + requête couverte
+#define PRICE_FETCH_DEADLINE_MS       10000   // = EXT_HTTP_TIMEOUT_MS : pas plus long qu'une requête seule
+
+struct PriceProvider {
+    const char* name;
+    const char* url;
+    uint16_t budgetPerHour;     // Sous la limite publique du fournisseur
+    bool (*parse)(JsonDocument& doc, float& price);
+};
+
+struct PriceProviderState {
+    float health;               // 1 = toujours répondu, 0 = toujours en échec
+    float lastPrice;            // Dernier prix reçu (réponse inchangée du cache HTTP)
+    uint16_t latencies[PRICE_LATENCY_SAMPLES];
+    int latencyCount;
+    int latencyNext;
+    uint32_t budgetWindowStart;
+    uint16_t budgetUsed;
+    uint32_t backoffUntil;      // 0 = pas de 429 en cours
+    uint32_t requests;
+    uint32_t failures;
+    uint32_t hedgesWon;         // Réponses arrivées avant celle du fournisseur principal
+};
+
+class PriceProviders {
+private:
+    static PriceProviders* instance;
+    SemaphoreHandle_t mutex;    // Protège states (écrit par la tâche et par loop())
+    TaskHandle_t workers[PRICE_WORKER_COUNT];
+    QueueHandle_t jobs;
+    QueueHandle_t results;
+    int inFlight;               // Requêtes lancées non terminées (sous mutex)
+    uint32_t jobSeq;
+    uint32_t hedges;
+
+    PriceProviderState states[PRICE_PROVIDER_COUNT];
+
+    struct PriceJob {
+        uint32_t seq;
+        int provider;
+    };
+    struct PriceResult {
+        uint32_t seq;
+        int provider;
+        bool ok;
+        float price;
+    };
+
+    // Course en cours : fournisseurs classés, prochain à lancer, requêtes en vol
+    struct PriceRace {
+        uint32_t seq;
+        int order[PRICE_PROVIDER_COUNT];
+        int count;
+        int next;
+        int outstanding;
+        uint32_t hedgeAt;
+        uint32_t deadline;
+    };
+    PriceRace race;
+
+    PriceProviders();
+
+    static void workerEntry(void* arg);
+    bool runProvider(int index, float& price);
+    int rankProviders(int* order);
+    uint32_t hedgeDelayMs(int index);
+    uint32_t p95Locked(const PriceProviderState& state) const;
+    bool launch(int provider);
+
+public:
+    static PriceProviders* getInstance();
+
+    void begin();
+
+    // Bloquant (thread de loop()). source pointe sur le nom du fournisseur retenu.
+    bool fetch(float& price, const char*& source);
+    void printStats();
+};
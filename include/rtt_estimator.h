@@ -0,0 +1,36 @@
+#pragma once
+#include <Arduino.h>
+
+// Délais dérivés du RTT mesuré de chaque mineur (RTO façon TCP, RFC 6298)
+#define BITAXE_RTO_INITIAL_MS   1000  // Avant la première mesure
+#define BITAXE_RTO_MAX_MS       8000  // Plafond après timeouts successifs
+#define BITAXE_REQUEST_MIN_MS   500   // Les timeouts socket du core sont à la seconde
+#define BITAXE_REQUEST_MAX_MS   4000
+#define BITAXE_ACTION_MIN_MS    1000  // POST : le mineur agit avant de répondre
+#define BITAXE_ACTION_MAX_MS    5000
+#define BITAXE_FIRMWARE_MIN_MS  5000
+#define BITAXE_FIRMWARE_MAX_MS  10000
+#define BITAXE_PROBE_MIN_MS     50    // Connexion TCP au port 80
+#define BITAXE_PROBE_MAX_MS     300   // Doublé à chaque timeout consécutif...
+#define BITAXE_PROBE_BACKOFF_MS 2400  // ...jusqu'à ce plafond (mineur éteint : ~1 % d'un worker)
+
+// RTT lissé et variance d'un mineur. rto = srtt + 4 * rttvar, doublé à chaque
+// timeout jusqu'à la prochaine mesure. La sonde TCP suit le même backoff : un
+// mineur lent à accepter la connexion finit par avoir assez de temps au lieu
+// de rester hors ligne.
+struct RttEstimator {
+    float srtt = 0;      // ms
+    float rttvar = 0;    // ms
+    uint32_t rto = BITAXE_RTO_INITIAL_MS;
+    uint32_t samples = 0;
+    uint8_t timeouts = 0;  // Timeouts consécutifs depuis la dernière mesure
+
+    void addSample(uint32_t rttMs);
+    void onTimeout();
+
+    // Délai d'une requête : rto x factor, borné à [minMs, maxMs]
+    uint32_t deadline(float factor, uint32_t minMs, uint32_t maxMs) const;
+    // Délai de la sonde TCP : BITAXE_PROBE_MAX_MS tant qu'aucune mesure, puis
+    // dérivé du RTO ; après un timeout, le plafond doublé à chaque échec
+    uint32_t probeTimeout() const;
+};
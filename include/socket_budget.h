@@ -0,0 +1,67 @@
+#pragma once
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+// Budget des sockets lwIP partagé par tous les sous-systèmes. Arduino-ESP32
+// est compilé avec CONFIG_LWIP_MAX_SOCKETS = 16 ; le serveur web (AsyncTCP)
+// et SNTP passent par l'API brute de lwIP et n'en consomment aucun.
+//
+// Chaque usage a une réserve qui lui reste toujours acquise ; au-delà il
+// emprunte au reste partagé tant qu'il en reste. Un sous-système qui n'obtient
+// pas de socket échoue proprement (requête refusée, abonnement reporté,
+// balayage ralenti) au lieu de priver les autres d'un socket() qui renverrait -1.
+#define SOCKET_BUDGET_TOTAL     16
+
+enum SocketUser : uint8_t {
+    SOCKET_MINERS,      // Pool keep-alive + connexions hors pool de BitaxeAPI
+    SOCKET_EXTERNAL,    // ExternalHttp (API externes)
+    SOCKET_ONE_SHOT,    // HTTPClient ponctuels : source pool, téléchargement firmware
+    SOCKET_CHAIN_FEED,  // WebSockets du flux de blocs (réservés s'il est activé)
+    SOCKET_TELEMETRY,   // WebSockets AxeOS : uniquement sur le reste partagé
+    SOCKET_DISCOVERY,   // Sondes connect() du balayage
+    SOCKET_USER_COUNT
+};
+
+class SocketBudget {
+private:
+    static SocketBudget* instance;
+    SemaphoreHandle_t mutex;
+    uint8_t reserved[SOCKET_USER_COUNT];
+    uint8_t inUse[SOCKET_USER_COUNT];
+    uint8_t peak[SOCKET_USER_COUNT];
+    uint32_t refused[SOCKET_USER_COUNT];
+
+    SocketBudget();
+    int sharedFreeLocked() const;
+
+public:
+    static SocketBudget* getInstance();
+
+    void setReserve(SocketUser user, uint8_t count);
+
+    // Réserve un socket avant de l'ouvrir. false : budget épuisé pour cet usage
+    bool acquire(SocketUser user);
+    // À appeler une fois le socket fermé (stop()/close())
+    void release(SocketUser user);
+    // Sockets que cet usage peut encore ouvrir (réserve restante + partagé libre)
+    int available(SocketUser user);
+
+    void printStats();
+};
+
+// Socket réservé pour la durée d'un bloc (HTTPClient ponctuels)
+class SocketLease {
+private:
+    SocketUser user;
+    bool held;
+
+public:
+    explicit SocketLease(SocketUser user) : user(user) {
+        held = SocketBudget::getInstance()->acquire(user);
+    }
+    ~SocketLease() {
+        if (held) SocketBudget::getInstance()->release(user);
+    }
+    bool granted() const { return held; }
+};
@@ -21,7 +21,7 @@ public:
     void showDashboard();       // DEPRECATED - kept for compatibility
     void showMainMenu();
     void updateClock();         // Update clock display (called from loop)
-    void checkBitaxeStatus();   // Check Bitaxe device status periodically
+    void checkBitaxeStatus();   // Apply miner results published by MinerPoller (non-blocking)
     void refreshMinersIfActive(); // Refresh Miners screen data if currently on that screen
     void updateBitcoinPrice();  // Update Bitcoin price display (called from loop)
     void updateWeatherDisplay(); // Update weather display (called from loop)
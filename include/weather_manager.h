@@ -4,6 +4,31 @@
 #include <Arduino.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
+#include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Prévision horaire sur 24 h récupérée en une requête open-meteo et gardée
+// localement : l'affichage avance d'heure en heure sans réseau. La position
+// (ip-api) est gardée en NVS avec l'IP publique qui l'a donnée et n'est
+// redemandée que si cette IP change (api.ipify.org, texte brut sans TLS).
+//
+// Les requêtes (poignée de main TLS comprise) partent vers une tâche du
+// cœur 0 qui remplit des tampons "flow*" ; updateWeather() ne fait que la
+// lancer et recopier son résultat, sans jamais bloquer loop().
+#define WEATHER_FORECAST_HOURS    24
+#define WEATHER_REFRESH_MS        43200000  // 12 h : deux prévisions par jour
+#define WEATHER_MIN_HOURS_AHEAD   6         // Moins d'heures restantes : rafraîchir plus tôt
+#define WEATHER_RETRY_MS          600000    // Après un échec
+#define WEATHER_IP_LEN            40        // IPv4 ou IPv6 en texte
+#define WEATHER_WORKER_STACK      8192      // Poignée de main TLS dans la tâche
+#define WEATHER_WORKER_CORE       0
+
+struct HourlyWeather {
+    uint32_t time;          // Début de l'heure (Unix)
+    int16_t tempTenths;     // Dixièmes de °C
+    uint8_t code;           // Code WMO
+};
 
 // Structure pour stocker les données météo
 struct WeatherData {
@@ -18,11 +43,14 @@ class WeatherManager {
 public:
     static WeatherManager* getInstance();
 
-    // Initialisation
+    // Initialisation (position en NVS, tâche worker)
     void init();
 
-    // Mise à jour des données météo
+    // Lance le rafraîchissement de la prévision s'il est dû, recopie celle
+    // reçue par le worker, puis sélectionne l'heure courante. Non bloquant.
     bool updateWeather();
+    // Requête en cours dans le worker
+    bool isFetching() const { return fetching; }
 
     // Accès aux données
     WeatherData getWeatherData();
@@ -36,19 +64,49 @@ private:
     WeatherManager();
     static WeatherManager* instance;
 
-    WeatherData weatherData;
+    WeatherData weatherData;  // Heure courante, tirée de forecast
+    float lastLatitude;    // Dernière position connue (NVS)
+    float lastLongitude;
+    bool locationKnown;
+    char locationIp[WEATHER_IP_LEN];  // IP publique qui a donné cette position
+    Preferences prefs;
+
+    HourlyWeather forecast[WEATHER_FORECAST_HOURS];
+    int forecastCount;
+    uint32_t forecastFetchedAt;
+    uint32_t lastAttempt;
+    int currentSlot;
     String apiKey;  // Vide pour Open-Meteo (pas de clé requise)
 
+    // Tâche worker et tampons qu'elle remplit, recopiés par applyFetch()
+    TaskHandle_t worker;
+    volatile bool fetching;   // Requête confiée au worker, résultat pas encore recopié
+    volatile bool flowDone;
+    bool flowOk;
+    bool flowHave;            // Prévision déjà gardée (haveResult), capturé avant le lancement
+    bool flowUnchanged;       // 304 ou max-age : la prévision gardée reste valable
+    HourlyWeather flowForecast[WEATHER_FORECAST_HOURS];
+    int flowCount;
+
     // URLs des APIs
     const char* GEOLOCATION_API = "http://ip-api.com/json/";
     const char* WEATHER_API = "https://api.open-meteo.com/v1/forecast";
 
-    // Cache
-    const uint32_t CACHE_TIMEOUT_MS = 1800000;  // 30 minutes
+    const char* PUBLIC_IP_API = "http://api.ipify.org";
 
     // Méthodes privées
+    static void workerEntry(void* arg);
+    void post();
+    bool fetch();           // Exécuté par le worker
+    void applyFetch();      // Depuis loop(), une fois flowDone
+    bool resolveLocation(float& latitude, float& longitude);
+    bool fetchPublicIp(char* ip, size_t len);
+    bool fetchForecast(float latitude, float longitude);
+    bool selectCurrentHour();
+    int hoursAhead() const;
     String getWeatherIcon(int weatherCode);
-    String httpGET(const char* url);
+    const char* getWeatherCondition(int weatherCode);
+    int httpGET(const char* url, String& payload, bool haveResult);
 };
 
 #endif
\ No newline at end of file
@@ -4,17 +4,15 @@
 #include <ESPAsyncWebServer.h>
 #include <Preferences.h>
 #include <ArduinoJson.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "bitaxe_api.h"
+#include "fleet_storage.h"
+#include "coroutine.h"
 
-#define MAX_BITAXE_DEVICES 10
-
-struct BitaxeDevice {
-    String name;
-    String ip;
-    bool online;
-    uint32_t bestDiff;        // Meilleure difficulté trouvée
-    uint32_t bestSessionDiff; // Meilleure difficulté de la session
-    float power;              // Consommation en Watts
-};
+#define WIFI_CONNECT_RETRIES      5       // Avant de basculer en mode AP
+#define WIFI_CONNECT_TIMEOUT_MS   5000    // Par tentative
+#define WIFI_RETRY_DELAY_MS       1000
 
 class WifiManager {
 private:
@@ -26,9 +24,17 @@ private:
     String password;
     bool apMode;
     bool wasConnected;  // Pour détecter la première connexion
+    CoState connectFlow;  // Connexion au démarrage, reprise par update()
+    int connectAttempt;
     
-    BitaxeDevice bitaxes[MAX_BITAXE_DEVICES];
+    // Écrit par le serveur web (async_tcp), lu par les tâches du cœur 0 :
+    // toute lecture passe par une copie prise sous fleetMutex
+    SemaphoreHandle_t fleetMutex;
+    BitaxeDevice* bitaxes;     // fleetCapacity() entrées (PSRAM)
+    int bitaxeCapacity;
     int bitaxeCount;
+    uint16_t nextMinerId;      // Prochain ID attribué (persisté en NVS)
+    uint32_t configGeneration; // Incrémenté à chaque ajout/suppression
     
     // Callback typedef et membre
     typedef void (*WifiConnectedCallback)();
@@ -38,10 +44,13 @@ private:
     
     void setupAP();
     void setupWebServer();
+    CoStatus connectStep();
     void loadConfig();
     void saveConfig();
     void saveBitaxeConfig();
     void loadBitaxeConfig();
+    bool loadLegacyBitaxeConfig();
+    void syncRegistry();
 
 public:
     static WifiManager* getInstance() {
@@ -51,6 +60,7 @@ public:
         return instance;
     }
     
+    // Lance la connexion sans bloquer : update() la poursuit depuis loop()
     void init();
     void update();
     
@@ -77,8 +87,15 @@ public:
     // Bitaxe management
     bool addBitaxe(String name, String ip);
     bool removeBitaxe(int index);
-    BitaxeDevice* getBitaxe(int index);
+    // Copie de l'entrée : removeBitaxe() décale le tableau, un pointeur
+    // dedans peut désigner un autre mineur dès la requête suivante
+    bool copyBitaxe(int index, BitaxeDevice& out);
+    bool copyBitaxeById(uint16_t id, BitaxeDevice& out);
+    bool hasBitaxe(uint16_t id);
     int getBitaxeCount() { return bitaxeCount; }
+    int getBitaxeCapacity() { return bitaxeCapacity; }
+    // Change quand la liste des mineurs change (le poller ne resynchronise qu'à ce moment)
+    uint32_t getConfigGeneration() { return configGeneration; }
 };
 
 inline WifiManager* WifiManager::instance = nullptr;
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include <WiFiClientSecure.h>
+
+// Client WebSocket minimal (RFC 6455) pour l'API /api/ws d'AxeOS et les flux
+// externes (wss) : poignée de main HTTP, trames texte du serveur (non
+// masquées), réponse aux ping. poll() ne bloque jamais : les octets
+// disponibles sont décodés au fil de l'eau et chaque message texte complet
+// est passé au callback. pollStream() passe la charge utile par morceaux,
+// sans limite de taille, pour les messages trop gros pour être gardés.
+#define WS_MAX_MESSAGE       512    // Message plus long : tronqué
+#define WS_HANDSHAKE_MS      2000
+
+class WsClient {
+public:
+    typedef void (*MessageCallback)(void* ctx, const char* data, size_t len);
+    // start : premier morceau d'un message ; end : message terminé (len peut être 0)
+    typedef void (*FragmentCallback)(void* ctx, const uint8_t* data, size_t len, bool start, bool end);
+
+    WsClient();
+
+    bool connect(const char* host, uint16_t port, const char* path, uint32_t timeoutMs, bool secure = false);
+    // Décode ce qui est arrivé. false si la connexion est fermée ou invalide.
+    bool poll(MessageCallback onMessage, void* ctx);
+    bool pollStream(FragmentCallback onFragment, void* ctx);
+    // Message texte court (abonnement), moins de 126 octets
+    bool sendText(const char* text);
+    void close();
+    bool connected() { return client->connected(); }
+
+private:
+    enum ParseState : uint8_t {
+        WS_HEADER0,
+        WS_HEADER1,
+        WS_EXT_LEN,
+        WS_MASK_KEY,
+        WS_PAYLOAD
+    };
+
+    WiFiClient plain;
+    WiFiClientSecure tls;
+    WiFiClient* client;       // plain ou tls selon la dernière connexion
+    ParseState state;
+    uint8_t opcode;           // Opcode de la trame courante
+    uint8_t messageOpcode;    // Opcode du message (les continuations gardent le premier)
+    bool fin;
+    bool masked;
+    uint8_t extNeeded;
+    uint8_t extRead;
+    uint8_t mask[4];
+    uint8_t maskRead;
+    uint32_t payloadLen;
+    uint32_t payloadRead;
+
+    char message[WS_MAX_MESSAGE + 1];
+    size_t messageLen;
+    uint8_t control[125];     // Charge d'un ping/close (125 octets max)
+    size_t controlLen;
+    bool streamStarted;       // pollStream : début du message déjà signalé
+
+    bool handshake(const char* host, const char* path);
+    void beginFrame();
+    bool pump(MessageCallback onMessage, FragmentCallback onFragment, void* ctx);
+    bool endFrame(MessageCallback onMessage, FragmentCallback onFragment, void* ctx);
+    void deliverRun(FragmentCallback onFragment, void* ctx, const uint8_t* data, size_t len);
+    uint8_t messageOpcodeOf(uint8_t frameOpcode) const;
+    void sendFrame(uint8_t opcode, const uint8_t* data, size_t len);
+};
@@ -1,45 +1,277 @@
 #include "bitaxe_api.h"
+#include "chunked_stream.h"
+#include "miner_connection_pool.h"
+#include "miner_request_coalescer.h"
+#include "socket_budget.h"
+
+// Estimateurs partagés par toutes les instances de BitaxeAPI (workers du
+// poller, boutons de l'UI, portail web). Pas de String ici : la table est
+// modifiée en section critique.
+struct RttSlot {
+    char host[40];
+    RttEstimator rtt;
+    uint32_t lastUsed;
+};
+static portMUX_TYPE rttLock = portMUX_INITIALIZER_UNLOCKED;
+
+// Un slot par mineur de la flotte, plus quelques-uns pour les tests du portail
+static int rttTableSize() {
+    return fleetCapacity() + BITAXE_RTT_EXTRA_SLOTS;
+}
+
+// Alloué au premier appel (initialisation de static thread-safe), jamais
+// depuis la section critique
+static RttSlot* rttTable() {
+    static RttSlot* table = fleetAllocArray<RttSlot>(rttTableSize());
+    return table;
+}
+
+static RttEstimator loadRtt(const char* host) {
+    RttEstimator result;
+    RttSlot* table = rttTable();
+    if (table == nullptr) {
+        return result;
+    }
+    int size = rttTableSize();
+    portENTER_CRITICAL(&rttLock);
+    for (int i = 0; i < size; i++) {
+        if (strcmp(table[i].host, host) == 0) {
+            result = table[i].rtt;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&rttLock);
+    return result;
+}
+
+static void storeRtt(const char* host, const RttEstimator& rtt) {
+    RttSlot* table = rttTable();
+    if (table == nullptr || host[0] == '\0' || strlen(host) >= sizeof(table[0].host)) {
+        return;
+    }
+    int size = rttTableSize();
+    portENTER_CRITICAL(&rttLock);
+    // Même hôte, sinon slot libre, sinon le moins récemment utilisé
+    int target = 0;
+    for (int i = 0; i < size; i++) {
+        if (strcmp(table[i].host, host) == 0) {
+            target = i;
+            break;
+        }
+        if (table[i].host[0] == '\0' ||
+            (table[target].host[0] != '\0' && table[i].lastUsed < table[target].lastUsed)) {
+            target = i;
+        }
+    }
+    strcpy(table[target].host, host);
+    table[target].rtt = rtt;
+    table[target].lastUsed = millis();
+    portEXIT_CRITICAL(&rttLock);
+}
 
 BitaxeAPI::BitaxeAPI() {
-    baseUrl = "";
+    url.reserve(BITAXE_HOST_LEN + 40);  // Préfixe + endpoint le plus long, alloué une fois
+    urlBaseLen = 0;
+    conn = nullptr;
+    pooled = false;
+    counted = false;
+    reused = false;
+    requestStart = 0;
+    // Une seule fois : collectHeaders() réalloue sa table à chaque appel
+    static const char* transferHeaders[] = { "Transfer-Encoding" };
+    http.collectHeaders(transferHeaders, 1);
 }
 
 BitaxeAPI::~BitaxeAPI() {
-    http.end();
+    close();
 }
 
-void BitaxeAPI::setDevice(String ip) {
-    baseUrl = "http://" + ip;
-    Serial.printf("[BitaxeAPI] Device set to: %s\n", baseUrl.c_str());
+void BitaxeAPI::setDevice(const char* ip) {
+    if (host != ip || urlBaseLen == 0) {
+        host = ip;
+        url = "http://";
+        url += host.c_str();
+        urlBaseLen = url.length();
+    }
+    rtt = loadRtt(host.c_str());
+    Serial.printf("[BitaxeAPI] Device set to: http://%s (rto %u ms, %u sample(s))\n", host.c_str(), rtt.rto, rtt.samples);
 }
 
-bool BitaxeAPI::makeRequest(const char* endpoint, JsonDocument& doc) {
-    if (baseUrl.length() == 0) {
+uint32_t BitaxeAPI::timeoutFor(float factor, uint32_t minMs, uint32_t maxMs) const {
+    return rtt.deadline(factor, minMs, maxMs);
+}
+
+bool BitaxeAPI::probe() {
+    uint32_t timeout = rtt.probeTimeout();
+    
+    // Pool plein et plus de socket partagé : le mineur n'y est pour rien, RTT inchangé
+    SocketBudget* budget = SocketBudget::getInstance();
+    if (!budget->acquire(SOCKET_MINERS)) {
+        Serial.printf("[BitaxeAPI] %s: no lwIP socket left, request skipped\n", host.c_str());
+        return false;
+    }
+    if (!conn->connect(host.c_str(), 80, timeout)) {
+        budget->release(SOCKET_MINERS);
+        rtt.onTimeout();
+        storeRtt(host.c_str(), rtt);
+        Serial.printf("[BitaxeAPI] %s unreachable (no TCP connect in %u ms)\n", host.c_str(), timeout);
+        return false;
+    }
+    if (pooled) {
+        MinerConnectionPool::getInstance()->markOpened(conn);
+    } else {
+        counted = true;
+    }
+    return true;
+}
+
+bool BitaxeAPI::open(const char* endpoint, uint32_t timeoutMs) {
+    if (host.isEmpty()) {
+        return false;
+    }
+    
+    // Connexion keep-alive du pool si possible, sinon connexion à usage unique
+    conn = MinerConnectionPool::getInstance()->acquire(host.c_str());
+    pooled = (conn != nullptr);
+    if (!pooled) {
+        conn = &client;
+    }
+    
+    reused = conn->connected();
+    requestStart = millis();
+    if (!reused && !probe()) {
+        close();
         return false;
     }
     
-    String url = baseUrl + endpoint;
+    // HTTPClient reprend la connexion déjà ouverte (pas de nouveau handshake)
+    // Seul l'endpoint change : réécrit après le préfixe, dans la capacité déjà réservée
+    url.remove(urlBaseLen);
+    url += endpoint;
+    http.begin(*conn, url);
+    http.useHTTP10(false);
+    http.setReuse(pooled);
+    http.setTimeout(timeoutMs);
+    return true;
+}
+
+int BitaxeAPI::execute(const char* method, const char* endpoint, uint32_t timeoutMs, const String& payload) {
+    if (!open(endpoint, timeoutMs)) {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    if (payload.length() > 0) {
+        http.addHeader("Content-Type", "application/json");
+    }
+    int httpCode = http.sendRequest(method, payload);
+    
+    // Connexion du pool fermée entre-temps par le mineur : une seule nouvelle tentative
+    if (httpCode < 0 && reused) {
+        MinerConnectionPool::getInstance()->countStale();
+        conn->stop();
+        close();
+        if (!open(endpoint, timeoutMs)) {
+            return HTTPC_ERROR_CONNECTION_REFUSED;
+        }
+        if (payload.length() > 0) {
+            http.addHeader("Content-Type", "application/json");
+        }
+        httpCode = http.sendRequest(method, payload);
+    } else if (httpCode > 0 && reused) {
+        MinerConnectionPool::getInstance()->countReused();
+    }
     
-    http.begin(url);
-    http.setTimeout(2000);  // REDUCED: 2 seconds timeout (was 1s) for better reliability with multiple devices
+    if (httpCode > 0) {
+        rtt.addSample(millis() - requestStart);
+    } else if (httpCode == HTTPC_ERROR_READ_TIMEOUT || httpCode == HTTPC_ERROR_CONNECTION_REFUSED) {
+        rtt.onTimeout();
+    }
+    storeRtt(host.c_str(), rtt);
+    return httpCode;
+}
+
+void BitaxeAPI::close() {
+    http.end();
+    if (conn == nullptr) {
+        return;
+    }
+    if (pooled) {
+        // Reste ouverte dans le pool si le mineur a gardé la connexion
+        MinerConnectionPool::getInstance()->release(conn);
+    } else {
+        conn->stop();
+        if (counted) {
+            SocketBudget::getInstance()->release(SOCKET_MINERS);
+            counted = false;
+        }
+    }
+    conn = nullptr;
+    pooled = false;
+}
+
+JsonDocument* BitaxeAPI::makeRequest(const char* endpoint, JsonDocument& scratch, const JsonDocument* filter, int& lease) {
+    MinerRequestCoalescer* coalescer = MinerRequestCoalescer::getInstance();
+    bool leader;
+    bool ok;
+    lease = coalescer->acquire(host.c_str(), endpoint, filter, leader, ok);
+    if (lease == COALESCE_BYPASS) {
+        return fetch(endpoint, scratch, filter) ? &scratch : nullptr;
+    }
+    if (lease == COALESCE_NO_SLOT) {
+        return nullptr;
+    }
     
-    int httpCode = http.GET();
+    JsonDocument& doc = coalescer->document(lease);
+    if (leader) {
+        ok = fetch(endpoint, doc, filter);
+        coalescer->complete(lease, ok);
+    }
+    if (!ok) {
+        coalescer->release(lease);
+        lease = COALESCE_NO_SLOT;
+        return nullptr;
+    }
+    return &doc;
+}
+
+bool BitaxeAPI::fetch(const char* endpoint, JsonDocument& doc, const JsonDocument* filter) {
+    int httpCode = execute("GET", endpoint, timeoutFor(1.0f, BITAXE_REQUEST_MIN_MS, BITAXE_REQUEST_MAX_MS));
     
     if (httpCode == HTTP_CODE_OK) {
-        String payload = http.getString();
+        DeserializationError error;
+        int size = http.getSize();
         
-        // LIMIT JSON SIZE to prevent memory issues with multiple devices
-        if (payload.length() > 2048) {  // Max 2KB per response
-            Serial.printf("[BitaxeAPI] Response too large: %d bytes, skipping\n", payload.length());
-            http.end();
-            return false;
+        if (size < 0 && http.header("Transfer-Encoding").equalsIgnoreCase("chunked")) {
+            // Réponse chunked (HTTP/1.1 keep-alive) : décodée au fil du flux,
+            // sans copier le body. Sans filtre, la taille est bornée en lisant.
+            ChunkedStream body(http.getStream(), filter == nullptr ? BITAXE_MAX_UNFILTERED_RESPONSE : 0);
+            error = filter != nullptr ? deserializeJson(doc, body, DeserializationOption::Filter(*filter))
+                                      : deserializeJson(doc, body);
+            if (body.overflowed()) {
+                Serial.printf("[BitaxeAPI] Response too large: over %u bytes, skipping\n", BITAXE_MAX_UNFILTERED_RESPONSE);
+                conn->stop();
+                close();
+                return false;
+            }
+            // Fin du body et chunk final lus : la connexion reste réutilisable
+            if (error || !body.drain()) {
+                conn->stop();
+            }
+        } else if (filter != nullptr) {
+            // Parse directement depuis le socket, sans copier le body en mémoire
+            error = deserializeJson(doc, http.getStream(), DeserializationOption::Filter(*filter));
+        } else {
+            // Sans filtre tout le document est gardé : limiter la taille annoncée
+            if (size > BITAXE_MAX_UNFILTERED_RESPONSE) {
+                Serial.printf("[BitaxeAPI] Response too large: %d bytes, skipping\n", size);
+                close();
+                return false;
+            }
+            error = deserializeJson(doc, http.getStream());
         }
         
-        DeserializationError error = deserializeJson(doc, payload);
-        
         if (error) {
             Serial.printf("[BitaxeAPI] JSON parse error: %s\n", error.c_str());
-            http.end();
+            close();
             return false;
         }
         
@@ -52,294 +284,109 @@ bool BitaxeAPI::makeRequest(const char* endpoint, JsonDocument& doc) {
             firstDebug = false;
         }
         
-        http.end();
+        close();
         return true;
     } else {
-        Serial.printf("[BitaxeAPI] HTTP error: %d for %s\n", httpCode, url.c_str());
-        http.end();
+        Serial.printf("[BitaxeAPI] HTTP error: %d for %s%s\n", httpCode, host.c_str(), endpoint);
+        close();
         return false;
     }
 }
 
 bool BitaxeAPI::testConnection() {
-    if (baseUrl.length() == 0) {
-        return false;
-    }
-    
-    http.begin(baseUrl + "/api/system/info");
-    http.setTimeout(3000);
-    
-    int httpCode = http.GET();
-    http.end();
+    int httpCode = execute("GET", "/api/system/info", timeoutFor(1.0f, BITAXE_REQUEST_MIN_MS, BITAXE_REQUEST_MAX_MS));
+    close();
     
     return (httpCode == HTTP_CODE_OK);
 }
 
 // Control actions
 bool BitaxeAPI::restart() {
-    if (baseUrl.length() == 0) return false;
-    
-    http.begin(baseUrl + "/api/system/restart");
-    http.setTimeout(5000);
-    
-    int httpCode = http.POST("");
-    http.end();
+    int httpCode = execute("POST", "/api/system/restart", timeoutFor(2.0f, BITAXE_ACTION_MIN_MS, BITAXE_ACTION_MAX_MS));
+    close();
+    MinerRequestCoalescer::getInstance()->invalidate(host.c_str());
     
     Serial.printf("[BitaxeAPI] Restart command: HTTP %d\n", httpCode);
     return (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_NO_CONTENT);
 }
 
 bool BitaxeAPI::reboot() {
-    if (baseUrl.length() == 0) return false;
-    
-    http.begin(baseUrl + "/api/system/reboot");
-    http.setTimeout(5000);
-    
-    int httpCode = http.POST("");
-    http.end();
+    int httpCode = execute("POST", "/api/system/reboot", timeoutFor(2.0f, BITAXE_ACTION_MIN_MS, BITAXE_ACTION_MAX_MS));
+    close();
+    MinerRequestCoalescer::getInstance()->invalidate(host.c_str());
     
     Serial.printf("[BitaxeAPI] Reboot command: HTTP %d\n", httpCode);
     return (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_NO_CONTENT);
 }
 
 bool BitaxeAPI::stopMining() {
-    if (baseUrl.length() == 0) return false;
-    
-    http.begin(baseUrl + "/api/mining/stop");
-    http.setTimeout(3000);
-    
-    int httpCode = http.POST("");
-    http.end();
+    int httpCode = execute("POST", "/api/mining/stop", timeoutFor(2.0f, BITAXE_ACTION_MIN_MS, BITAXE_ACTION_MAX_MS));
+    close();
+    MinerRequestCoalescer::getInstance()->invalidate(host.c_str());
     
     Serial.printf("[BitaxeAPI] Stop mining command: HTTP %d\n", httpCode);
     return (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_NO_CONTENT);
 }
 
 bool BitaxeAPI::startMining() {
-    if (baseUrl.length() == 0) return false;
-    
-    http.begin(baseUrl + "/api/mining/start");
-    http.setTimeout(3000);
-    
-    int httpCode = http.POST("");
-    http.end();
+    int httpCode = execute("POST", "/api/mining/start", timeoutFor(2.0f, BITAXE_ACTION_MIN_MS, BITAXE_ACTION_MAX_MS));
+    close();
+    MinerRequestCoalescer::getInstance()->invalidate(host.c_str());
     
     Serial.printf("[BitaxeAPI] Start mining command: HTTP %d\n", httpCode);
     return (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_NO_CONTENT);
 }
 
 // Configuration
-bool BitaxeAPI::getConfig(JsonDocument& config) {
-    return makeRequest("/api/system/config", config);
+bool BitaxeAPI::getConfig(JsonDocument& config, const JsonDocument& filter) {
+    int lease;
+    JsonDocument* result = makeRequest("/api/system/info", config, &filter, lease);
+    // Lu dans un slot du coalesceur : l'appelant garde la config au-delà de la requête
+    if (result != nullptr && result != &config) {
+        config.set(*result);
+    }
+    MinerRequestCoalescer::getInstance()->release(lease);
+    return result != nullptr;
 }
 
 bool BitaxeAPI::setConfig(JsonDocument& config) {
-    if (baseUrl.length() == 0) return false;
-    
-    String url = baseUrl + "/api/system/config";
     String jsonString;
     serializeJson(config, jsonString);
     
-    http.begin(url);
-    http.setTimeout(5000);
-    http.addHeader("Content-Type", "application/json");
-    
-    int httpCode = http.POST(jsonString);
-    http.end();
+    int httpCode = execute("PATCH", "/api/system", timeoutFor(2.0f, BITAXE_ACTION_MIN_MS, BITAXE_ACTION_MAX_MS), jsonString);
+    close();
+    MinerRequestCoalescer::getInstance()->invalidate(host.c_str());
     
     Serial.printf("[BitaxeAPI] Set config: HTTP %d\n", httpCode);
     return (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_NO_CONTENT);
 }
 
 // Firmware update
-bool BitaxeAPI::updateFirmware(String url) {
-    if (baseUrl.length() == 0) return false;
+bool BitaxeAPI::updateFirmware(String firmwareUrl) {
+    String payload = "{\"url\":\"" + firmwareUrl + "\"}";
     
-    String updateUrl = baseUrl + "/api/system/update";
-    String payload = "{\"url\":\"" + url + "\"}";
-    
-    http.begin(updateUrl);
-    http.setTimeout(10000);  // Longer timeout for firmware update
-    http.addHeader("Content-Type", "application/json");
-    
-    int httpCode = http.POST(payload);
-    http.end();
+    // Longer timeout for firmware update
+    int httpCode = execute("POST", "/api/system/update", timeoutFor(4.0f, BITAXE_FIRMWARE_MIN_MS, BITAXE_FIRMWARE_MAX_MS), payload);
+    close();
+    MinerRequestCoalescer::getInstance()->invalidate(host.c_str());
     
     Serial.printf("[BitaxeAPI] Firmware update: HTTP %d\n", httpCode);
     return (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_ACCEPTED);
 }
 
-bool BitaxeAPI::getStats(BitaxeStats& stats) {
+bool BitaxeAPI::getStats(BitaxeStats& stats, BitaxeFieldMap* plan, JsonDocument& scratch) {
     stats.valid = false;
     
     // Get system info from /api/system/info
-    JsonDocument infoDoc;
-    if (!makeRequest("/api/system/info", infoDoc)) {
-        return false;
-    }
-    
-    // Parse system info - check if response is valid
-    if (infoDoc.isNull()) {
-        return false;
-    }
-    
-    // Try different field names (AxeOS vs ESP-Miner variants)
-    if (infoDoc.containsKey("ASICModel")) {
-        stats.hostname = infoDoc["ASICModel"].as<String>();
-    } else if (infoDoc.containsKey("hostname")) {
-        stats.hostname = infoDoc["hostname"].as<String>();
-    } else {
-        stats.hostname = "Bitaxe";
-    }
-    
-    if (infoDoc.containsKey("version")) {
-        stats.version = infoDoc["version"].as<String>();
-    } else {
-        stats.version = "Unknown";
-    }
-    
-    // Temperature - can be in different places
-    if (infoDoc.containsKey("temp")) {
-        stats.temp = infoDoc["temp"].as<float>();
-    } else if (infoDoc.containsKey("temperature")) {
-        stats.temp = infoDoc["temperature"].as<float>();
-    } else {
-        stats.temp = 0.0;
-    }
-    
-    // Power
-    if (infoDoc.containsKey("power")) {
-        stats.power = infoDoc["power"].as<float>();
-    } else if (infoDoc.containsKey("voltage") && infoDoc.containsKey("current")) {
-        // Calculate power from voltage and current
-        stats.power = infoDoc["voltage"].as<float>() * infoDoc["current"].as<float>();
-    } else {
-        stats.power = 0.0;
-    }
-    
-    // Hashrate - usually in GH/s or needs conversion from H/s
-    if (infoDoc.containsKey("hashRate")) {
-        float hashrate = infoDoc["hashRate"].as<float>();
-        // If value is very large, it's probably in H/s, convert to GH/s
-        if (hashrate > 1000000) {
-            stats.hashrate = hashrate / 1000000000.0;
-        } else {
-            stats.hashrate = hashrate;
-        }
-    } else if (infoDoc.containsKey("currentHashrate")) {
-        stats.hashrate = infoDoc["currentHashrate"].as<float>() / 1000000000.0;
-    } else {
-        stats.hashrate = 0.0;
-    }
-    
-    // Best difficulty - peut être un nombre OU une string formatée (ex: "997.30 M", "72.6G")
-    if (infoDoc.containsKey("bestDiff")) {
-        if (infoDoc["bestDiff"].is<String>()) {
-            // C'est une string formatée comme "997.30 M" ou "72.6G"
-            String diffStr = infoDoc["bestDiff"].as<String>();
-            float diffValue = 0;
-            char unit = ' ';
-            
-            // Parse "997.30 M" ou "72.6G"
-            if (sscanf(diffStr.c_str(), "%f %c", &diffValue, &unit) >= 1) {
-                if (unit == 'G' || unit == 'g') {
-                    stats.bestDiff = (uint32_t)(diffValue * 1000000000.0); // Giga
-                } else if (unit == 'M' || unit == 'm') {
-                    stats.bestDiff = (uint32_t)(diffValue * 1000000.0);    // Mega
-                } else if (unit == 'K' || unit == 'k') {
-                    stats.bestDiff = (uint32_t)(diffValue * 1000.0);       // Kilo
-                } else {
-                    stats.bestDiff = (uint32_t)diffValue;                  // Pas d'unité
-                }
-                Serial.printf("[BitaxeAPI] Parsed bestDiff string '%s' -> %u\n", diffStr.c_str(), stats.bestDiff);
-            } else {
-                stats.bestDiff = 0;
-                Serial.printf("[BitaxeAPI] Failed to parse bestDiff string: '%s'\n", diffStr.c_str());
-            }
-        } else {
-            // C'est un nombre direct
-            stats.bestDiff = infoDoc["bestDiff"].as<uint32_t>();
-            Serial.printf("[BitaxeAPI] Found bestDiff as number: %u\n", stats.bestDiff);
-        }
-    } else if (infoDoc.containsKey("best_diff")) {
-        stats.bestDiff = infoDoc["best_diff"].as<uint32_t>();
-        Serial.printf("[BitaxeAPI] Found best_diff in JSON: %u\n", stats.bestDiff);
-    } else if (infoDoc.containsKey("bestSessionDiff")) {
-        if (infoDoc["bestSessionDiff"].is<String>()) {
-            String diffStr = infoDoc["bestSessionDiff"].as<String>();
-            float diffValue = 0;
-            char unit = ' ';
-            
-            if (sscanf(diffStr.c_str(), "%f %c", &diffValue, &unit) >= 1) {
-                if (unit == 'G' || unit == 'g') {
-                    stats.bestDiff = (uint32_t)(diffValue * 1000000000.0);
-                } else if (unit == 'M' || unit == 'm') {
-                    stats.bestDiff = (uint32_t)(diffValue * 1000000.0);
-                } else if (unit == 'K' || unit == 'k') {
-                    stats.bestDiff = (uint32_t)(diffValue * 1000.0);
-                } else {
-                    stats.bestDiff = (uint32_t)diffValue;
-                }
-                Serial.printf("[BitaxeAPI] Parsed bestSessionDiff string '%s' -> %u\n", diffStr.c_str(), stats.bestDiff);
-            } else {
-                stats.bestDiff = 0;
-            }
-        } else {
-            stats.bestDiff = infoDoc["bestSessionDiff"].as<uint32_t>();
-        }
-        Serial.printf("[BitaxeAPI] Found bestSessionDiff in JSON: %u\n", stats.bestDiff);
-    } else {
-        stats.bestDiff = 0;
-        Serial.println("[BitaxeAPI] WARNING: No bestDiff/best_diff/bestSessionDiff field found in JSON!");
-    }
-    
-    // Shares
-    if (infoDoc.containsKey("sharesAccepted")) {
-        stats.shares = infoDoc["sharesAccepted"].as<uint32_t>();
-    } else if (infoDoc.containsKey("shares_accepted")) {
-        stats.shares = infoDoc["shares_accepted"].as<uint32_t>();
-    } else if (infoDoc.containsKey("accepted")) {
-        stats.shares = infoDoc["accepted"].as<uint32_t>();
-    } else {
-        stats.shares = 0;
-    }
-    
-    // Calculate efficiency (J/TH)
-    if (stats.hashrate > 0 && stats.power > 0) {
-        stats.efficiency = (stats.power / stats.hashrate) * 1000.0;
-    } else {
-        stats.efficiency = 0;
-    }
-    
-    // Pool info - might be in the same response
-    if (infoDoc.containsKey("stratumURL")) {
-        stats.poolUrl = infoDoc["stratumURL"].as<String>();
-    } else if (infoDoc.containsKey("pool_url")) {
-        stats.poolUrl = infoDoc["pool_url"].as<String>();
-    } else {
-        stats.poolUrl = "";
-    }
-    
-    if (infoDoc.containsKey("stratumUser")) {
-        stats.poolUser = infoDoc["stratumUser"].as<String>();
-    } else if (infoDoc.containsKey("pool_user")) {
-        stats.poolUser = infoDoc["pool_user"].as<String>();
-    } else {
-        stats.poolUser = "";
-    }
-    
-    // Pool connection status
-    stats.poolConnected = (stats.hashrate > 0);  // Assume connected if hashing
-    
-    // Uptime
-    if (infoDoc.containsKey("uptimeSeconds")) {
-        stats.uptimeSeconds = infoDoc["uptimeSeconds"].as<uint32_t>();
-    } else if (infoDoc.containsKey("uptime")) {
-        stats.uptimeSeconds = infoDoc["uptime"].as<uint32_t>();
-    } else {
-        stats.uptimeSeconds = 0;
-    }
-    
-    stats.valid = true;
-    return true;
+    int lease;
+    JsonDocument* info = makeRequest("/api/system/info", scratch, &MinerSchema::infoFilter(), lease);
+    bool ok = info != nullptr && MinerSchema::parse(*info, plan, stats, host.c_str());
+    MinerRequestCoalescer::getInstance()->release(lease);
+    return ok;
+}
+
+bool BitaxeAPI::getStats(BitaxeStats& stats, BitaxeFieldMap* plan) {
+    // Appels ponctuels (découverte, portail) : document temporaire
+    JsonDocument scratch;
+    return getStats(stats, plan, scratch);
 }
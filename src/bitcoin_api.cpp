@@ -1,7 +1,10 @@
 #include "bitcoin_api.h"
-#include <HTTPClient.h>
+#include "external_http.h"
+#include "price_providers.h"
 #include <ArduinoJson.h>
 
+#define MEMPOOL_API "https://mempool.space/api"
+
 BitcoinAPI& BitcoinAPI::getInstance() {
     static BitcoinAPI instance;
     return instance;
@@ -10,202 +13,336 @@ BitcoinAPI& BitcoinAPI::getInstance() {
 void BitcoinAPI::begin() {
     price = 0.0;
     priceValid = false;
+    PriceProviders::getInstance()->begin();
+    if (worker == nullptr) {
+        xTaskCreatePinnedToCore(workerEntry, "bitcoin", BITCOIN_WORKER_STACK, this, 1, &worker, BITCOIN_WORKER_CORE);
+    }
     Serial.println("[BitcoinAPI] Initialized");
 }
 
+void BitcoinAPI::workerEntry(void* arg) {
+    BitcoinAPI* self = (BitcoinAPI*)arg;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        self->flowOk = (self->*(self->flowJob))();
+        self->flowDone = true;
+    }
+}
+
+void BitcoinAPI::post(FlowJob job) {
+    flowJob = job;
+    flowDone = false;
+    if (worker == nullptr) {
+        // begin() pas encore appelé : requête faite sur place
+        flowOk = (this->*job)();
+        flowDone = true;
+        return;
+    }
+    xTaskNotifyGive(worker);
+}
+
+CoStatus BitcoinAPI::stepPrice() {
+    CO_BEGIN(priceFlow);
+    // Plusieurs fournisseurs avec requêtes couvertes et budgets (PriceProviders)
+    post(&BitcoinAPI::fetchPrice);
+    CO_AWAIT(flowDone);
+    applyFlowPrice();
+    CO_END();
+}
+
 bool BitcoinAPI::fetchPrice() {
-    HTTPClient http;
-    
-    // CoinGecko API - Free tier: 10-50 req/min
-    // We're using 1 req/min = 60 req/hour - within limits
-    const char* url = "https://api.coingecko.com/api/v3/simple/price?ids=bitcoin&vs_currencies=usd";
-    
-    Serial.println("[BitcoinAPI] Fetching Bitcoin price...");
-    
-    http.begin(url);
-    http.setTimeout(10000); // 10 second timeout
-    
-    int httpCode = http.GET();
-    
-    if (httpCode == HTTP_CODE_OK) {
-        String payload = http.getString();
-        
-        // Parse JSON response
-        JsonDocument doc;
-        DeserializationError error = deserializeJson(doc, payload);
-        
-        if (!error) {
-            if (doc.containsKey("bitcoin") && doc["bitcoin"].containsKey("usd")) {
-                price = doc["bitcoin"]["usd"].as<float>();
-                priceValid = true;
-                Serial.printf("[BitcoinAPI] Price updated: $%.2f\n", price);
-                http.end();
-                return true;
-            } else {
-                Serial.println("[BitcoinAPI] Invalid JSON structure");
-            }
+    return PriceProviders::getInstance()->fetch(flowPrice, flowPriceSource);
+}
+
+void BitcoinAPI::applyFlowPrice() {
+    if (flowOk) {
+        if (flowPrice != price) {
+            Serial.printf("[BitcoinAPI] Price updated: $%.2f (%s)\n", flowPrice, flowPriceSource);
+        }
+        price = flowPrice;
+        priceValid = true;
+        lastPriceAt = millis();
+        priceSource = flowPriceSource;
+        return;
+    }
+
+    // Le dernier prix reste affiché ; isPriceStale() le signale à l'écran
+    if (priceValid) {
+        Serial.printf("[BitcoinAPI] No price source answered, keeping $%.2f from %lu s ago\n",
+                      price, (millis() - lastPriceAt) / 1000);
+    }
+}
+
+CoStatus BitcoinAPI::stepBlockData() {
+    CO_BEGIN(blockFlow);
+    blockFlowOk = false;
+    flowHave = blockDataValid;
+    flowKnownHeight = blockHeight;
+    post(&BitcoinAPI::fetchTipHeight);
+    CO_AWAIT(flowDone);
+    if (!flowOk) {
+        blockDataValid = false;
+        CO_EXIT();
+    }
+
+    // Nouveau bloc : détail du tip (cache par hash) et fees rafraîchies
+    flowNewBlock = !blockDataValid || flowHeight != blockHeight;
+    if (flowNewBlock) {
+        post(&BitcoinAPI::fetchTipHash);
+        CO_AWAIT(flowDone);
+        if (!flowOk) {
+            blockDataValid = false;
+            CO_EXIT();
+        }
+
+        // Tip déjà connu (données invalidées par une erreur passagère) : pas de nouvelle liste
+        if (findBlock(flowHash) != nullptr) {
+            blockCacheHits++;
         } else {
-            Serial.printf("[BitcoinAPI] JSON parse error: %s\n", error.c_str());
+            post(&BitcoinAPI::fetchRecentBlocks);
+            CO_AWAIT(flowDone);
+            applyFlowBlocks();
+        }
+        if (!applyFlowTip()) {
+            blockDataValid = false;
+            CO_EXIT();
         }
+    }
+
+    if (flowNewBlock || !feesValid || millis() - lastFeesFetch > FEES_REFRESH_MS) {
+        flowHave = feesValid;
+        post(&BitcoinAPI::fetchFees);
+        CO_AWAIT(flowDone);
+        applyFlowFees();
+        flowHave = projectedCount > 0;
+        post(&BitcoinAPI::fetchProjectedBlocks);
+        CO_AWAIT(flowDone);
+        applyFlowProjected();
+    }
+
+    // Âge recalculé localement à chaque appel
+    refreshBlockAge();
+
+    blockDataValid = true;
+    blockFlowOk = true;
+    if (flowNewBlock) {
+        Serial.printf("[BitcoinAPI] Block data updated: height=%u, age=%u min, fees=%.1f-%.1f sat/vB, pool=%s\n",
+                      blockHeight, blockAgeMinutes, minFee, maxFee, poolName.c_str());
+    }
+    CO_END();
+}
+
+// Tip de flowHash dans la liste des derniers blocs
+bool BitcoinAPI::applyFlowTip() {
+    const BlockInfo* block = findBlock(flowHash);
+    if (block == nullptr && recentCount > 0) {
+        block = &recentBlocks[0];  // Un bloc est arrivé entre les deux requêtes
+    }
+    if (block == nullptr) {
+        return false;
+    }
+    blockHeight = block->height != 0 ? block->height : flowHeight;
+    setTip(*block);
+    return true;
+}
+
+bool BitcoinAPI::fetchTipHeight() {
+    String payload;
+    int httpCode = ExternalHttp::getInstance()->get(MEMPOOL_API "/blocks/tip/height", payload, EXT_HTTP_TIMEOUT_MS,
+                                                    flowHave);
+    if (ExternalHttp::unchanged(httpCode)) {
+        flowHeight = flowKnownHeight;
+        return true;
+    }
+    if (httpCode != HTTP_CODE_OK) {
+        Serial.printf("[BitcoinAPI] Tip height HTTP error: %d\n", httpCode);
+        return false;
+    }
+    flowHeight = strtoul(payload.c_str(), nullptr, 10);
+    return flowHeight > 0;
+}
+
+bool BitcoinAPI::fetchTipHash() {
+    String payload;
+    int httpCode = ExternalHttp::getInstance()->get(MEMPOOL_API "/blocks/tip/hash", payload);
+    if (httpCode != HTTP_CODE_OK) {
+        Serial.printf("[BitcoinAPI] Tip hash HTTP error: %d\n", httpCode);
+        return false;
+    }
+    payload.trim();
+    if (payload.length() != BLOCK_HASH_LEN - 1) {
+        Serial.println("[BitcoinAPI] Invalid tip hash");
+        return false;
+    }
+    strlcpy(flowHash, payload.c_str(), BLOCK_HASH_LEN);
+    return true;
+}
+
+void BitcoinAPI::onRecentBlock(JsonVariantConst element, int index, void* ctx) {
+    BitcoinAPI* self = (BitcoinAPI*)ctx;
+    if (index >= RECENT_BLOCKS_COUNT) {
+        return;  // Lu (connexion réutilisable) mais pas gardé
+    }
+    BlockDecoder::decodeBlock(element, self->flowBlocks[index]);
+    self->flowBlockCount = index + 1;
+}
+
+bool BitcoinAPI::fetchRecentBlocks() {
+    // Appelé parce que le tip a changé : la liste déjà décodée ne suffit plus (pas de haveResult)
+    uint32_t start = millis();
+    flowBlockCount = 0;
+    int httpCode = ExternalHttp::getInstance()->getJsonArray(MEMPOOL_API "/v1/blocks", &BlockDecoder::blockFilter(), onRecentBlock, this);
+    if (httpCode != HTTP_CODE_OK || flowBlockCount == 0) {
+        Serial.printf("[BitcoinAPI] Recent blocks HTTP error: %d\n", httpCode);
+        flowBlockCount = 0;
+        return false;
+    }
+    Serial.printf("[BitcoinAPI] %d recent block(s) parsed in %lu ms\n", flowBlockCount, millis() - start);
+    return true;
+}
+
+void BitcoinAPI::applyFlowBlocks() {
+    // Échec : liste vidée, applyFlowTip() ne doit pas reprendre un ancien tip
+    recentCount = flowOk ? flowBlockCount : 0;
+    memcpy(recentBlocks, flowBlocks, sizeof(BlockInfo) * recentCount);
+}
+
+void BitcoinAPI::onProjectedBlock(JsonVariantConst element, int index, void* ctx) {
+    BitcoinAPI* self = (BitcoinAPI*)ctx;
+    if (index >= PROJECTED_BLOCKS_COUNT) {
+        return;
+    }
+    BlockDecoder::decodeProjectedBlock(element, self->flowProjected[index]);
+    self->flowProjectedCount = index + 1;
+}
+
+bool BitcoinAPI::fetchProjectedBlocks() {
+    // Rien n'arrive sur un 304 : flowProjectedCount reste à 0 et la liste affichée est gardée
+    flowProjectedCount = 0;
+    int httpCode = ExternalHttp::getInstance()->getJsonArray(MEMPOOL_API "/v1/fees/mempool-blocks", &BlockDecoder::projectedFilter(),
+                                                             onProjectedBlock, this, EXT_HTTP_TIMEOUT_MS, flowHave);
+    if (httpCode != HTTP_CODE_OK && !ExternalHttp::unchanged(httpCode)) {
+        Serial.printf("[BitcoinAPI] Mempool blocks HTTP error: %d\n", httpCode);
+        return false;
+    }
+    return true;
+}
+
+void BitcoinAPI::applyFlowProjected() {
+    if (flowOk && flowProjectedCount > 0) {
+        memcpy(projectedBlocks, flowProjected, sizeof(ProjectedBlock) * flowProjectedCount);
+        projectedCount = flowProjectedCount;
+    }
+}
+
+bool BitcoinAPI::fetchFees() {
+    JsonDocument feeDoc;
+    int httpCode = ExternalHttp::getInstance()->getJson(MEMPOOL_API "/v1/fees/recommended", feeDoc, nullptr,
+                                                        EXT_HTTP_TIMEOUT_MS, flowHave);
+    flowFeesUnchanged = ExternalHttp::unchanged(httpCode);
+    if (flowFeesUnchanged) {
+        return true;
+    }
+    if (httpCode != HTTP_CODE_OK) {
+        Serial.printf("[BitcoinAPI] Fees HTTP error: %d\n", httpCode);
+        return false;
+    }
+
+    // Use mempool fee estimates for min/max
+    if (feeDoc.containsKey("minimumFee")) {
+        flowMinFee = feeDoc["minimumFee"].as<float>();
     } else {
-        Serial.printf("[BitcoinAPI] HTTP error: %d\n", httpCode);
+        flowMinFee = feeDoc["hourFee"].as<float>() * 0.5; // Fallback
     }
-    
-    http.end();
-    priceValid = false;
-    return false;
-}
-
-bool BitcoinAPI::fetchBlockData() {
-    HTTPClient http;
-    
-    // Mempool.space API - Free tier, no rate limits mentioned
-    // Get latest block info and fee estimates
-    const char* url = "https://mempool.space/api/v1/blocks";
-    
-    Serial.println("[BitcoinAPI] Fetching block data...");
-    
-    http.begin(url);
-    http.setTimeout(10000); // 10 second timeout
-    
-    int httpCode = http.GET();
-    
-    if (httpCode == HTTP_CODE_OK) {
-        String payload = http.getString();
-        
-        // Parse JSON response (array of recent blocks)
-        JsonDocument doc;
-        DeserializationError error = deserializeJson(doc, payload);
-        
-        if (!error && doc.is<JsonArray>() && doc.size() > 0) {
-            // Get the latest block (first in array)
-            JsonObject latestBlock = doc[0];
-            
-            if (latestBlock.containsKey("height") && latestBlock.containsKey("timestamp") && latestBlock.containsKey("id")) {
-                blockHeight = latestBlock["height"].as<uint32_t>();
-                uint32_t blockTimestamp = latestBlock["timestamp"].as<uint32_t>();
-                String blockHash = latestBlock["id"].as<String>();
-                
-                // Calculate block age in minutes
-                uint32_t currentTime = time(nullptr); // Unix timestamp
-                if (currentTime > blockTimestamp) {
-                    blockAgeMinutes = (currentTime - blockTimestamp) / 60;
-                } else {
-                    blockAgeMinutes = 0;
-                }
-                
-                // Now get detailed block info
-                http.end();
-                http.begin("https://mempool.space/api/v1/block/" + blockHash);
-                
-                int blockHttpCode = http.GET();
-                if (blockHttpCode == HTTP_CODE_OK) {
-                    String blockPayload = http.getString();
-                    JsonDocument blockDoc;
-                    DeserializationError blockError = deserializeJson(blockDoc, blockPayload);
-                    
-                    if (!blockError) {
-                        // Extract fee information - try fee_range first, then estimates
-                        bool feeDataFound = false;
-                        
-                        if (blockDoc.containsKey("fee_range")) {
-                            JsonArray feeRange = blockDoc["fee_range"];
-                            if (feeRange.size() >= 2) {
-                                minFee = feeRange[0].as<float>();
-                                maxFee = feeRange[feeRange.size() - 1].as<float>();
-                                if (minFee > 0 || maxFee > 0) {
-                                    feeDataFound = true;
-                                }
-                            }
-                        }
-                        
-                        // Extract fee information from mempool fee estimates
-                        http.end();
-                        http.begin("https://mempool.space/api/v1/fees/recommended");
-
-                        int feeHttpCode = http.GET();
-                        if (feeHttpCode == HTTP_CODE_OK) {
-                            String feePayload = http.getString();
-                            JsonDocument feeDoc;
-                            DeserializationError feeError = deserializeJson(feeDoc, feePayload);
-
-                            if (!feeError) {
-                                // Use mempool fee estimates for min/max
-                                if (feeDoc.containsKey("minimumFee")) {
-                                    minFee = feeDoc["minimumFee"].as<float>();
-                                } else {
-                                    minFee = feeDoc["hourFee"].as<float>() * 0.5; // Fallback
-                                }
-
-                                if (feeDoc.containsKey("fastestFee")) {
-                                    maxFee = feeDoc["fastestFee"].as<float>();
-                                } else {
-                                    maxFee = feeDoc["halfHourFee"].as<float>() * 2.0; // Fallback
-                                }
-
-                                feeDataFound = true;
-                            }
-                        }
-                        http.end();
-                        http.begin("https://mempool.space/api/v1/block/" + blockHash); // Reconnect for pool data
-                        http.GET(); // Re-fetch block data
-                        deserializeJson(blockDoc, http.getString());
-                        
-                        // Extract average fee
-                        if (blockDoc.containsKey("extras") && blockDoc["extras"].containsKey("avgFeeRate")) {
-                            avgFee = blockDoc["extras"]["avgFeeRate"].as<float>();
-                        }
-                        
-                        // Extract pool name
-                        if (blockDoc.containsKey("extras") && blockDoc["extras"].containsKey("pool") && 
-                            blockDoc["extras"]["pool"].containsKey("name")) {
-                            poolName = blockDoc["extras"]["pool"]["name"].as<String>();
-                        } else {
-                            poolName = "Unknown";
-                        }
-                        
-                        blockDataValid = true;
-                        Serial.printf("[BitcoinAPI] Block data updated: height=%u, age=%u min, fees=%.1f-%.1f sat/vB, pool=%s\n", 
-                                    blockHeight, blockAgeMinutes, minFee, maxFee, poolName.c_str());
-                        http.end();
-                        return true;
-                    }
-                }
-                
-                // If detailed block fetch failed, try fee estimates
-                http.end();
-                http.begin("https://mempool.space/api/v1/fees/recommended");
-                
-                int feeHttpCode = http.GET();
-                if (feeHttpCode == HTTP_CODE_OK) {
-                    String feePayload = http.getString();
-                    JsonDocument feeDoc;
-                    DeserializationError feeError = deserializeJson(feeDoc, feePayload);
-                    
-                    if (!feeError && feeDoc.containsKey("halfHourFee")) {
-                        avgFee = feeDoc["halfHourFee"].as<float>();
-                        minFee = avgFee * 0.5; // Estimate min fee
-                        maxFee = avgFee * 2.0; // Estimate max fee
-                        poolName = "Unknown";
-                        blockDataValid = true;
-                        
-                        Serial.printf("[BitcoinAPI] Block data updated (basic): height=%u, age=%u min, avgFee=%.1f sat/vB\n", 
-                                    blockHeight, blockAgeMinutes, avgFee);
-                        http.end();
-                        return true;
-                    }
-                }
-            } else {
-                Serial.println("[BitcoinAPI] Invalid block JSON structure");
-            }
-        } else {
-            Serial.printf("[BitcoinAPI] JSON parse error or empty array: %s\n", error.c_str());
+    if (feeDoc.containsKey("fastestFee")) {
+        flowMaxFee = feeDoc["fastestFee"].as<float>();
+    } else {
+        flowMaxFee = feeDoc["halfHourFee"].as<float>() * 2.0; // Fallback
+    }
+    flowAvgFee = feeDoc["halfHourFee"] | 0.0f;
+    return true;
+}
+
+void BitcoinAPI::applyFlowFees() {
+    if (!flowOk) {
+        return;
+    }
+    if (!flowFeesUnchanged) {
+        minFee = flowMinFee;
+        maxFee = flowMaxFee;
+        // Pas d'extras pour le bloc : la fee moyenne vient des estimations
+        if (avgFee <= 0 && flowAvgFee > 0) {
+            avgFee = flowAvgFee;
+        }
+        feesValid = true;
+    }
+    lastFeesFetch = millis();
+}
+
+const BlockInfo* BitcoinAPI::findBlock(const char* hash) const {
+    for (int i = 0; i < recentCount; i++) {
+        if (strcmp(recentBlocks[i].hash, hash) == 0) {
+            return &recentBlocks[i];
         }
+    }
+    return nullptr;
+}
+
+void BitcoinAPI::setTip(const BlockInfo& block) {
+    blockTimestamp = block.timestamp;
+    avgFee = block.avgFee;
+    poolName = block.poolName[0] != '\0' ? block.poolName : "Unknown";
+}
+
+void BitcoinAPI::refreshBlockAge() {
+    uint32_t currentTime = time(nullptr); // Unix timestamp
+    if (currentTime > blockTimestamp) {
+        blockAgeMinutes = (currentTime - blockTimestamp) / 60;
     } else {
-        Serial.printf("[BitcoinAPI] HTTP error: %d\n", httpCode);
+        blockAgeMinutes = 0;
     }
-    
-    http.end();
-    blockDataValid = false;
-    return false;
+}
+
+void BitcoinAPI::applyPrice(float value) {
+    if (value <= 0) {
+        return;
+    }
+    price = value;
+    priceValid = true;
+    lastPriceAt = millis();
+    priceSource = "Coinbase (push)";
+}
+
+void BitcoinAPI::applyBlock(const BlockInfo& block) {
+    if (block.height == 0 || (blockDataValid && block.height < blockHeight) || findBlock(block.hash) != nullptr) {
+        return;  // Déjà connu (réémis à la reconnexion) ou plus ancien que le tip
+    }
+
+    // Nouveau tip en tête de la liste des derniers blocs
+    int count = min(recentCount + 1, RECENT_BLOCKS_COUNT);
+    memmove(&recentBlocks[1], &recentBlocks[0], sizeof(BlockInfo) * (count - 1));
+    recentBlocks[0] = block;
+    recentCount = count;
+
+    blockHeight = block.height;
+    setTip(block);
+    refreshBlockAge();
+    blockDataValid = true;
+    Serial.printf("[BitcoinAPI] Block pushed: height=%u, pool=%s\n", blockHeight, poolName.c_str());
+}
+
+void BitcoinAPI::applyFees(float minimum, float fastest) {
+    if (fastest <= 0) {
+        return;
+    }
+    minFee = minimum;
+    maxFee = fastest;
+    feesValid = true;
+    lastFeesFetch = millis();
+}
+
+void BitcoinAPI::applyProjectedBlocks(const ProjectedBlock* blocks, int count) {
+    count = min(count, PROJECTED_BLOCKS_COUNT);
+    memcpy(projectedBlocks, blocks, sizeof(ProjectedBlock) * count);
+    projectedCount = count;
 }
@@ -0,0 +1,57 @@
+#include "block_decoder.h"
+
+// Champs gardés pour chaque élément de /v1/blocks (le bloc complet fait ~2 Ko)
+static JsonDocument buildBlockFilter() {
+    JsonDocument filter;
+    filter["id"] = true;
+    filter["height"] = true;
+    filter["timestamp"] = true;
+    filter["tx_count"] = true;
+    filter["extras"]["avgFeeRate"] = true;
+    filter["extras"]["feeRange"] = true;
+    filter["extras"]["pool"]["name"] = true;
+    return filter;
+}
+static JsonDocument blockFields = buildBlockFilter();
+
+static JsonDocument buildProjectedFilter() {
+    JsonDocument filter;
+    filter["blockVSize"] = true;
+    filter["nTx"] = true;
+    filter["medianFee"] = true;
+    filter["feeRange"] = true;
+    return filter;
+}
+static JsonDocument projectedFields = buildProjectedFilter();
+
+const JsonDocument& BlockDecoder::blockFilter() {
+    return blockFields;
+}
+
+const JsonDocument& BlockDecoder::projectedFilter() {
+    return projectedFields;
+}
+
+// Bornes d'un feeRange (percentiles croissants)
+static void readFeeRange(JsonArrayConst range, float& feeMin, float& feeMax) {
+    feeMin = range.size() > 0 ? range[0].as<float>() : 0.0f;
+    feeMax = range.size() > 0 ? range[range.size() - 1].as<float>() : 0.0f;
+}
+
+void BlockDecoder::decodeBlock(JsonVariantConst element, BlockInfo& block) {
+    memset(&block, 0, sizeof(block));
+    strlcpy(block.hash, element["id"] | "", sizeof(block.hash));
+    block.height = element["height"] | 0;
+    block.timestamp = element["timestamp"] | 0;
+    block.txCount = element["tx_count"] | 0;
+    block.avgFee = element["extras"]["avgFeeRate"] | 0.0f;
+    readFeeRange(element["extras"]["feeRange"], block.feeMin, block.feeMax);
+    strlcpy(block.poolName, element["extras"]["pool"]["name"] | "", sizeof(block.poolName));
+}
+
+void BlockDecoder::decodeProjectedBlock(JsonVariantConst element, ProjectedBlock& block) {
+    block.medianFee = element["medianFee"] | 0.0f;
+    block.txCount = element["nTx"] | 0;
+    block.vsize = (uint32_t)(element["blockVSize"] | 0.0f);  // Fractionnaire (poids / 4)
+    readFeeRange(element["feeRange"], block.feeMin, block.feeMax);
+}
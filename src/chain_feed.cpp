@@ -0,0 +1,343 @@
+#include "chain_feed.h"
+#include "wifi_manager.h"
+#include "socket_budget.h"
+#include <ArduinoJson.h>
+
+ChainFeed* ChainFeed::instance = nullptr;
+
+// Clés de premier niveau capturées dans les messages de mempool.space
+enum ChainFeedKey {
+    FEED_KEY_BLOCK = 0,
+    FEED_KEY_MEMPOOL_BLOCKS,
+    FEED_KEY_FEES,
+    FEED_KEY_COUNT
+};
+static const char* const feedKeys[FEED_KEY_COUNT] = { "block", "mempool-blocks", "fees" };
+
+// "mempool-blocks" est un tableau : même filtre que /v1/fees/mempool-blocks pour chaque élément
+static JsonDocument buildProjectedArrayFilter() {
+    JsonDocument filter;
+    filter[0] = BlockDecoder::projectedFilter();
+    return filter;
+}
+
+static void initLink(FeedLink& link, const char* name, const char* host, uint16_t port, const char* path, const char* subscribe) {
+    link.name = name;
+    link.host = host;
+    link.port = port;
+    link.path = path;
+    link.subscribe = subscribe;
+    link.open = false;
+    link.live = false;
+    link.connectedAt = 0;
+    link.lastMessageAt = 0;
+    link.retryAt = 0;
+    link.retryDelayMs = CHAIN_FEED_RETRY_MIN_MS;
+    link.messages = 0;
+    link.reconnects = 0;
+}
+
+ChainFeed::ChainFeed() : scanner(feedKeys, FEED_KEY_COUNT, capture, sizeof(capture)) {
+    mutex = xSemaphoreCreateMutex();
+    task = nullptr;
+    enabled = false;
+    initLink(chain, "mempool", CHAIN_FEED_MEMPOOL_HOST, CHAIN_FEED_MEMPOOL_PORT, CHAIN_FEED_MEMPOOL_PATH, CHAIN_FEED_MEMPOOL_WANT);
+    initLink(ticker, "ticker", CHAIN_FEED_TICKER_HOST, CHAIN_FEED_TICKER_PORT, CHAIN_FEED_TICKER_PATH, CHAIN_FEED_TICKER_SUBSCRIBE);
+    pendingPrice = false;
+    price = 0;
+    pendingBlock = false;
+    memset(&block, 0, sizeof(block));
+    pendingFees = false;
+    minFee = 0;
+    maxFee = 0;
+    pendingProjected = false;
+    projectedCount = 0;
+    resyncBlocks = false;
+    blocks = 0;
+    dropped = 0;
+}
+
+ChainFeed* ChainFeed::getInstance() {
+    if (!instance) {
+        instance = new ChainFeed();
+    }
+    return instance;
+}
+
+void ChainFeed::begin() {
+    if (task != nullptr) {
+        return;  // Déjà démarré
+    }
+    prefs.begin("chainfeed", true);
+    enabled = prefs.getBool("enabled", false);
+    prefs.end();
+    SocketBudget::getInstance()->setReserve(SOCKET_CHAIN_FEED, enabled ? CHAIN_FEED_SOCKETS : 0);
+
+    xTaskCreatePinnedToCore(taskEntry, "chain_feed", CHAIN_FEED_TASK_STACK, this, 1, &task, CHAIN_FEED_TASK_CORE);
+    Serial.printf("[ChainFeed] Push feeds %s\n", enabled ? "enabled" : "disabled");
+}
+
+void ChainFeed::setEnabled(bool on) {
+    enabled = on;
+    prefs.begin("chainfeed", false);
+    prefs.putBool("enabled", on);
+    prefs.end();
+    // Flux coupé : ses sockets retournent au reste partagé
+    SocketBudget::getInstance()->setReserve(SOCKET_CHAIN_FEED, on ? CHAIN_FEED_SOCKETS : 0);
+    chain.retryAt = millis();
+    ticker.retryAt = millis();
+    Serial.printf("[ChainFeed] Push feeds %s\n", on ? "enabled" : "disabled");
+}
+
+void ChainFeed::taskEntry(void* arg) {
+    ChainFeed* self = (ChainFeed*)arg;
+    for (;;) {
+        if (!self->enabled || !WifiManager::getInstance()->isConnected()) {
+            self->dropLink(self->chain, "feed off");
+            self->dropLink(self->ticker, "feed off");
+            vTaskDelay(pdMS_TO_TICKS(1000));
+            continue;
+        }
+        self->service(self->chain, millis());
+        self->service(self->ticker, millis());
+        vTaskDelay(pdMS_TO_TICKS(CHAIN_FEED_TICK_MS));
+    }
+}
+
+void ChainFeed::service(FeedLink& link, uint32_t now) {
+    if (!link.open) {
+        if ((int32_t)(now - link.retryAt) >= 0) {
+            connectLink(link);
+        }
+        return;
+    }
+
+    bool ok = (&link == &chain) ? link.ws.pollStream(onChainFragment, this)
+                                : link.ws.poll(onTickerMessage, this);
+    if (!ok) {
+        dropLink(link, "closed");
+    } else if (millis() - link.lastMessageAt > CHAIN_FEED_SILENT_MS) {
+        dropLink(link, "silent");
+    }
+}
+
+void ChainFeed::connectLink(FeedLink& link) {
+    uint32_t start = millis();
+    SocketBudget* budget = SocketBudget::getInstance();
+    if (!budget->acquire(SOCKET_CHAIN_FEED)) {
+        link.retryAt = millis() + CHAIN_FEED_RETRY_MIN_MS;
+        return;  // Réserve rendue pendant l'arrêt du flux : on réessaie plus tard
+    }
+    if (!link.ws.connect(link.host, link.port, link.path, CHAIN_FEED_CONNECT_MS, CHAIN_FEED_TLS) || !link.ws.sendText(link.subscribe)) {
+        link.ws.close();
+        budget->release(SOCKET_CHAIN_FEED);
+        link.retryAt = millis() + link.retryDelayMs;
+        Serial.printf("[ChainFeed] %s: connection failed, polling (retry in %lu s)\n", link.name, link.retryDelayMs / 1000);
+        link.retryDelayMs = min((uint32_t)CHAIN_FEED_RETRY_MAX_MS, link.retryDelayMs * 2);
+        return;
+    }
+
+    if (&link == &chain) {
+        scanner.reset();
+    }
+    link.open = true;
+    link.connectedAt = millis();
+    link.lastMessageAt = millis();
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    link.reconnects++;
+    xSemaphoreGive(mutex);
+    Serial.printf("[ChainFeed] %s: subscribed in %lu ms\n", link.name, millis() - start);
+}
+
+void ChainFeed::dropLink(FeedLink& link, const char* reason) {
+    if (!link.open) {
+        return;
+    }
+    Serial.printf("[ChainFeed] %s: %s after %lu s, back to polling\n", link.name, reason, (millis() - link.connectedAt) / 1000);
+    link.ws.close();
+    SocketBudget::getInstance()->release(SOCKET_CHAIN_FEED);
+    link.open = false;
+    setLive(link, false);
+    if (strcmp(reason, "feed off") != 0) {
+        link.retryAt = millis() + link.retryDelayMs;
+        link.retryDelayMs = min((uint32_t)CHAIN_FEED_RETRY_MAX_MS, link.retryDelayMs * 2);
+    }
+}
+
+void ChainFeed::setLive(FeedLink& link, bool live) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    link.live = live;
+    xSemaphoreGive(mutex);
+}
+
+void ChainFeed::onChainFragment(void* ctx, const uint8_t* data, size_t len, bool start, bool end) {
+    ChainFeed* self = (ChainFeed*)ctx;
+    if (start) {
+        self->scanner.reset();
+    }
+    for (size_t i = 0; i < len; i++) {
+        int target = self->scanner.feed((char)data[i]);
+        if (target >= 0) {
+            self->handleCapture(target);
+        }
+    }
+    if (!end) {
+        return;
+    }
+
+    FeedLink& link = self->chain;
+    link.lastMessageAt = millis();
+    xSemaphoreTake(self->mutex, portMAX_DELAY);
+    link.messages++;
+    link.live = true;
+    xSemaphoreGive(self->mutex);
+    link.retryDelayMs = CHAIN_FEED_RETRY_MIN_MS;  // Le flux répond : la prochaine coupure repart du délai court
+}
+
+void ChainFeed::handleCapture(int target) {
+    if (scanner.overflowed()) {
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        dropped++;
+        if (target == FEED_KEY_BLOCK) {
+            resyncBlocks = true;
+        }
+        xSemaphoreGive(mutex);
+        Serial.printf("[ChainFeed] \"%s\" larger than %d bytes, skipped\n", feedKeys[target], CHAIN_FEED_CAPTURE_MAX);
+        return;
+    }
+
+    JsonDocument doc;
+    DeserializationError error;
+    if (target == FEED_KEY_BLOCK) {
+        error = deserializeJson(doc, capture, scanner.valueLen(), DeserializationOption::Filter(BlockDecoder::blockFilter()));
+    } else if (target == FEED_KEY_MEMPOOL_BLOCKS) {
+        static JsonDocument projectedArrayFilter = buildProjectedArrayFilter();
+        error = deserializeJson(doc, capture, scanner.valueLen(), DeserializationOption::Filter(projectedArrayFilter));
+    } else {
+        error = deserializeJson(doc, capture, scanner.valueLen());
+    }
+    if (error) {
+        Serial.printf("[ChainFeed] \"%s\" parse error: %s\n", feedKeys[target], error.c_str());
+        return;
+    }
+
+    if (target == FEED_KEY_BLOCK) {
+        BlockInfo decoded;
+        BlockDecoder::decodeBlock(doc.as<JsonVariantConst>(), decoded);
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        block = decoded;
+        pendingBlock = true;
+        blocks++;
+        xSemaphoreGive(mutex);
+        Serial.printf("[ChainFeed] New block %u pushed\n", decoded.height);
+    } else if (target == FEED_KEY_MEMPOOL_BLOCKS) {
+        ProjectedBlock decoded[PROJECTED_BLOCKS_COUNT];
+        int count = 0;
+        for (JsonVariantConst element : doc.as<JsonArrayConst>()) {
+            if (count == PROJECTED_BLOCKS_COUNT) break;
+            BlockDecoder::decodeProjectedBlock(element, decoded[count++]);
+        }
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        memcpy(projected, decoded, sizeof(ProjectedBlock) * count);
+        projectedCount = count;
+        pendingProjected = count > 0;
+        xSemaphoreGive(mutex);
+    } else {
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        minFee = doc["minimumFee"] | 0.0f;
+        maxFee = doc["fastestFee"] | 0.0f;
+        pendingFees = true;
+        xSemaphoreGive(mutex);
+    }
+}
+
+// Message ticker_batch : {"type":"ticker","sequence":...,"product_id":"BTC-USD","price":"67012.34",...}
+// Le prix arrive dans les premiers octets : la troncature à WS_MAX_MESSAGE ne le coupe pas.
+void ChainFeed::onTickerMessage(void* ctx, const char* data, size_t len) {
+    ChainFeed* self = (ChainFeed*)ctx;
+    FeedLink& link = self->ticker;
+    link.lastMessageAt = millis();
+
+    if (strstr(data, "\"type\":\"error\"") != nullptr) {
+        Serial.printf("[ChainFeed] ticker: %.120s\n", data);
+        return;
+    }
+
+    float value = 0;
+    const char* field = strstr(data, "\"price\":\"");
+    if (strstr(data, "\"type\":\"ticker\"") != nullptr && field != nullptr) {
+        value = strtof(field + 9, nullptr);
+    }
+
+    xSemaphoreTake(self->mutex, portMAX_DELAY);
+    link.messages++;
+    link.live = true;
+    if (value > 0) {
+        self->price = value;
+        self->pendingPrice = true;
+    }
+    xSemaphoreGive(self->mutex);
+    link.retryDelayMs = CHAIN_FEED_RETRY_MIN_MS;
+}
+
+bool ChainFeed::isChainLive() {
+    if (!enabled || xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return false;
+    }
+    bool live = chain.live;
+    xSemaphoreGive(mutex);
+    return live;
+}
+
+bool ChainFeed::isPriceLive() {
+    if (!enabled || xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return false;
+    }
+    bool live = ticker.live;
+    xSemaphoreGive(mutex);
+    return live;
+}
+
+bool ChainFeed::applyTo(BitcoinAPI& api, bool& resync) {
+    resync = false;
+    if (!enabled || xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return false;
+    }
+    bool hasPrice = pendingPrice;
+    float newPrice = price;
+    bool hasBlock = pendingBlock;
+    BlockInfo newBlock = block;
+    bool hasFees = pendingFees;
+    float newMinFee = minFee;
+    float newMaxFee = maxFee;
+    bool hasProjected = pendingProjected;
+    ProjectedBlock newProjected[PROJECTED_BLOCKS_COUNT];
+    int newProjectedCount = projectedCount;
+    memcpy(newProjected, projected, sizeof(ProjectedBlock) * projectedCount);
+    resync = resyncBlocks;
+    pendingPrice = pendingBlock = pendingFees = pendingProjected = resyncBlocks = false;
+    xSemaphoreGive(mutex);
+
+    // BitcoinAPI n'est modifié que depuis loop() : rien à verrouiller de ce côté
+    if (hasPrice) api.applyPrice(newPrice);
+    if (hasBlock) api.applyBlock(newBlock);
+    if (hasFees) api.applyFees(newMinFee, newMaxFee);
+    if (hasProjected) api.applyProjectedBlocks(newProjected, newProjectedCount);
+    return hasPrice || hasBlock || hasFees || hasProjected;
+}
+
+bool ChainFeed::getStatus(ChainFeedStatus& out) {
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return false;
+    }
+    out.enabled = enabled;
+    out.chainLive = chain.live;
+    out.priceLive = ticker.live;
+    out.chainMessages = chain.messages;
+    out.priceMessages = ticker.messages;
+    out.blocks = blocks;
+    out.dropped = dropped;
+    out.reconnects = chain.reconnects + ticker.reconnects;
+    xSemaphoreGive(mutex);
+    return true;
+}
@@ -0,0 +1,119 @@
+#include "chunked_stream.h"
+
+ChunkedStream::ChunkedStream(Stream& source, size_t limit) : source(source), limit(limit) {
+    remaining = 0;
+    total = 0;
+    started = false;
+    done = false;
+    error = false;
+    overflow = false;
+    // Attente des données du body (timedRead) : même délai que le socket
+    setTimeout(source.getTimeout());
+}
+
+// Une ligne terminée par CRLF, sans le CRLF. Les caractères au-delà de la
+// capacité (extensions de chunk) sont lus et ignorés.
+bool ChunkedStream::readLine(char* line, size_t capacity) {
+    size_t len = 0;
+    for (;;) {
+        char c;
+        if (source.readBytes(&c, 1) != 1) {
+            return false;  // Timeout ou connexion fermée
+        }
+        if (c == '\n') break;
+        if (c != '\r' && len < capacity - 1) {
+            line[len++] = c;
+        }
+    }
+    line[len] = '\0';
+    return true;
+}
+
+bool ChunkedStream::nextChunk() {
+    char line[CHUNKED_LINE_LEN];
+    // Les données d'un chunk sont suivies d'un CRLF seul
+    if (started && (!readLine(line, sizeof(line)) || line[0] != '\0')) {
+        error = true;
+        return false;
+    }
+    if (!readLine(line, sizeof(line)) || !isxdigit((unsigned char)line[0])) {
+        error = true;
+        return false;
+    }
+    char* end;
+    unsigned long size = strtoul(line, &end, 16);
+    if (*end != '\0' && *end != ';' && *end != ' ' && *end != '\t') {
+        error = true;
+        return false;
+    }
+    started = true;
+
+    if (size == 0) {
+        // Chunk final : trailer éventuel jusqu'à la ligne vide
+        do {
+            if (!readLine(line, sizeof(line))) {
+                error = true;
+                return false;
+            }
+        } while (line[0] != '\0');
+        done = true;
+        return false;
+    }
+    remaining = size;
+    return true;
+}
+
+int ChunkedStream::available() {
+    // Seulement le chunk courant : l'en-tête suivant n'est pas encore lu
+    if (done || error || overflow || remaining == 0) {
+        return 0;
+    }
+    int ready = source.available();
+    return ready < 0 ? 0 : (int)min((size_t)ready, remaining);
+}
+
+int ChunkedStream::read() {
+    if (done || error || overflow) {
+        return -1;
+    }
+    if (remaining == 0 && !nextChunk()) {
+        return -1;
+    }
+    if (limit > 0 && total >= limit) {
+        overflow = true;
+        return -1;
+    }
+    int c = source.read();
+    if (c >= 0) {
+        remaining--;
+        total++;
+    }
+    return c;
+}
+
+int ChunkedStream::peek() {
+    if (done || error || overflow) {
+        return -1;
+    }
+    if (remaining == 0 && !nextChunk()) {
+        return -1;
+    }
+    return source.peek();
+}
+
+bool ChunkedStream::drain() {
+    char skip[64];
+    while (!done && !error) {
+        if (remaining == 0) {
+            nextChunk();
+            continue;
+        }
+        size_t count = source.readBytes(skip, min(remaining, sizeof(skip)));
+        if (count == 0) {
+            error = true;
+            break;
+        }
+        remaining -= count;
+    }
+    return done;
+}
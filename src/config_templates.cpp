@@ -0,0 +1,184 @@
+#include "config_templates.h"
+
+ConfigTemplates* ConfigTemplates::instance = nullptr;
+
+// Clés de config AxeOS qu'un modèle peut fixer
+static const char* const TEMPLATE_KEYS[] = {
+    "frequency", "coreVoltage",
+    "stratumURL", "stratumPort", "stratumUser", "stratumPassword",
+    "fallbackStratumURL", "fallbackStratumPort", "fallbackStratumUser",
+    "autofanspeed", "fanspeed", "temptarget"
+};
+static const int TEMPLATE_KEY_COUNT = sizeof(TEMPLATE_KEYS) / sizeof(TEMPLATE_KEYS[0]);
+
+// Le mineur ne renvoie jamais le mot de passe : il n'est envoyé qu'avec un
+// autre champ de pool modifié, sinon chaque application forcerait un redémarrage
+static const char* const WRITE_ONLY_KEY = "stratumPassword";
+
+static JsonDocument buildConfigFilter() {
+    JsonDocument filter;
+    for (int i = 0; i < TEMPLATE_KEY_COUNT; i++) {
+        filter[TEMPLATE_KEYS[i]] = true;
+    }
+    return filter;
+}
+
+// Construit une fois : le coalesceur distingue les requêtes par adresse de filtre
+static JsonDocument templateFilter = buildConfigFilter();
+
+ConfigTemplates::ConfigTemplates() {
+    loaded = false;
+}
+
+ConfigTemplates* ConfigTemplates::getInstance() {
+    if (!instance) {
+        instance = new ConfigTemplates();
+    }
+    return instance;
+}
+
+void ConfigTemplates::load() {
+    if (loaded) {
+        return;
+    }
+    loaded = true;
+
+    prefs.begin("templates", true);
+    String json = prefs.getString("all", "{}");
+    prefs.end();
+
+    DeserializationError error = deserializeJson(templates, json);
+    if (error || !templates.is<JsonObject>()) {
+        Serial.printf("[Templates] Stored templates unreadable (%s), starting empty\n", error.c_str());
+        templates.clear();
+        templates.to<JsonObject>();
+    }
+    Serial.printf("[Templates] %u template(s) loaded\n", (unsigned)templates.size());
+}
+
+bool ConfigTemplates::persist() {
+    String json;
+    serializeJson(templates, json);
+    prefs.begin("templates", false);
+    size_t written = prefs.putString("all", json);
+    prefs.end();
+    return written == json.length();
+}
+
+const JsonDocument& ConfigTemplates::configFilter() {
+    return templateFilter;
+}
+
+bool ConfigTemplates::isTemplateKey(const char* key) {
+    for (int i = 0; i < TEMPLATE_KEY_COUNT; i++) {
+        if (strcmp(key, TEMPLATE_KEYS[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ConfigTemplates::save(const char* name, JsonVariantConst config, String& error) {
+    load();
+
+    if (name == nullptr || name[0] == '\0' || strlen(name) >= CONFIG_TEMPLATE_NAME_LEN) {
+        error = "Template name must be 1-" + String(CONFIG_TEMPLATE_NAME_LEN - 1) + " characters";
+        return false;
+    }
+    if (!config.is<JsonObjectConst>()) {
+        error = "Config must be an object";
+        return false;
+    }
+    if (!templates[name].is<JsonObject>() && templates.size() >= CONFIG_TEMPLATE_MAX) {
+        error = "Too many templates";
+        return false;
+    }
+
+    // Champs retenus d'abord dans un brouillon : une mise à jour invalide ne
+    // touche pas au template existant
+    JsonDocument scratch;
+    JsonObject stored = scratch.to<JsonObject>();
+    for (JsonPairConst field : config.as<JsonObjectConst>()) {
+        const char* key = field.key().c_str();
+        if (!isTemplateKey(key)) {
+            Serial.printf("[Templates] Ignoring unknown key '%s' in template %s\n", key, name);
+            continue;
+        }
+        if (!field.value().is<const char*>() && !field.value().is<float>() && !field.value().is<bool>()) {
+            continue;
+        }
+        stored[key] = field.value();
+    }
+
+    if (stored.size() == 0) {
+        error = "No known config field";
+        return false;
+    }
+    templates[name] = stored;
+    if (!persist()) {
+        error = "NVS write failed";
+        return false;
+    }
+    Serial.printf("[Templates] Saved %s (%u field(s))\n", name, (unsigned)stored.size());
+    return true;
+}
+
+bool ConfigTemplates::remove(const char* name) {
+    load();
+    if (name == nullptr || !templates[name].is<JsonObject>()) {
+        return false;
+    }
+    templates.remove(name);
+    persist();
+    Serial.printf("[Templates] Removed %s\n", name);
+    return true;
+}
+
+bool ConfigTemplates::get(const char* name, JsonDocument& out) {
+    load();
+    if (name == nullptr || !templates[name].is<JsonObject>()) {
+        return false;
+    }
+    out.set(templates[name]);
+    return true;
+}
+
+void ConfigTemplates::list(JsonDocument& out) {
+    load();
+    out.set(templates);
+}
+
+// Égalité tolérante aux représentations : 525 == 525.0, true == 1
+static bool sameValue(JsonVariantConst wanted, JsonVariantConst current) {
+    if (current.isNull()) {
+        return false;
+    }
+    if (wanted.is<const char*>()) {
+        return current.is<const char*>() && strcmp(wanted.as<const char*>(), current.as<const char*>()) == 0;
+    }
+    float a = wanted.is<bool>() ? (wanted.as<bool>() ? 1.0f : 0.0f) : wanted.as<float>();
+    float b = current.is<bool>() ? (current.as<bool>() ? 1.0f : 0.0f) : current.as<float>();
+    return fabsf(a - b) < 0.001f;
+}
+
+int ConfigTemplates::diff(JsonVariantConst tpl, JsonVariantConst current, JsonDocument& out) {
+    out.clear();
+    JsonObject changes = out.to<JsonObject>();
+    bool poolChanged = false;
+
+    for (JsonPairConst field : tpl.as<JsonObjectConst>()) {
+        const char* key = field.key().c_str();
+        if (strcmp(key, WRITE_ONLY_KEY) == 0) continue;
+        if (sameValue(field.value(), current[key])) continue;
+        changes[key] = field.value();
+        if (strncmp(key, "stratum", 7) == 0) {
+            poolChanged = true;
+        }
+    }
+
+    JsonVariantConst password = tpl[WRITE_ONLY_KEY];
+    if (poolChanged && !password.isNull()) {
+        changes[WRITE_ONLY_KEY] = password;
+    }
+    return changes.size();
+}
@@ -0,0 +1,526 @@
+#include "external_http.h"
+#include <WiFi.h>
+#include "chunked_stream.h"
+#include "socket_budget.h"
+
+ExternalHttp* ExternalHttp::instance = nullptr;
+
+// "https://host[:port]/path" -> secure, host, port
+static bool parseUrl(const String& url, bool& secure, char* host, uint16_t& port) {
+    int start;
+    if (url.startsWith("https://")) {
+        secure = true;
+        port = 443;
+        start = 8;
+    } else if (url.startsWith("http://")) {
+        secure = false;
+        port = 80;
+        start = 7;
+    } else {
+        return false;
+    }
+
+    int end = url.indexOf('/', start);
+    if (end < 0) end = url.length();
+    int colon = url.indexOf(':', start);
+    int hostEnd = (colon >= 0 && colon < end) ? colon : end;
+    if (hostEnd == start || hostEnd - start >= EXT_HTTP_HOST_LEN) {
+        return false;
+    }
+    memcpy(host, url.c_str() + start, hostEnd - start);
+    host[hostEnd - start] = '\0';
+    if (hostEnd == colon) {
+        port = (uint16_t)atoi(url.c_str() + colon + 1);
+    }
+    return port != 0;
+}
+
+ExternalHttp::ExternalHttp() {
+    mutex = xSemaphoreCreateMutex();
+    for (int i = 0; i < EXT_HTTP_MAX_CONNECTIONS; i++) {
+        slots[i].host[0] = '\0';
+        slots[i].busy = false;
+        slots[i].counted = false;
+        slots[i].lastUsed = 0;
+        // Comme HTTPClient::begin(url) sans certificat : pas de vérification
+        slots[i].tls.setInsecure();
+    }
+    for (int i = 0; i < EXT_DNS_CACHE_SIZE; i++) {
+        dnsCache[i].host[0] = '\0';
+    }
+    memset(cache, 0, sizeof(cache));
+    memset(&stats, 0, sizeof(stats));
+    memset(handshakeBuckets, 0, sizeof(handshakeBuckets));
+    handshakeMinute = 0;
+}
+
+ExternalHttp* ExternalHttp::getInstance() {
+    if (!instance) {
+        instance = new ExternalHttp();
+    }
+    return instance;
+}
+
+ExternalConnection* ExternalHttp::acquire(const char* host, uint16_t port, bool secure) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    uint32_t now = millis();
+
+    int chosen = -1;
+    int freeSlot = -1;
+    int oldestIdle = -1;
+    for (int i = 0; i < EXT_HTTP_MAX_CONNECTIONS; i++) {
+        ExternalConnection& slot = slots[i];
+        if (slot.busy) continue;
+        // Connexion inactive trop longtemps : le serveur l'a probablement déjà fermée
+        if (slot.host[0] != '\0' && now - slot.lastUsed >= EXT_HTTP_IDLE_TIMEOUT_MS) {
+            closeLocked(slot);
+            slot.host[0] = '\0';
+        }
+        if (slot.host[0] == '\0') {
+            if (freeSlot < 0) freeSlot = i;
+            continue;
+        }
+        if (strcmp(slot.host, host) == 0 && slot.port == port && slot.secure == secure) {
+            chosen = i;
+            break;
+        }
+        if (oldestIdle < 0 || slot.lastUsed < slots[oldestIdle].lastUsed) {
+            oldestIdle = i;
+        }
+    }
+
+    if (chosen < 0) {
+        chosen = freeSlot >= 0 ? freeSlot : oldestIdle;
+        if (chosen >= 0) {
+            ExternalConnection& slot = slots[chosen];
+            closeLocked(slot);
+            strcpy(slot.host, host);
+            slot.port = port;
+            slot.secure = secure;
+        }
+    }
+
+    ExternalConnection* conn = nullptr;
+    if (chosen >= 0) {
+        conn = &slots[chosen];
+        conn->busy = true;
+        conn->lastUsed = now;
+    }
+    xSemaphoreGive(mutex);
+    return conn;
+}
+
+void ExternalHttp::release(ExternalConnection* conn) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    conn->busy = false;
+    conn->lastUsed = millis();
+    if (!conn->client().connected()) {
+        closeLocked(*conn);
+        conn->host[0] = '\0';
+    }
+    xSemaphoreGive(mutex);
+}
+
+void ExternalHttp::closeLocked(ExternalConnection& slot) {
+    slot.client().stop();
+    if (slot.counted) {
+        SocketBudget::getInstance()->release(SOCKET_EXTERNAL);
+        slot.counted = false;
+    }
+}
+
+bool ExternalHttp::resolve(const char* host, IPAddress& ip) {
+    uint32_t now = millis();
+    int freeSlot = -1;
+    int oldest = 0;
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    for (int i = 0; i < EXT_DNS_CACHE_SIZE; i++) {
+        DnsEntry& entry = dnsCache[i];
+        if (entry.host[0] != '\0' && strcmp(entry.host, host) == 0) {
+            if (now - entry.resolvedAt < EXT_DNS_TTL_MS) {
+                ip = entry.ip;
+                stats.dnsHits++;
+                xSemaphoreGive(mutex);
+                return true;
+            }
+            entry.host[0] = '\0';  // Expirée : on la remplace
+        }
+        if (entry.host[0] == '\0') {
+            if (freeSlot < 0) freeSlot = i;
+        } else if (entry.resolvedAt < dnsCache[oldest].resolvedAt) {
+            oldest = i;
+        }
+    }
+    stats.dnsLookups++;
+    xSemaphoreGive(mutex);
+
+    if (!WiFi.hostByName(host, ip)) {
+        Serial.printf("[ExtHTTP] DNS lookup failed for %s\n", host);
+        return false;
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    DnsEntry& entry = dnsCache[freeSlot >= 0 ? freeSlot : oldest];
+    strcpy(entry.host, host);
+    entry.ip = ip;
+    entry.resolvedAt = now;
+    xSemaphoreGive(mutex);
+    return true;
+}
+
+void ExternalHttp::forgetHost(const char* host) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    for (int i = 0; i < EXT_DNS_CACHE_SIZE; i++) {
+        if (strcmp(dnsCache[i].host, host) == 0) {
+            dnsCache[i].host[0] = '\0';
+        }
+    }
+    xSemaphoreGive(mutex);
+}
+
+bool ExternalHttp::connect(ExternalConnection* conn) {
+    IPAddress ip;
+    if (!resolve(conn->host, ip)) {
+        return false;
+    }
+
+    SocketBudget* budget = SocketBudget::getInstance();
+    if (!budget->acquire(SOCKET_EXTERNAL)) {
+        Serial.printf("[ExtHTTP] No lwIP socket left for %s\n", conn->host);
+        return false;
+    }
+
+    uint32_t start = millis();
+    bool ok;
+    if (conn->secure) {
+        // Connexion par IP (cache DNS) avec le nom d'hôte pour le SNI
+        conn->tls.setTimeout(EXT_HTTP_TIMEOUT_MS / 1000);
+        conn->tls.setHandshakeTimeout(EXT_HTTP_TIMEOUT_MS / 1000);
+        ok = conn->tls.connect(ip, conn->port, conn->host, nullptr, nullptr, nullptr);
+    } else {
+        ok = conn->plain.connect(ip, conn->port, EXT_HTTP_TIMEOUT_MS);
+    }
+    if (!ok) {
+        budget->release(SOCKET_EXTERNAL);
+        // L'adresse en cache est peut-être périmée
+        forgetHost(conn->host);
+        Serial.printf("[ExtHTTP] Connect to %s failed\n", conn->host);
+        return false;
+    }
+    conn->counted = true;
+    if (conn->secure) {
+        noteHandshake(millis() - start);
+    }
+    return true;
+}
+
+void ExternalHttp::rollHandshakeBucketsLocked() {
+    // Vide les minutes écoulées depuis le dernier appel
+    uint32_t minute = millis() / 60000;
+    uint32_t elapsed = minute - handshakeMinute;
+    if (elapsed >= 60) {
+        memset(handshakeBuckets, 0, sizeof(handshakeBuckets));
+    } else {
+        for (uint32_t m = 1; m <= elapsed; m++) {
+            handshakeBuckets[(handshakeMinute + m) % 60] = 0;
+        }
+    }
+    handshakeMinute = minute;
+}
+
+void ExternalHttp::noteHandshake(uint32_t ms) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    rollHandshakeBucketsLocked();
+    handshakeBuckets[handshakeMinute % 60]++;
+    stats.handshakes++;
+    stats.tlsMs += ms;
+    xSemaphoreGive(mutex);
+}
+
+// FNV-1a : clé du cache de réponses
+static uint32_t hashUrl(const String& url) {
+    uint32_t hash = 2166136261u;
+    for (unsigned int i = 0; i < url.length(); i++) {
+        hash = (hash ^ (uint8_t)url[i]) * 16777619u;
+    }
+    return hash != 0 ? hash : 1;
+}
+
+static const char* cacheHeaders[] = { "ETag", "Last-Modified", "Cache-Control", "Age", "Transfer-Encoding" };
+
+ExternalHttp::CacheEntry* ExternalHttp::findCacheLocked(uint32_t urlHash) {
+    for (int i = 0; i < EXT_CACHE_SIZE; i++) {
+        if (cache[i].urlHash == urlHash) {
+            return &cache[i];
+        }
+    }
+    return nullptr;
+}
+
+void ExternalHttp::storeCache(uint32_t urlHash, HTTPClient& http, bool keep) {
+    String control = http.header("Cache-Control");
+    control.toLowerCase();
+    String etag = http.header("ETag");
+    String lastModified = http.header("Last-Modified");
+
+    uint32_t maxAgeS = 0;
+    int maxAgePos = control.indexOf("max-age=");
+    if (maxAgePos >= 0) {
+        maxAgeS = strtoul(control.c_str() + maxAgePos + 8, nullptr, 10);
+        // Âge déjà passé dans un cache intermédiaire (CDN)
+        uint32_t age = strtoul(http.header("Age").c_str(), nullptr, 10);
+        maxAgeS = maxAgeS > age ? min(maxAgeS - age, (uint32_t)EXT_CACHE_MAX_AGE_S) : 0;
+    }
+    if (control.indexOf("no-cache") >= 0) {
+        maxAgeS = 0;  // Revalider à chaque fois
+    }
+    // Rien d'exploitable (ou interdit) : pas d'entrée
+    bool useful = keep && control.indexOf("no-store") < 0 &&
+                  (maxAgeS > 0 || etag.length() > 0 || lastModified.length() > 0);
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    CacheEntry* entry = findCacheLocked(urlHash);
+    if (!useful) {
+        if (entry != nullptr) entry->urlHash = 0;
+        xSemaphoreGive(mutex);
+        return;
+    }
+    if (entry == nullptr) {
+        // Slot libre, sinon l'entrée la plus ancienne
+        entry = &cache[0];
+        for (int i = 0; i < EXT_CACHE_SIZE; i++) {
+            if (cache[i].urlHash == 0) {
+                entry = &cache[i];
+                break;
+            }
+            if (cache[i].storedAt < entry->storedAt) {
+                entry = &cache[i];
+            }
+        }
+        entry->urlHash = urlHash;
+        entry->etag[0] = '\0';
+        entry->lastModified[0] = '\0';
+    }
+    // Un 304 peut omettre les validateurs : on garde les précédents
+    if (etag.length() > 0) strlcpy(entry->etag, etag.c_str(), sizeof(entry->etag));
+    if (lastModified.length() > 0) strlcpy(entry->lastModified, lastModified.c_str(), sizeof(entry->lastModified));
+    entry->storedAt = millis();
+    entry->maxAgeMs = maxAgeS * 1000;
+    xSemaphoreGive(mutex);
+}
+
+int ExternalHttp::request(const String& url, uint32_t timeoutMs, BodyReader reader, void* ctx, bool haveResult) {
+    bool secure;
+    char host[EXT_HTTP_HOST_LEN];
+    uint16_t port;
+    if (!parseUrl(url, secure, host, port)) {
+        Serial.printf("[ExtHTTP] Invalid URL: %s\n", url.c_str());
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+
+    // Réponse encore fraîche et résultat toujours chez l'appelant : pas de requête
+    uint32_t urlHash = hashUrl(url);
+    char etag[EXT_CACHE_ETAG_LEN] = "";
+    char lastModified[EXT_CACHE_DATE_LEN] = "";
+    if (haveResult) {
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        CacheEntry* entry = findCacheLocked(urlHash);
+        if (entry != nullptr) {
+            if (millis() - entry->storedAt < entry->maxAgeMs) {
+                stats.cacheHits++;
+                xSemaphoreGive(mutex);
+                return EXT_HTTP_CACHE_FRESH;
+            }
+            strcpy(etag, entry->etag);
+            strcpy(lastModified, entry->lastModified);
+        }
+        xSemaphoreGive(mutex);
+    }
+
+    int httpCode = HTTPC_ERROR_CONNECTION_REFUSED;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        ExternalConnection* conn = acquire(host, port, secure);
+        if (conn == nullptr) {
+            Serial.println("[ExtHTTP] All connections busy");
+            break;
+        }
+
+        bool reused = conn->client().connected();
+        if (!reused && !connect(conn)) {
+            release(conn);
+            break;
+        }
+
+        // HTTPClient reprend la connexion déjà ouverte (pas de nouveau handshake)
+        HTTPClient& http = conn->http;
+        http.begin(conn->client(), url);
+        http.setReuse(true);
+        http.setTimeout(timeoutMs);
+        http.collectHeaders(cacheHeaders, sizeof(cacheHeaders) / sizeof(cacheHeaders[0]));
+        if (etag[0] != '\0') http.addHeader("If-None-Match", etag);
+        if (lastModified[0] != '\0') http.addHeader("If-Modified-Since", lastModified);
+        httpCode = http.GET();
+
+        // Connexion fermée par le serveur pendant qu'elle dormait : une seule nouvelle tentative
+        if (httpCode < 0 && reused && attempt == 0) {
+            http.end();
+            conn->client().stop();
+            release(conn);
+            continue;
+        }
+
+        if (httpCode == HTTP_CODE_OK) {
+            bool ok = reader == nullptr || reader(http, ctx);
+            if (!ok) {
+                // Corps illisible : la connexion est dans un état inconnu
+                conn->client().stop();
+            }
+            storeCache(urlHash, http, ok);
+        } else if (httpCode == HTTP_CODE_NOT_MODIFIED) {
+            storeCache(urlHash, http, true);  // Nouvelle expiration
+        }
+        http.end();
+        release(conn);
+
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        stats.requests++;
+        if (reused) stats.reused++;
+        if (httpCode == HTTP_CODE_OK) stats.cacheMisses++;
+        if (httpCode == HTTP_CODE_NOT_MODIFIED) stats.notModified++;
+        xSemaphoreGive(mutex);
+        break;
+    }
+
+    if (httpCode != HTTP_CODE_OK && httpCode != HTTP_CODE_NOT_MODIFIED) {
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        stats.errors++;
+        xSemaphoreGive(mutex);
+    }
+    return httpCode;
+}
+
+static bool readString(HTTPClient& http, void* ctx) {
+    *(String*)ctx = http.getString();
+    return true;
+}
+
+int ExternalHttp::get(const String& url, String& payload, uint32_t timeoutMs, bool haveResult) {
+    payload = "";
+    return request(url, timeoutMs, readString, &payload, haveResult);
+}
+
+struct StreamTarget {
+    ExternalHttp::StreamReader reader;
+    void* ctx;
+};
+
+static bool readStream(HTTPClient& http, void* ctx) {
+    StreamTarget* target = (StreamTarget*)ctx;
+    if (http.getSize() >= 0 || !http.header("Transfer-Encoding").equalsIgnoreCase("chunked")) {
+        // Taille connue, ou corps jusqu'à la fermeture : lecture directe depuis le socket
+        return target->reader(http.getStream(), target->ctx);
+    }
+    // Chunked : décodé au fil de la lecture, puis chunk final lu pour que la
+    // connexion keep-alive reste utilisable
+    ChunkedStream body(http.getStream());
+    return target->reader(body, target->ctx) && body.drain();
+}
+
+int ExternalHttp::getStream(const String& url, StreamReader reader, void* ctx, uint32_t timeoutMs, bool haveResult) {
+    StreamTarget target = { reader, ctx };
+    return request(url, timeoutMs, readStream, &target, haveResult);
+}
+
+struct JsonTarget {
+    JsonDocument* doc;
+    const JsonDocument* filter;
+    ExternalHttp::ElementHandler handler;
+    void* ctx;
+    DeserializationError error;
+};
+
+static DeserializationError parseJson(JsonTarget* target, Stream& stream) {
+    return target->filter != nullptr
+        ? deserializeJson(*target->doc, stream, DeserializationOption::Filter(*target->filter))
+        : deserializeJson(*target->doc, stream);
+}
+
+static bool readJson(Stream& stream, void* ctx) {
+    JsonTarget* target = (JsonTarget*)ctx;
+    target->error = parseJson(target, stream);
+    return !target->error;
+}
+
+static bool readJsonArray(Stream& stream, void* ctx) {
+    JsonTarget* target = (JsonTarget*)ctx;
+    if (!stream.find('[')) {
+        target->error = DeserializationError::InvalidInput;
+        return false;
+    }
+    // Un élément à la fois : le document ne contient jamais plus d'un élément filtré.
+    // Le tableau est lu jusqu'au bout pour laisser la connexion réutilisable.
+    int index = 0;
+    do {
+        target->error = parseJson(target, stream);
+        if (target->error) {
+            return false;
+        }
+        target->handler(target->doc->as<JsonVariantConst>(), index++, target->ctx);
+    } while (stream.findUntil(",", "]"));
+    return true;
+}
+
+int ExternalHttp::getJson(const String& url, JsonDocument& doc, const JsonDocument* filter, uint32_t timeoutMs,
+                          bool haveResult) {
+    JsonTarget target = { &doc, filter, nullptr, nullptr, DeserializationError::Ok };
+    int httpCode = getStream(url, readJson, &target, timeoutMs, haveResult);
+    if (httpCode == HTTP_CODE_OK && target.error) {
+        Serial.printf("[ExtHTTP] JSON parse error: %s\n", target.error.c_str());
+        return HTTPC_ERROR_NO_HTTP_SERVER;
+    }
+    return httpCode;
+}
+
+int ExternalHttp::getJsonArray(const String& url, const JsonDocument* filter, ElementHandler handler, void* ctx,
+                               uint32_t timeoutMs, bool haveResult) {
+    JsonDocument element;
+    JsonTarget target = { &element, filter, handler, ctx, DeserializationError::Ok };
+    int httpCode = getStream(url, readJsonArray, &target, timeoutMs, haveResult);
+    if (httpCode == HTTP_CODE_OK && target.error) {
+        Serial.printf("[ExtHTTP] JSON array parse error: %s\n", target.error.c_str());
+        return HTTPC_ERROR_NO_HTTP_SERVER;
+    }
+    return httpCode;
+}
+
+bool ExternalHttp::getStats(ExternalHttpStats& out) {
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return false;
+    }
+    rollHandshakeBucketsLocked();
+    out = stats;
+    out.handshakesLastHour = 0;
+    for (int i = 0; i < 60; i++) {
+        out.handshakesLastHour += handshakeBuckets[i];
+    }
+    xSemaphoreGive(mutex);
+    return true;
+}
+
+void ExternalHttp::printStats() {
+    ExternalHttpStats s;
+    if (!getStats(s)) {
+        return;
+    }
+    int openCount = 0;
+    for (int i = 0; i < EXT_HTTP_MAX_CONNECTIONS; i++) {
+        if (slots[i].host[0] != '\0' && !slots[i].busy && slots[i].client().connected()) openCount++;
+    }
+    Serial.printf("External APIs: %u request(s), %u error(s), %u reused | %u TLS handshake(s) (%u last hour, avg %u ms) | DNS %u lookup(s), %u hit(s) | %d/%d open\n",
+                  s.requests, s.errors, s.reused, s.handshakes, s.handshakesLastHour,
+                  s.handshakes > 0 ? s.tlsMs / s.handshakes : 0, s.dnsLookups, s.dnsHits,
+                  openCount, EXT_HTTP_MAX_CONNECTIONS);
+    Serial.printf("Response cache: %u fresh hit(s), %u miss(es), %u not modified (304)\n",
+                  s.cacheHits, s.cacheMisses, s.notModified);
+}
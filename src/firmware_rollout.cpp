@@ -0,0 +1,458 @@
+#include "firmware_rollout.h"
+#include "wifi_manager.h"
+#include "miner_registry.h"
+#include "miner_poller.h"
+#include "socket_budget.h"
+#include <HTTPClient.h>
+#include "esp_ota_ops.h"
+
+FirmwareRollout* FirmwareRollout::instance = nullptr;
+
+#define FIRMWARE_IMAGE_MAGIC 0xE9   // Premier octet d'une image d'application ESP32
+
+// Flux d'écriture vers la partition : HTTPClient::writeToStream gère la
+// longueur et le chunked, on efface la flash secteur par secteur au fil de l'eau
+class PartitionWriter : public Stream {
+public:
+    const esp_partition_t* partition;
+    uint32_t written;
+    uint32_t erased;
+    volatile bool* abortFlag;
+    volatile uint32_t* progress;
+
+    PartitionWriter(const esp_partition_t* part, volatile bool* abort, volatile uint32_t* downloaded)
+        : partition(part), written(0), erased(0), abortFlag(abort), progress(downloaded) {}
+
+    size_t write(const uint8_t* data, size_t len) override {
+        if (*abortFlag || written + len > partition->size) {
+            return 0;  // writeToStream abandonne
+        }
+        while (erased < written + len) {
+            if (esp_partition_erase_range(partition, erased, SPI_FLASH_SEC_SIZE) != ESP_OK) {
+                return 0;
+            }
+            erased += SPI_FLASH_SEC_SIZE;
+        }
+        if (esp_partition_write(partition, written, data, len) != ESP_OK) {
+            return 0;
+        }
+        written += len;
+        *progress = written;
+        return len;
+    }
+    size_t write(uint8_t b) override { return write(&b, 1); }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    void flush() override {}
+};
+
+FirmwareRollout::FirmwareRollout() {
+    mutex = xSemaphoreCreateMutex();
+    task = nullptr;
+    abortRequested = false;
+    waveSize = FIRMWARE_DEFAULT_WAVE_SIZE;
+    recoveryRatio = FIRMWARE_DEFAULT_RECOVERY;
+
+    capacity = fleetCapacity();
+    targets = fleetAllocArray<FirmwareTarget>(capacity);
+    if (targets == nullptr) {
+        capacity = 0;
+    }
+    memset(&status, 0, sizeof(status));
+    status.state = FIRMWARE_IDLE;
+
+    // Slot OTA que TouchAxe n'exécute pas : assez grand pour un firmware de mineur
+    partition = esp_ota_get_next_update_partition(nullptr);
+    imageSize = 0;
+    if (partition != nullptr) {
+        prefs.begin("fwcache", true);
+        imageUrl = prefs.getString("url", "");
+        imageSize = prefs.getUInt("size", 0);
+        prefs.end();
+        if (imageSize > partition->size) {
+            imageSize = 0;
+        }
+    }
+}
+
+FirmwareRollout* FirmwareRollout::getInstance() {
+    if (!instance) {
+        instance = new FirmwareRollout();
+    }
+    return instance;
+}
+
+bool FirmwareRollout::start(const char* url, JsonArrayConst ids, bool all, int wave, float recovery, String& error) {
+    WifiManager* wifi = WifiManager::getInstance();
+
+    if (task != nullptr) {
+        error = "A rollout is already running";
+        return false;
+    }
+    if (url == nullptr || strncmp(url, "http", 4) != 0) {
+        error = "Firmware URL required";
+        return false;
+    }
+    if (partition == nullptr || capacity == 0) {
+        error = "No flash partition available for the image";
+        return false;
+    }
+    if (!wifi->isConnected()) {
+        error = "WiFi not connected";
+        return false;
+    }
+    // Les mineurs téléchargent l'image chez nous
+    if (!wifi->isWebServerRunning()) {
+        wifi->startWebServer();
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    int count = 0;
+    if (all) {
+        for (int i = 0; i < wifi->getBitaxeCount() && count < capacity; i++) {
+            BitaxeDevice device;
+            if (wifi->copyBitaxe(i, device)) {
+                targets[count++].id = device.id;
+            }
+        }
+    } else {
+        for (JsonVariantConst id : ids) {
+            if (count >= capacity) break;
+            if (wifi->hasBitaxe(id.as<uint16_t>())) {
+                targets[count++].id = id.as<uint16_t>();
+            }
+        }
+    }
+    if (count == 0) {
+        xSemaphoreGive(mutex);
+        error = "No miner selected";
+        return false;
+    }
+    for (int i = 0; i < count; i++) {
+        targets[i].state = FIRMWARE_TARGET_PENDING;
+        targets[i].baselineHashrate = 0;
+    }
+
+    uint32_t served = status.served;
+    memset(&status, 0, sizeof(status));
+    status.served = served;
+    status.total = count;
+    waveSize = wave > 0 ? wave : FIRMWARE_DEFAULT_WAVE_SIZE;
+    recoveryRatio = (recovery > 0.0f && recovery <= 1.0f) ? recovery : FIRMWARE_DEFAULT_RECOVERY;
+    status.waveCount = (count + waveSize - 1) / waveSize;
+    status.state = FIRMWARE_DOWNLOADING;
+    requestedUrl = url;
+    abortRequested = false;
+    xSemaphoreGive(mutex);
+
+    if (xTaskCreatePinnedToCore(taskEntry, "fw_rollout", FIRMWARE_TASK_STACK, this, 1, &task, FIRMWARE_TASK_CORE) != pdPASS) {
+        task = nullptr;
+        fail(FIRMWARE_FAILED, "Could not start rollout task");
+        error = "Could not start rollout task";
+        return false;
+    }
+    Serial.printf("[Firmware] Rollout to %d miner(s) in %d wave(s) of %d\n", count, status.waveCount, waveSize);
+    return true;
+}
+
+void FirmwareRollout::abort() {
+    if (task != nullptr) {
+        abortRequested = true;
+        Serial.println("[Firmware] Abort requested");
+    }
+}
+
+void FirmwareRollout::taskEntry(void* arg) {
+    FirmwareRollout* self = (FirmwareRollout*)arg;
+    self->run();
+    self->task = nullptr;
+    vTaskDelete(nullptr);
+}
+
+void FirmwareRollout::fail(FirmwareRolloutState state, const char* error) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    status.state = state;
+    strlcpy(status.error, error, sizeof(status.error));
+    xSemaphoreGive(mutex);
+    Serial.printf("[Firmware] Rollout stopped: %s\n", error);
+}
+
+void FirmwareRollout::run() {
+    // Même URL que l'image en cache : pas de nouveau téléchargement
+    if (imageSize > 0 && requestedUrl == imageUrl) {
+        Serial.printf("[Firmware] Using cached image (%u bytes)\n", imageSize);
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        status.imageSize = imageSize;
+        status.downloaded = imageSize;
+        xSemaphoreGive(mutex);
+    } else if (!downloadImage(requestedUrl)) {
+        return;
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    status.state = FIRMWARE_ROLLING;
+    xSemaphoreGive(mutex);
+
+    String localUrl = "http://" + WiFi.localIP().toString() + FIRMWARE_LOCAL_PATH;
+    BitaxeAPI api;
+    for (int first = 0; first < status.total; first += waveSize) {
+        if (abortRequested) {
+            fail(FIRMWARE_ABORTED, "Aborted");
+            return;
+        }
+        int count = min(waveSize, status.total - first);
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        status.wave = first / waveSize + 1;
+        xSemaphoreGive(mutex);
+        Serial.printf("[Firmware] Wave %d/%d: %d miner(s)\n", status.wave, status.waveCount, count);
+        if (!runWave(first, count, localUrl, api)) {
+            return;
+        }
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    status.state = FIRMWARE_DONE;
+    xSemaphoreGive(mutex);
+    Serial.printf("[Firmware] Rollout complete: %d miner(s) updated\n", status.recovered);
+}
+
+bool FirmwareRollout::downloadImage(const String& url) {
+    // L'ancienne image est écrasée : le cache n'est plus valide
+    imageSize = 0;
+    imageUrl = "";
+    prefs.begin("fwcache", false);
+    prefs.clear();
+    prefs.end();
+
+    Serial.printf("[Firmware] Downloading %s\n", url.c_str());
+    SocketLease socket(SOCKET_ONE_SHOT);
+    if (!socket.granted()) {
+        fail(FIRMWARE_FAILED, "No network socket available");
+        return false;
+    }
+    HTTPClient http;
+    http.begin(url);
+    http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);  // Releases GitHub
+    http.setTimeout(FIRMWARE_DOWNLOAD_TIMEOUT_MS);
+
+    int httpCode = http.GET();
+    if (httpCode != HTTP_CODE_OK) {
+        http.end();
+        char error[64];
+        snprintf(error, sizeof(error), "Download failed: HTTP %d", httpCode);
+        fail(FIRMWARE_FAILED, error);
+        return false;
+    }
+    int length = http.getSize();  // -1 en chunked
+    if (length > (int)partition->size) {
+        http.end();
+        fail(FIRMWARE_FAILED, "Image larger than the flash partition");
+        return false;
+    }
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    status.imageSize = length > 0 ? length : 0;
+    xSemaphoreGive(mutex);
+
+    PartitionWriter writer(partition, &abortRequested, &status.downloaded);
+    int result = http.writeToStream(&writer);
+    http.end();
+
+    if (abortRequested) {
+        fail(FIRMWARE_ABORTED, "Aborted");
+        return false;
+    }
+    if (result <= 0 || (length > 0 && writer.written != (uint32_t)length)) {
+        fail(FIRMWARE_FAILED, "Download interrupted");
+        return false;
+    }
+
+    // Une page d'erreur HTML servie en 200 ne doit pas partir vers la flotte
+    uint8_t magic = 0;
+    esp_partition_read(partition, 0, &magic, 1);
+    if (magic != FIRMWARE_IMAGE_MAGIC) {
+        fail(FIRMWARE_FAILED, "Not an ESP32 firmware image");
+        return false;
+    }
+
+    imageSize = writer.written;
+    imageUrl = url;
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    status.imageSize = imageSize;
+    xSemaphoreGive(mutex);
+    prefs.begin("fwcache", false);
+    prefs.putString("url", imageUrl);
+    prefs.putUInt("size", imageSize);
+    prefs.end();
+    Serial.printf("[Firmware] Image cached: %u bytes in partition %s\n", imageSize, partition->label);
+    return true;
+}
+
+bool FirmwareRollout::runWave(int first, int count, const String& localUrl, BitaxeAPI& api) {
+    MinerRegistry* registry = MinerRegistry::getInstance();
+    WifiManager* wifi = WifiManager::getInstance();
+
+    // Les mineurs d'une vague téléchargent l'image en parallèle
+    for (int i = first; i < first + count; i++) {
+        FirmwareTarget& target = targets[i];
+        MinerView view;
+        if (registry->read(target.id, view) && view.online) {
+            target.baselineHashrate = view.stats.hashrate;
+        }
+
+        bool sent = false;
+        BitaxeDevice device;
+        if (wifi->copyBitaxeById(target.id, device)) {
+            api.setDevice(device.ip.c_str());
+            sent = api.updateFirmware(localUrl);
+        }
+
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        target.state = sent ? FIRMWARE_TARGET_UPDATING : FIRMWARE_TARGET_FAILED;
+        if (!sent) {
+            status.failed++;
+        }
+        xSemaphoreGive(mutex);
+    }
+
+    if (!waitRecovery(first, count, millis())) {
+        return false;  // Abandon
+    }
+    // Les vagues précédentes n'ont eu aucun échec : tous ceux-ci sont de cette vague
+    if (status.failed > 0) {
+        char error[64];
+        snprintf(error, sizeof(error), "Wave %d: %d miner(s) did not recover", status.wave, status.failed);
+        fail(FIRMWARE_FAILED, error);
+        return false;
+    }
+    return true;
+}
+
+bool FirmwareRollout::waitRecovery(int first, int count, uint32_t sentAt) {
+    MinerRegistry* registry = MinerRegistry::getInstance();
+    uint32_t checkFrom = sentAt + FIRMWARE_SETTLE_MS;
+    uint32_t lastCheck = 0;
+
+    while (millis() - sentAt < FIRMWARE_RECOVERY_TIMEOUT_MS) {
+        if (abortRequested) {
+            fail(FIRMWARE_ABORTED, "Aborted");
+            return false;
+        }
+        vTaskDelay(pdMS_TO_TICKS(1000));
+        if ((int32_t)(millis() - checkFrom) < 0) {
+            continue;  // Redémarrage en cours
+        }
+        if (lastCheck != 0 && millis() - lastCheck < FIRMWARE_CHECK_INTERVAL_MS) {
+            continue;
+        }
+        lastCheck = millis();
+
+        int pending = 0;
+        for (int i = first; i < first + count; i++) {
+            FirmwareTarget& target = targets[i];
+            if (target.state != FIRMWARE_TARGET_UPDATING) continue;
+
+            MinerView view;
+            bool fresh = registry->read(target.id, view) && view.online &&
+                         (int32_t)(view.timestamp - checkFrom) > 0;
+            float needed = target.baselineHashrate * recoveryRatio;
+            if (fresh && view.stats.hashrate > 0 && view.stats.hashrate >= needed) {
+                xSemaphoreTake(mutex, portMAX_DELAY);
+                target.state = FIRMWARE_TARGET_RECOVERED;
+                status.recovered++;
+                xSemaphoreGive(mutex);
+                Serial.printf("[Firmware] #%u recovered: %.1f GH/s (was %.1f)\n",
+                              target.id, view.stats.hashrate, target.baselineHashrate);
+            } else {
+                // Seuls les mineurs de la vague encore en attente sont réinterrogés
+                MinerPoller::getInstance()->requestPoll(target.id);
+                pending++;
+            }
+        }
+        if (pending == 0) {
+            return true;
+        }
+    }
+
+    // Délai dépassé : les mineurs restants sont en échec
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    for (int i = first; i < first + count; i++) {
+        if (targets[i].state == FIRMWARE_TARGET_UPDATING) {
+            targets[i].state = FIRMWARE_TARGET_FAILED;
+            status.failed++;
+        }
+    }
+    xSemaphoreGive(mutex);
+    return true;
+}
+
+bool FirmwareRollout::getStatus(FirmwareRolloutStatus& out) {
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return false;
+    }
+    out = status;
+    xSemaphoreGive(mutex);
+    return true;
+}
+
+bool FirmwareRollout::getTarget(int index, FirmwareTarget& out) {
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return false;
+    }
+    bool valid = index >= 0 && index < status.total;
+    if (valid) {
+        out = targets[index];
+    }
+    xSemaphoreGive(mutex);
+    return valid;
+}
+
+void FirmwareRollout::handleImageRequest(AsyncWebServerRequest* request) {
+    // Pas d'image tant que le téléchargement n'est pas terminé et vérifié
+    if (imageSize == 0 || partition == nullptr) {
+        request->send(404, "text/plain", "No firmware image cached");
+        return;
+    }
+
+    const esp_partition_t* part = partition;
+    uint32_t size = imageSize;
+    AsyncWebServerResponse* response = request->beginResponse("application/octet-stream", size,
+        [part, size](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+            if (index >= size) {
+                return 0;
+            }
+            size_t len = min((size_t)(size - index), maxLen);
+            if (esp_partition_read(part, index, buffer, len) != ESP_OK) {
+                return 0;
+            }
+            return len;
+        });
+    request->send(response);
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    status.served++;
+    xSemaphoreGive(mutex);
+    Serial.printf("[Firmware] Serving image to %s\n", request->client()->remoteIP().toString().c_str());
+}
+
+const char* FirmwareRollout::stateName(FirmwareRolloutState state) {
+    switch (state) {
+        case FIRMWARE_IDLE:        return "idle";
+        case FIRMWARE_DOWNLOADING: return "downloading";
+        case FIRMWARE_ROLLING:     return "rolling";
+        case FIRMWARE_DONE:        return "done";
+        case FIRMWARE_FAILED:      return "failed";
+        case FIRMWARE_ABORTED:     return "aborted";
+    }
+    return "?";
+}
+
+const char* FirmwareRollout::targetStateName(FirmwareTargetState state) {
+    switch (state) {
+        case FIRMWARE_TARGET_PENDING:   return "pending";
+        case FIRMWARE_TARGET_UPDATING:  return "updating";
+        case FIRMWARE_TARGET_RECOVERED: return "recovered";
+        case FIRMWARE_TARGET_FAILED:    return "failed";
+    }
+    return "?";
+}
@@ -0,0 +1,272 @@
+#include "fleet_command_queue.h"
+#include "wifi_manager.h"
+#include "miner_registry.h"
+#include "config_templates.h"
+
+FleetCommandQueue* FleetCommandQueue::instance = nullptr;
+
+FleetCommandQueue::FleetCommandQueue() {
+    jobs = nullptr;
+    mutex = xSemaphoreCreateMutex();
+    for (int i = 0; i < FLEET_CMD_WORKERS; i++) {
+        workers[i] = nullptr;
+    }
+    capacity = fleetCapacity();
+    results = fleetAllocArray<FleetCommandResult>(capacity);
+    if (results == nullptr) {
+        capacity = 0;
+    }
+    progress.batch = 0;
+    progress.total = 0;
+    progress.done = 0;
+    progress.succeeded = 0;
+    progress.failed = 0;
+    progress.unchanged = 0;
+    generation = 0;
+    batchHasConfig = false;
+}
+
+FleetCommandQueue* FleetCommandQueue::getInstance() {
+    if (!instance) {
+        instance = new FleetCommandQueue();
+    }
+    return instance;
+}
+
+void FleetCommandQueue::begin() {
+    if (jobs != nullptr || capacity == 0) {
+        return;  // Déjà démarré
+    }
+
+    jobs = xQueueCreate(capacity, sizeof(int));
+    for (int i = 0; i < FLEET_CMD_WORKERS; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "fleet_cmd%d", i);
+        xTaskCreatePinnedToCore(workerTaskEntry, name, FLEET_CMD_WORKER_STACK, this, 1, &workers[i], FLEET_CMD_TASK_CORE);
+    }
+    Serial.printf("[FleetCmd] Started %d worker(s) on core %d\n", FLEET_CMD_WORKERS, FLEET_CMD_TASK_CORE);
+}
+
+void FleetCommandQueue::workerTaskEntry(void* arg) {
+    FleetCommandQueue* self = (FleetCommandQueue*)arg;
+    BitaxeAPI api;
+    int index;
+    for (;;) {
+        if (xQueueReceive(self->jobs, &index, portMAX_DELAY) == pdTRUE) {
+            self->run(index, api);
+        }
+    }
+}
+
+bool FleetCommandQueue::enqueueLocked(uint16_t id, FleetCommand command) {
+    // Lot précédent terminé : on repart de zéro
+    if (progress.done == progress.total) {
+        progress.batch++;
+        progress.total = 0;
+        progress.done = 0;
+        progress.succeeded = 0;
+        progress.failed = 0;
+        progress.unchanged = 0;
+        batchHasConfig = false;
+    }
+    if (progress.total >= capacity) {
+        Serial.printf("[FleetCmd] Queue full, %s #%u dropped\n", commandName(command), id);
+        return false;
+    }
+
+    int index = progress.total++;
+    results[index].id = id;
+    results[index].command = command;
+    results[index].state = FLEET_CMD_QUEUED;
+    results[index].durationMs = 0;
+    generation++;
+
+    // La file a la taille du tableau de résultats : l'envoi ne bloque jamais
+    xQueueSend(jobs, &index, 0);
+    return true;
+}
+
+bool FleetCommandQueue::submit(uint16_t id, FleetCommand command) {
+    if (jobs == nullptr || command == FLEET_CMD_APPLY_CONFIG) {
+        return false;  // Le modèle passe par submitConfig
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    bool queued = enqueueLocked(id, command);
+    xSemaphoreGive(mutex);
+    return queued;
+}
+
+int FleetCommandQueue::submitAll(FleetCommand command, bool onlineOnly) {
+    WifiManager* wifi = WifiManager::getInstance();
+    MinerRegistry* registry = MinerRegistry::getInstance();
+    int queued = 0;
+    for (int i = 0; i < wifi->getBitaxeCount(); i++) {
+        BitaxeDevice device;
+        if (!wifi->copyBitaxe(i, device)) continue;
+        if (onlineOnly && !registry->isOnline(device.id)) continue;
+        if (submit(device.id, command)) {
+            queued++;
+        }
+    }
+    Serial.printf("[FleetCmd] %s queued for %d miner(s)\n", commandName(command), queued);
+    return queued;
+}
+
+int FleetCommandQueue::submitConfig(JsonVariantConst config, JsonArrayConst ids, bool all) {
+    if (jobs == nullptr) {
+        return 0;
+    }
+
+    WifiManager* wifi = WifiManager::getInstance();
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    // Un seul modèle par lot : les workers le relisent au moment d'exécuter
+    bool running = progress.done != progress.total;
+    if (running && batchHasConfig && batchConfig.as<JsonVariantConst>() != config) {
+        xSemaphoreGive(mutex);
+        Serial.println("[FleetCmd] Another template is being applied, request refused");
+        return -1;
+    }
+
+    int queued = 0;
+    if (all) {
+        for (int i = 0; i < wifi->getBitaxeCount(); i++) {
+            BitaxeDevice device;
+            if (wifi->copyBitaxe(i, device) && enqueueLocked(device.id, FLEET_CMD_APPLY_CONFIG)) {
+                queued++;
+            }
+        }
+    } else {
+        for (JsonVariantConst id : ids) {
+            if (enqueueLocked(id.as<uint16_t>(), FLEET_CMD_APPLY_CONFIG)) {
+                queued++;
+            }
+        }
+    }
+    // Le mutex est tenu : aucun worker n'a encore pu lire le modèle
+    if (queued > 0 && !batchHasConfig) {
+        batchConfig.set(config);
+        batchHasConfig = true;
+    }
+    xSemaphoreGive(mutex);
+
+    Serial.printf("[FleetCmd] Config template queued for %d miner(s)\n", queued);
+    return queued;
+}
+
+// Lit la config, n'envoie que la différence. changed = false si déjà conforme.
+bool FleetCommandQueue::applyConfig(BitaxeAPI& api, const JsonDocument& config, bool& changed) {
+    changed = false;
+    JsonDocument current;
+    if (!api.getConfig(current, ConfigTemplates::configFilter())) {
+        return false;
+    }
+
+    JsonDocument patch;
+    int fields = ConfigTemplates::diff(config.as<JsonVariantConst>(), current.as<JsonVariantConst>(), patch);
+    if (fields == 0) {
+        return true;
+    }
+    changed = true;
+    Serial.printf("[FleetCmd] Sending %d changed field(s)\n", fields);
+    return api.setConfig(patch);
+}
+
+void FleetCommandQueue::run(int index, BitaxeAPI& api) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    uint16_t id = results[index].id;
+    FleetCommand command = results[index].command;
+    results[index].state = FLEET_CMD_RUNNING;
+    generation++;
+    JsonDocument config;
+    if (command == FLEET_CMD_APPLY_CONFIG) {
+        config.set(batchConfig);
+    }
+    xSemaphoreGive(mutex);
+
+    uint32_t start = millis();
+    bool ok = false;
+    bool changed = true;
+    BitaxeDevice device;
+    if (WifiManager::getInstance()->copyBitaxeById(id, device)) {
+        api.setDevice(device.ip.c_str());
+        switch (command) {
+            case FLEET_CMD_RESTART: ok = api.restart(); break;
+            case FLEET_CMD_REBOOT:  ok = api.reboot(); break;
+            case FLEET_CMD_STOP:    ok = api.stopMining(); break;
+            case FLEET_CMD_START:   ok = api.startMining(); break;
+            case FLEET_CMD_APPLY_CONFIG: ok = applyConfig(api, config, changed); break;
+        }
+    }
+    uint32_t duration = millis() - start;
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    results[index].state = !ok ? FLEET_CMD_FAILED : (changed ? FLEET_CMD_OK : FLEET_CMD_UNCHANGED);
+    results[index].durationMs = duration;
+    progress.done++;
+    if (ok) {
+        progress.succeeded++;
+        if (!changed) {
+            progress.unchanged++;
+        }
+    } else {
+        progress.failed++;
+    }
+    generation++;
+    xSemaphoreGive(mutex);
+
+    Serial.printf("[FleetCmd] %s #%u: %s (%u ms)\n", commandName(command), id,
+                  !ok ? "failed" : (changed ? "ok" : "unchanged"), duration);
+}
+
+bool FleetCommandQueue::getProgress(FleetProgress& out) {
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return false;
+    }
+    out = progress;
+    xSemaphoreGive(mutex);
+    return true;
+}
+
+bool FleetCommandQueue::getResult(int index, FleetCommandResult& out) {
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return false;
+    }
+    bool valid = index >= 0 && index < progress.total;
+    if (valid) {
+        out = results[index];
+    }
+    xSemaphoreGive(mutex);
+    return valid;
+}
+
+const char* FleetCommandQueue::commandName(FleetCommand command) {
+    switch (command) {
+        case FLEET_CMD_RESTART: return "restart";
+        case FLEET_CMD_REBOOT:  return "reboot";
+        case FLEET_CMD_STOP:    return "stop";
+        case FLEET_CMD_START:   return "start";
+        case FLEET_CMD_APPLY_CONFIG: return "config";
+    }
+    return "?";
+}
+
+bool FleetCommandQueue::parseCommand(const char* name, FleetCommand& out) {
+    if (name == nullptr) return false;
+    if (strcmp(name, "restart") == 0) { out = FLEET_CMD_RESTART; return true; }
+    if (strcmp(name, "reboot") == 0)  { out = FLEET_CMD_REBOOT;  return true; }
+    if (strcmp(name, "stop") == 0)    { out = FLEET_CMD_STOP;    return true; }
+    if (strcmp(name, "start") == 0)   { out = FLEET_CMD_START;   return true; }
+    return false;
+}
+
+const char* FleetCommandQueue::stateName(FleetCommandState state) {
+    switch (state) {
+        case FLEET_CMD_QUEUED:  return "queued";
+        case FLEET_CMD_RUNNING: return "running";
+        case FLEET_CMD_OK:      return "ok";
+        case FLEET_CMD_FAILED:  return "failed";
+        case FLEET_CMD_UNCHANGED: return "unchanged";
+    }
+    return "?";
+}
@@ -0,0 +1,157 @@
+#include "job_scheduler.h"
+
+JobScheduler* JobScheduler::instance = nullptr;
+
+JobScheduler::JobScheduler() {
+    memset(jobs, 0, sizeof(jobs));
+    jobCount = 0;
+    heapSize = 0;
+    passesCut = 0;
+}
+
+JobScheduler* JobScheduler::getInstance() {
+    if (!instance) {
+        instance = new JobScheduler();
+    }
+    return instance;
+}
+
+int JobScheduler::addJob(const char* name, JobFunction run, void* ctx, uint32_t periodMs, uint8_t priority,
+                         uint32_t budgetMs, uint32_t minSpacingMs, uint32_t firstDelayMs) {
+    if (jobCount >= SCHED_MAX_JOBS) {
+        Serial.printf("[Sched] Job table full, %s not scheduled\n", name);
+        return -1;
+    }
+    int id = jobCount++;
+    Job& job = jobs[id];
+    strlcpy(job.name, name, sizeof(job.name));
+    job.run = run;
+    job.ctx = ctx;
+    job.periodMs = periodMs;
+    job.priority = priority;
+    job.budgetMs = budgetMs;
+    job.minSpacingMs = minSpacingMs;
+    job.nextRun = millis() + firstDelayMs;
+    job.lastRun = job.nextRun - minSpacingMs;  // Premier trigger() accepté tout de suite
+    push(id);
+    return id;
+}
+
+// Échéance la plus proche d'abord ; à égalité, la priorité la plus basse
+bool JobScheduler::before(int a, int b) const {
+    int32_t delta = (int32_t)(jobs[a].nextRun - jobs[b].nextRun);
+    if (delta != 0) {
+        return delta < 0;
+    }
+    return jobs[a].priority < jobs[b].priority;
+}
+
+void JobScheduler::siftUp(int pos) {
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!before(heap[pos], heap[parent])) break;
+        uint8_t tmp = heap[pos];
+        heap[pos] = heap[parent];
+        heap[parent] = tmp;
+        pos = parent;
+    }
+}
+
+void JobScheduler::siftDown(int pos) {
+    for (;;) {
+        int best = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+        if (left < heapSize && before(heap[left], heap[best])) best = left;
+        if (right < heapSize && before(heap[right], heap[best])) best = right;
+        if (best == pos) break;
+        uint8_t tmp = heap[pos];
+        heap[pos] = heap[best];
+        heap[best] = tmp;
+        pos = best;
+    }
+}
+
+void JobScheduler::push(int id) {
+    heap[heapSize] = (uint8_t)id;
+    siftUp(heapSize++);
+}
+
+int JobScheduler::pop() {
+    int id = heap[0];
+    heap[0] = heap[--heapSize];
+    siftDown(0);
+    return id;
+}
+
+void JobScheduler::remove(int id) {
+    for (int i = 0; i < heapSize; i++) {
+        if (heap[i] != id) continue;
+        heap[i] = heap[--heapSize];
+        if (i < heapSize) {
+            siftUp(i);
+            siftDown(i);
+        }
+        return;
+    }
+}
+
+void JobScheduler::trigger(int id) {
+    if (id < 0 || id >= jobCount) {
+        return;
+    }
+    Job& job = jobs[id];
+    uint32_t earliest = job.lastRun + job.minSpacingMs;
+    uint32_t now = millis();
+    uint32_t runAt = due(earliest, now) ? now : earliest;
+    if ((int32_t)(runAt - job.nextRun) >= 0) {
+        return;  // Déjà prévue plus tôt
+    }
+    remove(id);
+    job.nextRun = runAt;
+    push(id);
+}
+
+void JobScheduler::runDue() {
+    uint32_t passStart = millis();
+    while (heapSize > 0 && due(jobs[heap[0]].nextRun, millis())) {
+        if (millis() - passStart >= SCHED_PASS_BUDGET_MS) {
+            passesCut++;  // Le reste attend le tour suivant de loop()
+            return;
+        }
+
+        int id = pop();
+        Job& job = jobs[id];
+        uint32_t start = millis();
+        uint32_t delayMs = job.run(job.ctx);
+        uint32_t elapsed = millis() - start;
+
+        job.lastRun = start;
+        job.lastDurationMs = elapsed;
+        if (elapsed > job.maxDurationMs) job.maxDurationMs = elapsed;
+        job.runs++;
+        if (elapsed > job.budgetMs) {
+            job.overruns++;
+            Serial.printf("[Sched] %s took %u ms (budget %u ms)\n", job.name, elapsed, job.budgetMs);
+        }
+
+        // Depuis le début de l'exécution : la cadence ne dérive pas avec la durée
+        if (delayMs == SCHED_USE_PERIOD) delayMs = job.periodMs;
+        job.nextRun = start + delayMs;
+        push(id);
+    }
+}
+
+void JobScheduler::printJobs() {
+    uint32_t now = millis();
+    Serial.printf("\n=== Jobs (%d, %u pass(es) cut at %d ms) ===\n", jobCount, passesCut, SCHED_PASS_BUDGET_MS);
+    Serial.println("job          prio  period    next   last   max  budget    runs  over");
+    for (int i = 0; i < jobCount; i++) {
+        const Job& job = jobs[i];
+        int32_t next = (int32_t)(job.nextRun - now);
+        Serial.printf("%-12s %4u %7u %7ld %6u %5u %7u %7u %5u\n", job.name, job.priority, job.periodMs,
+                      next > 0 ? (long)next : 0L, job.lastDurationMs, job.maxDurationMs, job.budgetMs, job.runs,
+                      job.overruns);
+    }
+    Serial.println("(times in ms)\n");
+}
@@ -0,0 +1,97 @@
+#include "json_arena.h"
+
+// Chaque bloc est précédé de sa taille, pour que reallocate() sache combien copier
+#define JSON_ARENA_HEADER   JSON_ARENA_ALIGN
+#define JSON_ARENA_NONE     ((size_t)-1)
+
+static inline size_t alignUp(size_t value) {
+    return (value + JSON_ARENA_ALIGN - 1) & ~(size_t)(JSON_ARENA_ALIGN - 1);
+}
+
+JsonArena::JsonArena(void* buffer, size_t capacity) {
+    failed = 0;
+    peakOffset = 0;
+    attach(buffer, capacity);
+}
+
+void JsonArena::attach(void* buffer, size_t capacity) {
+    // Début aligné : les blocs rendus le sont aussi
+    uintptr_t start = (uintptr_t)buffer;
+    uintptr_t aligned = alignUp(start);
+    if (buffer == nullptr || capacity < aligned - start) {
+        base = nullptr;
+        size = 0;
+    } else {
+        base = (uint8_t*)aligned;
+        size = (capacity - (aligned - start)) & ~(size_t)(JSON_ARENA_ALIGN - 1);
+    }
+    offset = 0;
+    lastBlock = JSON_ARENA_NONE;
+    live = 0;
+}
+
+void* JsonArena::allocate(size_t blockSize) {
+    size_t needed = JSON_ARENA_HEADER + alignUp(blockSize);
+    if (base == nullptr || needed > size - offset) {
+        failed++;
+        return nullptr;
+    }
+    size_t header = offset;
+    *(size_t*)(base + header) = blockSize;
+    offset += needed;
+    if (offset > peakOffset) peakOffset = offset;
+    lastBlock = header;
+    live++;
+    return base + header + JSON_ARENA_HEADER;
+}
+
+void JsonArena::deallocate(void* ptr) {
+    if (ptr == nullptr || live == 0) {
+        return;
+    }
+    size_t header = (uint8_t*)ptr - base - JSON_ARENA_HEADER;
+    if (header == lastBlock) {
+        // Dernier bloc : sa place est reprise tout de suite
+        offset = header;
+        lastBlock = JSON_ARENA_NONE;
+    }
+    // Les autres restent occupés jusqu'à ce que le document soit vidé
+    if (--live == 0) {
+        offset = 0;
+        lastBlock = JSON_ARENA_NONE;
+    }
+}
+
+void* JsonArena::reallocate(void* ptr, size_t newSize) {
+    if (ptr == nullptr) {
+        return allocate(newSize);
+    }
+    size_t header = (uint8_t*)ptr - base - JSON_ARENA_HEADER;
+    size_t oldSize = *(size_t*)(base + header);
+
+    if (header == lastBlock) {
+        // Dernier bloc (pool en cours de remplissage, chaîne en construction) :
+        // agrandi ou réduit sur place
+        size_t end = header + JSON_ARENA_HEADER + alignUp(newSize);
+        if (end > size) {
+            failed++;
+            return nullptr;
+        }
+        *(size_t*)(base + header) = newSize;
+        offset = end;
+        if (offset > peakOffset) peakOffset = offset;
+        return ptr;
+    }
+    if (newSize <= oldSize) {
+        *(size_t*)(base + header) = newSize;
+        return ptr;
+    }
+
+    void* moved = allocate(newSize);
+    if (moved == nullptr) {
+        return nullptr;
+    }
+    memcpy(moved, ptr, oldSize);
+    live--;   // L'ancien bloc est abandonné (jamais le dernier ici)
+    return moved;
+}
@@ -0,0 +1,115 @@
+#include "json_key_scanner.h"
+
+JsonKeyScanner::JsonKeyScanner(const char* const* keys, int keyCount, char* buffer, size_t capacity)
+    : keys(keys), keyCount(keyCount), buffer(buffer), capacity(capacity) {
+    reset();
+}
+
+void JsonKeyScanner::reset() {
+    depth = 0;
+    inString = false;
+    escape = false;
+    readingKey = false;
+    keyDone = false;
+    expectKey = false;
+    key[0] = '\0';
+    keyLen = 0;
+    target = -1;
+    capturing = false;
+    overflow = false;
+    captureLen = 0;
+}
+
+// Seules la profondeur et les chaînes sont suivies : la valeur d'une clé
+// reconnue au premier niveau est copiée telle quelle dans buffer, et signalée
+// quand son crochet fermant arrive.
+int JsonKeyScanner::feed(char c) {
+    if (capturing) {
+        if (captureLen < capacity - 1) {
+            buffer[captureLen++] = c;
+        } else {
+            overflow = true;
+        }
+    }
+
+    if (inString) {
+        if (escape) {
+            escape = false;
+        } else if (c == '\\') {
+            escape = true;
+            return -1;
+        } else if (c == '"') {
+            inString = false;
+            if (readingKey) {
+                readingKey = false;
+                keyDone = true;
+                key[keyLen] = '\0';
+            }
+            return -1;
+        }
+        if (readingKey && keyLen < JSON_SCANNER_KEY_LEN - 1) {
+            key[keyLen++] = c;
+        }
+        return -1;
+    }
+
+    switch (c) {
+        case '"':
+            inString = true;
+            if (depth == 1 && expectKey) {
+                readingKey = true;
+                expectKey = false;
+                keyLen = 0;
+            }
+            break;
+
+        case ':':
+            if (depth == 1 && keyDone) {
+                keyDone = false;
+                target = -1;
+                for (int i = 0; i < keyCount; i++) {
+                    if (strcmp(key, keys[i]) == 0) {
+                        target = i;
+                        break;
+                    }
+                }
+            }
+            break;
+
+        case '{':
+        case '[':
+            if (depth == 1 && target >= 0 && !capturing) {
+                capturing = true;
+                overflow = false;
+                buffer[0] = c;
+                captureLen = 1;
+            }
+            depth++;
+            if (depth == 1) {
+                expectKey = c == '{';
+            }
+            break;
+
+        case '}':
+        case ']':
+            if (depth > 0) {
+                depth--;
+            }
+            if (capturing && depth == 1) {
+                capturing = false;
+                buffer[captureLen] = '\0';
+                int done = target;
+                target = -1;
+                return done;
+            }
+            break;
+
+        case ',':
+            if (depth == 1) {
+                expectKey = true;
+                target = -1;
+            }
+            break;
+    }
+    return -1;
+}
@@ -11,6 +11,18 @@
 #include "wifi_manager.h"
 #include "weather_manager.h"
 #include "bitcoin_api.h"
+#include "external_http.h"
+#include "miner_poller.h"
+#include "miner_connection_pool.h"
+#include "socket_budget.h"
+#include "miner_request_coalescer.h"
+#include "fleet_command_queue.h"
+#include "miner_discovery.h"
+#include "pool_stats_source.h"
+#include "miner_telemetry.h"
+#include "chain_feed.h"
+#include "price_providers.h"
+#include "job_scheduler.h"
 
 static esp_lcd_panel_handle_t panel_handle = NULL;
 static lv_display_t *disp = NULL;
@@ -88,6 +100,138 @@ static void touchpad_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
     }
 }
 
+// ===== Tâches périodiques de loop() (JobScheduler) =====
+static uint32_t loop_count = 0;
+static int bitcoin_job = -1;
+static bool bitcoin_price_flow = false;   // Prix en cours (BitcoinAPI::stepPrice)
+static bool bitcoin_block_flow = false;   // Chaîne des blocs en cours (BitcoinAPI::stepBlockData)
+static bool bitcoin_resync = false;       // Bloc poussé illisible : chaîne REST même si le flux vit
+#define BITCOIN_STEP_MS  20               // Reprise des flux en attente du worker
+static bool weather_first_fetch = true;
+
+static uint32_t clockJob(void* ctx) {
+    UI::getInstance().updateClock();
+    return SCHED_USE_PERIOD;
+}
+
+// Appliquer les résultats déjà publiés par le poller (aucune requête réseau ici).
+// Le polling des Bitaxe est planifié par mineur sur le cœur 0 (MinerPoller).
+static uint32_t minerStatusJob(void* ctx) {
+    UI::getInstance().checkBitaxeStatus();
+    return SCHED_USE_PERIOD;
+}
+
+static uint32_t minersRefreshJob(void* ctx) {
+    if (!WifiManager::getInstance()->isAPMode()) {
+        UI::getInstance().refreshMinersIfActive();
+    }
+    return SCHED_USE_PERIOD;
+}
+
+// Prix et blocs : 60 s avec 3+ Bitaxe, 30 s sinon ; un flux WebSocket vivant
+// remplace la requête correspondante
+static uint32_t bitcoinJob(void* ctx) {
+    if (WifiManager::getInstance()->isAPMode() || !WifiManager::getInstance()->isConnected()) {
+        return 1000;  // Premier fetch dès que le WiFi est connecté
+    }
+    uint32_t interval = (WifiManager::getInstance()->getBitaxeCount() > 2) ? 60000 : 30000;
+
+    // Les requêtes tournent sur le cœur 0 : ici on ne fait que reprendre les flux
+    // jusqu'à leur fin, LVGL et le tactile passent entre deux reprises
+    if (!bitcoin_block_flow) {
+        if (!bitcoin_price_flow && !ChainFeed::getInstance()->isPriceLive()) {
+            bitcoin_price_flow = true;
+        }
+        if (bitcoin_price_flow) {
+            if (BitcoinAPI::getInstance().stepPrice() == CO_RUNNING) {
+                return BITCOIN_STEP_MS;
+            }
+            bitcoin_price_flow = false;
+        }
+        if (ChainFeed::getInstance()->isChainLive() && !bitcoin_resync) {
+            BitcoinAPI::getInstance().refreshBlockAge();
+            UI::getInstance().updateBitcoinPrice();
+            return interval;
+        }
+        bitcoin_resync = false;
+        bitcoin_block_flow = true;
+    }
+    if (BitcoinAPI::getInstance().stepBlockData() == CO_RUNNING) {
+        return BITCOIN_STEP_MS;
+    }
+    bitcoin_block_flow = false;
+    UI::getInstance().updateBitcoinPrice();
+    return interval;
+}
+
+static uint32_t chainFeedJob(void* ctx) {
+    // Données poussées (nouveau bloc, prix, fees) : affichées dès leur arrivée
+    bool resync = false;
+    if (ChainFeed::getInstance()->applyTo(BitcoinAPI::getInstance(), resync)) {
+        UI::getInstance().updateBitcoinPrice();
+    }
+    // Rattrapage par la chaîne REST pas à pas, jamais bloquant ici
+    if (resync) {
+        bitcoin_resync = true;
+        JobScheduler::getInstance()->trigger(bitcoin_job);
+    }
+
+    // Flux tombé : le polling reprend sans attendre la fin de l'intervalle
+    static bool chain_was_live = false;
+    static bool price_was_live = false;
+    bool chain_live = ChainFeed::getInstance()->isChainLive();
+    bool price_live = ChainFeed::getInstance()->isPriceLive();
+    if ((chain_was_live && !chain_live) || (price_was_live && !price_live)) {
+        JobScheduler::getInstance()->trigger(bitcoin_job);
+    }
+    chain_was_live = chain_live;
+    price_was_live = price_live;
+    return SCHED_USE_PERIOD;
+}
+
+// Weather: 24 h forecast kept locally, refreshed twice a day by WeatherManager.
+// Checked every minute so the display advances hour by hour without network.
+// La requête tourne dans le worker de WeatherManager : le job ne fait que la
+// lancer, puis repasse chaque seconde jusqu'à recopier la nouvelle prévision.
+static uint32_t weatherJob(void* ctx) {
+    // First fetch immediately after WiFi connection (apMode reste vrai pendant la connexion)
+    if (weather_first_fetch && !WifiManager::getInstance()->isConnected()) {
+        return 1000;
+    }
+    if (WifiManager::getInstance()->isAPMode()) {
+        return SCHED_USE_PERIOD;
+    }
+    weather_first_fetch = false;
+    WeatherManager* weather = WeatherManager::getInstance();
+    weather->updateWeather();
+    UI::getInstance().updateWeatherDisplay();
+    return weather->isFetching() ? 1000 : SCHED_USE_PERIOD;
+}
+
+// *** MONITORING: Print CPU and RAM usage every 2 seconds (instead of 1) for high load ***
+static uint32_t monitorJob(void* ctx) {
+    int bitaxeCount = WifiManager::getInstance()->getBitaxeCount();
+    Serial.printf("[MONITOR] Loops/sec: %lu, Free RAM: %lu bytes (%.1f%% used), Bitaxe: %d\n", 
+                 loop_count, 
+                 (unsigned long)ESP.getFreeHeap(), 
+                 100.0f - (ESP.getFreeHeap() / 327680.0f * 100.0f),
+                 bitaxeCount);
+    loop_count = 0;
+    return (bitaxeCount > 2) ? 2000 : 1000;  // 2s for 3+ devices, 1s for fewer
+}
+
+static void registerJobs() {
+    JobScheduler* sched = JobScheduler::getInstance();
+    // Arguments : nom, fonction, ctx, période, priorité, budget, espacement minimal, premier délai (ms)
+    sched->addJob("clock", clockJob, nullptr, 1000, 0, 50);
+    sched->addJob("miner_status", minerStatusJob, nullptr, 100, 1, 50);
+    sched->addJob("chain_feed", chainFeedJob, nullptr, 100, 2, 100);
+    sched->addJob("miners_ui", minersRefreshJob, nullptr, 20000, 3, 100, 0, 20000);
+    bitcoin_job = sched->addJob("bitcoin", bitcoinJob, nullptr, 30000, 4, 100, 10000);
+    sched->addJob("weather", weatherJob, nullptr, 60000, 5, 100, 30000);
+    sched->addJob("monitor", monitorJob, nullptr, 1000, 6, 10, 0, 1000);
+}
+
 void setup() {
     Serial.begin(115200);
     delay(2000); // Attendre que le port USB CDC soit prêt
@@ -268,6 +412,14 @@ void setup() {
         UI::getInstance().showClockScreen();
     });
     
+    // Démarrer le poller des mineurs (tâche FreeRTOS sur le cœur 0)
+    Serial.println("Starting MinerPoller...");
+    MinerPoller::getInstance()->begin(POLLER_DEFAULT_IN_FLIGHT);
+    FleetCommandQueue::getInstance()->begin();
+    MinerDiscovery::getInstance()->begin();
+    PoolStatsSource::getInstance()->begin();
+    MinerTelemetry::getInstance()->begin();
+    
     // Initialiser le TimeManager (NTP) - WiFiManager s'occupera de la connexion
     Serial.println("Initializing TimeManager...");
     TimeManager::getInstance()->init();
@@ -275,18 +427,20 @@ void setup() {
     // Initialiser le BitcoinAPI
     Serial.println("Initializing BitcoinAPI...");
     BitcoinAPI::getInstance().begin();
+    ChainFeed::getInstance()->begin();
     
     // Initialiser le WeatherManager
     Serial.println("Initializing WeatherManager...");
     WeatherManager::getInstance()->init();
     
+    // Tâches périodiques de loop()
+    registerJobs();
+    
     Serial.println("\n=== SETUP COMPLETE ===\n");
 }
 
 void loop() {
     // *** MONITORING: Track CPU usage and RAM ***
-    static uint32_t loop_count = 0;
-    static uint32_t last_monitor_time = 0;
     loop_count++;
     
     // Get bitaxe count for optimizations
@@ -303,8 +457,44 @@ void loop() {
             Serial.printf("WiFi SSID: %s\n", WifiManager::getInstance()->getSSID().c_str());
             Serial.printf("IP Address: %s\n", WifiManager::getInstance()->getIP().c_str());
             Serial.printf("Web Server: %s\n", WifiManager::getInstance()->isWebServerRunning() ? "Running" : "Stopped");
+            Serial.printf("Poller: %u poll(s), %d/%d request(s) in flight, cycle %u ms (avg %u ms)\n",
+                          MinerPoller::getInstance()->getTotalPolls(),
+                          MinerPoller::getInstance()->getInFlight(),
+                          MinerPoller::getInstance()->getMaxInFlight(),
+                          MinerPoller::getInstance()->getLastCycle(),
+                          MinerPoller::getInstance()->getAvgCycle());
+            MinerConnectionPool::getInstance()->printStats();
+            MinerRequestCoalescer::getInstance()->printStats();
+            PoolSourceStatus poolSource;
+            if (PoolStatsSource::getInstance()->getStatus(poolSource) && poolSource.enabled) {
+                Serial.printf("Pool source: %u fetch(es), %u error(s), %d worker(s), %d miner(s) covered, last %lu s ago\n",
+                              poolSource.fetches, poolSource.errors, poolSource.workers, poolSource.matched,
+                              poolSource.lastFetchAt ? (millis() - poolSource.lastFetchAt) / 1000 : 0);
+            }
+            TelemetryStatus telemetry;
+            if (MinerTelemetry::getInstance()->getStatus(telemetry) && telemetry.enabled) {
+                Serial.printf("Telemetry: %d/%d socket(s) live, %u message(s), %u share(s), %u connect(s)\n",
+                              telemetry.live, TELEMETRY_MAX_SOCKETS, telemetry.messages, telemetry.shares,
+                              telemetry.reconnects);
+            }
+            ChainFeedStatus feed;
+            if (ChainFeed::getInstance()->getStatus(feed) && feed.enabled) {
+                Serial.printf("Chain feed: mempool %s (%u msg, %u block(s)), ticker %s (%u msg), %u dropped, %u connect(s)\n",
+                              feed.chainLive ? "live" : "polling", feed.chainMessages, feed.blocks,
+                              feed.priceLive ? "live" : "polling", feed.priceMessages, feed.dropped, feed.reconnects);
+            }
+            PriceProviders::getInstance()->printStats();
+            ExternalHttp::getInstance()->printStats();
+            SocketBudget::getInstance()->printStats();
+            Serial.printf("Block cache: %u hit(s)\n", BitcoinAPI::getInstance().getBlockCacheHits());
             WifiManager::getInstance()->printBitaxeConfig();
         }
+        else if (cmd == "sched") {
+            MinerPoller::getInstance()->printSchedule();
+        }
+        else if (cmd == "jobs") {
+            JobScheduler::getInstance()->printJobs();
+        }
         else if (cmd == "clear") {
             WifiManager::getInstance()->clearAllBitaxes();
         }
@@ -321,6 +511,8 @@ void loop() {
         else if (cmd == "help") {
             Serial.println("\n=== TouchAxe Serial Commands ===");
             Serial.println("status   - Show WiFi and Bitaxe status");
+            Serial.println("sched    - Show per-miner poll schedule and cost");
+            Serial.println("jobs     - Show loop jobs: next run and last duration");
             Serial.println("clear    - Clear all Bitaxe devices");
             Serial.println("reset    - Reset WiFi config and restart in AP mode");
             Serial.println("webstop  - Stop web server to save CPU/RAM");
@@ -339,12 +531,9 @@ void loop() {
     // Update TimeManager
     TimeManager::getInstance()->update();
     
-    // Simple timer for clock update (bypass LVGL timer issues)
-    static uint32_t last_clock_update = 0;
-    if (millis() - last_clock_update > 1000) {
-        last_clock_update = millis();
-        UI::getInstance().updateClock();
-    }
+    // Horloge, mineurs, Bitcoin, météo et monitoring : tâches échues du JobScheduler.
+    // Une passe rend la main après SCHED_PASS_BUDGET_MS pour laisser tourner LVGL.
+    JobScheduler::getInstance()->runDue();
     
     // ANIMATION MANUELLE des carrés - SEULEMENT sur Clock screen !
     // Désactivée automatiquement sur Miners pour meilleures performances
@@ -353,84 +542,6 @@ void loop() {
         UI::getInstance().updateFallingSquares();
     }
     
-    // Check Bitaxe status every 30 seconds (instead of 15) - REDUCED FREQUENCY
-    // (skip sur Miners pour éviter conflits HTTP)
-    static uint32_t last_bitaxe_check = 0;
-    static uint8_t consecutive_errors = 0;
-    if (!WifiManager::getInstance()->isAPMode() && millis() - last_bitaxe_check > 30000) {  // 30s instead of 15s
-        last_bitaxe_check = millis();
-        
-        // PROTECTION: Limit concurrent HTTP requests to prevent overload
-        if (bitaxeCount > 3) {
-            // For 4+ devices, increase interval to 45 seconds
-            if (millis() - last_bitaxe_check < 45000) {
-                return;  // Skip this check
-            }
-            last_bitaxe_check = millis();
-        }
-        
-        UI::getInstance().checkBitaxeStatus();  // Cette fonction vérifie déjà current_screen
-        bool success = true;  // Assume success for now - could be improved with return value
-        if (!success) {
-            consecutive_errors++;
-            if (consecutive_errors >= 3) {
-                Serial.println("[MAIN] Too many consecutive errors, increasing check interval to 60s");
-                // Next check will be delayed further
-            }
-        } else {
-            consecutive_errors = 0;
-        }
-    }
-    
-    // Refresh Miners screen data every 20 seconds (instead of 10) - REDUCED FREQUENCY
-    static uint32_t last_miners_refresh = 0;
-    if (!WifiManager::getInstance()->isAPMode() && millis() - last_miners_refresh > 20000) {  // 20s instead of 10s
-        last_miners_refresh = millis();
-        UI::getInstance().refreshMinersIfActive();
-    }
-    
-    // Fetch Bitcoin price every 60 seconds (instead of 30) when multiple Bitaxe - REDUCED FREQUENCY
-    static uint32_t last_bitcoin_fetch = 0;
-    static bool bitcoin_first_fetch = true;
-    if (!WifiManager::getInstance()->isAPMode()) {
-        uint32_t bitcoin_interval = (bitaxeCount > 2) ? 60000 : 30000;  // 60s for 3+ devices, 30s for fewer
-        
-        // First fetch immediately after WiFi connection
-        if (bitcoin_first_fetch && WifiManager::getInstance()->isConnected()) {
-            bitcoin_first_fetch = false;
-            last_bitcoin_fetch = millis();
-            BitcoinAPI::getInstance().fetchPrice();
-            BitcoinAPI::getInstance().fetchBlockData();
-            UI::getInstance().updateBitcoinPrice();
-        }
-        // Then fetch at reduced frequency
-        else if (millis() - last_bitcoin_fetch > bitcoin_interval) {
-            last_bitcoin_fetch = millis();
-            BitcoinAPI::getInstance().fetchPrice();
-            BitcoinAPI::getInstance().fetchBlockData();
-            UI::getInstance().updateBitcoinPrice();
-        }
-    }
-    
-    // Fetch weather data every 30 minutes (1800000ms) - Open-Meteo free tier
-    static uint32_t last_weather_fetch = 0;
-    static bool weather_first_fetch = true;
-    if (!WifiManager::getInstance()->isAPMode()) {
-        // First fetch immediately after WiFi connection
-        if (weather_first_fetch && WifiManager::getInstance()->isConnected()) {
-            weather_first_fetch = false;
-            last_weather_fetch = millis();
-            WeatherManager::getInstance()->updateWeather();
-            UI::getInstance().updateWeatherDisplay();
-        }
-        // Then fetch every 30 minutes
-        else if (millis() - last_weather_fetch > 1800000) {
-            last_weather_fetch = millis();
-            WeatherManager::getInstance()->updateWeather();
-            UI::getInstance().updateWeatherDisplay();
-        }
-    }
-    
     // *** OPTIMIZED: Call lv_timer_handler() every 2ms instead of every millisecond ***
     // LVGL recommends 5-10ms intervals for smooth operation with much better CPU efficiency
     static uint32_t last_lvgl_call = 0;
@@ -457,18 +568,4 @@ void loop() {
     // *** OPTIMIZED: Small delay to prevent CPU overload while maintaining responsiveness ***
     // ESP32-S3 @ 240MHz can handle this, but prevents excessive power consumption
     delayMicroseconds(25);  // 0.025ms delay = ~40kHz loop rate (ultra responsive)
-    
-    // *** MONITORING: Print CPU and RAM usage every 2 seconds (instead of 1) for high load ***
-    uint32_t monitor_interval = (bitaxeCount > 2) ? 2000 : 1000;  // 2s for 3+ devices, 1s for fewer
-    
-    if (millis() - last_monitor_time >= monitor_interval) {
-        last_monitor_time = millis();
-        Serial.printf("[MONITOR] Loops/sec: %lu, Free RAM: %lu bytes (%.1f%% used), Bitaxe: %d\n", 
-                     loop_count, 
-                     (unsigned long)ESP.getFreeHeap(), 
-                     100.0f - (ESP.getFreeHeap() / 327680.0f * 100.0f),
-                     bitaxeCount);
-        loop_count = 0;
-    }
 }
-
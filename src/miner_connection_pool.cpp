@@ -0,0 +1,159 @@
+#include "miner_connection_pool.h"
+#include "socket_budget.h"
+
+MinerConnectionPool* MinerConnectionPool::instance = nullptr;
+
+MinerConnectionPool::MinerConnectionPool() {
+    mutex = xSemaphoreCreateMutex();
+    for (int i = 0; i < POOL_MAX_CONNECTIONS; i++) {
+        slots[i].host[0] = '\0';
+        slots[i].busy = false;
+        slots[i].counted = false;
+        slots[i].lastUsed = 0;
+    }
+    opened = 0;
+    reused = 0;
+    stale = 0;
+    evicted = 0;
+}
+
+MinerConnectionPool* MinerConnectionPool::getInstance() {
+    if (!instance) {
+        instance = new MinerConnectionPool();
+    }
+    return instance;
+}
+
+void MinerConnectionPool::closeSlotLocked(PooledConnection& slot) {
+    slot.client.stop();
+    if (slot.counted) {
+        SocketBudget::getInstance()->release(SOCKET_MINERS);
+        slot.counted = false;
+    }
+}
+
+void MinerConnectionPool::evictIdleLocked(uint32_t now) {
+    for (int i = 0; i < POOL_MAX_CONNECTIONS; i++) {
+        PooledConnection& slot = slots[i];
+        if (slot.host[0] == '\0' || slot.busy) continue;
+        if (now - slot.lastUsed >= POOL_IDLE_TIMEOUT_MS) {
+            if (slot.client.connected()) {
+                evicted++;
+            }
+            closeSlotLocked(slot);
+            slot.host[0] = '\0';
+        }
+    }
+}
+
+WiFiClient* MinerConnectionPool::acquire(const char* host) {
+    if (host[0] == '\0' || strlen(host) >= sizeof(slots[0].host)) {
+        return nullptr;
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    uint32_t now = millis();
+    evictIdleLocked(now);
+
+    int open = -1;
+    int sameHostIdle = -1;
+    int sameHost = 0;
+    int freeSlot = -1;
+    int oldestIdle = -1;
+    for (int i = 0; i < POOL_MAX_CONNECTIONS; i++) {
+        PooledConnection& slot = slots[i];
+        if (slot.host[0] == '\0') {
+            if (freeSlot < 0) freeSlot = i;
+            continue;
+        }
+        if (strcmp(slot.host, host) == 0) {
+            sameHost++;
+            if (!slot.busy) {
+                if (slot.client.connected()) {
+                    open = i;
+                    break;
+                }
+                sameHostIdle = i;
+            }
+        }
+        if (!slot.busy && (oldestIdle < 0 || slot.lastUsed < slots[oldestIdle].lastUsed)) {
+            oldestIdle = i;
+        }
+    }
+
+    int chosen = open;
+    if (chosen < 0) chosen = sameHostIdle;   // Connexion morte vers le même hôte : on la rouvre
+    if (chosen < 0 && sameHost < POOL_MAX_PER_HOST) {
+        chosen = freeSlot;
+        // Pool plein : fermer la connexion inactive la plus ancienne
+        if (chosen < 0 && oldestIdle >= 0) {
+            chosen = oldestIdle;
+            closeSlotLocked(slots[chosen]);
+        }
+    }
+
+    WiFiClient* client = nullptr;
+    if (chosen >= 0) {
+        PooledConnection& slot = slots[chosen];
+        if (chosen != open) {
+            closeSlotLocked(slot);
+            strcpy(slot.host, host);
+        }
+        slot.busy = true;
+        slot.lastUsed = now;
+        client = &slot.client;
+    }
+
+    xSemaphoreGive(mutex);
+    return client;
+}
+
+void MinerConnectionPool::release(WiFiClient* client) {
+    if (client == nullptr) {
+        return;
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    for (int i = 0; i < POOL_MAX_CONNECTIONS; i++) {
+        PooledConnection& slot = slots[i];
+        if (&slot.client != client) continue;
+        slot.busy = false;
+        slot.lastUsed = millis();
+        if (!slot.client.connected()) {
+            closeSlotLocked(slot);
+            slot.host[0] = '\0';
+        }
+        break;
+    }
+    xSemaphoreGive(mutex);
+}
+
+void MinerConnectionPool::markOpened(WiFiClient* client) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    for (int i = 0; i < POOL_MAX_CONNECTIONS; i++) {
+        if (&slots[i].client == client) {
+            slots[i].counted = true;
+            opened++;
+            break;
+        }
+    }
+    xSemaphoreGive(mutex);
+}
+
+void MinerConnectionPool::printStats() {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    int openCount = 0;
+    int busyCount = 0;
+    for (int i = 0; i < POOL_MAX_CONNECTIONS; i++) {
+        if (slots[i].host[0] == '\0') continue;
+        if (slots[i].busy) busyCount++;
+        else if (slots[i].client.connected()) openCount++;
+    }
+    xSemaphoreGive(mutex);
+
+    uint32_t total = opened + reused;
+    Serial.printf("Miner connections: %d idle open, %d busy / %d | opened %u, reused %u (%.0f%%), stale %u, evicted %u\n",
+                  openCount, busyCount, POOL_MAX_CONNECTIONS,
+                  opened, reused, total > 0 ? reused * 100.0f / total : 0.0f,
+                  stale, evicted);
+}
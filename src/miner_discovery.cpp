@@ -0,0 +1,489 @@
+#include "miner_discovery.h"
+#include "wifi_manager.h"
+#include "socket_budget.h"
+#include <lwip/sockets.h>
+
+MinerDiscovery* MinerDiscovery::instance = nullptr;
+
+enum DiscoveryJobKind : uint8_t {
+    JOB_IDENTIFY,   // Hôte trouvé par le balayage
+    JOB_PROBE       // Test demandé par le portail
+};
+
+struct DiscoveryJob {
+    uint32_t ip;
+    uint16_t connectMs;
+    DiscoveryJobKind kind;
+};
+
+// Connexion en cours pendant le balayage
+struct SweepSlot {
+    int fd;
+    uint32_t host;      // Ordre hôte
+    uint32_t startedAt;
+};
+
+static uint32_t toHostOrder(const IPAddress& ip) {
+    return ((uint32_t)ip[0] << 24) | ((uint32_t)ip[1] << 16) | ((uint32_t)ip[2] << 8) | ip[3];
+}
+
+static IPAddress fromHostOrder(uint32_t host) {
+    return IPAddress((host >> 24) & 0xFF, (host >> 16) & 0xFF, (host >> 8) & 0xFF, host & 0xFF);
+}
+
+MinerDiscovery::MinerDiscovery() {
+    mutex = xSemaphoreCreateMutex();
+    sweepTask = nullptr;
+    worker = nullptr;
+    jobs = nullptr;
+    events = nullptr;
+    eventQueue = xQueueCreate(DISCOVERY_EVENT_QUEUE_LEN, sizeof(DiscoveryEvent));
+    droppedEvents = 0;
+
+    capacity = fleetCapacity();
+    found = fleetAllocArray<DiscoveredMiner>(capacity);
+    if (found == nullptr) {
+        capacity = 0;
+    }
+    memset(&progress, 0, sizeof(progress));
+    sweepDone = true;
+    pendingJobs = 0;
+    startedAt = 0;
+
+    for (int i = 0; i < DISCOVERY_PROBE_SLOTS; i++) {
+        probes[i].ip = 0;
+        probes[i].state = PROBE_FREE;
+        probes[i].finishedAt = 0;
+    }
+}
+
+MinerDiscovery* MinerDiscovery::getInstance() {
+    if (!instance) {
+        instance = new MinerDiscovery();
+    }
+    return instance;
+}
+
+void MinerDiscovery::begin() {
+    if (jobs != nullptr) {
+        return;  // Déjà démarré
+    }
+    jobs = xQueueCreate(DISCOVERY_QUEUE_LEN, sizeof(DiscoveryJob));
+    xTaskCreatePinnedToCore(workerTaskEntry, "discovery_id", DISCOVERY_WORKER_STACK, this, 1, &worker, DISCOVERY_TASK_CORE);
+    Serial.println("[Discovery] Worker started on core 0");
+}
+
+bool MinerDiscovery::start() {
+    if (jobs == nullptr || capacity == 0) {
+        return false;
+    }
+    if (!WifiManager::getInstance()->isConnected()) {
+        Serial.println("[Discovery] Not connected, scan refused");
+        return false;
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    if (progress.running) {
+        xSemaphoreGive(mutex);
+        return false;
+    }
+    uint32_t scan = progress.scan + 1;
+    memset(&progress, 0, sizeof(progress));
+    progress.scan = scan;
+    progress.running = true;
+    sweepDone = false;
+    pendingJobs = 0;
+    startedAt = millis();
+    xSemaphoreGive(mutex);
+    xQueueReset(eventQueue);  // Restes d'un balayage sans portail ouvert
+
+    if (xTaskCreatePinnedToCore(sweepTaskEntry, "discovery", DISCOVERY_TASK_STACK, this, 1, &sweepTask, DISCOVERY_TASK_CORE) != pdPASS) {
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        progress.running = false;
+        sweepDone = true;
+        xSemaphoreGive(mutex);
+        return false;
+    }
+    return true;
+}
+
+void MinerDiscovery::sweepTaskEntry(void* arg) {
+    MinerDiscovery* self = (MinerDiscovery*)arg;
+    self->sweep();
+    self->sweepTask = nullptr;
+    vTaskDelete(nullptr);
+}
+
+void MinerDiscovery::sweep() {
+    uint32_t self = toHostOrder(WiFi.localIP());
+    uint32_t mask = toHostOrder(WiFi.subnetMask());
+    // Au plus un /24 autour de notre adresse : un /16 prendrait des minutes
+    if (mask < 0xFFFFFF00) {
+        mask = 0xFFFFFF00;
+    }
+    uint32_t network = self & mask;
+    uint32_t first = network + 1;
+    uint32_t last = (network | ~mask) - 1;
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    progress.total = last - first;  // Sans notre propre adresse
+    xSemaphoreGive(mutex);
+    SocketBudget* budget = SocketBudget::getInstance();
+    Serial.printf("[Discovery] Scanning %s - %s (%d hosts, %d/%d sockets available)\n",
+                  fromHostOrder(first).toString().c_str(), fromHostOrder(last).toString().c_str(),
+                  progress.total, min(budget->available(SOCKET_DISCOVERY), DISCOVERY_MAX_SOCKETS), DISCOVERY_MAX_SOCKETS);
+
+    SweepSlot slots[DISCOVERY_MAX_SOCKETS];
+    for (int i = 0; i < DISCOVERY_MAX_SOCKETS; i++) {
+        slots[i].fd = -1;
+    }
+    uint32_t next = first;
+    int active = 0;
+    int scanned = 0;
+
+    while (next <= last || active > 0) {
+        // Remplit les emplacements libres avec les adresses suivantes
+        for (int i = 0; i < DISCOVERY_MAX_SOCKETS && next <= last; i++) {
+            if (slots[i].fd >= 0) continue;
+            if (next == self) {
+                next++;
+                if (next > last) break;
+            }
+            // Pools pleins : le balayage se contente de sa réserve au lieu de
+            // leur prendre les sockets partagés
+            if (!budget->acquire(SOCKET_DISCOVERY)) {
+                break;
+            }
+            int fd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+            if (fd < 0) {
+                budget->release(SOCKET_DISCOVERY);
+                break;  // Plus de socket lwIP libre : on attend qu'une sonde se termine
+            }
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+            struct sockaddr_in addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(80);
+            addr.sin_addr.s_addr = htonl(next);
+            int rc = connect(fd, (struct sockaddr*)&addr, sizeof(addr));
+            if (rc < 0 && errno != EINPROGRESS) {
+                close(fd);
+                budget->release(SOCKET_DISCOVERY);
+                scanned++;
+                next++;
+                continue;
+            }
+            slots[i].fd = fd;
+            slots[i].host = next;
+            slots[i].startedAt = millis();
+            active++;
+            next++;
+        }
+        if (active == 0) {
+            vTaskDelay(pdMS_TO_TICKS(DISCOVERY_SELECT_MS));
+            continue;
+        }
+
+        // Une connexion aboutie ou refusée rend le socket inscriptible
+        fd_set writable;
+        FD_ZERO(&writable);
+        int maxFd = -1;
+        for (int i = 0; i < DISCOVERY_MAX_SOCKETS; i++) {
+            if (slots[i].fd < 0) continue;
+            FD_SET(slots[i].fd, &writable);
+            maxFd = max(maxFd, slots[i].fd);
+        }
+        struct timeval tv;
+        tv.tv_sec = 0;
+        tv.tv_usec = DISCOVERY_SELECT_MS * 1000;
+        select(maxFd + 1, nullptr, &writable, nullptr, &tv);
+
+        uint32_t now = millis();
+        for (int i = 0; i < DISCOVERY_MAX_SOCKETS; i++) {
+            SweepSlot& slot = slots[i];
+            if (slot.fd < 0) continue;
+
+            bool finished = false;
+            if (FD_ISSET(slot.fd, &writable)) {
+                int error = 0;
+                socklen_t len = sizeof(error);
+                getsockopt(slot.fd, SOL_SOCKET, SO_ERROR, &error, &len);
+                if (error == 0) {
+                    // Port 80 ouvert : à identifier par le worker
+                    DiscoveryJob job;
+                    job.ip = (uint32_t)fromHostOrder(slot.host);
+                    job.connectMs = now - slot.startedAt;
+                    job.kind = JOB_IDENTIFY;
+                    xSemaphoreTake(mutex, portMAX_DELAY);
+                    progress.responders++;
+                    pendingJobs++;
+                    xSemaphoreGive(mutex);
+                    if (xQueueSend(jobs, &job, pdMS_TO_TICKS(1000)) != pdTRUE) {
+                        xSemaphoreTake(mutex, portMAX_DELAY);
+                        pendingJobs--;
+                        xSemaphoreGive(mutex);
+                    }
+                }
+                finished = true;
+            } else if (now - slot.startedAt > DISCOVERY_CONNECT_TIMEOUT_MS) {
+                finished = true;  // Personne à cette adresse
+            }
+
+            if (finished) {
+                close(slot.fd);
+                budget->release(SOCKET_DISCOVERY);
+                slot.fd = -1;
+                active--;
+                scanned++;
+            }
+        }
+
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        progress.scanned = scanned;
+        xSemaphoreGive(mutex);
+        sendProgress(false);
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    progress.scanned = scanned;
+    sweepDone = true;
+    Serial.printf("[Discovery] Sweep done in %u ms: %d host(s) with port 80 open\n",
+                  millis() - startedAt, progress.responders);
+    finishIfIdleLocked();
+    xSemaphoreGive(mutex);
+}
+
+// Fin du balayage quand le dernier hôte a été identifié (mutex tenu)
+void MinerDiscovery::finishIfIdleLocked() {
+    if (!progress.running || !sweepDone || pendingJobs > 0) {
+        return;
+    }
+    progress.running = false;
+    progress.durationMs = millis() - startedAt;
+    Serial.printf("[Discovery] Scan #%u complete: %d miner(s) in %u ms\n",
+                  progress.scan, progress.found, progress.durationMs);
+    char json[96];
+    snprintf(json, sizeof(json), "{\"scan\":%u,\"found\":%d,\"ms\":%u}",
+             progress.scan, progress.found, progress.durationMs);
+    postEvent("done", json);
+}
+
+void MinerDiscovery::sendProgress(bool force) {
+    static uint32_t lastSent = 0;
+    if (!force && millis() - lastSent < DISCOVERY_PROGRESS_MS) {
+        return;
+    }
+    lastSent = millis();
+
+    DiscoveryProgress snapshot;
+    if (!getProgress(snapshot)) {
+        return;
+    }
+    char json[128];
+    snprintf(json, sizeof(json), "{\"scan\":%u,\"scanned\":%d,\"total\":%d,\"responders\":%d,\"found\":%d}",
+             snapshot.scan, snapshot.scanned, snapshot.total, snapshot.responders, snapshot.found);
+    postEvent("progress", json);
+}
+
+void MinerDiscovery::postEvent(const char* name, const char* data) {
+    DiscoveryEvent event;
+    strlcpy(event.name, name, sizeof(event.name));
+    strlcpy(event.data, data, sizeof(event.data));
+    // File pleine (portail fermé ou lent) : l'état reste lisible par GET /api/discovery
+    if (xQueueSend(eventQueue, &event, 0) != pdTRUE) {
+        droppedEvents++;
+    }
+}
+
+void MinerDiscovery::setEventSource(AsyncEventSource* source) {
+    events = source;
+    if (source == nullptr) {
+        return;
+    }
+    // async_tcp n'offre pas de minuterie : le poll de chaque client SSE
+    // (toutes les 500 ms) vide la file. Un message resté en attente côté
+    // bibliothèque repart au prochain ACK.
+    source->onConnect([](AsyncEventSourceClient* client) {
+        client->client()->onPoll([](void* arg, AsyncClient* tcp) {
+            MinerDiscovery::getInstance()->flushEvents();
+        }, nullptr);
+        MinerDiscovery::getInstance()->flushEvents();
+    });
+}
+
+void MinerDiscovery::flushEvents() {
+    if (events == nullptr) {
+        return;
+    }
+    DiscoveryEvent event;
+    while (xQueueReceive(eventQueue, &event, 0) == pdTRUE) {
+        events->send(event.data, event.name, millis());
+    }
+}
+
+void MinerDiscovery::workerTaskEntry(void* arg) {
+    MinerDiscovery* self = (MinerDiscovery*)arg;
+    BitaxeAPI api;
+    DiscoveryJob job;
+    for (;;) {
+        if (xQueueReceive(self->jobs, &job, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        if (job.kind == JOB_PROBE) {
+            self->runProbe(job.ip, api);
+        } else {
+            self->identify(job.ip, job.connectMs, api);
+        }
+    }
+}
+
+void MinerDiscovery::identify(uint32_t ip, uint16_t connectMs, BitaxeAPI& api) {
+    IPAddress address(ip);
+    String host = address.toString();
+
+    // Un routeur ou une imprimante répondent aussi sur le port 80 : seul un
+    // /api/system/info au format AxeOS/ESP-Miner compte
+    BitaxeStats stats;
+    api.setDevice(host.c_str());
+    bool isMiner = api.getStats(stats) && stats.valid;
+
+    bool configured = false;
+    WifiManager* wifi = WifiManager::getInstance();
+    for (int i = 0; i < wifi->getBitaxeCount(); i++) {
+        BitaxeDevice device;
+        if (wifi->copyBitaxe(i, device) && device.ip == host.c_str()) {
+            configured = true;
+            break;
+        }
+    }
+
+    int index = -1;
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    if (isMiner && progress.found < capacity) {
+        index = progress.found++;
+        DiscoveredMiner& miner = found[index];
+        miner.ip = ip;
+        miner.connectMs = connectMs;
+        miner.hostname = stats.hostname;
+        miner.version = stats.version;
+        miner.hashrate = stats.hashrate;
+    }
+    xSemaphoreGive(mutex);
+
+    if (index >= 0) {
+        Serial.printf("[Discovery] Found %s at %s (%s, %.1f GH/s)\n",
+                      stats.hostname.c_str(), host.c_str(), stats.version.c_str(), stats.hashrate);
+        JsonDocument doc;
+        doc["ip"] = host;
+        doc["hostname"] = stats.hostname.c_str();
+        doc["version"] = stats.version.c_str();
+        doc["hashrate"] = stats.hashrate;
+        doc["connectMs"] = connectMs;
+        doc["configured"] = configured;
+        char json[DISCOVERY_EVENT_LEN];
+        if (measureJson(doc) < sizeof(json)) {
+            serializeJson(doc, json, sizeof(json));
+            postEvent("found", json);
+        }
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    pendingJobs--;
+    finishIfIdleLocked();
+    xSemaphoreGive(mutex);
+    sendProgress(true);
+}
+
+MinerProbeState MinerDiscovery::probe(uint32_t ip, MinerProbe& out) {
+    if (jobs == nullptr) {
+        return PROBE_FREE;
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    int freeSlot = -1;
+    for (int i = 0; i < DISCOVERY_PROBE_SLOTS; i++) {
+        MinerProbe& slot = probes[i];
+        bool expired = slot.state == PROBE_DONE && millis() - slot.finishedAt > DISCOVERY_PROBE_TTL_MS;
+        if (expired) {
+            slot.state = PROBE_FREE;
+        }
+        if (slot.state != PROBE_FREE && slot.ip == ip) {
+            MinerProbeState state = slot.state;
+            out = slot;
+            xSemaphoreGive(mutex);
+            return state;
+        }
+        if (slot.state == PROBE_FREE && freeSlot < 0) {
+            freeSlot = i;
+        }
+    }
+    if (freeSlot < 0) {
+        xSemaphoreGive(mutex);
+        return PROBE_FREE;
+    }
+
+    probes[freeSlot].ip = ip;
+    probes[freeSlot].state = PROBE_PENDING;
+    xSemaphoreGive(mutex);
+
+    DiscoveryJob job;
+    job.ip = ip;
+    job.connectMs = 0;
+    job.kind = JOB_PROBE;
+    if (xQueueSend(jobs, &job, 0) != pdTRUE) {
+        xSemaphoreTake(mutex, portMAX_DELAY);
+        probes[freeSlot].state = PROBE_FREE;
+        xSemaphoreGive(mutex);
+        return PROBE_FREE;
+    }
+    return PROBE_PENDING;
+}
+
+void MinerDiscovery::runProbe(uint32_t ip, BitaxeAPI& api) {
+    String host = IPAddress(ip).toString();
+    BitaxeStats stats;
+    api.setDevice(host.c_str());
+
+    uint32_t start = millis();
+    bool ok = api.getStats(stats) && stats.valid;
+    uint32_t latency = millis() - start;
+    Serial.printf("[Discovery] Test %s: %s in %u ms\n", host.c_str(), ok ? "ok" : "failed", latency);
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    for (int i = 0; i < DISCOVERY_PROBE_SLOTS; i++) {
+        MinerProbe& slot = probes[i];
+        if (slot.state == PROBE_PENDING && slot.ip == ip) {
+            slot.ok = ok;
+            slot.latencyMs = latency;
+            slot.stats = stats;
+            slot.finishedAt = millis();
+            slot.state = PROBE_DONE;
+        }
+    }
+    xSemaphoreGive(mutex);
+}
+
+bool MinerDiscovery::getProgress(DiscoveryProgress& out) {
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return false;
+    }
+    out = progress;
+    if (out.running) {
+        out.durationMs = millis() - startedAt;
+    }
+    xSemaphoreGive(mutex);
+    return true;
+}
+
+bool MinerDiscovery::getFound(int index, DiscoveredMiner& out) {
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return false;
+    }
+    bool valid = index >= 0 && index < progress.found;
+    if (valid) {
+        out = found[index];
+    }
+    xSemaphoreGive(mutex);
+    return valid;
+}
@@ -0,0 +1,244 @@
+#include "miner_poller.h"
+#include "pool_stats_source.h"
+#include "miner_telemetry.h"
+#include "json_arena.h"
+
+MinerPoller* MinerPoller::instance = nullptr;
+
+MinerPoller::MinerPoller() {
+    pollerTask = nullptr;
+    for (int i = 0; i < POLLER_MAX_IN_FLIGHT; i++) {
+        workerTasks[i] = nullptr;
+    }
+    jobQueue = nullptr;
+    schedMutex = nullptr;
+    syncedGeneration = 0;
+    focusedId = MINER_ID_NONE;
+    pollAllRequested = false;
+    startedAt = 0;
+}
+
+MinerPoller* MinerPoller::getInstance() {
+    if (!instance) {
+        instance = new MinerPoller();
+    }
+    return instance;
+}
+
+void MinerPoller::begin(uint8_t inFlight) {
+    if (pollerTask != nullptr) {
+        return;  // Déjà démarré
+    }
+
+    int capacity = fleetCapacity();
+    MinerSchedule* schedule = fleetAllocArray<MinerSchedule>(capacity);
+    scheduler.begin(schedule, capacity, inFlight, millis());
+    startedAt = millis();
+
+    jobQueue = xQueueCreate(scheduler.getCapacity() > 0 ? scheduler.getCapacity() : 1, sizeof(int));
+    schedMutex = xSemaphoreCreateMutex();
+
+    for (int i = 0; i < scheduler.getMaxInFlight(); i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "poll_w%d", i);
+        xTaskCreatePinnedToCore(workerTaskEntry, name, POLLER_WORKER_STACK, this, 1, &workerTasks[i], POLLER_TASK_CORE);
+    }
+    xTaskCreatePinnedToCore(pollerTaskEntry, "poller", POLLER_TASK_STACK, this, 1, &pollerTask, POLLER_TASK_CORE);
+
+    Serial.printf("[Poller] Started on core %d with %d request(s) in flight, %d req/s budget\n",
+                  POLLER_TASK_CORE, scheduler.getMaxInFlight(), POLL_MAX_RPS);
+}
+
+void MinerPoller::requestCycle() {
+    if (pollerTask == nullptr) {
+        return;
+    }
+    pollAllRequested = true;
+    xTaskNotifyGive(pollerTask);
+}
+
+void MinerPoller::requestPoll(uint16_t id) {
+    if (pollerTask == nullptr || id == MINER_ID_NONE) {
+        return;
+    }
+    xSemaphoreTake(schedMutex, portMAX_DELAY);
+    scheduler.requestPoll(id, millis());
+    xSemaphoreGive(schedMutex);
+    xTaskNotifyGive(pollerTask);
+}
+
+void MinerPoller::pollerTaskEntry(void* arg) {
+    MinerPoller* self = (MinerPoller*)arg;
+    for (;;) {
+        // Réveillé par un tick, une requête terminée, requestCycle() ou requestPoll()
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(POLLER_TICK_MS));
+
+        WifiManager* wifi = WifiManager::getInstance();
+        if (wifi->isAPMode() || !wifi->isConnected()) {
+            continue;
+        }
+        self->syncTargets();
+        self->dispatchDue();
+    }
+}
+
+void MinerPoller::workerTaskEntry(void* arg) {
+    MinerPoller* self = (MinerPoller*)arg;
+    // Un client par worker, réutilisé d'un poll à l'autre : ses buffers gardent leur capacité
+    BitaxeAPI api;
+    // Document du worker sur une arène allouée une fois : un poll n'alloue rien
+    JsonArena arena(fleetAllocArray<uint8_t>(MINER_JSON_ARENA_BYTES), MINER_JSON_ARENA_BYTES);
+    JsonDocument scratch(&arena);
+    int slot;
+    for (;;) {
+        if (xQueueReceive(self->jobQueue, &slot, portMAX_DELAY) == pdTRUE) {
+            self->pollOne(slot, api, scratch);
+            xTaskNotifyGive(self->pollerTask);
+        }
+    }
+}
+
+// Aligne les slots sur la liste de WifiManager, par ID (l'ordre de la liste
+// n'importe pas). Ne parcourt la flotte que si la liste a changé.
+void MinerPoller::syncTargets() {
+    WifiManager* wifi = WifiManager::getInstance();
+    uint32_t configGeneration = wifi->getConfigGeneration();
+    if (configGeneration == syncedGeneration) {
+        return;
+    }
+    int count = wifi->getBitaxeCount();
+
+    xSemaphoreTake(schedMutex, portMAX_DELAY);
+    syncedGeneration = configGeneration;
+
+    for (int slot = 0; slot < scheduler.getCapacity(); slot++) {
+        const MinerSchedule& entry = scheduler.at(slot);
+        if (entry.id == MINER_ID_NONE || entry.removed) continue;
+        if (!wifi->hasBitaxe(entry.id)) {
+            scheduler.remove(slot);
+        }
+    }
+
+    // Nouveaux mineurs : interrogés tout de suite
+    uint32_t now = millis();
+    for (int i = 0; i < count; i++) {
+        BitaxeDevice device;
+        if (!wifi->copyBitaxe(i, device) || device.id == MINER_ID_NONE) continue;
+        if (scheduler.find(device.id) < 0) {
+            scheduler.add(device.id, device.ip.c_str(), now);
+        }
+    }
+
+    // Cadence normale tenable avec la part du budget qui lui revient
+    if (scheduler.updateNormalInterval()) {
+        Serial.printf("[Poller] %d miner(s): normal interval %u s for a %d req/s budget\n",
+                      count, scheduler.getNormalInterval() / 1000, POLL_MAX_RPS);
+    }
+
+    xSemaphoreGive(schedMutex);
+}
+
+// Lance les requêtes échues choisies par le PollScheduler. Entre deux
+// échéances le tick ne parcourt pas la flotte.
+void MinerPoller::dispatchDue() {
+    uint32_t now = millis();
+    bool pollAll = pollAllRequested;
+    if (!pollAll && !scheduler.hasDue(now)) {
+        return;
+    }
+    pollAllRequested = false;
+
+    int launch[POLLER_MAX_IN_FLIGHT];
+    xSemaphoreTake(schedMutex, portMAX_DELAY);
+    int count = scheduler.dispatchDue(now, pollAll, launch, POLLER_MAX_IN_FLIGHT);
+    xSemaphoreGive(schedMutex);
+
+    for (int i = 0; i < count; i++) {
+        xQueueSend(jobQueue, &launch[i], portMAX_DELAY);
+    }
+}
+
+void MinerPoller::pollOne(int slot, BitaxeAPI& api, JsonDocument& scratch) {
+    if (slot < 0 || slot >= scheduler.getCapacity()) {
+        return;
+    }
+    MinerSchedule& entry = scheduler.at(slot);
+
+    uint32_t start = millis();
+
+    // ip et fieldMap ne sont touchés que par le worker tant que inFlight est vrai
+    api.setDevice(entry.ip.c_str());
+
+    BitaxeStats stats;
+    bool success = api.getStats(stats, &entry.fieldMap, scratch);
+    uint32_t latency = millis() - start;
+
+    MinerRegistry::getInstance()->publish(entry.id, stats, success, latency);
+
+    PollOutcome outcome;
+    outcome.success = success;
+    outcome.hashrate = stats.hashrate;
+    outcome.temp = stats.temp;
+    outcome.latencyMs = latency;
+    outcome.srttMs = (uint32_t)api.getRtt().srtt;
+    outcome.rtoMs = api.getRtt().rto;
+    outcome.focused = (entry.id == focusedId);
+    outcome.pushLive = MinerTelemetry::getInstance()->isLive(entry.id);
+    outcome.poolCovered = PoolStatsSource::getInstance()->covers(entry.id);
+
+    xSemaphoreTake(schedMutex, portMAX_DELAY);
+    scheduler.complete(slot, outcome, millis());
+    xSemaphoreGive(schedMutex);
+}
+
+void MinerPoller::printSchedule() {
+    WifiManager* wifi = WifiManager::getInstance();
+    uint32_t now = millis();
+    uint32_t uptime = now - startedAt;
+
+    Serial.println("\n=== Poll Schedule ===");
+    uint32_t totalBusyMs = scheduler.getTotalBusyMs();
+    Serial.printf("%u poll(s), %u ms busy, %d/%d in flight, budget %d req/s (%.1f tokens)\n",
+                  scheduler.getTotalPolls(), totalBusyMs, scheduler.getInFlight(), scheduler.getMaxInFlight(),
+                  POLL_MAX_RPS, scheduler.getTokens());
+    Serial.printf("normal interval %u s, dispatch lag %u ms avg, %u ms max\n",
+                  scheduler.getNormalInterval() / 1000, scheduler.getLag(), scheduler.getMaxLag());
+    Serial.printf("cycle %u ms last, %u ms avg over %u cycle(s)\n",
+                  scheduler.getLastCycle(), scheduler.getAvgCycle(), scheduler.getCycles());
+    Serial.println(" id  name             state     interval  next in  fail  polls  errors  srtt  rto    busy ms  share  duty");
+
+    xSemaphoreTake(schedMutex, portMAX_DELAY);
+    for (int slot = 0; slot < scheduler.getCapacity(); slot++) {
+        const MinerSchedule& entry = scheduler.at(slot);
+        if (entry.id == MINER_ID_NONE) continue;
+
+        BitaxeDevice device;
+        bool named = wifi->copyBitaxeById(entry.id, device);
+        const char* state = entry.inFlight ? "polling" :
+                            entry.failures > 0 ? "backoff" :
+                            (entry.fast || entry.id == focusedId) ? "fast" : "normal";
+        int32_t nextIn = entry.inFlight ? 0 : (int32_t)(entry.nextDue - now);
+        if (nextIn < 0) nextIn = 0;
+
+        // share : part du temps de polling total ; duty : part de la capacité des workers
+        float share = totalBusyMs > 0 ? entry.busyMs * 100.0f / totalBusyMs : 0;
+        float duty = uptime > 0 ? entry.busyMs * 100.0f / ((float)uptime * scheduler.getMaxInFlight()) : 0;
+
+        Serial.printf("%3u  %-15.15s  %-8s  %6us  %6ds  %4u  %5u  %6u  %4u  %5u  %7u  %4.1f%%  %4.2f%%\n",
+                      entry.id,
+                      named ? device.name.c_str() : "?",
+                      state,
+                      entry.interval / 1000,
+                      nextIn / 1000,
+                      entry.failures,
+                      entry.polls,
+                      entry.errors,
+                      entry.srttMs,
+                      entry.rtoMs,
+                      entry.busyMs,
+                      share,
+                      duty);
+    }
+    xSemaphoreGive(schedMutex);
+    Serial.println("=====================\n");
+}
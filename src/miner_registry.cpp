@@ -0,0 +1,387 @@
+#include "miner_registry.h"
+
+#define MINER_FLAG_ONLINE          (1 << 0)
+#define MINER_FLAG_POLLED          (1 << 1)
+#define MINER_FLAG_POOL_CONNECTED  (1 << 2)
+#define MINER_FLAG_KEEP            (1 << 7)  // Marque temporaire de sync()
+
+MinerRegistry* MinerRegistry::instance = nullptr;
+
+MinerRegistry::MinerRegistry() {
+    mutex = xSemaphoreCreateMutex();
+    generation = 0;
+
+    capacity = fleetCapacity();
+    ids = fleetAllocArray<uint16_t>(capacity);
+    flags = fleetAllocArray<uint8_t>(capacity);
+    seqs = fleetAllocArray<uint32_t>(capacity);
+    changed = fleetAllocArray<uint16_t>(capacity);
+    timestamps = fleetAllocArray<uint32_t>(capacity);
+    latencies = fleetAllocArray<uint32_t>(capacity);
+    hashrates = fleetAllocArray<float>(capacity);
+    temps = fleetAllocArray<float>(capacity);
+    powers = fleetAllocArray<float>(capacity);
+    efficiencies = fleetAllocArray<float>(capacity);
+    bestDiffs = fleetAllocArray<uint32_t>(capacity);
+    shares = fleetAllocArray<uint32_t>(capacity);
+    uptimes = fleetAllocArray<uint32_t>(capacity);
+    hostnames = fleetAllocArray<FixedString<BITAXE_HOSTNAME_LEN> >(capacity);
+    versions = fleetAllocArray<FixedString<BITAXE_VERSION_LEN> >(capacity);
+    poolUrls = fleetAllocArray<FixedString<BITAXE_POOL_URL_LEN> >(capacity);
+    poolUsers = fleetAllocArray<FixedString<BITAXE_POOL_USER_LEN> >(capacity);
+
+    // Index au moins deux fois plus grand que la flotte (sondes courtes)
+    int indexSize = 1;
+    while (indexSize < capacity * 2) indexSize <<= 1;
+    indexMask = indexSize - 1;
+    slotIndex = fleetAllocArray<int16_t>(indexSize);
+
+    if (!ids || !flags || !seqs || !changed || !timestamps || !latencies || !hashrates || !temps ||
+        !powers || !efficiencies || !bestDiffs || !shares || !uptimes || !hostnames || !versions ||
+        !poolUrls || !poolUsers || !slotIndex) {
+        Serial.println("[Registry] Out of memory, fleet disabled");
+        capacity = 0;
+        indexMask = 0;
+        return;
+    }
+
+    for (int i = 0; i < capacity; i++) {
+        clearSlot(i, MINER_ID_NONE);
+    }
+    rebuildIndexLocked();
+    recomputeTotalsLocked();
+}
+
+MinerRegistry* MinerRegistry::getInstance() {
+    if (!instance) {
+        instance = new MinerRegistry();
+    }
+    return instance;
+}
+
+int MinerRegistry::slotOf(uint16_t id) const {
+    if (id == MINER_ID_NONE || capacity == 0) {
+        return -1;
+    }
+    for (uint16_t pos = id & indexMask; ; pos = (pos + 1) & indexMask) {
+        int16_t slot = slotIndex[pos];
+        if (slot < 0) {
+            return -1;
+        }
+        if (ids[slot] == id) {
+            return slot;
+        }
+    }
+}
+
+void MinerRegistry::indexSlotLocked(int slot) {
+    uint16_t pos = ids[slot] & indexMask;
+    while (slotIndex[pos] >= 0) {
+        pos = (pos + 1) & indexMask;
+    }
+    slotIndex[pos] = slot;
+}
+
+void MinerRegistry::rebuildIndexLocked() {
+    for (int pos = 0; pos <= indexMask; pos++) {
+        slotIndex[pos] = -1;
+    }
+    for (int slot = 0; slot < capacity; slot++) {
+        if (ids[slot] != MINER_ID_NONE) {
+            indexSlotLocked(slot);
+        }
+    }
+}
+
+// Recalcul complet, seulement quand la liste change ou que le meilleur bestDiff baisse
+void MinerRegistry::recomputeTotalsLocked() {
+    configuredCount = 0;
+    onlineCount = 0;
+    hashrateSum = 0;
+    powerSum = 0;
+    bestDiffMax = 0;
+    for (int slot = 0; slot < capacity; slot++) {
+        if (ids[slot] == MINER_ID_NONE) continue;
+        configuredCount++;
+        if (!(flags[slot] & MINER_FLAG_ONLINE)) continue;
+        onlineCount++;
+        hashrateSum += hashrates[slot];
+        powerSum += powers[slot];
+        if (bestDiffs[slot] > bestDiffMax) {
+            bestDiffMax = bestDiffs[slot];
+        }
+    }
+}
+
+void MinerRegistry::clearSlot(int slot, uint16_t id) {
+    ids[slot] = id;
+    flags[slot] = 0;
+    seqs[slot] = 0;
+    changed[slot] = 0;
+    timestamps[slot] = 0;
+    latencies[slot] = 0;
+    hashrates[slot] = 0;
+    temps[slot] = 0;
+    powers[slot] = 0;
+    efficiencies[slot] = 0;
+    bestDiffs[slot] = 0;
+    shares[slot] = 0;
+    uptimes[slot] = 0;
+    hostnames[slot].clear();
+    versions[slot].clear();
+    poolUrls[slot].clear();
+    poolUsers[slot].clear();
+}
+
+void MinerRegistry::sync(const BitaxeDevice* devices, int count) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+
+    // Marquer les slots encore configurés, puis libérer les autres
+    for (int i = 0; i < count; i++) {
+        int slot = slotOf(devices[i].id);
+        if (slot >= 0) flags[slot] |= MINER_FLAG_KEEP;
+    }
+    for (int slot = 0; slot < capacity; slot++) {
+        if (ids[slot] == MINER_ID_NONE) continue;
+        if (flags[slot] & MINER_FLAG_KEEP) {
+            flags[slot] &= ~MINER_FLAG_KEEP;
+        } else {
+            clearSlot(slot, MINER_ID_NONE);
+        }
+    }
+    rebuildIndexLocked();
+
+    // Réserver un slot vide pour chaque nouveau mineur
+    int freeSlot = 0;
+    for (int i = 0; i < count; i++) {
+        uint16_t id = devices[i].id;
+        if (id == MINER_ID_NONE || slotOf(id) >= 0) continue;
+        while (freeSlot < capacity && ids[freeSlot] != MINER_ID_NONE) freeSlot++;
+        if (freeSlot >= capacity) {
+            Serial.printf("[Registry] No free slot for miner #%u\n", id);
+            continue;
+        }
+        clearSlot(freeSlot, id);
+        indexSlotLocked(freeSlot);
+    }
+
+    recomputeTotalsLocked();
+    generation++;
+    xSemaphoreGive(mutex);
+}
+
+void MinerRegistry::publish(uint16_t id, const BitaxeStats& stats, bool success, uint32_t latencyMs) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+
+    int slot = slotOf(id);
+    if (slot < 0) {
+        // Mineur supprimé pendant la requête : résultat ignoré
+        xSemaphoreGive(mutex);
+        return;
+    }
+
+    uint16_t mask = 0;
+    bool wasOnline = (flags[slot] & MINER_FLAG_ONLINE) != 0;
+    if (success != wasOnline || !(flags[slot] & MINER_FLAG_POLLED)) {
+        mask |= MINER_CHANGED_ONLINE;
+    }
+
+    // Retirer l'ancienne contribution du mineur aux agrégats
+    uint32_t oldBestDiff = bestDiffs[slot];
+    if (wasOnline) {
+        onlineCount--;
+        hashrateSum -= hashrates[slot];
+        powerSum -= powers[slot];
+    }
+
+    // Un échec garde les dernières valeurs connues, seul le statut change
+    if (success) {
+        if (hashrates[slot] != stats.hashrate) mask |= MINER_CHANGED_HASHRATE;
+        if (temps[slot] != stats.temp) mask |= MINER_CHANGED_TEMP;
+        if (powers[slot] != stats.power) mask |= MINER_CHANGED_POWER;
+        if (bestDiffs[slot] != stats.bestDiff) mask |= MINER_CHANGED_BESTDIFF;
+        if (shares[slot] != stats.shares) mask |= MINER_CHANGED_SHARES;
+        bool poolConnected = (flags[slot] & MINER_FLAG_POOL_CONNECTED) != 0;
+        if (poolConnected != stats.poolConnected || poolUrls[slot] != stats.poolUrl || poolUsers[slot] != stats.poolUser) {
+            mask |= MINER_CHANGED_POOL;
+        }
+        if (hostnames[slot] != stats.hostname || versions[slot] != stats.version) {
+            mask |= MINER_CHANGED_INFO;
+        }
+
+        hashrates[slot] = stats.hashrate;
+        temps[slot] = stats.temp;
+        powers[slot] = stats.power;
+        efficiencies[slot] = stats.efficiency;
+        bestDiffs[slot] = stats.bestDiff;
+        shares[slot] = stats.shares;
+        uptimes[slot] = stats.uptimeSeconds;
+        poolUrls[slot] = stats.poolUrl;
+        poolUsers[slot] = stats.poolUser;
+        hostnames[slot] = stats.hostname;
+        versions[slot] = stats.version;
+    }
+
+    uint8_t newFlags = MINER_FLAG_POLLED;
+    if (success) newFlags |= MINER_FLAG_ONLINE;
+    if (success ? stats.poolConnected : (flags[slot] & MINER_FLAG_POOL_CONNECTED)) newFlags |= MINER_FLAG_POOL_CONNECTED;
+    flags[slot] = newFlags;
+
+    // Ajouter la nouvelle contribution
+    if (success) {
+        onlineCount++;
+        hashrateSum += hashrates[slot];
+        powerSum += powers[slot];
+    }
+    if (onlineCount == 0) {
+        hashrateSum = 0;
+        powerSum = 0;
+    }
+    if (success && bestDiffs[slot] > bestDiffMax) {
+        bestDiffMax = bestDiffs[slot];
+    } else if (wasOnline && oldBestDiff == bestDiffMax && (!success || bestDiffs[slot] < oldBestDiff)) {
+        // Le mineur qui détenait le maximum l'a perdu : seul cas qui parcourt la flotte
+        recomputeTotalsLocked();
+    }
+
+    changed[slot] = mask;
+    timestamps[slot] = millis();
+    latencies[slot] = latencyMs;
+    seqs[slot]++;
+    generation++;
+
+    xSemaphoreGive(mutex);
+}
+
+uint16_t MinerRegistry::setHashrateLocked(int slot, float hashrate) {
+    if (hashrates[slot] == hashrate) {
+        return 0;
+    }
+    hashrateSum += hashrate - hashrates[slot];
+    hashrates[slot] = hashrate;
+    return MINER_CHANGED_HASHRATE;
+}
+
+uint16_t MinerRegistry::raiseBestDiffLocked(int slot, uint32_t bestDiff) {
+    if (bestDiff <= bestDiffs[slot]) {
+        return 0;
+    }
+    bestDiffs[slot] = bestDiff;
+    if (bestDiff > bestDiffMax) {
+        bestDiffMax = bestDiff;
+    }
+    return MINER_CHANGED_BESTDIFF;
+}
+
+void MinerRegistry::commitLocked(int slot, uint16_t mask) {
+    if (mask != 0) {
+        changed[slot] = mask;
+        seqs[slot]++;
+        generation++;
+    }
+}
+
+int MinerRegistry::onlineSlotLocked(uint16_t id) const {
+    int slot = slotOf(id);
+    // Seul le poll direct décide qu'un mineur est online
+    return (slot >= 0 && (flags[slot] & MINER_FLAG_ONLINE)) ? slot : -1;
+}
+
+void MinerRegistry::publishPoolStats(uint16_t id, float hashrate, uint32_t bestDiff) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    int slot = onlineSlotLocked(id);
+    if (slot >= 0) {
+        // Le pool garde le meilleur share depuis plus longtemps que le mineur : on ne fait que monter
+        commitLocked(slot, setHashrateLocked(slot, hashrate) | raiseBestDiffLocked(slot, bestDiff));
+    }
+    xSemaphoreGive(mutex);
+}
+
+void MinerRegistry::publishHashrate(uint16_t id, float hashrate) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    int slot = onlineSlotLocked(id);
+    if (slot >= 0) {
+        commitLocked(slot, setHashrateLocked(slot, hashrate));
+    }
+    xSemaphoreGive(mutex);
+}
+
+void MinerRegistry::publishShare(uint16_t id, uint32_t difficulty, bool submitted) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    int slot = onlineSlotLocked(id);
+    if (slot >= 0) {
+        uint16_t mask = raiseBestDiffLocked(slot, difficulty);
+        if (submitted) {
+            // Le prochain poll direct recale le compteur sur celui du mineur
+            shares[slot]++;
+            mask |= MINER_CHANGED_SHARES;
+        }
+        commitLocked(slot, mask);
+    }
+    xSemaphoreGive(mutex);
+}
+
+bool MinerRegistry::read(uint16_t id, MinerView& out) {
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return false;
+    }
+
+    int slot = slotOf(id);
+    if (slot < 0) {
+        xSemaphoreGive(mutex);
+        return false;
+    }
+
+    out.id = id;
+    out.online = (flags[slot] & MINER_FLAG_ONLINE) != 0;
+    out.polled = (flags[slot] & MINER_FLAG_POLLED) != 0;
+    out.seq = seqs[slot];
+    out.changed = changed[slot];
+    out.timestamp = timestamps[slot];
+    out.latencyMs = latencies[slot];
+
+    out.stats.hostname = hostnames[slot];
+    out.stats.version = versions[slot];
+    out.stats.hashrate = hashrates[slot];
+    out.stats.temp = temps[slot];
+    out.stats.power = powers[slot];
+    out.stats.efficiency = efficiencies[slot];
+    out.stats.bestDiff = bestDiffs[slot];
+    out.stats.shares = shares[slot];
+    out.stats.poolUrl = poolUrls[slot];
+    out.stats.poolUser = poolUsers[slot];
+    out.stats.poolConnected = (flags[slot] & MINER_FLAG_POOL_CONNECTED) != 0;
+    out.stats.uptimeSeconds = uptimes[slot];
+    out.stats.valid = out.online;
+
+    xSemaphoreGive(mutex);
+    return true;
+}
+
+bool MinerRegistry::isOnline(uint16_t id) {
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return false;
+    }
+    int slot = slotOf(id);
+    bool online = slot >= 0 && (flags[slot] & MINER_FLAG_ONLINE);
+    xSemaphoreGive(mutex);
+    return online;
+}
+
+bool MinerRegistry::getTotals(FleetTotals& out) {
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        out.configured = 0;
+        out.online = 0;
+        out.hashrate = 0;
+        out.power = 0;
+        out.bestDiff = 0;
+        return false;
+    }
+    out.configured = configuredCount;
+    out.online = onlineCount;
+    out.hashrate = (float)hashrateSum;
+    out.power = (float)powerSum;
+    out.bestDiff = bestDiffMax;
+    xSemaphoreGive(mutex);
+    return true;
+}
@@ -0,0 +1,180 @@
+#include "miner_request_coalescer.h"
+#include "fleet_storage.h"
+
+MinerRequestCoalescer* MinerRequestCoalescer::instance = nullptr;
+
+MinerRequestCoalescer::MinerRequestCoalescer() {
+    mutex = xSemaphoreCreateMutex();
+    doneBits = xEventGroupCreate();
+    for (int i = 0; i < COALESCE_SLOTS; i++) {
+        slots[i].host[0] = '\0';
+        slots[i].endpoint[0] = '\0';
+        slots[i].filter = nullptr;
+        slots[i].inFlight = false;
+        slots[i].ok = false;
+        slots[i].readers = 0;
+        slots[i].completedAt = 0;
+    }
+    // Une arène par slot, allouée une fois (PSRAM si disponible)
+    uint8_t* buffer = fleetAllocArray<uint8_t>(COALESCE_SLOTS * MINER_JSON_ARENA_BYTES);
+    arenas = (buffer != nullptr);
+    if (arenas) {
+        for (int i = 0; i < COALESCE_SLOTS; i++) {
+            slots[i].arena.attach(buffer + i * MINER_JSON_ARENA_BYTES, MINER_JSON_ARENA_BYTES);
+        }
+    }
+    fetches = 0;
+    coalesced = 0;
+    cacheHits = 0;
+}
+
+MinerRequestCoalescer* MinerRequestCoalescer::getInstance() {
+    if (!instance) {
+        instance = new MinerRequestCoalescer();
+    }
+    return instance;
+}
+
+int MinerRequestCoalescer::findLocked(const char* host, const char* endpoint, const JsonDocument* filter) const {
+    for (int i = 0; i < COALESCE_SLOTS; i++) {
+        const CoalescedRequest& slot = slots[i];
+        if (slot.host[0] == '\0') continue;
+        if (slot.filter == filter && strcmp(slot.host, host) == 0 && strcmp(slot.endpoint, endpoint) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Slot libre, sinon le résultat terminé le plus ancien (jamais un slot lu)
+int MinerRequestCoalescer::claimLocked(uint32_t now) {
+    int oldest = -1;
+    for (int i = 0; i < COALESCE_SLOTS; i++) {
+        const CoalescedRequest& slot = slots[i];
+        if (slot.host[0] == '\0') {
+            return i;
+        }
+        if (slot.inFlight || slot.readers > 0) continue;
+        if (oldest < 0 || (now - slot.completedAt) > (now - slots[oldest].completedAt)) {
+            oldest = i;
+        }
+    }
+    return oldest;
+}
+
+int MinerRequestCoalescer::acquire(const char* host, const char* endpoint, const JsonDocument* filter,
+                                   bool& leader, bool& ok) {
+    leader = false;
+    ok = false;
+    if (!arenas || host[0] == '\0' || strlen(host) >= sizeof(slots[0].host) || strlen(endpoint) >= sizeof(slots[0].endpoint)) {
+        return COALESCE_BYPASS;
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    uint32_t now = millis();
+    int index = findLocked(host, endpoint, filter);
+
+    if (index >= 0) {
+        CoalescedRequest& slot = slots[index];
+        if (!slot.inFlight && slot.ok && now - slot.completedAt < COALESCE_TTL_MS) {
+            // Résultat récent : lu en place, le slot ne peut pas être repris tant que readers > 0
+            slot.readers++;
+            ok = true;
+            cacheHits++;
+            xSemaphoreGive(mutex);
+            return index;
+        }
+        if (slot.inFlight) {
+            // Rattaché à la requête en vol
+            slot.readers++;
+            coalesced++;
+            xSemaphoreGive(mutex);
+
+            EventBits_t bits = xEventGroupWaitBits(doneBits, 1 << index, pdFALSE, pdTRUE, pdMS_TO_TICKS(COALESCE_WAIT_MS));
+
+            xSemaphoreTake(mutex, portMAX_DELAY);
+            ok = (bits & (1 << index)) && slot.ok;
+            if (!ok) {
+                slot.readers--;
+            }
+            xSemaphoreGive(mutex);
+            return ok ? index : COALESCE_NO_SLOT;
+        }
+        if (slot.readers > 0) {
+            // Des appelants lisent encore le résultat précédent
+            xSemaphoreGive(mutex);
+            return COALESCE_BYPASS;
+        }
+        // Résultat expiré ou en échec : ce slot est réutilisé pour la nouvelle requête
+    } else {
+        index = claimLocked(now);
+        if (index < 0) {
+            // Tous les slots sont lus : requête directe, sans mutualisation
+            xSemaphoreGive(mutex);
+            return COALESCE_BYPASS;
+        }
+    }
+
+    CoalescedRequest& slot = slots[index];
+    strcpy(slot.host, host);
+    strcpy(slot.endpoint, endpoint);
+    slot.filter = filter;
+    slot.inFlight = true;
+    slot.ok = false;
+    slot.readers = 1;
+    slot.result.clear();
+    xEventGroupClearBits(doneBits, 1 << index);
+    fetches++;
+    xSemaphoreGive(mutex);
+    leader = true;
+    return index;
+}
+
+void MinerRequestCoalescer::complete(int index, bool ok) {
+    if (index < 0 || index >= COALESCE_SLOTS) {
+        return;
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    CoalescedRequest& slot = slots[index];
+    slot.ok = ok;
+    slot.completedAt = millis();
+    slot.inFlight = false;
+    xEventGroupSetBits(doneBits, 1 << index);
+    xSemaphoreGive(mutex);
+}
+
+void MinerRequestCoalescer::release(int index) {
+    if (index < 0 || index >= COALESCE_SLOTS) {
+        return;
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    if (slots[index].readers > 0) {
+        slots[index].readers--;
+    }
+    xSemaphoreGive(mutex);
+}
+
+void MinerRequestCoalescer::invalidate(const char* host) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    for (int i = 0; i < COALESCE_SLOTS; i++) {
+        CoalescedRequest& slot = slots[i];
+        if (slot.inFlight || strcmp(slot.host, host) != 0) continue;
+        if (slot.readers > 0) {
+            // Encore lu : plus servi aux nouveaux appelants, libéré plus tard
+            slot.ok = false;
+        } else {
+            slot.host[0] = '\0';
+            slot.result.clear();
+        }
+    }
+    xSemaphoreGive(mutex);
+}
+
+void MinerRequestCoalescer::printStats() {
+    uint32_t calls = fetches + coalesced + cacheHits;
+    Serial.printf("Miner requests: %u call(s), %u sent, %u coalesced, %u cache hit(s) (%.0f%% saved)\n",
+                  calls, fetches, coalesced, cacheHits,
+                  calls > 0 ? (coalesced + cacheHits) * 100.0f / calls : 0.0f);
+}
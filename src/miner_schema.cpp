@@ -0,0 +1,231 @@
+#include "miner_schema.h"
+
+// Filtre ArduinoJson : seuls les champs lus par getStats() sont conservés.
+// Le reste du payload /api/system/info est lu puis jeté au fil du flux, donc la
+// mémoire utilisée ne dépend pas de la taille de la réponse.
+static JsonDocument buildInfoFilter() {
+    JsonDocument filter;
+    const char* fields[] = {
+        "ASICModel", "hostname", "version",
+        "temp", "temperature",
+        "power", "voltage", "current",
+        "hashRate", "currentHashrate",
+        "bestDiff", "best_diff", "bestSessionDiff",
+        "sharesAccepted", "shares_accepted", "accepted",
+        "stratumURL", "pool_url", "stratumUser", "pool_user",
+        "uptimeSeconds", "uptime"
+    };
+    for (const char* field : fields) {
+        filter[field] = true;
+    }
+    return filter;
+}
+
+// Construit une seule fois au démarrage, en lecture seule ensuite (partagé par les workers du poller)
+static JsonDocument infoFilterDoc = buildInfoFilter();
+
+const JsonDocument& MinerSchema::infoFilter() {
+    return infoFilterDoc;
+}
+
+uint32_t MinerSchema::parseDiff(const char* diffStr) {
+    float diffValue = 0;
+    char unit = ' ';
+    
+    if (diffStr == nullptr || sscanf(diffStr, "%f %c", &diffValue, &unit) < 1) {
+        return 0;
+    }
+    if (unit == 'G' || unit == 'g') {
+        return (uint32_t)(diffValue * 1000000000.0); // Giga
+    } else if (unit == 'M' || unit == 'm') {
+        return (uint32_t)(diffValue * 1000000.0);    // Mega
+    } else if (unit == 'K' || unit == 'k') {
+        return (uint32_t)(diffValue * 1000.0);       // Kilo
+    }
+    return (uint32_t)diffValue;                      // Pas d'unité
+}
+
+// Variantes connues de chaque champ, par ordre de priorité (AxeOS vs ESP-Miner)
+static const char* const HOSTNAME_KEYS[] = { "ASICModel", "hostname" };
+static const char* const VERSION_KEYS[]  = { "version" };
+static const char* const TEMP_KEYS[]     = { "temp", "temperature" };
+static const char* const POWER_KEYS[]    = { "power" };
+static const char* const HASHRATE_KEYS[] = { "hashRate", "currentHashrate" };
+static const char* const DIFF_KEYS[]     = { "bestDiff", "best_diff", "bestSessionDiff" };
+static const char* const SHARES_KEYS[]   = { "sharesAccepted", "shares_accepted", "accepted" };
+static const char* const POOL_URL_KEYS[] = { "stratumURL", "pool_url" };
+static const char* const POOL_USER_KEYS[] = { "stratumUser", "pool_user" };
+static const char* const UPTIME_KEYS[]   = { "uptimeSeconds", "uptime" };
+
+#define KEY_COUNT(keys) (sizeof(keys) / sizeof(keys[0]))
+
+// Première clé présente parmi les variantes connues (nullptr si aucune)
+static const char* firstPresentKey(JsonDocument& doc, const char* const* keys, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (doc.containsKey(keys[i])) {
+            return keys[i];
+        }
+    }
+    return nullptr;
+}
+
+void MinerSchema::detect(JsonDocument& doc, BitaxeFieldMap& plan) {
+    plan = BitaxeFieldMap();
+    
+    plan.hostname = firstPresentKey(doc, HOSTNAME_KEYS, KEY_COUNT(HOSTNAME_KEYS));
+    plan.version = firstPresentKey(doc, VERSION_KEYS, KEY_COUNT(VERSION_KEYS));
+    plan.temp = firstPresentKey(doc, TEMP_KEYS, KEY_COUNT(TEMP_KEYS));
+    
+    plan.power = firstPresentKey(doc, POWER_KEYS, KEY_COUNT(POWER_KEYS));
+    plan.powerFromVoltageCurrent = (plan.power == nullptr && doc.containsKey("voltage") && doc.containsKey("current"));
+    
+    plan.hashrate = firstPresentKey(doc, HASHRATE_KEYS, KEY_COUNT(HASHRATE_KEYS));
+    plan.hashrateInHs = (plan.hashrate != nullptr && strcmp(plan.hashrate, "currentHashrate") == 0);
+    
+    // Best difficulty - peut être un nombre OU une string formatée (ex: "997.30 M", "72.6G")
+    plan.bestDiff = firstPresentKey(doc, DIFF_KEYS, KEY_COUNT(DIFF_KEYS));
+    plan.bestDiffIsString = (plan.bestDiff != nullptr && doc[plan.bestDiff].is<const char*>());
+    
+    plan.shares = firstPresentKey(doc, SHARES_KEYS, KEY_COUNT(SHARES_KEYS));
+    plan.poolUrl = firstPresentKey(doc, POOL_URL_KEYS, KEY_COUNT(POOL_URL_KEYS));
+    plan.poolUser = firstPresentKey(doc, POOL_USER_KEYS, KEY_COUNT(POOL_USER_KEYS));
+    plan.uptime = firstPresentKey(doc, UPTIME_KEYS, KEY_COUNT(UPTIME_KEYS));
+    
+    // Empreinte de la variante de firmware (pour les logs)
+    bool axeos = plan.hashrate != nullptr && strcmp(plan.hashrate, "hashRate") == 0 &&
+                 plan.poolUrl != nullptr && strcmp(plan.poolUrl, "stratumURL") == 0;
+    bool legacy = plan.hashrateInHs &&
+                  plan.poolUrl != nullptr && strcmp(plan.poolUrl, "pool_url") == 0;
+    plan.schemaName = axeos ? "AxeOS" : (legacy ? "ESP-Miner (legacy)" : "mixed");
+    plan.resolved = true;
+    
+    if (plan.bestDiff == nullptr) {
+        Serial.println("[Schema] WARNING: No bestDiff/best_diff/bestSessionDiff field found in JSON!");
+    }
+    Serial.printf("[Schema] Detected %s (hashrate=%s, bestDiff=%s%s, shares=%s)\n",
+                  plan.schemaName,
+                  plan.hashrate ? plan.hashrate : "-",
+                  plan.bestDiff ? plan.bestDiff : "-",
+                  plan.bestDiffIsString ? " (string)" : "",
+                  plan.shares ? plan.shares : "-");
+}
+
+// Lecture directe d'une clé du plan. key == nullptr : champ absent pour ce
+// firmware, on prend la valeur par défaut. false si la clé a disparu du payload.
+template <typename T>
+static bool readField(JsonDocument& doc, const char* key, T& out, const T& fallback) {
+    if (key == nullptr) {
+        out = fallback;
+        return true;
+    }
+    JsonVariantConst value = doc[key];
+    if (value.isNull()) {
+        return false;
+    }
+    out = value.as<T>();
+    return true;
+}
+
+// Champs texte : copiés depuis le document dans la chaîne fixe, sans String intermédiaire
+template <size_t N>
+static bool readField(JsonDocument& doc, const char* key, FixedString<N>& out, const char* fallback) {
+    if (key == nullptr) {
+        out = fallback;
+        return true;
+    }
+    JsonVariantConst value = doc[key];
+    if (value.isNull()) {
+        return false;
+    }
+    out = value.as<const char*>();
+    return true;
+}
+
+bool MinerSchema::extract(JsonDocument& doc, const BitaxeFieldMap& plan, BitaxeStats& stats) {
+    if (!readField(doc, plan.hostname, stats.hostname, "Bitaxe")) return false;
+    if (!readField(doc, plan.version, stats.version, "Unknown")) return false;
+    if (!readField(doc, plan.temp, stats.temp, 0.0f)) return false;
+    
+    // Power
+    if (plan.powerFromVoltageCurrent) {
+        // Calculate power from voltage and current
+        float voltage, current;
+        if (!readField(doc, "voltage", voltage, 0.0f)) return false;
+        if (!readField(doc, "current", current, 0.0f)) return false;
+        stats.power = voltage * current;
+    } else if (!readField(doc, plan.power, stats.power, 0.0f)) {
+        return false;
+    }
+    
+    // Hashrate - usually in GH/s or needs conversion from H/s
+    float hashrate;
+    if (!readField(doc, plan.hashrate, hashrate, 0.0f)) return false;
+    // If value is very large, it's probably in H/s, convert to GH/s
+    if (plan.hashrateInHs || hashrate > 1000000) {
+        stats.hashrate = hashrate / 1000000000.0;
+    } else {
+        stats.hashrate = hashrate;
+    }
+    
+    // Best difficulty : le format (string/nombre) fait partie du plan
+    if (plan.bestDiff == nullptr) {
+        stats.bestDiff = 0;
+    } else {
+        JsonVariantConst diff = doc[plan.bestDiff];
+        if (diff.isNull() || diff.is<const char*>() != plan.bestDiffIsString) {
+            return false;
+        }
+        stats.bestDiff = plan.bestDiffIsString ? parseDiff(diff.as<const char*>()) : diff.as<uint32_t>();
+    }
+    
+    if (!readField(doc, plan.shares, stats.shares, (uint32_t)0)) return false;
+    
+    // Pool info - might be in the same response
+    if (!readField(doc, plan.poolUrl, stats.poolUrl, "")) return false;
+    if (!readField(doc, plan.poolUser, stats.poolUser, "")) return false;
+    
+    // Uptime
+    if (!readField(doc, plan.uptime, stats.uptimeSeconds, (uint32_t)0)) return false;
+    
+    return true;
+}
+
+bool MinerSchema::parse(JsonDocument& doc, BitaxeFieldMap* plan, BitaxeStats& stats, const char* host) {
+    stats.valid = false;
+    
+    // Parse system info - check if response is valid
+    if (doc.isNull()) {
+        return false;
+    }
+    
+    // Sans plan mémorisé (appel ponctuel) : détection à chaque fois
+    BitaxeFieldMap localPlan;
+    if (plan == nullptr) {
+        plan = &localPlan;
+    }
+    
+    // Chemin rapide : lectures directes avec le plan déjà résolu
+    if (!plan->resolved || !extract(doc, *plan, stats)) {
+        if (plan->resolved) {
+            Serial.printf("[Schema] Expected %s field missing on %s, re-detecting schema\n",
+                          plan->schemaName, host);
+        }
+        detect(doc, *plan);
+        if (!extract(doc, *plan, stats)) {
+            return false;
+        }
+    }
+    
+    // Calculate efficiency (J/TH)
+    if (stats.hashrate > 0 && stats.power > 0) {
+        stats.efficiency = (stats.power / stats.hashrate) * 1000.0;
+    } else {
+        stats.efficiency = 0;
+    }
+    
+    // Pool connection status
+    stats.poolConnected = (stats.hashrate > 0);  // Assume connected if hashing
+    
+    stats.valid = true;
+    return true;
+}
@@ -0,0 +1,307 @@
+#include "miner_telemetry.h"
+#include "wifi_manager.h"
+#include "miner_registry.h"
+#include "miner_poller.h"
+#include "socket_budget.h"
+
+MinerTelemetry* MinerTelemetry::instance = nullptr;
+
+MinerTelemetry::MinerTelemetry() {
+    mutex = xSemaphoreCreateMutex();
+    task = nullptr;
+    enabled = false;
+    lastSelect = 0;
+    reconnects = 0;
+    for (int i = 0; i < TELEMETRY_MAX_SOCKETS; i++) {
+        links[i].id = MINER_ID_NONE;
+        links[i].live = false;
+        links[i].messages = 0;
+        links[i].shares = 0;
+    }
+    for (int i = 0; i < TELEMETRY_MAX_SOCKETS * 2; i++) {
+        retries[i].id = MINER_ID_NONE;
+    }
+}
+
+MinerTelemetry* MinerTelemetry::getInstance() {
+    if (!instance) {
+        instance = new MinerTelemetry();
+    }
+    return instance;
+}
+
+void MinerTelemetry::begin() {
+    if (task != nullptr) {
+        return;  // Déjà démarré
+    }
+    prefs.begin("telemetry", true);
+    enabled = prefs.getBool("enabled", false);
+    prefs.end();
+
+    xTaskCreatePinnedToCore(taskEntry, "telemetry", TELEMETRY_TASK_STACK, this, 1, &task, TELEMETRY_TASK_CORE);
+    Serial.printf("[Telemetry] Push mode %s (max %d sockets)\n", enabled ? "enabled" : "disabled", TELEMETRY_MAX_SOCKETS);
+}
+
+void MinerTelemetry::setEnabled(bool on) {
+    enabled = on;
+    prefs.begin("telemetry", false);
+    prefs.putBool("enabled", on);
+    prefs.end();
+    lastSelect = 0;  // Réévaluer tout de suite
+    Serial.printf("[Telemetry] Push mode %s\n", on ? "enabled" : "disabled");
+}
+
+void MinerTelemetry::taskEntry(void* arg) {
+    MinerTelemetry* self = (MinerTelemetry*)arg;
+    for (;;) {
+        if (!self->enabled || !WifiManager::getInstance()->isConnected()) {
+            for (int i = 0; i < TELEMETRY_MAX_SOCKETS; i++) {
+                if (self->links[i].id != MINER_ID_NONE) {
+                    self->dropLink(self->links[i], "push mode off");
+                }
+            }
+            vTaskDelay(pdMS_TO_TICKS(1000));
+            continue;
+        }
+
+        if (self->lastSelect == 0 || millis() - self->lastSelect > TELEMETRY_RESELECT_MS) {
+            self->selectTargets();
+            self->lastSelect = millis();
+        }
+
+        for (int i = 0; i < TELEMETRY_MAX_SOCKETS; i++) {
+            TelemetryLink& link = self->links[i];
+            if (link.id == MINER_ID_NONE) continue;
+            if (!link.ws.poll(onMessage, &link)) {
+                self->dropLink(link, "closed");
+            } else if (millis() - link.lastMessageAt > TELEMETRY_SILENT_MS) {
+                // millis() relu après poll() : lastMessageAt peut venir d'y être mis à jour
+                self->dropLink(link, "silent");
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(TELEMETRY_TICK_MS));
+    }
+}
+
+// Le mineur affiché d'abord, puis les mineurs online dans l'ordre de la config
+void MinerTelemetry::selectTargets() {
+    WifiManager* wifi = WifiManager::getInstance();
+    MinerRegistry* registry = MinerRegistry::getInstance();
+    uint16_t focused = MinerPoller::getInstance()->getFocusedMiner();
+
+    // Le mineur affiché doit avoir un lien : libérer le dernier si tout est pris
+    bool focusedLinked = focused == MINER_ID_NONE;
+    int freeLinks = 0;
+    for (int i = 0; i < TELEMETRY_MAX_SOCKETS; i++) {
+        if (links[i].id == focused) focusedLinked = true;
+        if (links[i].id == MINER_ID_NONE) freeLinks++;
+    }
+    if (!focusedLinked && freeLinks == 0 && registry->isOnline(focused) && canRetry(focused)) {
+        dropLink(links[TELEMETRY_MAX_SOCKETS - 1], "making room for focused miner");
+    }
+
+    for (int i = 0; i < TELEMETRY_MAX_SOCKETS; i++) {
+        TelemetryLink& link = links[i];
+        if (link.id != MINER_ID_NONE) continue;
+        if (SocketBudget::getInstance()->available(SOCKET_TELEMETRY) == 0) {
+            break;  // Sockets pris par les pools ou un balayage : on reste en polling
+        }
+
+        uint16_t candidate = MINER_ID_NONE;
+        if (!focusedLinked && registry->isOnline(focused) && canRetry(focused)) {
+            candidate = focused;
+            focusedLinked = true;
+        } else {
+            for (int d = 0; d < wifi->getBitaxeCount() && candidate == MINER_ID_NONE; d++) {
+                BitaxeDevice device;
+                if (!wifi->copyBitaxe(d, device) || !registry->isOnline(device.id) || !canRetry(device.id)) continue;
+                bool linked = false;
+                for (int l = 0; l < TELEMETRY_MAX_SOCKETS && !linked; l++) {
+                    linked = links[l].id == device.id;
+                }
+                if (!linked) {
+                    candidate = device.id;
+                }
+            }
+        }
+        if (candidate == MINER_ID_NONE) {
+            break;  // Plus personne à abonner
+        }
+
+        BitaxeDevice device;
+        if (!wifi->copyBitaxeById(candidate, device)) continue;
+        link.id = candidate;
+        link.ip = device.ip;
+        connectLink(link);
+    }
+}
+
+void MinerTelemetry::connectLink(TelemetryLink& link) {
+    SocketBudget* budget = SocketBudget::getInstance();
+    if (!budget->acquire(SOCKET_TELEMETRY)) {
+        link.id = MINER_ID_NONE;  // Pas la faute du mineur : pas de backoff
+        return;
+    }
+    if (!link.ws.connect(link.ip.c_str(), 80, TELEMETRY_WS_PATH, TELEMETRY_CONNECT_MS)) {
+        link.ws.close();
+        budget->release(SOCKET_TELEMETRY);
+        Serial.printf("[Telemetry] #%u %s: WebSocket unavailable, staying on polling\n", link.id, link.ip.c_str());
+        noteFailure(link.id);
+        link.id = MINER_ID_NONE;
+        return;
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    link.live = true;
+    link.connectedAt = millis();
+    link.lastMessageAt = millis();
+    link.messages = 0;
+    link.shares = 0;
+    reconnects++;
+    xSemaphoreGive(mutex);
+    Serial.printf("[Telemetry] #%u %s: subscribed\n", link.id, link.ip.c_str());
+}
+
+void MinerTelemetry::dropLink(TelemetryLink& link, const char* reason) {
+    if (link.id == MINER_ID_NONE) {
+        return;
+    }
+    Serial.printf("[Telemetry] #%u %s: %s after %lu s, back to polling\n",
+                  link.id, link.ip.c_str(), reason, (millis() - link.connectedAt) / 1000);
+    link.ws.close();
+    SocketBudget::getInstance()->release(SOCKET_TELEMETRY);
+    if (strcmp(reason, "push mode off") != 0) {
+        noteFailure(link.id);
+    }
+
+    uint16_t id = link.id;
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    link.live = false;
+    link.id = MINER_ID_NONE;
+    xSemaphoreGive(mutex);
+
+    // Ce mineur seul est réinterrogé, puis reprend sa cadence de polling
+    MinerPoller::getInstance()->requestPoll(id);
+}
+
+bool MinerTelemetry::canRetry(uint16_t id) {
+    for (int i = 0; i < TELEMETRY_MAX_SOCKETS * 2; i++) {
+        if (retries[i].id == id) {
+            return (int32_t)(millis() - retries[i].retryAt) >= 0;
+        }
+    }
+    return true;
+}
+
+void MinerTelemetry::noteFailure(uint16_t id) {
+    // Backoff par mineur : un firmware sans /api/ws n'est pas réessayé en boucle
+    int slot = -1;
+    for (int i = 0; i < TELEMETRY_MAX_SOCKETS * 2; i++) {
+        if (retries[i].id == id) {
+            slot = i;
+            break;
+        }
+        if (slot < 0 && (retries[i].id == MINER_ID_NONE || (int32_t)(millis() - retries[i].retryAt) >= 0)) {
+            slot = i;
+        }
+    }
+    if (slot < 0) {
+        slot = 0;
+    }
+    RetryEntry& entry = retries[slot];
+    if (entry.id == id) {
+        entry.delayMs = min((uint32_t)TELEMETRY_RETRY_MAX_MS, entry.delayMs * 2);
+    } else {
+        entry.id = id;
+        entry.delayMs = TELEMETRY_RETRY_MIN_MS;
+    }
+    entry.retryAt = millis() + entry.delayMs;
+}
+
+void MinerTelemetry::onMessage(void* ctx, const char* data, size_t len) {
+    TelemetryLink* link = (TelemetryLink*)ctx;
+    link->lastMessageAt = millis();
+    link->messages++;
+
+    // Un message peut contenir plusieurs lignes du journal
+    char line[WS_MAX_MESSAGE + 1];
+    size_t start = 0;
+    while (start < len) {
+        size_t end = start;
+        while (end < len && data[end] != '\n') end++;
+        size_t lineLen = min(end - start, sizeof(line) - 1);
+        memcpy(line, data + start, lineLen);
+        line[lineLen] = '\0';
+        instance->handleLine(*link, line);
+        start = end + 1;
+    }
+}
+
+// Lignes du journal ESP-Miner utilisées (les codes couleur ANSI sont ignorés) :
+//   "asic_result: Ver: 20000000 Nonce 1A2B3C4D diff 1234.5 of 1000."  -> nonce trouvé
+//   "... 512.3 GH/s ..."                                              -> hashrate
+void MinerTelemetry::handleLine(TelemetryLink& link, const char* line) {
+    MinerRegistry* registry = MinerRegistry::getInstance();
+
+    const char* diff = strstr(line, " diff ");
+    if (diff != nullptr) {
+        float shareDiff = 0;
+        float poolDiff = 0;
+        if (sscanf(diff, " diff %f of %f", &shareDiff, &poolDiff) >= 1 && shareDiff > 0) {
+            // Sous la difficulté du pool le nonce n'est pas soumis mais compte pour la meilleure diff
+            bool submitted = poolDiff <= 0 || shareDiff >= poolDiff;
+            registry->publishShare(link.id, (uint32_t)min(shareDiff, 4294967295.0f), submitted);
+            if (submitted) {
+                link.shares++;
+            }
+        }
+        return;
+    }
+
+    const char* unit = strstr(line, "GH/s");
+    if (unit != nullptr && unit > line) {
+        // Remonte jusqu'au début du nombre qui précède l'unité
+        const char* p = unit;
+        while (p > line && p[-1] == ' ') p--;
+        const char* numberEnd = p;
+        while (p > line && (isdigit((unsigned char)p[-1]) || p[-1] == '.')) p--;
+        if (p < numberEnd) {
+            float hashrate = strtof(p, nullptr);
+            if (hashrate > 0) {
+                registry->publishHashrate(link.id, hashrate);
+            }
+        }
+    }
+}
+
+bool MinerTelemetry::isLive(uint16_t id) {
+    if (!enabled || xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return false;
+    }
+    bool live = false;
+    for (int i = 0; i < TELEMETRY_MAX_SOCKETS; i++) {
+        if (links[i].id == id && links[i].live) {
+            live = true;
+            break;
+        }
+    }
+    xSemaphoreGive(mutex);
+    return live;
+}
+
+bool MinerTelemetry::getStatus(TelemetryStatus& out) {
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return false;
+    }
+    memset(&out, 0, sizeof(out));
+    out.enabled = enabled;
+    out.reconnects = reconnects;
+    for (int i = 0; i < TELEMETRY_MAX_SOCKETS; i++) {
+        if (links[i].id == MINER_ID_NONE) continue;
+        if (links[i].live) out.live++;
+        out.messages += links[i].messages;
+        out.shares += links[i].shares;
+    }
+    xSemaphoreGive(mutex);
+    return true;
+}
@@ -0,0 +1,49 @@
+#include "poll_pacer.h"
+
+PollPacer::PollPacer() {
+    tokens = 0;
+    lastRefill = 0;
+    burst = 1;
+}
+
+void PollPacer::begin(uint8_t burst, uint32_t now) {
+    this->burst = burst > 0 ? burst : 1;
+    tokens = this->burst;
+    lastRefill = now;
+}
+
+void PollPacer::refill(uint32_t now) {
+    tokens += (now - lastRefill) * POLL_MAX_RPS / 1000.0f;
+    if (tokens > burst) tokens = burst;
+    lastRefill = now;
+}
+
+bool PollPacer::take() {
+    if (tokens < 1.0f) {
+        return false;
+    }
+    tokens -= 1.0f;
+    return true;
+}
+
+uint32_t PollPacer::normalInterval(int activeMiners) {
+    uint32_t sustainable = (uint32_t)activeMiners * 1000 * 100 / (POLL_MAX_RPS * POLL_NORMAL_BUDGET_PERCENT);
+    return max((uint32_t)POLL_INTERVAL_MS, sustainable);
+}
+
+uint32_t PollPacer::backoffInterval(uint32_t normal, uint8_t failures) {
+    if (failures == 0) {
+        return normal;
+    }
+    // 30 s, 60 s, 120 s... plafonné
+    uint8_t shift = failures - 1;
+    if (shift > 4) shift = 4;
+    uint32_t interval = normal << shift;
+    if (interval > POLL_BACKOFF_MAX_MS) interval = POLL_BACKOFF_MAX_MS;
+    return interval;
+}
+
+uint32_t PollPacer::withJitter(uint32_t interval) {
+    int32_t jitter = (int32_t)(interval * POLL_JITTER_PERCENT / 100);
+    return interval + random(-jitter, jitter + 1);
+}
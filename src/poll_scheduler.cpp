@@ -0,0 +1,270 @@
+#include "poll_scheduler.h"
+
+// Comparaison d'échéances millis() robuste au débordement (~49 jours)
+static inline bool isDue(uint32_t now, uint32_t deadline) {
+    return (int32_t)(now - deadline) >= 0;
+}
+
+PollScheduler::PollScheduler() {
+    schedule = nullptr;
+    capacity = 0;
+    maxInFlight = 1;
+    inFlightCount = 0;
+    earliestDue = 0;
+    normalIntervalMs = POLL_INTERVAL_MS;
+    lagMs = 0;
+    maxLagMs = 0;
+    totalPolls = 0;
+    totalBusyMs = 0;
+    cycleActive = false;
+    cycleStart = 0;
+    cyclePending = 0;
+    cycles = 0;
+    lastCycleMs = 0;
+    avgCycleMs = 0;
+}
+
+void PollScheduler::begin(MinerSchedule* slots, int count, uint8_t inFlight, uint32_t now) {
+    schedule = slots;
+    capacity = slots != nullptr ? count : 0;
+    for (int i = 0; i < capacity; i++) {
+        schedule[i].id = MINER_ID_NONE;
+        schedule[i].inFlight = false;
+        schedule[i].removed = false;
+        schedule[i].cycled = true;
+    }
+    maxInFlight = constrain(inFlight, 1, POLLER_MAX_IN_FLIGHT);
+    inFlightCount = 0;
+    pacer.begin(maxInFlight, now);
+    earliestDue = now;
+    cycleActive = false;
+    cyclePending = 0;
+    cycles = 0;
+    lastCycleMs = 0;
+    avgCycleMs = 0;
+}
+
+// Nouveau cycle : les mineurs actifs hors backoff (tous si all) sont attendus
+void PollScheduler::startCycle(uint32_t now, bool all) {
+    cyclePending = 0;
+    for (int slot = 0; slot < capacity; slot++) {
+        MinerSchedule& entry = schedule[slot];
+        bool counted = entry.id != MINER_ID_NONE && !entry.removed && (all || entry.failures == 0);
+        entry.cycled = !counted;
+        if (counted) cyclePending++;
+    }
+    cycleActive = cyclePending > 0;
+    cycleStart = now;
+}
+
+int PollScheduler::find(uint16_t id) const {
+    for (int slot = 0; slot < capacity; slot++) {
+        if (schedule[slot].id == id && !schedule[slot].removed) {
+            return slot;
+        }
+    }
+    return -1;
+}
+
+bool PollScheduler::add(uint16_t id, const char* ip, uint32_t now) {
+    int freeSlot = -1;
+    for (int slot = 0; slot < capacity; slot++) {
+        if (schedule[slot].id == MINER_ID_NONE) {
+            freeSlot = slot;
+            break;
+        }
+    }
+    if (freeSlot < 0) {
+        return false;
+    }
+
+    MinerSchedule& entry = schedule[freeSlot];
+    entry.id = id;
+    entry.ip = ip;
+    entry.fieldMap = BitaxeFieldMap();
+    entry.inFlight = false;
+    entry.removed = false;
+    entry.nextDue = now;
+    entry.interval = 0;
+    entry.failures = 0;
+    entry.fast = false;
+    entry.lastHashrate = 0;
+    entry.lastTemp = 0;
+    entry.polls = 0;
+    entry.errors = 0;
+    entry.busyMs = 0;
+    entry.srttMs = 0;
+    entry.rtoMs = 0;
+    entry.cycled = true;
+    earliestDue = now;
+    // Attendu dans le cycle en cours, ou en ouvre un
+    if (cycleActive) {
+        entry.cycled = false;
+        cyclePending++;
+    } else {
+        startCycle(now, false);
+    }
+    return true;
+}
+
+void PollScheduler::remove(int slot) {
+    MinerSchedule& entry = schedule[slot];
+    // Plus attendu : le cycle se ferme à la prochaine réponse s'il ne restait que lui
+    if (!entry.cycled) {
+        entry.cycled = true;
+        cyclePending--;
+    }
+    if (entry.inFlight) {
+        entry.removed = true;  // Le worker libère le slot à la fin de la requête
+    } else {
+        entry.id = MINER_ID_NONE;
+    }
+}
+
+bool PollScheduler::updateNormalInterval() {
+    int active = 0;
+    for (int slot = 0; slot < capacity; slot++) {
+        if (schedule[slot].id != MINER_ID_NONE && !schedule[slot].removed) active++;
+    }
+    uint32_t interval = PollPacer::normalInterval(active);
+    if (interval == normalIntervalMs) {
+        return false;
+    }
+    normalIntervalMs = interval;
+    return true;
+}
+
+void PollScheduler::requestPoll(uint16_t id, uint32_t now) {
+    int slot = find(id);
+    // Déjà en vol : la réponse attendue est aussi fraîche
+    if (slot >= 0 && !schedule[slot].inFlight) {
+        schedule[slot].nextDue = now;
+        earliestDue = now;
+    }
+}
+
+bool PollScheduler::hasDue(uint32_t now) const {
+    return isDue(now, earliestDue);
+}
+
+// Entre deux échéances le tick ne parcourt pas la flotte (hasDue)
+int PollScheduler::dispatchDue(uint32_t now, bool pollAll, int* launch, int maxLaunch) {
+    // Remplir le seau à jetons (rafale max = nombre de workers)
+    pacer.refill(now);
+
+    if (pollAll) {
+        for (int slot = 0; slot < capacity; slot++) {
+            if (schedule[slot].id != MINER_ID_NONE && !schedule[slot].inFlight) {
+                schedule[slot].nextDue = now;
+            }
+        }
+        // Refresh : le cycle mesure la passe complète, mineurs en backoff compris
+        startCycle(now, true);
+    }
+
+    int count = 0;
+    for (;;) {
+        // Le plus en retard, et la prochaine échéance parmi les autres
+        int best = -1;
+        int32_t bestLate = -1;
+        uint32_t nextDue = now + POLL_BACKOFF_MAX_MS;
+        for (int slot = 0; slot < capacity; slot++) {
+            MinerSchedule& entry = schedule[slot];
+            if (entry.id == MINER_ID_NONE || entry.removed || entry.inFlight) continue;
+            if (!isDue(now, entry.nextDue)) {
+                if (isDue(nextDue, entry.nextDue)) nextDue = entry.nextDue;
+                continue;
+            }
+            int32_t late = (int32_t)(now - entry.nextDue);
+            if (late > bestLate) {
+                bestLate = late;
+                best = slot;
+            }
+        }
+        // Mineur échu mais pas de worker ou de jeton libre : réessayer au prochain tick
+        earliestDue = best >= 0 ? now : nextDue;
+        if (best < 0 || count >= maxLaunch || inFlightCount >= maxInFlight || !pacer.take()) break;
+
+        lagMs = (lagMs * 7 + (uint32_t)bestLate) / 8;
+        if ((uint32_t)bestLate > maxLagMs) maxLagMs = bestLate;
+        schedule[best].inFlight = true;
+        inFlightCount++;
+        launch[count++] = best;
+    }
+    return count;
+}
+
+uint32_t PollScheduler::nextInterval(const MinerSchedule& entry, const PollOutcome& outcome) const {
+    uint32_t interval;
+    if (entry.failures > 0) {
+        interval = PollPacer::backoffInterval(normalIntervalMs, entry.failures);
+    } else if (outcome.pushLive) {
+        // Hashrate et shares arrivent par le WebSocket : réconciliation lente (temp/power)
+        interval = POLL_PUSH_RECONCILE_MS;
+    } else if (outcome.focused) {
+        interval = POLL_FAST_INTERVAL_MS;
+    } else if (outcome.poolCovered) {
+        // Données du pool fraîches pour ce mineur : le poll direct s'espace
+        interval = POLL_POOL_COVERED_MS;
+    } else if (entry.fast) {
+        interval = POLL_FAST_INTERVAL_MS;
+    } else {
+        interval = normalIntervalMs;
+    }
+
+    return PollPacer::withJitter(interval);
+}
+
+void PollScheduler::complete(int slot, const PollOutcome& outcome, uint32_t now) {
+    if (slot < 0 || slot >= capacity) {
+        return;
+    }
+    MinerSchedule& entry = schedule[slot];
+
+    entry.polls++;
+    entry.busyMs += outcome.latencyMs;
+    entry.srttMs = outcome.srttMs;
+    entry.rtoMs = outcome.rtoMs;
+    totalPolls++;
+    totalBusyMs += outcome.latencyMs;
+
+    if (outcome.success) {
+        // Cadence rapide tant que hashrate ou température bougent
+        float hashrateDelta = fabsf(outcome.hashrate - entry.lastHashrate);
+        entry.fast = entry.polls > 1 &&
+                     (hashrateDelta > entry.lastHashrate * POLL_HASHRATE_DELTA ||
+                      fabsf(outcome.temp - entry.lastTemp) >= POLL_TEMP_DELTA);
+        entry.lastHashrate = outcome.hashrate;
+        entry.lastTemp = outcome.temp;
+        entry.failures = 0;
+    } else {
+        entry.errors++;
+        if (entry.failures < 255) entry.failures++;
+        entry.fast = false;
+    }
+
+    entry.interval = nextInterval(entry, outcome);
+    entry.nextDue = now + entry.interval;
+    if (isDue(earliestDue, entry.nextDue)) {
+        earliestDue = entry.nextDue;
+    }
+    entry.inFlight = false;
+    if (entry.removed) {
+        entry.removed = false;
+        entry.id = MINER_ID_NONE;
+    }
+    if (inFlightCount > 0) inFlightCount--;
+
+    if (!entry.cycled) {
+        entry.cycled = true;
+        cyclePending--;
+    }
+    if (!cycleActive) {
+        startCycle(now, false);
+    } else if (cyclePending <= 0) {
+        lastCycleMs = now - cycleStart;
+        avgCycleMs = cycles == 0 ? lastCycleMs : (avgCycleMs * 7 + lastCycleMs) / 8;
+        cycles++;
+        startCycle(now, false);
+    }
+}
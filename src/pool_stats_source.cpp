@@ -0,0 +1,227 @@
+#include "pool_stats_source.h"
+#include "wifi_manager.h"
+#include "miner_registry.h"
+#include "socket_budget.h"
+#include <HTTPClient.h>
+
+PoolStatsSource* PoolStatsSource::instance = nullptr;
+
+PoolStatsSource::PoolStatsSource() {
+    mutex = xSemaphoreCreateMutex();
+    task = nullptr;
+    coveredCount = 0;
+    capacity = fleetCapacity();
+    coveredIds = fleetAllocArray<uint16_t>(capacity);
+    scratchIds = fleetAllocArray<uint16_t>(capacity);
+    if (coveredIds == nullptr || scratchIds == nullptr) {
+        capacity = 0;
+    }
+    memset(&status, 0, sizeof(status));
+}
+
+PoolStatsSource* PoolStatsSource::getInstance() {
+    if (!instance) {
+        instance = new PoolStatsSource();
+    }
+    return instance;
+}
+
+void PoolStatsSource::begin() {
+    if (task != nullptr || capacity == 0) {
+        return;  // Déjà démarré
+    }
+
+    prefs.begin("poolsrc", true);
+    urlTemplate = prefs.getString("url", "");
+    prefs.end();
+    status.enabled = !urlTemplate.isEmpty();
+
+    xTaskCreatePinnedToCore(taskEntry, "pool_source", POOL_SOURCE_TASK_STACK, this, 1, &task, POOL_SOURCE_TASK_CORE);
+    Serial.printf("[PoolSource] %s\n", status.enabled ? urlTemplate.c_str() : "Disabled (no URL configured)");
+}
+
+bool PoolStatsSource::setUrlTemplate(const String& url) {
+    if (!url.isEmpty() && (url.length() >= POOL_SOURCE_URL_LEN || !url.startsWith("http") ||
+                           url.indexOf(POOL_SOURCE_ADDRESS_TOKEN) < 0)) {
+        return false;
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    urlTemplate = url;
+    status.enabled = !url.isEmpty();
+    if (!status.enabled) {
+        coveredCount = 0;  // Le polling direct reprend sa cadence normale
+    }
+    xSemaphoreGive(mutex);
+
+    prefs.begin("poolsrc", false);
+    prefs.putString("url", url);
+    prefs.end();
+    Serial.printf("[PoolSource] URL set to '%s'\n", url.c_str());
+
+    if (task != nullptr) {
+        xTaskNotifyGive(task);  // Premier fetch sans attendre l'intervalle
+    }
+    return true;
+}
+
+String PoolStatsSource::getUrlTemplate() {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    String url = urlTemplate;
+    xSemaphoreGive(mutex);
+    return url;
+}
+
+void PoolStatsSource::taskEntry(void* arg) {
+    PoolStatsSource* self = (PoolStatsSource*)arg;
+    for (;;) {
+        if (self->status.enabled) {
+            self->refresh();
+        }
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(POOL_SOURCE_INTERVAL_MS));
+    }
+}
+
+bool PoolStatsSource::fetchAddress(const char* address, JsonDocument& doc) {
+    String url = getUrlTemplate();
+    url.replace(POOL_SOURCE_ADDRESS_TOKEN, address);
+
+    SocketLease socket(SOCKET_ONE_SHOT);
+    if (!socket.granted()) {
+        Serial.println("[PoolSource] No lwIP socket left, refresh skipped");
+        return false;
+    }
+    HTTPClient http;
+    http.begin(url);
+    http.useHTTP10(true);  // Pas de chunked : parse direct depuis le flux
+    http.setTimeout(POOL_SOURCE_TIMEOUT_MS);
+
+    int httpCode = http.GET();
+    if (httpCode != HTTP_CODE_OK) {
+        Serial.printf("[PoolSource] HTTP %d for %.12s...\n", httpCode, address);
+        http.end();
+        return false;
+    }
+    DeserializationError error = deserializeJson(doc, http.getStream(), DeserializationOption::Filter(PoolWorkers::filter()));
+    http.end();
+    if (error) {
+        Serial.printf("[PoolSource] JSON parse error: %s\n", error.c_str());
+        return false;
+    }
+    return true;
+}
+
+void PoolStatsSource::refresh() {
+    WifiManager* wifi = WifiManager::getInstance();
+    MinerRegistry* registry = MinerRegistry::getInstance();
+
+    // Adresses distinctes tirées des poolUser déjà connus ("adresse.worker")
+    char addresses[POOL_SOURCE_MAX_ADDRESSES][POOL_SOURCE_ADDRESS_LEN];
+    int addressCount = 0;
+    for (int i = 0; i < wifi->getBitaxeCount(); i++) {
+        BitaxeDevice device;
+        MinerView view;
+        if (!wifi->copyBitaxe(i, device) || !registry->read(device.id, view) || !view.polled) continue;
+
+        const char* user = view.stats.poolUser.c_str();
+        size_t len = strcspn(user, ".");
+        if (len == 0 || len >= POOL_SOURCE_ADDRESS_LEN) continue;
+
+        bool known = false;
+        for (int a = 0; a < addressCount && !known; a++) {
+            known = strncmp(addresses[a], user, len) == 0 && addresses[a][len] == '\0';
+        }
+        if (!known && addressCount < POOL_SOURCE_MAX_ADDRESSES) {
+            memcpy(addresses[addressCount], user, len);
+            addresses[addressCount][len] = '\0';
+            addressCount++;
+        }
+    }
+    if (addressCount == 0) {
+        return;  // Aucun mineur interrogé pour l'instant
+    }
+
+    // Une requête par adresse (en général une seule pour toute la flotte)
+    int count = 0;
+    int workers = 0;
+    bool ok = false;
+    for (int a = 0; a < addressCount; a++) {
+        JsonDocument doc;
+        if (!fetchAddress(addresses[a], doc)) continue;
+        ok = true;
+        workers += doc["worker"].size() + doc["workers"].size();
+        count = applyWorkers(addresses[a], doc.as<JsonVariantConst>(), scratchIds, count);
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    if (ok) {
+        memcpy(coveredIds, scratchIds, count * sizeof(uint16_t));
+        coveredCount = count;
+        status.fetches++;
+        status.lastFetchAt = millis();
+        status.workers = workers;
+        status.matched = count;
+    } else {
+        status.errors++;
+    }
+    xSemaphoreGive(mutex);
+
+    if (ok) {
+        Serial.printf("[PoolSource] %d worker(s), %d miner(s) covered\n", workers, count);
+    }
+}
+
+int PoolStatsSource::applyWorkers(const char* address, JsonVariantConst doc, uint16_t* covered, int count) {
+    PoolWorkerList workers;
+    if (!PoolWorkers::open(doc, workers)) {
+        Serial.println("[PoolSource] Unknown pool response format");
+        return count;
+    }
+
+    WifiManager* wifi = WifiManager::getInstance();
+    MinerRegistry* registry = MinerRegistry::getInstance();
+    size_t addressLen = strlen(address);
+    for (int i = 0; i < wifi->getBitaxeCount(); i++) {
+        BitaxeDevice device;
+        MinerView view;
+        if (!wifi->copyBitaxe(i, device) || !registry->read(device.id, view)) continue;
+        const char* user = view.stats.poolUser.c_str();
+        if (strncmp(user, address, addressLen) != 0 || (user[addressLen] != '.' && user[addressLen] != '\0')) continue;
+
+        float hashrate;
+        uint32_t bestDiff;
+        if (!PoolWorkers::find(workers, user, hashrate, bestDiff)) continue;
+        registry->publishPoolStats(device.id, hashrate, bestDiff);
+        // Un worker à 0 H/s ne prouve pas que le mineur tourne : polling direct
+        if (hashrate > 0 && count < capacity) {
+            covered[count++] = device.id;
+        }
+    }
+    return count;
+}
+
+bool PoolStatsSource::covers(uint16_t id) {
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return false;
+    }
+    bool result = false;
+    if (status.enabled && status.lastFetchAt != 0 && millis() - status.lastFetchAt < POOL_SOURCE_FRESH_MS) {
+        for (int i = 0; i < coveredCount; i++) {
+            if (coveredIds[i] == id) {
+                result = true;
+                break;
+            }
+        }
+    }
+    xSemaphoreGive(mutex);
+    return result;
+}
+
+bool PoolStatsSource::getStatus(PoolSourceStatus& out) {
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return false;
+    }
+    out = status;
+    xSemaphoreGive(mutex);
+    return true;
+}
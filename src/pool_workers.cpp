@@ -0,0 +1,80 @@
+#include "pool_workers.h"
+
+static JsonDocument buildPoolFilter() {
+    JsonDocument filter;
+    filter["worker"][0]["workername"] = true;
+    filter["worker"][0]["hashrate1m"] = true;
+    filter["worker"][0]["bestshare"] = true;
+    filter["workers"][0]["name"] = true;
+    filter["workers"][0]["hashRate"] = true;
+    filter["workers"][0]["bestDifficulty"] = true;
+    return filter;
+}
+static JsonDocument poolFilter = buildPoolFilter();
+
+const JsonDocument& PoolWorkers::filter() {
+    return poolFilter;
+}
+
+bool PoolWorkers::open(JsonVariantConst doc, PoolWorkerList& out) {
+    if (doc["worker"].is<JsonArrayConst>()) {
+        out.list = doc["worker"];
+        out.nameKey = "workername";
+        out.hashrateKey = "hashrate1m";
+        out.bestKey = "bestshare";
+        return true;
+    }
+    if (doc["workers"].is<JsonArrayConst>()) {
+        out.list = doc["workers"];
+        out.nameKey = "name";
+        out.hashrateKey = "hashRate";
+        out.bestKey = "bestDifficulty";
+        return true;
+    }
+    return false;
+}
+
+bool PoolWorkers::find(const PoolWorkerList& workers, const char* poolUser, float& hashrate, uint32_t& bestDiff) {
+    for (JsonVariantConst worker : workers.list) {
+        const char* name = worker[workers.nameKey];
+        if (name == nullptr || !workerMatches(name, poolUser)) continue;
+
+        hashrate = (float)(parseScaled(worker[workers.hashrateKey]) / 1e9);  // H/s -> GH/s
+        double best = parseScaled(worker[workers.bestKey]);
+        bestDiff = best >= 4294967295.0 ? UINT32_MAX : (best > 0 ? (uint32_t)best : 0);
+        return true;
+    }
+    return false;
+}
+
+double PoolWorkers::parseScaled(JsonVariantConst value) {
+    if (!value.is<const char*>()) {
+        return value.as<double>();
+    }
+    char* end = nullptr;
+    double number = strtod(value.as<const char*>(), &end);
+    while (end != nullptr && *end == ' ') end++;
+    switch (end != nullptr ? toupper(*end) : 0) {
+        case 'K': return number * 1e3;
+        case 'M': return number * 1e6;
+        case 'G': return number * 1e9;
+        case 'T': return number * 1e12;
+        case 'P': return number * 1e15;
+        case 'E': return number * 1e18;
+    }
+    return number;
+}
+
+// Partie après "adresse." (le nom du worker), ou toute la chaîne
+static const char* workerSuffix(const char* name) {
+    const char* dot = strchr(name, '.');
+    return dot != nullptr ? dot + 1 : name;
+}
+
+bool PoolWorkers::workerMatches(const char* workerName, const char* poolUser) {
+    if (strcmp(workerName, poolUser) == 0) {
+        return true;
+    }
+    const char* suffix = workerSuffix(poolUser);
+    return suffix != poolUser && suffix[0] != '\0' && strcmp(workerSuffix(workerName), suffix) == 0;
+}
@@ -0,0 +1,290 @@
+#include "price_providers.h"
+#include "external_http.h"
+#include <algorithm>
+
+PriceProviders* PriceProviders::instance = nullptr;
+
+// CoinGecko : {"bitcoin":{"usd":67012.34}}
+static bool parseCoinGecko(JsonDocument& doc, float& price) {
+    price = doc["bitcoin"]["usd"] | 0.0f;
+    return price > 0;
+}
+
+// Coinbase : {"data":{"amount":"67012.34","base":"BTC","currency":"USD"}}
+static bool parseCoinbase(JsonDocument& doc, float& price) {
+    price = strtof(doc["data"]["amount"] | "0", nullptr);
+    return price > 0;
+}
+
+// Kraken : {"error":[],"result":{"XXBTZUSD":{"c":["67012.30000","0.0012"],...}}}
+static bool parseKraken(JsonDocument& doc, float& price) {
+    price = strtof(doc["result"]["XXBTZUSD"]["c"][0] | "0", nullptr);
+    return price > 0;
+}
+
+// Ordre de préférence à santé égale
+static const PriceProvider providers[PRICE_PROVIDER_COUNT] = {
+    { "CoinGecko", "https://api.coingecko.com/api/v3/simple/price?ids=bitcoin&vs_currencies=usd", 300, parseCoinGecko },
+    { "Coinbase",  "https://api.coinbase.com/v2/prices/BTC-USD/spot",                             600, parseCoinbase },
+    { "Kraken",    "https://api.kraken.com/0/public/Ticker?pair=XBTUSD",                          600, parseKraken },
+};
+
+PriceProviders::PriceProviders() {
+    mutex = xSemaphoreCreateMutex();
+    for (int i = 0; i < PRICE_WORKER_COUNT; i++) {
+        workers[i] = nullptr;
+    }
+    jobs = nullptr;
+    results = nullptr;
+    inFlight = 0;
+    jobSeq = 0;
+    hedges = 0;
+    memset(states, 0, sizeof(states));
+    for (int i = 0; i < PRICE_PROVIDER_COUNT; i++) {
+        states[i].health = 1.0f;
+    }
+}
+
+PriceProviders* PriceProviders::getInstance() {
+    if (!instance) {
+        instance = new PriceProviders();
+    }
+    return instance;
+}
+
+void PriceProviders::begin() {
+    if (jobs != nullptr) {
+        return;  // Déjà démarré
+    }
+    jobs = xQueueCreate(PRICE_WORKER_COUNT, sizeof(PriceJob));
+    results = xQueueCreate(PRICE_WORKER_COUNT * 2, sizeof(PriceResult));
+    for (int i = 0; i < PRICE_WORKER_COUNT; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "price_w%d", i);
+        xTaskCreatePinnedToCore(workerEntry, name, PRICE_WORKER_STACK, this, 1, &workers[i], PRICE_WORKER_CORE);
+    }
+    Serial.printf("[Price] %d provider(s), hedging after p95 (%d-%d ms)\n", PRICE_PROVIDER_COUNT,
+                  PRICE_HEDGE_MIN_MS, PRICE_HEDGE_MAX_MS);
+}
+
+void PriceProviders::workerEntry(void* arg) {
+    PriceProviders* self = (PriceProviders*)arg;
+    PriceJob job;
+    for (;;) {
+        if (xQueueReceive(self->jobs, &job, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        PriceResult result;
+        result.seq = job.seq;
+        result.provider = job.provider;
+        result.ok = self->runProvider(job.provider, result.price);
+        xSemaphoreTake(self->mutex, portMAX_DELAY);
+        self->inFlight--;
+        xSemaphoreGive(self->mutex);
+        // Réponse tardive d'une course terminée : ignorée par fetch() (statistiques déjà comptées)
+        xQueueSend(self->results, &result, 0);
+    }
+}
+
+bool PriceProviders::runProvider(int index, float& price) {
+    const PriceProvider& provider = providers[index];
+    PriceProviderState& state = states[index];
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    uint32_t now = millis();
+    if (now - state.budgetWindowStart >= PRICE_BUDGET_WINDOW_MS) {
+        state.budgetWindowStart = now;
+        state.budgetUsed = 0;
+    }
+    state.budgetUsed++;
+    state.requests++;
+    bool haveResult = state.lastPrice > 0;
+    xSemaphoreGive(mutex);
+
+    JsonDocument doc;
+    uint32_t start = millis();
+    int httpCode = ExternalHttp::getInstance()->getJson(provider.url, doc, nullptr, EXT_HTTP_TIMEOUT_MS, haveResult);
+    uint32_t elapsed = millis() - start;
+
+    price = 0;
+    bool ok = false;
+    if (ExternalHttp::unchanged(httpCode)) {
+        price = state.lastPrice;
+        ok = price > 0;
+    } else if (httpCode == HTTP_CODE_OK) {
+        ok = provider.parse(doc, price);
+    }
+
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    // Une réponse servie par le cache n'a pas de latence réseau
+    if (httpCode != EXT_HTTP_CACHE_FRESH) {
+        state.latencies[state.latencyNext] = (uint16_t)min(elapsed, (uint32_t)UINT16_MAX);
+        state.latencyNext = (state.latencyNext + 1) % PRICE_LATENCY_SAMPLES;
+        if (state.latencyCount < PRICE_LATENCY_SAMPLES) state.latencyCount++;
+    }
+    state.health = state.health * (1.0f - PRICE_HEALTH_ALPHA) + (ok ? PRICE_HEALTH_ALPHA : 0.0f);
+    if (ok) {
+        state.lastPrice = price;
+    } else {
+        state.failures++;
+    }
+    if (httpCode == HTTP_CODE_TOO_MANY_REQUESTS) {
+        state.backoffUntil = millis() + PRICE_RATE_LIMIT_BACKOFF_MS;
+    }
+    xSemaphoreGive(mutex);
+
+    if (!ok) {
+        Serial.printf("[Price] %s failed: %d after %lu ms\n", provider.name, httpCode, elapsed);
+    }
+    return ok;
+}
+
+// Fournisseurs utilisables, du plus sain au moins sain ; retourne leur nombre
+int PriceProviders::rankProviders(int* order) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    uint32_t now = millis();
+    int count = 0;
+    for (int i = 0; i < PRICE_PROVIDER_COUNT; i++) {
+        PriceProviderState& state = states[i];
+        if (state.backoffUntil != 0) {
+            if ((int32_t)(now - state.backoffUntil) < 0) continue;
+            state.backoffUntil = 0;
+        }
+        bool windowOpen = now - state.budgetWindowStart < PRICE_BUDGET_WINDOW_MS;
+        if (windowOpen && state.budgetUsed >= providers[i].budgetPerHour) continue;
+
+        // Tri par insertion : à santé égale, l'ordre de la table est gardé
+        int pos = count++;
+        while (pos > 0 && states[order[pos - 1]].health < state.health) {
+            order[pos] = order[pos - 1];
+            pos--;
+        }
+        order[pos] = i;
+    }
+    xSemaphoreGive(mutex);
+    return count;
+}
+
+uint32_t PriceProviders::p95Locked(const PriceProviderState& state) const {
+    if (state.latencyCount == 0) {
+        return PRICE_HEDGE_DEFAULT_MS;
+    }
+    uint16_t sorted[PRICE_LATENCY_SAMPLES];
+    memcpy(sorted, state.latencies, sizeof(uint16_t) * state.latencyCount);
+    std::sort(sorted, sorted + state.latencyCount);
+    int rank = (state.latencyCount * 95 + 99) / 100;  // Rang du p95 arrondi au-dessus
+    return sorted[rank - 1];
+}
+
+uint32_t PriceProviders::hedgeDelayMs(int index) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    uint32_t delayMs = p95Locked(states[index]);
+    xSemaphoreGive(mutex);
+    return constrain(delayMs, (uint32_t)PRICE_HEDGE_MIN_MS, (uint32_t)PRICE_HEDGE_MAX_MS);
+}
+
+// Lance un fournisseur sur une tâche libre ; false si les deux sont occupées
+// (par exemple par les réponses tardives d'une course précédente)
+bool PriceProviders::launch(int provider) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    bool free = inFlight < PRICE_WORKER_COUNT;
+    if (free) {
+        inFlight++;
+    }
+    xSemaphoreGive(mutex);
+    if (!free) {
+        return false;
+    }
+    PriceJob job = { race.seq, provider };
+    xQueueSend(jobs, &job, portMAX_DELAY);
+    race.outstanding++;
+    race.hedgeAt = millis() + hedgeDelayMs(provider);
+    return true;
+}
+
+bool PriceProviders::fetch(float& price, const char*& source) {
+    race.count = rankProviders(race.order);
+    if (race.count == 0) {
+        Serial.println("[Price] All providers rate-limited or over budget");
+        return false;
+    }
+
+    // Tâches pas démarrées : fournisseurs interrogés l'un après l'autre
+    if (jobs == nullptr) {
+        for (int i = 0; i < race.count; i++) {
+            if (runProvider(race.order[i], price)) {
+                source = providers[race.order[i]].name;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    race.seq = ++jobSeq;
+    race.next = 0;
+    race.outstanding = 0;
+    race.deadline = millis() + PRICE_FETCH_DEADLINE_MS;
+
+    for (;;) {
+        uint32_t now = millis();
+        if ((int32_t)(now - race.deadline) >= 0) {
+            Serial.printf("[Price] No provider answered within %d ms\n", PRICE_FETCH_DEADLINE_MS);
+            return false;
+        }
+
+        // Rien en vol, ou la requête en cours dépasse son p95 : le suivant part
+        bool wantLaunch = race.next < race.count &&
+                          (race.outstanding == 0 || (int32_t)(now - race.hedgeAt) >= 0);
+        uint32_t waitMs;
+        if (wantLaunch) {
+            if (launch(race.order[race.next])) {
+                if (race.outstanding > 1) {
+                    hedges++;
+                    Serial.printf("[Price] Hedging with %s\n", providers[race.order[race.next]].name);
+                }
+                race.next++;
+                continue;
+            }
+            waitMs = 50;  // Tâches encore prises par une course précédente
+        } else if (race.outstanding == 0) {
+            return false;  // Tous les fournisseurs ont échoué
+        } else {
+            uint32_t wakeAt = race.next < race.count ? race.hedgeAt : race.deadline;
+            if ((int32_t)(wakeAt - race.deadline) > 0) wakeAt = race.deadline;
+            waitMs = max((int32_t)(wakeAt - now), (int32_t)1);
+        }
+
+        PriceResult result;
+        if (xQueueReceive(results, &result, pdMS_TO_TICKS(waitMs)) != pdTRUE || result.seq != race.seq) {
+            continue;
+        }
+        race.outstanding--;
+        if (result.ok) {
+            if (result.provider != race.order[0]) {
+                xSemaphoreTake(mutex, portMAX_DELAY);
+                states[result.provider].hedgesWon++;
+                xSemaphoreGive(mutex);
+            }
+            price = result.price;
+            source = providers[result.provider].name;
+            return true;
+        }
+        // Échec : la tâche libérée part tout de suite sur le suivant
+        race.hedgeAt = millis();
+    }
+}
+
+void PriceProviders::printStats() {
+    if (xSemaphoreTake(mutex, pdMS_TO_TICKS(2)) != pdTRUE) {
+        return;
+    }
+    Serial.printf("Price providers: %u hedge(s)\n", hedges);
+    for (int i = 0; i < PRICE_PROVIDER_COUNT; i++) {
+        const PriceProviderState& state = states[i];
+        Serial.printf("  %-10s health %.2f, p95 %lu ms, %u req, %u fail, %u hedge win(s), budget %u/%u%s\n",
+                      providers[i].name, state.health, p95Locked(state), state.requests, state.failures,
+                      state.hedgesWon, state.budgetUsed, providers[i].budgetPerHour,
+                      state.backoffUntil != 0 ? ", rate-limited" : "");
+    }
+    xSemaphoreGive(mutex);
+}
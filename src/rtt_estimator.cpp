@@ -0,0 +1,42 @@
+#include "rtt_estimator.h"
+
+void RttEstimator::addSample(uint32_t rttMs) {
+    if (samples == 0) {
+        srtt = rttMs;
+        rttvar = rttMs / 2.0f;
+    } else {
+        float delta = srtt > rttMs ? srtt - rttMs : rttMs - srtt;
+        rttvar = 0.75f * rttvar + 0.25f * delta;
+        srtt = 0.875f * srtt + 0.125f * rttMs;
+    }
+    samples++;
+    timeouts = 0;
+    rto = (uint32_t)(srtt + 4.0f * rttvar);
+    if (rto < 1) rto = 1;
+}
+
+void RttEstimator::onTimeout() {
+    rto = rto * 2;
+    if (rto > BITAXE_RTO_MAX_MS) rto = BITAXE_RTO_MAX_MS;
+    if (timeouts < 255) timeouts++;
+}
+
+uint32_t RttEstimator::deadline(float factor, uint32_t minMs, uint32_t maxMs) const {
+    return constrain((uint32_t)(rto * factor), minMs, maxMs);
+}
+
+uint32_t RttEstimator::probeTimeout() const {
+    // Même formule que le RTO mais sans le plancher des requêtes : le RTT
+    // mesuré inclut la réponse HTTP, il majore donc le temps de connexion
+    uint32_t cap = BITAXE_PROBE_MAX_MS;
+    for (uint8_t i = 0; i < timeouts && cap < BITAXE_PROBE_BACKOFF_MS; i++) {
+        cap *= 2;
+    }
+    if (cap > BITAXE_PROBE_BACKOFF_MS) cap = BITAXE_PROBE_BACKOFF_MS;
+    // Connexion déjà manquée : le mineur a droit au plafond, même si son
+    // RTT habituel est bas (redémarrage, Wi-Fi dégradé)
+    if (samples == 0 || timeouts > 0) {
+        return cap;
+    }
+    return constrain(rto, (uint32_t)BITAXE_PROBE_MIN_MS, (uint32_t)BITAXE_PROBE_MAX_MS);
+}
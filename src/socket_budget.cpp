@@ -0,0 +1,89 @@
+#include "socket_budget.h"
+#include "miner_connection_pool.h"
+#include "external_http.h"
+
+SocketBudget* SocketBudget::instance = nullptr;
+
+static const char* const SOCKET_USER_NAMES[SOCKET_USER_COUNT] = {
+    "miners", "external", "one-shot", "chain feed", "telemetry", "discovery"
+};
+
+SocketBudget::SocketBudget() {
+    mutex = xSemaphoreCreateMutex();
+    for (int i = 0; i < SOCKET_USER_COUNT; i++) {
+        reserved[i] = 0;
+        inUse[i] = 0;
+        peak[i] = 0;
+        refused[i] = 0;
+    }
+    // Les pools ont toujours de quoi remplir tous leurs slots ; le flux de
+    // blocs réserve ses sockets quand il est activé (ChainFeed::setEnabled)
+    reserved[SOCKET_MINERS] = POOL_MAX_CONNECTIONS;
+    reserved[SOCKET_EXTERNAL] = EXT_HTTP_MAX_CONNECTIONS;
+    reserved[SOCKET_ONE_SHOT] = 1;
+    reserved[SOCKET_DISCOVERY] = 1;  // Le balayage avance même quand tout est pris
+}
+
+SocketBudget* SocketBudget::getInstance() {
+    if (!instance) {
+        instance = new SocketBudget();
+    }
+    return instance;
+}
+
+int SocketBudget::sharedFreeLocked() const {
+    // Une réserve non utilisée reste bloquée pour son propriétaire
+    int committed = 0;
+    for (int i = 0; i < SOCKET_USER_COUNT; i++) {
+        committed += max(inUse[i], reserved[i]);
+    }
+    return max(0, SOCKET_BUDGET_TOTAL - committed);
+}
+
+void SocketBudget::setReserve(SocketUser user, uint8_t count) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    reserved[user] = count;
+    xSemaphoreGive(mutex);
+}
+
+bool SocketBudget::acquire(SocketUser user) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    bool granted = inUse[user] < reserved[user] || sharedFreeLocked() > 0;
+    if (granted) {
+        inUse[user]++;
+        peak[user] = max(peak[user], inUse[user]);
+    } else {
+        refused[user]++;
+    }
+    xSemaphoreGive(mutex);
+    return granted;
+}
+
+void SocketBudget::release(SocketUser user) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    if (inUse[user] > 0) {
+        inUse[user]--;
+    }
+    xSemaphoreGive(mutex);
+}
+
+int SocketBudget::available(SocketUser user) {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    int count = max(0, reserved[user] - inUse[user]) + sharedFreeLocked();
+    xSemaphoreGive(mutex);
+    return count;
+}
+
+void SocketBudget::printStats() {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    int total = 0;
+    for (int i = 0; i < SOCKET_USER_COUNT; i++) {
+        total += inUse[i];
+    }
+    Serial.printf("Sockets: %d/%d in use, %d shared free\n", total, SOCKET_BUDGET_TOTAL, sharedFreeLocked());
+    for (int i = 0; i < SOCKET_USER_COUNT; i++) {
+        Serial.printf("  %-10s %u in use (reserve %u, peak %u), %u refused\n",
+                      SOCKET_USER_NAMES[i], inUse[i], reserved[i], peak[i], refused[i]);
+    }
+    xSemaphoreGive(mutex);
+}
@@ -108,7 +108,8 @@ String TimeManager::getFormattedDate() {
 void TimeManager::update() {
     if (!timeInitialized) {
         struct tm timeinfo;
-        if (getLocalTime(&timeinfo)) {
+        // Sans attente : appelé à chaque tour de loop(), avant même la connexion WiFi
+        if (getLocalTime(&timeinfo, 0)) {
             timeInitialized = true;
             Serial.printf("[TimeManager] NTP synchronized! Time: %02d:%02d:%02d\n", 
                          timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
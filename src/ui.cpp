@@ -5,6 +5,9 @@
 #include "time_manager.h"
 #include "wifi_manager.h"
 #include "bitaxe_api.h"
+#include "miner_poller.h"
+#include "miner_registry.h"
+#include "fleet_command_queue.h"
 #include "bitcoin_api.h"
 #include "weather_manager.h"
 
@@ -32,6 +35,9 @@ static lv_obj_t *block_height_label = nullptr;  // Label pour la hauteur du bloc
 static lv_obj_t *block_fees_label = nullptr;  // Label pour les frais min-max
 static lv_obj_t *block_age_label = nullptr;  // Label pour l'âge du bloc
 static lv_obj_t *block_pool_label = nullptr;  // Label pour le pool minier
+static lv_obj_t *fee_strip_container = nullptr;  // Bandeau blocs projetés | blocs minés
+static lv_obj_t *projected_bars[PROJECTED_BLOCKS_COUNT] = {};  // Fee médiane des blocs projetés
+static lv_obj_t *recent_bars[RECENT_BLOCKS_COUNT] = {};  // Fee moyenne des derniers blocs
 static lv_obj_t *best_diff_label = nullptr;  // Meilleure difficulté des miners
 static lv_obj_t *total_power_label = nullptr;  // Consommation totale des miners
 static lv_obj_t *bitaxe_container = nullptr;
@@ -58,12 +64,9 @@ static bool squares_animation_active = false;
 // Index du mineur actuellement affiché dans le carousel
 static int current_miner_index = 0;
 
-// Cache des statistiques des mineurs pour navigation instantanée
-#define MAX_CACHED_MINERS 10
-static BitaxeStats cached_stats[MAX_CACHED_MINERS];
-static uint32_t cached_stats_timestamp[MAX_CACHED_MINERS];
-static bool cached_stats_valid[MAX_CACHED_MINERS];
-#define CACHE_TIMEOUT_MS 30000  // 30 secondes de validité du cache
+// Les statistiques des mineurs viennent du MinerRegistry, alimenté par le
+// MinerPoller (tâche cœur 0) qui planifie lui-même chaque mineur :
+// l'UI ne fait plus jamais de requête HTTP elle-même
 
 // Flag pour différer le changement d'écran (évite crash pendant event callbacks)
 static bool pending_screen_change = false;
@@ -80,86 +83,18 @@ static lv_obj_t* page_indicator = nullptr;  // Indicateur de page
 enum ScreenState { WELCOME_SCREEN, CLOCK_SCREEN, MINERS_SCREEN, DASHBOARD_SCREEN };
 static ScreenState current_screen = WELCOME_SCREEN;
 
-// Fonction pour rafraîchir le cache des statistiques de tous les mineurs
-static void refreshStatsCache() {
-    WifiManager* wifi = WifiManager::getInstance();
-    int bitaxeCount = wifi->getBitaxeCount();
-    uint32_t now = millis();
-
-    if (!wifi->isConnected()) {
-        Serial.println("[UI] WiFi not connected - skipping stats cache refresh");
-        return;
-    }
-
-    Serial.printf("[UI] Refreshing stats cache for %d miners...\n", bitaxeCount);
-
-    for (int i = 0; i < bitaxeCount && i < MAX_CACHED_MINERS; i++) {
-        BitaxeDevice* device = wifi->getBitaxe(i);
-        if (device == nullptr) continue;
-
-        // Vérifier si le cache est encore valide (moins de 30 secondes)
-        if (cached_stats_valid[i] && (now - cached_stats_timestamp[i]) < CACHE_TIMEOUT_MS) {
-            continue;  // Cache encore valide, passer au suivant
-        }
-
-        BitaxeAPI api;
-        api.setDevice(device->ip);
-
-        BitaxeStats stats;
-        if (api.getStats(stats)) {
-            // Cache valide
-            cached_stats[i] = stats;
-            cached_stats_timestamp[i] = now;
-            cached_stats_valid[i] = true;
-            device->online = true;
-
-            Serial.printf("[UI] Cached stats for miner %d (%s): %.1f GH/s, %.1f°C\n",
-                        i, device->name.c_str(), stats.hashrate, stats.temp);
-        } else {
-            // Échec de récupération - invalider le cache
-            cached_stats_valid[i] = false;
-            device->online = false;
-            Serial.printf("[UI] Failed to cache stats for miner %d (%s)\n",
-                        i, device->name.c_str());
-        }
-    }
-
-    Serial.println("[UI] Stats cache refresh completed");
+// Fonction pour obtenir l'entrée du registre d'un mineur (par position dans la liste)
+static bool getMinerView(int minerIndex, MinerView& view) {
+    BitaxeDevice device;
+    return WifiManager::getInstance()->copyBitaxe(minerIndex, device) &&
+           MinerRegistry::getInstance()->read(device.id, view);
 }
 
-// Fonction pour obtenir les stats d'un mineur depuis le cache (ou forcer refresh si expiré)
-static bool getCachedStats(int minerIndex, BitaxeStats& stats) {
-    if (minerIndex < 0 || minerIndex >= MAX_CACHED_MINERS) return false;
-
-    // Si le cache n'est pas valide ou expiré, essayer de rafraîchir
-    if (!cached_stats_valid[minerIndex] ||
-        (millis() - cached_stats_timestamp[minerIndex]) >= CACHE_TIMEOUT_MS) {
-
-        // Forcer un refresh rapide pour ce mineur
-        WifiManager* wifi = WifiManager::getInstance();
-        BitaxeDevice* device = wifi->getBitaxe(minerIndex);
-        if (device && wifi->isConnected()) {
-            BitaxeAPI api;
-            api.setDevice(device->ip);
-
-            if (api.getStats(stats)) {
-                cached_stats[minerIndex] = stats;
-                cached_stats_timestamp[minerIndex] = millis();
-                cached_stats_valid[minerIndex] = true;
-                device->online = true;
-                return true;
-            } else {
-                cached_stats_valid[minerIndex] = false;
-                device->online = false;
-                return false;
-            }
-        }
-        return false;
-    }
-
-    // Cache valide
-    stats = cached_stats[minerIndex];
-    return true;
+// Le bouton porte l'ID stable du mineur, pas un pointeur dans la liste
+// (removeBitaxe() décale le tableau de WifiManager)
+static bool deviceFromEvent(lv_event_t * e, BitaxeDevice& device) {
+    uint16_t id = (uint16_t)(uintptr_t)lv_event_get_user_data(e);
+    return WifiManager::getInstance()->copyBitaxeById(id, device);
 }
 
 // Fonction pour rafraîchir les stats Bitaxe
@@ -209,9 +144,6 @@ static void refreshBitaxeStats() {
         lv_obj_set_style_text_align(msg, LV_TEXT_ALIGN_CENTER, 0);
         lv_obj_center(msg);
     } else {
-        // Rafraîchir le cache des stats si nécessaire (en arrière-plan)
-        refreshStatsCache();
-
         // Assurer que l'index du carousel est valide
         if (current_miner_index >= bitaxeCount) {
             current_miner_index = bitaxeCount - 1;
@@ -232,33 +164,148 @@ static void refreshBitaxeStats() {
     Serial.println("[UI] Bitaxe stats refreshed with carousel display (using cache)");
 }
 
-// Callback functions for miner actions
+// Overlay d'avancement des commandes (FleetCommandQueue) : les commandes
+// tournent sur le cœur 0, un timer LVGL relit l'avancement et affiche les
+// résultats au fil de l'eau
+#define COMMAND_OVERLAY_LINES       8      // Derniers résultats affichés
+#define COMMAND_OVERLAY_REFRESH_MS  250
+#define COMMAND_OVERLAY_AUTOCLOSE_MS 4000  // Fermeture auto si tout a réussi
+
+static lv_obj_t* command_overlay = nullptr;
+static lv_obj_t* command_title_label = nullptr;
+static lv_obj_t* command_list_label = nullptr;
+static lv_timer_t* command_overlay_timer = nullptr;
+static uint32_t command_overlay_generation = 0;
+static uint32_t command_overlay_done_at = 0;
+
+static void closeCommandOverlay() {
+    if (command_overlay_timer != nullptr) {
+        lv_timer_delete(command_overlay_timer);
+        command_overlay_timer = nullptr;
+    }
+    if (command_overlay != nullptr) {
+        lv_obj_delete(command_overlay);
+        command_overlay = nullptr;
+        command_title_label = nullptr;
+        command_list_label = nullptr;
+    }
+}
+
+static void command_overlay_close_cb(lv_event_t * e) {
+    closeCommandOverlay();
+}
+
+static void command_overlay_timer_cb(lv_timer_t * timer) {
+    FleetCommandQueue* queue = FleetCommandQueue::getInstance();
+    FleetProgress progress;
+    if (!queue->getProgress(progress)) {
+        return;  // Occupé, prochain tick
+    }
+    
+    // Lot terminé sans échec : fermeture automatique après un court délai
+    if (progress.done == progress.total && progress.failed == 0) {
+        if (command_overlay_done_at == 0) {
+            command_overlay_done_at = millis();
+        } else if (millis() - command_overlay_done_at > COMMAND_OVERLAY_AUTOCLOSE_MS) {
+            closeCommandOverlay();
+            return;
+        }
+    } else {
+        command_overlay_done_at = 0;
+    }
+    
+    uint32_t generation = queue->getGeneration();
+    if (generation == command_overlay_generation) {
+        return;
+    }
+    command_overlay_generation = generation;
+    
+    char title[64];
+    snprintf(title, sizeof(title), "%d/%d done - %d ok, %d failed",
+             progress.done, progress.total, progress.succeeded, progress.failed);
+    lv_label_set_text(command_title_label, title);
+    
+    // Derniers résultats, un mineur par ligne
+    WifiManager* wifi = WifiManager::getInstance();
+    char list[COMMAND_OVERLAY_LINES * 56];
+    size_t used = 0;
+    list[0] = '\0';
+    int first = progress.total > COMMAND_OVERLAY_LINES ? progress.total - COMMAND_OVERLAY_LINES : 0;
+    for (int i = first; i < progress.total && used < sizeof(list); i++) {
+        FleetCommandResult result;
+        if (!queue->getResult(i, result)) break;
+        BitaxeDevice device;
+        bool named = wifi->copyBitaxeById(result.id, device);
+        used += snprintf(list + used, sizeof(list) - used, "%s%-16.16s %-7s %s",
+                         used > 0 ? "\n" : "",
+                         named ? device.name.c_str() : "?",
+                         FleetCommandQueue::commandName(result.command),
+                         FleetCommandQueue::stateName(result.state));
+    }
+    lv_label_set_text(command_list_label, list);
+}
+
+static void showCommandOverlay() {
+    command_overlay_generation = 0;
+    command_overlay_done_at = 0;
+    if (command_overlay != nullptr) {
+        return;  // Déjà ouvert : le timer affichera les nouvelles commandes
+    }
+    
+    // Sur la couche du dessus : reste visible si l'écran change
+    command_overlay = lv_obj_create(lv_layer_top());
+    lv_obj_set_size(command_overlay, 400, 220);
+    lv_obj_center(command_overlay);
+    lv_obj_set_style_bg_color(command_overlay, lv_color_hex(0x1a1a1a), 0);
+    lv_obj_set_style_bg_opa(command_overlay, LV_OPA_90, 0);
+    lv_obj_set_style_border_color(command_overlay, lv_color_hex(0xFF6600), 0);
+    lv_obj_set_style_border_width(command_overlay, 2, 0);
+    lv_obj_set_style_radius(command_overlay, 6, 0);
+    lv_obj_set_style_pad_all(command_overlay, 8, 0);
+    lv_obj_remove_flag(command_overlay, LV_OBJ_FLAG_SCROLLABLE);
+    
+    command_title_label = lv_label_create(command_overlay);
+    lv_label_set_text(command_title_label, "Sending commands...");
+    lv_obj_set_style_text_font(command_title_label, &lv_font_montserrat_16, 0);
+    lv_obj_set_style_text_color(command_title_label, lv_color_hex(0xFF6600), 0);
+    lv_obj_align(command_title_label, LV_ALIGN_TOP_LEFT, 0, 0);
+    
+    command_list_label = lv_label_create(command_overlay);
+    lv_label_set_text(command_list_label, "");
+    lv_obj_set_style_text_font(command_list_label, &lv_font_montserrat_14, 0);
+    lv_obj_set_style_text_color(command_list_label, lv_color_hex(0xCCCCCC), 0);
+    lv_obj_align(command_list_label, LV_ALIGN_TOP_LEFT, 0, 26);
+    
+    lv_obj_t* btn_close = lv_button_create(command_overlay);
+    lv_obj_set_size(btn_close, 60, 26);
+    lv_obj_align(btn_close, LV_ALIGN_BOTTOM_RIGHT, 0, 0);
+    lv_obj_set_style_bg_color(btn_close, lv_color_hex(0x444444), 0);
+    lv_obj_add_event_cb(btn_close, command_overlay_close_cb, LV_EVENT_CLICKED, NULL);
+    lv_obj_t* lbl_close = lv_label_create(btn_close);
+    lv_label_set_text(lbl_close, "OK");
+    lv_obj_set_style_text_font(lbl_close, &lv_font_montserrat_14, 0);
+    lv_obj_center(lbl_close);
+    
+    command_overlay_timer = lv_timer_create(command_overlay_timer_cb, COMMAND_OVERLAY_REFRESH_MS, NULL);
+}
+
+// Callback functions for miner actions (mises en file, jamais bloquantes)
 static void miner_restart_cb(lv_event_t * e) {
-    lv_obj_t* btn = (lv_obj_t*)lv_event_get_target(e);
-    BitaxeDevice* device = (BitaxeDevice*)lv_event_get_user_data(e);
-    if (device && device->online) {
-        Serial.printf("[UI] Restarting miner: %s\n", device->name.c_str());
-        BitaxeAPI api;
-        api.setDevice(device->ip);
-        if (api.restart()) {
-            Serial.println("[UI] Restart command sent successfully");
-        } else {
-            Serial.println("[UI] Failed to send restart command");
+    BitaxeDevice device;
+    if (deviceFromEvent(e, device) && MinerRegistry::getInstance()->isOnline(device.id)) {
+        Serial.printf("[UI] Restarting miner: %s\n", device.name.c_str());
+        if (FleetCommandQueue::getInstance()->submit(device.id, FLEET_CMD_RESTART)) {
+            showCommandOverlay();
         }
     }
 }
 
 static void miner_reboot_cb(lv_event_t * e) {
-    lv_obj_t* btn = (lv_obj_t*)lv_event_get_target(e);
-    BitaxeDevice* device = (BitaxeDevice*)lv_event_get_user_data(e);
-    if (device && device->online) {
-        Serial.printf("[UI] Rebooting miner: %s\n", device->name.c_str());
-        BitaxeAPI api;
-        api.setDevice(device->ip);
-        if (api.reboot()) {
-            Serial.println("[UI] Reboot command sent successfully");
-        } else {
-            Serial.println("[UI] Failed to send reboot command");
+    BitaxeDevice device;
+    if (deviceFromEvent(e, device) && MinerRegistry::getInstance()->isOnline(device.id)) {
+        Serial.printf("[UI] Rebooting miner: %s\n", device.name.c_str());
+        if (FleetCommandQueue::getInstance()->submit(device.id, FLEET_CMD_REBOOT)) {
+            showCommandOverlay();
         }
     }
 }
@@ -266,10 +313,10 @@ static void miner_reboot_cb(lv_event_t * e) {
 // Open miner config (placeholder)
 static void miner_config_cb(lv_event_t * e) {
     lv_obj_t* btn = (lv_obj_t*)lv_event_get_target(e);
-    BitaxeDevice* device = (BitaxeDevice*)lv_event_get_user_data(e);
-    if (device) {
+    BitaxeDevice device;
+    if (deviceFromEvent(e, device)) {
         Serial.printf("[UI] Opening config for miner: %s at http://%s\n", 
-                    device->name.c_str(), device->ip.c_str());
+                    device.name.c_str(), device.ip.c_str());
         // TODO: Show a small modal with the IP and actions, or launch webserver
     }
 }
@@ -283,8 +330,8 @@ static void displayMinerInCarousel(int minerIndex) {
 
     if (minerIndex < 0 || minerIndex >= bitaxeCount) return;
 
-    BitaxeDevice* device = wifi->getBitaxe(minerIndex);
-    if (device == nullptr) return;
+    BitaxeDevice device;
+    if (!wifi->copyBitaxe(minerIndex, device)) return;
 
     // Container principal pour le mineur (centré, style carte) - RÉDUIT
     lv_obj_t* miner_card = lv_obj_create(bitaxe_container);
@@ -300,10 +347,12 @@ static void displayMinerInCarousel(int minerIndex) {
     lv_obj_set_flex_flow(miner_card, LV_FLEX_FLOW_COLUMN);
     lv_obj_set_style_pad_row(miner_card, 6, 0); // Padding réduit
 
-    // Récupérer les stats depuis le cache (pas d'appel API bloquant)
-    BitaxeStats stats;
-    if (getCachedStats(minerIndex, stats)) {
-        device->online = true;
+    // Récupérer les stats depuis le registre (pas d'appel API bloquant)
+    MinerView view;
+    bool pending = !getMinerView(minerIndex, view) || !view.polled;
+    const BitaxeStats& stats = view.stats;
+    void* device_id = (void*)(uintptr_t)device.id;
+    if (!pending && view.online) {
 
         // Déterminer la couleur selon l'état
         lv_color_t status_color = lv_color_hex(0x00FF00); // Vert = OK
@@ -316,7 +365,7 @@ static void displayMinerInCarousel(int minerIndex) {
         // Nom du device avec statut (en haut, gros)
         lv_obj_t* name_label = lv_label_create(miner_card);
         char name_text[64];
-        snprintf(name_text, sizeof(name_text), "%s (%s)", device->name.c_str(), stats.hostname.c_str());
+        snprintf(name_text, sizeof(name_text), "%s (%s)", device.name.c_str(), stats.hostname.c_str());
         lv_label_set_text(name_label, name_text);
         lv_obj_set_style_text_font(name_label, &lv_font_montserrat_16, 0); // Police réduite
         lv_obj_set_style_text_color(name_label, status_color, 0);
@@ -346,13 +395,13 @@ static void displayMinerInCarousel(int minerIndex) {
         }
         
         // Afficher l'adresse stratum de la pool au lieu de "OK"
-        String pool_display = stats.poolConnected ? stats.poolUrl : "ERR";
-        // Tronquer si trop long pour l'affichage
-        if (pool_display.length() > 18) {  // Réduit pour la police plus petite
-            pool_display = pool_display.substring(0, 15) + "...";
+        const char* pool_display = stats.poolConnected ? stats.poolUrl.c_str() : "ERR";
+        // Tronquer si trop long pour l'affichage (réduit pour la police plus petite)
+        if (strlen(pool_display) > 18) {
+            snprintf(line2, sizeof(line2), "%u shares | %.15s... | %s", stats.shares, pool_display, diff_str);
+        } else {
+            snprintf(line2, sizeof(line2), "%u shares | %s | %s", stats.shares, pool_display, diff_str);
         }
-        
-        snprintf(line2, sizeof(line2), "%u shares | %s | %s", stats.shares, pool_display.c_str(), diff_str);
         lv_label_set_text(stats_line2, line2);
         lv_obj_set_style_text_font(stats_line2, &lv_font_montserrat_16, 0);  // Police plus petite
         lv_color_t pool_color = stats.poolConnected ? lv_color_hex(0x00FF00) : lv_color_hex(0xFF0000);
@@ -375,7 +424,7 @@ static void displayMinerInCarousel(int minerIndex) {
         lv_obj_set_style_bg_color(btn_restart, lv_color_hex(0xFF6600), 0);
         lv_obj_set_style_radius(btn_restart, 1, 0); // Presque carré
         lv_obj_add_flag(btn_restart, LV_OBJ_FLAG_CLICKABLE);
-        lv_obj_add_event_cb(btn_restart, miner_restart_cb, LV_EVENT_CLICKED, device);
+        lv_obj_add_event_cb(btn_restart, miner_restart_cb, LV_EVENT_CLICKED, device_id);
         lv_obj_t* lbl_restart = lv_label_create(btn_restart);
         lv_label_set_text(lbl_restart, "RST");
         lv_obj_set_style_text_font(lbl_restart, &lv_font_montserrat_16, 0); // Police minuscule
@@ -387,7 +436,7 @@ static void displayMinerInCarousel(int minerIndex) {
         lv_obj_set_style_bg_color(btn_reboot, lv_color_hex(0xFF0000), 0);
         lv_obj_set_style_radius(btn_reboot, 1, 0); // Presque carré
         lv_obj_add_flag(btn_reboot, LV_OBJ_FLAG_CLICKABLE);
-        lv_obj_add_event_cb(btn_reboot, miner_reboot_cb, LV_EVENT_CLICKED, device);
+        lv_obj_add_event_cb(btn_reboot, miner_reboot_cb, LV_EVENT_CLICKED, device_id);
         lv_obj_t* lbl_reboot = lv_label_create(btn_reboot);
         lv_label_set_text(lbl_reboot, "RBT");
         lv_obj_set_style_text_font(lbl_reboot, &lv_font_montserrat_16, 0); // Police minuscule
@@ -399,24 +448,22 @@ static void displayMinerInCarousel(int minerIndex) {
         lv_obj_set_style_bg_color(btn_config, lv_color_hex(0x0080FF), 0);
         lv_obj_set_style_radius(btn_config, 1, 0); // Presque carré
         lv_obj_add_flag(btn_config, LV_OBJ_FLAG_CLICKABLE);
-        lv_obj_add_event_cb(btn_config, miner_config_cb, LV_EVENT_CLICKED, device);
+        lv_obj_add_event_cb(btn_config, miner_config_cb, LV_EVENT_CLICKED, device_id);
         lv_obj_t* lbl_config = lv_label_create(btn_config);
         lv_label_set_text(lbl_config, "CFG");
         lv_obj_set_style_text_font(lbl_config, &lv_font_montserrat_16, 0); // Police minuscule
         lv_obj_center(lbl_config);
 
     } else {
-        device->online = false;
-
-        // Offline status - grande carte centrée
+        // Offline status - grande carte centrée (LOADING tant que le poller n'a pas répondu)
         lv_obj_t* offline_label = lv_label_create(miner_card);
-        lv_label_set_text(offline_label, "OFFLINE");
+        lv_label_set_text(offline_label, pending ? "LOADING" : "OFFLINE");
         lv_obj_set_style_text_font(offline_label, &lv_font_montserrat_24, 0);
         lv_obj_set_style_text_color(offline_label, lv_color_hex(0xFF0000), 0);
         lv_obj_set_style_text_align(offline_label, LV_TEXT_ALIGN_CENTER, 0);
 
         lv_obj_t* ip_label = lv_label_create(miner_card);
-        lv_label_set_text(ip_label, device->ip.c_str());
+        lv_label_set_text(ip_label, device.ip.c_str());
         lv_obj_set_style_text_font(ip_label, &lv_font_montserrat_16, 0);
         lv_obj_set_style_text_color(ip_label, lv_color_hex(0x666666), 0);
         lv_obj_set_style_text_align(ip_label, LV_TEXT_ALIGN_CENTER, 0);
@@ -491,23 +538,14 @@ static void navigateCarousel(bool next) {
 
 static void global_restart_all_cb(lv_event_t * e) {
     Serial.println("[UI] Restarting ALL miners");
-    WifiManager* wifi = WifiManager::getInstance();
-    for (int i = 0; i < wifi->getBitaxeCount(); i++) {
-        BitaxeDevice* device = wifi->getBitaxe(i);
-        if (device && device->online) {
-            BitaxeAPI api;
-            api.setDevice(device->ip);
-            if (api.restart()) {
-                Serial.printf("[UI] Restarted: %s\n", device->name.c_str());
-            } else {
-                Serial.printf("[UI] Failed to restart: %s\n", device->name.c_str());
-            }
-        }
+    if (FleetCommandQueue::getInstance()->submitAll(FLEET_CMD_RESTART, true) > 0) {
+        showCommandOverlay();
     }
 }
 
 static void global_refresh_all_cb(lv_event_t * e) {
     Serial.println("[UI] Refreshing ALL miners");
+    MinerPoller::getInstance()->requestCycle();
     refreshBitaxeStats();
 }
 
@@ -570,36 +608,15 @@ static void update_time_cb(lv_timer_t * timer) {
     lv_refr_now(NULL);
     
     // Calculer et mettre à jour le hashrate total
-    if (hashrate_total_label != NULL) {
-        WifiManager* wifi = WifiManager::getInstance();
-        float totalHashrate = 0.0;
-        int onlineCount = 0;
-        
-        for (int i = 0; i < wifi->getBitaxeCount(); i++) {
-            BitaxeDevice* device = wifi->getBitaxe(i);
-            if (device && device->online) {
-                // On pourrait stocker le hashrate dans BitaxeDevice
-                // Pour l'instant on affiche juste le nombre de mineurs online
-                onlineCount++;
-            }
-        }
-        
+    FleetTotals totals;
+    if (hashrate_total_label != NULL && MinerRegistry::getInstance()->getTotals(totals)) {
         char hashrate_text[64];
-        snprintf(hashrate_text, sizeof(hashrate_text), "%d miners online", onlineCount);
+        snprintf(hashrate_text, sizeof(hashrate_text), "%d miners online", totals.online);
         lv_label_set_text(hashrate_total_label, hashrate_text);
         lv_obj_invalidate(hashrate_total_label);
     }
 }
 
-// Timer pour rafraîchir le cache des stats des mineurs (30 secondes)
-static lv_timer_t* stats_cache_timer = nullptr;
-static void refresh_stats_cache_cb(lv_timer_t * timer) {
-    if (current_screen == MINERS_SCREEN) {
-        Serial.println("[UI] Background cache refresh (30s timer)");
-        refreshStatsCache();
-    }
-}
-
 // Callback d'animation pour la pulsation du titre
 static void anim_opa_cb(void * var, int32_t v) {
     lv_obj_set_style_opa((lv_obj_t*)var, v, 0);
@@ -971,15 +988,96 @@ static void createBlockDataDisplay(lv_obj_t* parent) {
     lv_obj_set_style_text_align(block_pool_label, LV_TEXT_ALIGN_CENTER, 0);  // Centré
 }
 
+// Bandeau en bas au centre : blocs projetés du mempool (cyan, le prochain contre
+// le séparateur) puis derniers blocs minés (orange, le tip contre le séparateur).
+// La hauteur de chaque barre suit sa fee.
+#define FEE_STRIP_BAR_WIDTH   12
+#define FEE_STRIP_HEIGHT      24
+
+static lv_obj_t* createFeeStripBar(lv_obj_t* parent, uint32_t color) {
+    lv_obj_t* bar = lv_obj_create(parent);
+    lv_obj_set_size(bar, FEE_STRIP_BAR_WIDTH, 2);
+    lv_obj_set_style_bg_color(bar, lv_color_hex(color), 0);
+    lv_obj_set_style_bg_opa(bar, LV_OPA_80, 0);
+    lv_obj_set_style_border_width(bar, 0, 0);
+    lv_obj_set_style_radius(bar, 1, 0);
+    lv_obj_set_style_pad_all(bar, 0, 0);
+    lv_obj_clear_flag(bar, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_clear_flag(bar, LV_OBJ_FLAG_CLICKABLE);  // Le toucher reste à l'écran
+    lv_obj_add_flag(bar, LV_OBJ_FLAG_HIDDEN);
+    return bar;
+}
+
+static void createFeeStrip(lv_obj_t* parent) {
+    fee_strip_container = lv_obj_create(parent);
+    lv_obj_set_size(fee_strip_container, LV_SIZE_CONTENT, FEE_STRIP_HEIGHT);
+    lv_obj_set_style_bg_opa(fee_strip_container, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_border_width(fee_strip_container, 0, 0);
+    lv_obj_set_style_pad_all(fee_strip_container, 0, 0);
+    lv_obj_set_style_pad_column(fee_strip_container, 2, 0);
+    lv_obj_set_flex_flow(fee_strip_container, LV_FLEX_FLOW_ROW);
+    lv_obj_set_flex_align(fee_strip_container, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_END, LV_FLEX_ALIGN_END);
+    lv_obj_clear_flag(fee_strip_container, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_clear_flag(fee_strip_container, LV_OBJ_FLAG_CLICKABLE);
+
+    // Créés de gauche à droite : le dernier bloc projeté d'abord
+    for (int i = PROJECTED_BLOCKS_COUNT - 1; i >= 0; i--) {
+        projected_bars[i] = createFeeStripBar(fee_strip_container, 0x00FFAA);
+    }
+
+    lv_obj_t* divider = lv_obj_create(fee_strip_container);
+    lv_obj_set_size(divider, 2, FEE_STRIP_HEIGHT);
+    lv_obj_set_style_bg_color(divider, lv_color_hex(0x808080), 0);
+    lv_obj_set_style_border_width(divider, 0, 0);
+    lv_obj_set_style_radius(divider, 0, 0);
+    lv_obj_clear_flag(divider, LV_OBJ_FLAG_CLICKABLE);
+
+    for (int i = 0; i < RECENT_BLOCKS_COUNT; i++) {
+        recent_bars[i] = createFeeStripBar(fee_strip_container, 0xFFAA00);
+    }
+
+    lv_obj_align(fee_strip_container, LV_ALIGN_BOTTOM_MID, 0, -4);
+}
+
+static void setFeeStripBar(lv_obj_t* bar, float fee, float maxFee) {
+    if (bar == nullptr) {
+        return;
+    }
+    if (fee <= 0 || maxFee <= 0) {
+        lv_obj_add_flag(bar, LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+    int height = 3 + (int)((FEE_STRIP_HEIGHT - 3) * fee / maxFee);
+    lv_obj_set_height(bar, min(height, FEE_STRIP_HEIGHT));
+    lv_obj_clear_flag(bar, LV_OBJ_FLAG_HIDDEN);
+}
+
+static void updateFeeStrip() {
+    if (fee_strip_container == nullptr) {
+        return;
+    }
+    BitcoinAPI& btc = BitcoinAPI::getInstance();
+
+    // Même échelle pour les deux côtés
+    float maxFee = 0;
+    for (int i = 0; i < btc.getProjectedBlockCount(); i++) {
+        maxFee = max(maxFee, btc.getProjectedBlock(i).medianFee);
+    }
+    for (int i = 0; i < btc.getRecentBlockCount(); i++) {
+        maxFee = max(maxFee, btc.getRecentBlock(i).avgFee);
+    }
+
+    for (int i = 0; i < PROJECTED_BLOCKS_COUNT; i++) {
+        setFeeStripBar(projected_bars[i], i < btc.getProjectedBlockCount() ? btc.getProjectedBlock(i).medianFee : 0, maxFee);
+    }
+    for (int i = 0; i < RECENT_BLOCKS_COUNT; i++) {
+        setFeeStripBar(recent_bars[i], i < btc.getRecentBlockCount() ? btc.getRecentBlock(i).avgFee : 0, maxFee);
+    }
+}
+
 void UI::showClockScreen() {
     Serial.println("[UI] ========== Showing clock screen ==========");
     
-    // Arrêter le timer du cache des stats quand on quitte l'écran Miners
-    if (stats_cache_timer != nullptr) {
-        lv_timer_pause(stats_cache_timer);
-        Serial.println("[UI] Stats cache timer paused");
-    }
-    
     // Nettoyer les carrés tombants de l'écran précédent
     Serial.println("[UI] Cleaning up old falling squares...");
     cleanupFallingSquares();
@@ -1002,6 +1100,9 @@ void UI::showClockScreen() {
     block_fees_label = nullptr;
     block_age_label = nullptr;
     block_pool_label = nullptr;
+    fee_strip_container = nullptr;
+    memset(projected_bars, 0, sizeof(projected_bars));
+    memset(recent_bars, 0, sizeof(recent_bars));
     best_diff_label = nullptr;
     total_power_label = nullptr;
     hashrate_total_label = nullptr;
@@ -1106,6 +1207,9 @@ void UI::showClockScreen() {
         lv_obj_align(block_data_container, LV_ALIGN_LEFT_MID, 15, -15);  // Remonté de 3mm (15px), 15px du bord gauche
     }
     
+    // Blocs projetés et derniers blocs en bas au centre
+    createFeeStrip(scr);
+    
     // Best Diff en bas à gauche - Même style que BTC/Sats
     best_diff_label = lv_label_create(scr);
     lv_label_set_text(best_diff_label, "Best Diff\n---");
@@ -1151,17 +1255,11 @@ void UI::showClockScreen() {
     hashrate_total_label = lv_label_create(scr);
     
     // Calculer le nombre de miners online
-    WifiManager* wifi = WifiManager::getInstance();
-    int onlineCount = 0;
-    for (int i = 0; i < wifi->getBitaxeCount(); i++) {
-        BitaxeDevice* device = wifi->getBitaxe(i);
-        if (device && device->online) {
-            onlineCount++;
-        }
-    }
+    FleetTotals totals;
+    MinerRegistry::getInstance()->getTotals(totals);
     
     char hashrate_text[64];
-    snprintf(hashrate_text, sizeof(hashrate_text), "%d miners online", onlineCount);
+    snprintf(hashrate_text, sizeof(hashrate_text), "%d miners online", totals.online);
     lv_label_set_text(hashrate_total_label, hashrate_text);
     lv_obj_set_style_text_font(hashrate_total_label, &lv_font_montserrat_16, 0);
     lv_obj_set_style_text_color(hashrate_total_label, lv_color_hex(0x00FF00), 0);
@@ -1411,17 +1509,6 @@ void UI::showMinersScreen() {
     // Charger les stats Bitaxe (appel API seulement ici!)
     refreshBitaxeStats();
 
-    // Démarrer le timer de rafraîchissement du cache (30 secondes)
-    if (stats_cache_timer == nullptr) {
-        Serial.println("[UI] Starting stats cache refresh timer (30s)");
-        stats_cache_timer = lv_timer_create(refresh_stats_cache_cb, 30000, NULL);
-        lv_timer_set_repeat_count(stats_cache_timer, -1);
-    } else {
-        Serial.println("[UI] Resuming stats cache refresh timer");
-        lv_timer_resume(stats_cache_timer);
-        lv_timer_reset(stats_cache_timer);
-    }
-
     // Container pour les boutons globaux (Back/Config) - NON scrollable, placé sur l'écran principal
     static lv_obj_t* nav_container = nullptr;
     if (!nav_container) {
@@ -1589,28 +1676,17 @@ void UI::updateClock() {
     lv_refr_now(NULL);
 
     // Update hashrate labels (count + sum)
-    WifiManager* wifi = WifiManager::getInstance();
-    int onlineCount = 0;
-    float totalHashrate = 0.0;
-    
-    for (int i = 0; i < wifi->getBitaxeCount(); i++) {
-        BitaxeDevice* device = wifi->getBitaxe(i);
-        if (device && device->online) {
-            onlineCount++;
-            // Note: device doesn't store hashrate, only checkBitaxeStatus() updates it
-            // This just counts online devices, actual hashrate updated every 30s
-        }
-    }
+    FleetTotals totals;
     
     // Update miner count
-    if (hashrate_total_label != NULL) {
+    if (hashrate_total_label != NULL && MinerRegistry::getInstance()->getTotals(totals)) {
         char hashrate_text[64];
-        snprintf(hashrate_text, sizeof(hashrate_text), "%d miners online", onlineCount);
+        snprintf(hashrate_text, sizeof(hashrate_text), "%d miners online", totals.online);
         lv_label_set_text(hashrate_total_label, hashrate_text);
         lv_obj_invalidate(hashrate_total_label);
     }
     
-    // Note: hashrate_sum_label is updated by checkBitaxeStatus() every 30s
+    // Note: hashrate_sum_label is updated by checkBitaxeStatus() when the registry changes
 }
 
 // Public method to update Bitcoin price display (called from main loop)
@@ -1626,23 +1702,26 @@ void UI::updateBitcoinPrice() {
         float price = btc.getPrice();
         char price_text[32];
         char sats_text[32];
+        // Dernier prix connu mais aucune source ne répond : marqué "~" et grisé
+        bool stale = btc.isPriceStale();
+        const char* tag = stale ? "BTC ~" : "BTC";
         
         // Format prix BTC avec séparateurs de milliers
         int price_int = (int)price;
         if (price_int >= 1000000) {
             // Format: $1,234,567
-            snprintf(price_text, sizeof(price_text), "BTC\n$%d,%03d,%03d", 
+            snprintf(price_text, sizeof(price_text), "%s\n$%d,%03d,%03d", tag,
                      price_int / 1000000, 
                      (price_int / 1000) % 1000, 
                      price_int % 1000);
         } else if (price_int >= 1000) {
             // Format: $89,234
-            snprintf(price_text, sizeof(price_text), "BTC\n$%d,%03d", 
+            snprintf(price_text, sizeof(price_text), "%s\n$%d,%03d", tag,
                      price_int / 1000, 
                      price_int % 1000);
         } else {
             // Format: $234
-            snprintf(price_text, sizeof(price_text), "BTC\n$%d", price_int);
+            snprintf(price_text, sizeof(price_text), "%s\n$%d", tag, price_int);
         }
         
         // Calculer combien de Sats pour 1$ (1 BTC = 100,000,000 Sats)
@@ -1659,6 +1738,7 @@ void UI::updateBitcoinPrice() {
         }
         
         lv_label_set_text(bitcoin_price_label, price_text);
+        lv_obj_set_style_text_color(bitcoin_price_label, lv_color_hex(stale ? 0x808080 : 0x00FFAA), 0);
         lv_label_set_text(sats_conversion_label, sats_text);
     } else {
         lv_label_set_text(bitcoin_price_label, "BTC\n$--,---");
@@ -1766,6 +1846,8 @@ void UI::updateBitcoinPrice() {
         if (block_pool_label != NULL) lv_label_set_text(block_pool_label, "---");
     }
     
+    updateFeeStrip();
+    
     lv_obj_invalidate(bitcoin_price_label);
     lv_obj_invalidate(sats_conversion_label);
     if (block_data_container != NULL) lv_obj_invalidate(block_data_container);
@@ -1777,77 +1859,68 @@ void UI::updateFallingSquares() {
     updateFallingSquaresInternal();
 }
 
-// Public method to check Bitaxe status periodically (called from main loop)
+// Public method to apply Bitaxe status published in the MinerRegistry (called from main loop)
+// Non bloquant : ne fait que lire le registre, les requêtes HTTP tournent sur le cœur 0
 void UI::checkBitaxeStatus() {
     WifiManager* wifi = WifiManager::getInstance();
-    
-    // Skip if not on Clock screen (avoid conflicts with Miners screen)
-    if (current_screen != CLOCK_SCREEN) {
-        return;
-    }
-    
-    // Skip if in AP mode (no internet access)
-    if (wifi->isAPMode()) {
-        return;
-    }
-    
-    // Skip if not connected to WiFi
-    if (!wifi->isConnected()) {
+    MinerRegistry* registry = MinerRegistry::getInstance();
+    
+    // Le mineur affiché dans le carousel passe en cadence rapide
+    BitaxeDevice displayed;
+    bool hasDisplayed = wifi->copyBitaxe(current_miner_index, displayed);
+    MinerPoller::getInstance()->setFocusedMiner(
+        (current_screen == MINERS_SCREEN && hasDisplayed) ? displayed.id : MINER_ID_NONE);
+    
+    // Rien de nouveau depuis le dernier passage
+    static uint32_t last_generation = 0;
+    uint32_t generation = registry->getGeneration();
+    if (generation == last_generation) {
         return;
     }
     
     int bitaxeCount = wifi->getBitaxeCount();
     if (bitaxeCount == 0) {
+        last_generation = generation;
         return;  // No devices configured
     }
     
-    Serial.printf("[UI] Checking status of %d Bitaxe device(s)...\n", bitaxeCount);
-    
-    int onlineCount = 0;
-    float totalHashrate = 0.0;
-    float totalPower = 0.0;    // Consommation totale en Watts
-    uint32_t maxBestDiff = 0;  // Track highest bestDiff across all miners
-    
-    // Quick check each device
-    for (int i = 0; i < bitaxeCount; i++) {
-        BitaxeDevice* device = wifi->getBitaxe(i);
-        if (device == nullptr) continue;
-        
-        BitaxeAPI api;
-        api.setDevice(device->ip);
-        
-        BitaxeStats stats;
-        bool success = api.getStats(stats);
-        
-        device->online = success;
-        
-        if (success) {
-            onlineCount++;
-            totalHashrate += stats.hashrate;
-            totalPower += stats.power;
-            
-            // Store stats in device structure
-            device->bestDiff = stats.bestDiff;
-            device->bestSessionDiff = stats.bestDiff;
-            device->power = stats.power;
-            
-            // Track maximum across all miners
-            if (stats.bestDiff > maxBestDiff) {
-                maxBestDiff = stats.bestDiff;
-            }
-            
-            Serial.printf("[UI]   [%d] %s - ONLINE (%.1f GH/s, %.1f°C, %.1fW, bestDiff=%u)\n", 
-                i, device->name.c_str(), stats.hashrate, stats.temp, stats.power, stats.bestDiff);
-        } else {
-            Serial.printf("[UI]   [%d] %s - OFFLINE (%s)\n", 
-                i, device->name.c_str(), device->ip.c_str());
-            device->bestDiff = 0;
-            device->bestSessionDiff = 0;
-            device->power = 0;
+    FleetTotals totals;
+    if (!registry->getTotals(totals)) {
+        return;  // Registre occupé, on réessaie au prochain passage
+    }
+    last_generation = generation;
+    
+    int onlineCount = totals.online;
+    float totalHashrate = totals.hashrate;
+    float totalPower = totals.power;          // Consommation totale en Watts
+    uint32_t maxBestDiff = totals.bestDiff;   // Highest bestDiff across all miners
+    
+    // Le mineur affiché dans le carousel a reçu un nouveau résultat
+    static uint16_t last_displayed_id = MINER_ID_NONE;
+    static uint32_t last_displayed_seq = 0;
+    bool displayedMinerChanged = false;
+    MinerView view;
+    if (hasDisplayed && registry->read(displayed.id, view) && view.polled) {
+        if (view.id != last_displayed_id || view.seq != last_displayed_seq) {
+            last_displayed_id = view.id;
+            last_displayed_seq = view.seq;
+            displayedMinerChanged = true;
         }
     }
     
-    Serial.printf("[UI] Total: %d online, %.1f GH/s, %.1fW, Best Diff=%u\n", onlineCount, totalHashrate, totalPower, maxBestDiff);
+    // Redessiner la carte du carousel dès que le mineur affiché a de nouvelles données
+    if (current_screen == MINERS_SCREEN && displayedMinerChanged && bitaxe_container != nullptr) {
+        lv_obj_clean(bitaxe_container);
+        displayMinerInCarousel(current_miner_index);
+        updateCarouselIndicators(bitaxeCount);
+    }
+    
+    // Log limité à une ligne toutes les 30 s (les mineurs ne sont plus interrogés ensemble)
+    static uint32_t last_total_log = 0;
+    if (millis() - last_total_log > 30000) {
+        last_total_log = millis();
+        Serial.printf("[UI] Total: %d online, %.1f GH/s, %.1fW, Best Diff=%u\n", onlineCount, totalHashrate, totalPower, maxBestDiff);
+    }
     
     // Update clock screen labels if we're on it
     if (current_screen == CLOCK_SCREEN) {
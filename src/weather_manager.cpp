@@ -1,4 +1,5 @@
 #include "weather_manager.h"
+#include "external_http.h"
 #include <WiFi.h>
 
 // Singleton instance
@@ -8,6 +9,23 @@ WeatherManager::WeatherManager() {
     weatherData.valid = false;
     weatherData.temperature = 0.0;
     weatherData.lastUpdate = 0;
+    lastLatitude = 0.0;
+    lastLongitude = 0.0;
+    locationKnown = false;
+    locationIp[0] = '\0';
+    memset(forecast, 0, sizeof(forecast));
+    forecastCount = 0;
+    forecastFetchedAt = 0;
+    lastAttempt = 0;
+    currentSlot = -1;
+    worker = nullptr;
+    fetching = false;
+    flowDone = true;
+    flowOk = false;
+    flowHave = false;
+    flowUnchanged = false;
+    memset(flowForecast, 0, sizeof(flowForecast));
+    flowCount = 0;
 }
 
 WeatherManager* WeatherManager::getInstance() {
@@ -18,7 +36,48 @@ WeatherManager* WeatherManager::getInstance() {
 }
 
 void WeatherManager::init() {
-    Serial.println("[WEATHER] WeatherManager initialized");
+    // Position gardée d'un démarrage à l'autre
+    prefs.begin("weather", true);
+    locationKnown = prefs.isKey("lat") && prefs.isKey("lon");
+    if (locationKnown) {
+        lastLatitude = prefs.getFloat("lat", 0.0);
+        lastLongitude = prefs.getFloat("lon", 0.0);
+        prefs.getString("ip", locationIp, sizeof(locationIp));
+    }
+    prefs.end();
+
+    if (locationKnown) {
+        Serial.printf("[WEATHER] WeatherManager initialized, stored location %.4f, %.4f (IP %s)\n",
+                      lastLatitude, lastLongitude, locationIp);
+    } else {
+        Serial.println("[WEATHER] WeatherManager initialized");
+    }
+
+    if (worker == nullptr) {
+        xTaskCreatePinnedToCore(workerEntry, "weather", WEATHER_WORKER_STACK, this, 1, &worker, WEATHER_WORKER_CORE);
+    }
+}
+
+void WeatherManager::workerEntry(void* arg) {
+    WeatherManager* self = (WeatherManager*)arg;
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        self->flowOk = self->fetch();
+        self->flowDone = true;
+    }
+}
+
+void WeatherManager::post() {
+    flowHave = forecastCount > 0;
+    flowDone = false;
+    fetching = true;
+    if (worker == nullptr) {
+        // init() pas encore appelé : requête faite sur place
+        flowOk = fetch();
+        flowDone = true;
+        return;
+    }
+    xTaskNotifyGive(worker);
 }
 
 bool WeatherManager::getLocationFromIP(float& latitude, float& longitude) {
@@ -29,14 +88,16 @@ bool WeatherManager::getLocationFromIP(float& latitude, float& longitude) {
 
     Serial.println("[WEATHER] Getting location from IP...");
 
-    String response = httpGET(GEOLOCATION_API);
+    // Appelé parce que l'IP publique a changé : pas de réponse en cache à réutiliser
+    String response;
+    httpGET(GEOLOCATION_API, response, false);
     if (response.length() == 0) {
         Serial.println("[WEATHER] Failed to get geolocation response");
         return false;
     }
 
     // Parse JSON response
-    DynamicJsonDocument doc(1024);
+    JsonDocument doc;
     DeserializationError error = deserializeJson(doc, response);
 
     if (error) {
@@ -47,6 +108,9 @@ bool WeatherManager::getLocationFromIP(float& latitude, float& longitude) {
     if (doc.containsKey("lat") && doc.containsKey("lon")) {
         latitude = doc["lat"];
         longitude = doc["lon"];
+        lastLatitude = latitude;
+        lastLongitude = longitude;
+        locationKnown = true;
         Serial.printf("[WEATHER] Location: %.4f, %.4f\n", latitude, longitude);
         return true;
     }
@@ -56,80 +120,198 @@ bool WeatherManager::getLocationFromIP(float& latitude, float& longitude) {
 }
 
 bool WeatherManager::updateWeather() {
-    if (!WiFi.isConnected()) {
-        Serial.println("[WEATHER] WiFi not connected for weather update");
-        return false;
+    if (fetching) {
+        if (!flowDone) {
+            return selectCurrentHour();  // Requête en cours : heure locale seulement
+        }
+        applyFetch();
     }
 
-    // Check cache
-    if (weatherData.valid && (millis() - weatherData.lastUpdate) < CACHE_TIMEOUT_MS) {
-        Serial.println("[WEATHER] Using cached weather data");
-        return true;
+    bool due = forecastCount == 0 || millis() - forecastFetchedAt > WEATHER_REFRESH_MS ||
+               hoursAhead() < WEATHER_MIN_HOURS_AHEAD;
+    if (!due || (lastAttempt != 0 && millis() - lastAttempt < WEATHER_RETRY_MS)) {
+        return selectCurrentHour();  // Données locales : aucune requête
+    }
+    if (!WiFi.isConnected()) {
+        Serial.println("[WEATHER] WiFi not connected for weather update");
+        return selectCurrentHour();
     }
+    lastAttempt = millis();
+    post();
+    return selectCurrentHour();
+}
 
-    // Get location
+// Worker : position puis prévision, dans les tampons flow*
+bool WeatherManager::fetch() {
     float lat, lon;
-    if (!getLocationFromIP(lat, lon)) {
+    if (!resolveLocation(lat, lon)) {
         Serial.println("[WEATHER] Failed to get location");
         return false;
     }
+    return fetchForecast(lat, lon);
+}
 
-    // Build weather API URL
-    String url = String(WEATHER_API) +
-                 "?latitude=" + String(lat, 4) +
-                 "&longitude=" + String(lon, 4) +
-                 "&current=temperature_2m,weather_code" +
-                 "&timezone=auto";
+void WeatherManager::applyFetch() {
+    fetching = false;
+    if (!flowOk) {
+        return;  // Nouvel essai après WEATHER_RETRY_MS
+    }
+    lastAttempt = 0;
+    forecastFetchedAt = millis();
+    if (flowUnchanged) {
+        Serial.println("[WEATHER] Forecast unchanged on server, keeping current data");
+        return;
+    }
+    memcpy(forecast, flowForecast, sizeof(HourlyWeather) * flowCount);
+    forecastCount = flowCount;
+    currentSlot = -1;
+    Serial.printf("[WEATHER] Forecast updated: %d hour(s), now %.1f°C\n", forecastCount, forecast[0].tempTenths / 10.0);
+}
 
-    Serial.printf("[WEATHER] Fetching weather from: %s\n", url.c_str());
+// Position en NVS tant que l'IP publique ne change pas ; ip-api sinon
+bool WeatherManager::resolveLocation(float& latitude, float& longitude) {
+    char ip[WEATHER_IP_LEN];
+    if (!fetchPublicIp(ip, sizeof(ip))) {
+        // IP inconnue : la dernière position reste la meilleure estimation
+        latitude = lastLatitude;
+        longitude = lastLongitude;
+        return locationKnown;
+    }
+    if (locationKnown && strcmp(ip, locationIp) == 0) {
+        latitude = lastLatitude;
+        longitude = lastLongitude;
+        return true;
+    }
 
-    String response = httpGET(url.c_str());
-    if (response.length() == 0) {
-        Serial.println("[WEATHER] Failed to get weather response");
-        return false;
+    Serial.printf("[WEATHER] Public IP changed (%s -> %s), locating again\n", locationIp[0] ? locationIp : "none", ip);
+    if (!getLocationFromIP(latitude, longitude)) {
+        latitude = lastLatitude;
+        longitude = lastLongitude;
+        return locationKnown;
     }
 
-    // Parse JSON response
-    DynamicJsonDocument doc(2048);
-    DeserializationError error = deserializeJson(doc, response);
+    strlcpy(locationIp, ip, sizeof(locationIp));
+    prefs.begin("weather", false);
+    prefs.putFloat("lat", latitude);
+    prefs.putFloat("lon", longitude);
+    prefs.putString("ip", locationIp);
+    prefs.end();
+    return true;
+}
 
-    if (error) {
-        Serial.printf("[WEATHER] Weather JSON parse error: %s\n", error.c_str());
+bool WeatherManager::fetchPublicIp(char* ip, size_t len) {
+    String response;
+    int httpCode = httpGET(PUBLIC_IP_API, response, false);
+    response.trim();
+    if (httpCode != HTTP_CODE_OK || response.length() == 0 || response.length() >= len) {
         return false;
     }
+    strlcpy(ip, response.c_str(), len);
+    return true;
+}
 
-    if (doc.containsKey("current")) {
-        JsonObject current = doc["current"];
+bool WeatherManager::fetchForecast(float latitude, float longitude) {
+    // Une requête pour 24 h : heures en Unix, pas de bloc "current"
+    String url = String(WEATHER_API) +
+                 "?latitude=" + String(latitude, 4) +
+                 "&longitude=" + String(longitude, 4) +
+                 "&hourly=temperature_2m,weather_code" +
+                 "&forecast_hours=" + String(WEATHER_FORECAST_HOURS) +
+                 "&timeformat=unixtime&timezone=auto";
+
+    Serial.printf("[WEATHER] Fetching forecast from: %s\n", url.c_str());
+
+    static JsonDocument filter;
+    if (filter.isNull()) {
+        filter["hourly"]["time"] = true;
+        filter["hourly"]["temperature_2m"] = true;
+        filter["hourly"]["weather_code"] = true;
+    }
 
-        if (current.containsKey("temperature_2m") && current.containsKey("weather_code")) {
-            weatherData.temperature = current["temperature_2m"];
-            int weatherCode = current["weather_code"];
+    // Prévision inchangée (max-age ou 304) : celle gardée reste valable
+    JsonDocument doc;
+    int httpCode = ExternalHttp::getInstance()->getJson(url, doc, &filter, EXT_HTTP_TIMEOUT_MS, flowHave);
+    flowUnchanged = ExternalHttp::unchanged(httpCode);
+    if (flowUnchanged) {
+        return true;
+    }
+    if (httpCode != HTTP_CODE_OK) {
+        Serial.printf("[WEATHER] Forecast HTTP error: %d\n", httpCode);
+        return false;
+    }
 
-            // Convert weather code to icon directly
-            weatherData.icon = getWeatherIcon(weatherCode);
-            weatherData.condition = "current"; // Not used for display
-            weatherData.valid = true;
-            weatherData.lastUpdate = millis();
+    JsonArrayConst times = doc["hourly"]["time"];
+    JsonArrayConst temperatures = doc["hourly"]["temperature_2m"];
+    JsonArrayConst codes = doc["hourly"]["weather_code"];
+    int count = min((int)times.size(), WEATHER_FORECAST_HOURS);
+    if (count == 0 || (int)temperatures.size() < count || (int)codes.size() < count) {
+        Serial.println("[WEATHER] Forecast data not found in response");
+        return false;
+    }
 
-            Serial.printf("[WEATHER] Updated: %.1f°C, weather code: %d, icon: %s\n",
-                        weatherData.temperature,
-                        weatherCode,
-                        weatherData.icon.c_str());
+    for (int i = 0; i < count; i++) {
+        flowForecast[i].time = times[i] | 0;
+        flowForecast[i].tempTenths = (int16_t)lroundf((temperatures[i] | 0.0f) * 10.0f);
+        flowForecast[i].code = codes[i] | 0;
+    }
+    flowCount = count;
+    return true;
+}
 
-            return true;
+// Heures de prévision restantes à partir de maintenant
+int WeatherManager::hoursAhead() const {
+    if (forecastCount == 0) {
+        return 0;
+    }
+    time_t now = time(nullptr);
+    if (now < 1700000000) {
+        return forecastCount;  // Heure pas encore synchronisée (NTP)
+    }
+    int ahead = 0;
+    for (int i = 0; i < forecastCount; i++) {
+        if (forecast[i].time + 3600 > (uint32_t)now) ahead++;
+    }
+    return ahead;
+}
+
+// weatherData reflète l'heure de la prévision qui contient maintenant
+bool WeatherManager::selectCurrentHour() {
+    int slot = -1;
+    time_t now = time(nullptr);
+    if (forecastCount > 0 && now < 1700000000) {
+        slot = 0;  // Heure pas encore synchronisée : première heure reçue
+    } else {
+        for (int i = 0; i < forecastCount; i++) {
+            if (forecast[i].time <= (uint32_t)now && (uint32_t)now < forecast[i].time + 3600) {
+                slot = i;
+                break;
+            }
         }
     }
 
-    Serial.println("[WEATHER] Weather data not found in response");
-    return false;
+    if (slot != currentSlot) {
+        currentSlot = slot;
+        if (slot >= 0) {
+            const HourlyWeather& hour = forecast[slot];
+            weatherData.temperature = hour.tempTenths / 10.0;
+            weatherData.icon = getWeatherIcon(hour.code);
+            weatherData.condition = getWeatherCondition(hour.code);
+            Serial.printf("[WEATHER] Hour %d/%d: %.1f°C, weather code: %u\n", slot + 1, forecastCount,
+                          weatherData.temperature, hour.code);
+        }
+    }
+    weatherData.valid = slot >= 0;
+    weatherData.lastUpdate = forecastFetchedAt;
+    return weatherData.valid;
 }
 
 WeatherData WeatherManager::getWeatherData() {
+    selectCurrentHour();
     return weatherData;
 }
 
 bool WeatherManager::isWeatherValid() {
-    return weatherData.valid && (millis() - weatherData.lastUpdate) < CACHE_TIMEOUT_MS;
+    return selectCurrentHour();
 }
 
 String WeatherManager::getWeatherDisplayText() {
@@ -142,6 +324,15 @@ String WeatherManager::getWeatherDisplayText() {
     return String(buffer);
 }
 
+// Catégories reconnues par UI::updateWeatherDisplay()
+const char* WeatherManager::getWeatherCondition(int weatherCode) {
+    if (weatherCode == 0) return "clear";
+    if (weatherCode >= 95) return "thunderstorm";
+    if ((weatherCode >= 71 && weatherCode <= 77) || weatherCode == 85 || weatherCode == 86) return "snow";
+    if (weatherCode >= 51) return "rain";
+    return "clouds";  // 1-3 nuageux, 45-48 brouillard
+}
+
 String WeatherManager::getWeatherIcon(int weatherCode) {
     // WMO Weather interpretation codes (Open-Meteo)
     // Using Font Awesome icons for proper display
@@ -163,20 +354,13 @@ String WeatherManager::getWeatherIcon(int weatherCode) {
     }
 }
 
-String WeatherManager::httpGET(const char* url) {
-    HTTPClient http;
-    http.begin(url);
-    http.setTimeout(10000);  // 10 seconds timeout
-
-    int httpCode = http.GET();
+int WeatherManager::httpGET(const char* url, String& payload, bool haveResult) {
+    // Connexion keep-alive, DNS et cache de réponses partagés avec les autres API externes
+    int httpCode = ExternalHttp::getInstance()->get(url, payload, EXT_HTTP_TIMEOUT_MS, haveResult);
 
-    if (httpCode == HTTP_CODE_OK) {
-        String payload = http.getString();
-        http.end();
-        return payload;
-    } else {
+    if (httpCode != HTTP_CODE_OK && !ExternalHttp::unchanged(httpCode)) {
         Serial.printf("[WEATHER] HTTP GET failed, code: %d\n", httpCode);
-        http.end();
-        return "";
+        payload = "";
     }
+    return httpCode;
 }
\ No newline at end of file
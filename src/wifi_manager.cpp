@@ -1,4 +1,12 @@
 #include "wifi_manager.h"
+#include "miner_registry.h"
+#include "fleet_command_queue.h"
+#include "config_templates.h"
+#include "firmware_rollout.h"
+#include "miner_discovery.h"
+#include "pool_stats_source.h"
+#include "miner_telemetry.h"
+#include "chain_feed.h"
 #include <SPIFFS.h>
 #include <AsyncJson.h>
 #include <ESPAsyncWebServer.h>
@@ -7,8 +15,18 @@ WifiManager::WifiManager() {
     server = nullptr;
     apMode = true;
     wasConnected = false;
+    connectAttempt = 0;
     wifiConnectedCallback = nullptr;
     bitaxeCount = 0;
+    fleetMutex = xSemaphoreCreateMutex();
+    nextMinerId = 1;
+    configGeneration = 1;
+    
+    bitaxeCapacity = fleetCapacity();
+    bitaxes = fleetAllocArray<BitaxeDevice>(bitaxeCapacity);
+    if (bitaxes == nullptr) {
+        bitaxeCapacity = 0;
+    }
 }
 
 void WifiManager::init() {
@@ -35,55 +53,49 @@ void WifiManager::init() {
     loadConfig();
     loadBitaxeConfig();
     
-    // Try to connect to saved WiFi
-    if (ssid.length() > 0) {
-        Serial.printf("[WiFi] Connecting to %s...\n", ssid.c_str());
-        WiFi.mode(WIFI_STA);
-        
-        // Retry 5 fois avant de basculer en mode AP
-        int retry_count = 0;
-        const int MAX_RETRIES = 5;
-        bool connected = false;
-        
-        while (retry_count < MAX_RETRIES && !connected) {
-            retry_count++;
-            Serial.printf("[WiFi] Attempt %d/%d...\n", retry_count, MAX_RETRIES);
-            
-            WiFi.begin(ssid.c_str(), password.c_str());
-            
-            // Wait 5 seconds for connection (10 × 500ms)
-            int attempts = 0;
-            while (WiFi.status() != WL_CONNECTED && attempts < 10) {
-                delay(500);
-                Serial.print(".");
-                attempts++;
-            }
-            Serial.println();
-            
-            if (WiFi.status() == WL_CONNECTED) {
-                Serial.printf("[WiFi] Connected! IP: %s\n", WiFi.localIP().toString().c_str());
-                apMode = false;
-                connected = true;
-            } else {
-                Serial.printf("[WiFi] Attempt %d failed\n", retry_count);
-                if (retry_count < MAX_RETRIES) {
-                    Serial.println("[WiFi] Retrying in 1 second...");
-                    delay(1000);
-                }
-            }
-        }
-        
-        if (!connected) {
-            Serial.println("[WiFi] All connection attempts failed, starting AP mode");
-            setupAP();
-        }
-    } else {
+    // Connexion (ou mode AP) puis serveur web : poursuivi par update() sans bloquer le rendu
+    connectFlow.reset();
+    connectStep();
+}
+
+CoStatus WifiManager::connectStep() {
+    CO_BEGIN(connectFlow);
+    if (ssid.length() == 0) {
         Serial.println("[WiFi] No saved credentials, starting AP mode");
         setupAP();
+        setupWebServer();
+        CO_EXIT();
     }
-    
-    // Setup web server
+
+    Serial.printf("[WiFi] Connecting to %s...\n", ssid.c_str());
+    WiFi.mode(WIFI_STA);
+
+    // Retry 5 fois avant de basculer en mode AP
+    for (connectAttempt = 1; connectAttempt <= WIFI_CONNECT_RETRIES; connectAttempt++) {
+        Serial.printf("[WiFi] Attempt %d/%d...\n", connectAttempt, WIFI_CONNECT_RETRIES);
+        WiFi.begin(ssid.c_str(), password.c_str());
+
+        // Jusqu'à 5 secondes par tentative
+        CO_AWAIT_TIMEOUT(WiFi.status() == WL_CONNECTED, WIFI_CONNECT_TIMEOUT_MS);
+
+        if (WiFi.status() == WL_CONNECTED) {
+            Serial.printf("[WiFi] Connected! IP: %s\n", WiFi.localIP().toString().c_str());
+            apMode = false;
+            setupWebServer();
+            CO_EXIT();
+        }
+
+        Serial.printf("[WiFi] Attempt %d failed\n", connectAttempt);
+        if (connectAttempt < WIFI_CONNECT_RETRIES) {
+            Serial.println("[WiFi] Retrying in 1 second...");
+            CO_SLEEP(WIFI_RETRY_DELAY_MS);
+        }
+    }
+
+    Serial.println("[WiFi] All connection attempts failed, starting AP mode");
+    setupAP();
     setupWebServer();
+    CO_END();
 }
 
 void WifiManager::setupAP() {
@@ -122,6 +134,7 @@ void WifiManager::setupWebServer() {
     Serial.println("[WiFi] Setting up web server...");
     
     if (server) {
+        MinerDiscovery::getInstance()->setEventSource(nullptr);
         delete server;
     }
     
@@ -181,11 +194,26 @@ void WifiManager::setupWebServer() {
         JsonDocument doc;
         JsonArray array = doc.to<JsonArray>();
         
-        for (int i = 0; i < bitaxeCount; i++) {
+        // Tâche async_tcp : la liste peut changer pendant la réponse, chaque
+        // mineur est copié sous fleetMutex avant d'être sérialisé
+        MinerRegistry* registry = MinerRegistry::getInstance();
+        BitaxeDevice device;
+        for (int i = 0; copyBitaxe(i, device); i++) {
             JsonObject obj = array.add<JsonObject>();
-            obj["name"] = bitaxes[i].name;
-            obj["ip"] = bitaxes[i].ip;
-            obj["online"] = bitaxes[i].online;
+            obj["id"] = device.id;
+            obj["name"] = device.name.c_str();
+            obj["ip"] = device.ip.c_str();
+            
+            // Mêmes valeurs que l'écran (registre partagé)
+            MinerView view;
+            bool known = registry->read(device.id, view);
+            obj["online"] = known && view.online;
+            if (known && view.online) {
+                obj["hashrate"] = view.stats.hashrate;
+                obj["temp"] = view.stats.temp;
+                obj["power"] = view.stats.power;
+                obj["bestDiff"] = view.stats.bestDiff;
+            }
         }
         
         String response;
@@ -267,21 +295,396 @@ void WifiManager::setupWebServer() {
     );
     server->addHandler(removeHandler);
     
-    // Test Bitaxe connection (placeholder)
+    // Fleet commands: {"command":"restart","ids":[1,2]} or {"command":"restart","all":true}
+    // Mises en file (mêmes workers que l'écran), l'avancement se lit en GET
+    AsyncCallbackJsonWebHandler* commandHandler = new AsyncCallbackJsonWebHandler("/api/fleet/command",
+        [](AsyncWebServerRequest *request, JsonVariant &json) {
+            JsonObject jsonObj = json.as<JsonObject>();
+            FleetCommandQueue* queue = FleetCommandQueue::getInstance();
+            
+            AsyncResponseStream *response = request->beginResponseStream("application/json");
+            
+            FleetCommand command;
+            if (!FleetCommandQueue::parseCommand(jsonObj["command"].as<const char*>(), command)) {
+                response->print("{\"success\":false,\"error\":\"Unknown command (restart, reboot, stop, start)\"}");
+                request->send(response);
+                return;
+            }
+            
+            int queued = 0;
+            if (jsonObj["all"].as<bool>()) {
+                queued = queue->submitAll(command, jsonObj["onlineOnly"] | false);
+            } else {
+                JsonArray ids = jsonObj["ids"].as<JsonArray>();
+                for (JsonVariant id : ids) {
+                    if (queue->submit(id.as<uint16_t>(), command)) {
+                        queued++;
+                    }
+                }
+            }
+            
+            FleetProgress progress;
+            queue->getProgress(progress);
+            response->printf("{\"success\":%s,\"queued\":%d,\"batch\":%u}",
+                             queued > 0 ? "true" : "false", queued, progress.batch);
+            request->send(response);
+        }
+    );
+    server->addHandler(commandHandler);
+    
+    // Fleet command progress (current batch)
+    server->on("/api/fleet/command", HTTP_GET, [](AsyncWebServerRequest *request) {
+        FleetCommandQueue* queue = FleetCommandQueue::getInstance();
+        JsonDocument doc;
+        
+        FleetProgress progress;
+        if (!queue->getProgress(progress)) {
+            request->send(503, "application/json", "{\"success\":false,\"error\":\"Busy\"}");
+            return;
+        }
+        doc["batch"] = progress.batch;
+        doc["total"] = progress.total;
+        doc["done"] = progress.done;
+        doc["succeeded"] = progress.succeeded;
+        doc["failed"] = progress.failed;
+        doc["unchanged"] = progress.unchanged;
+        
+        JsonArray results = doc["results"].to<JsonArray>();
+        for (int i = 0; i < progress.total; i++) {
+            FleetCommandResult result;
+            if (!queue->getResult(i, result)) break;
+            JsonObject obj = results.add<JsonObject>();
+            obj["id"] = result.id;
+            obj["command"] = FleetCommandQueue::commandName(result.command);
+            obj["state"] = FleetCommandQueue::stateName(result.state);
+            obj["ms"] = result.durationMs;
+        }
+        
+        String output;
+        serializeJson(doc, output);
+        request->send(200, "application/json", output);
+    });
+    
+    // Config templates: GET lists them, POST {"name":"eco","config":{...}} saves,
+    // POST {"name":"eco","delete":true} removes
+    server->on("/api/fleet/templates", HTTP_GET, [](AsyncWebServerRequest *request) {
+        JsonDocument doc;
+        ConfigTemplates::getInstance()->list(doc);
+        String output;
+        serializeJson(doc, output);
+        request->send(200, "application/json", output);
+    });
+    
+    AsyncCallbackJsonWebHandler* templateHandler = new AsyncCallbackJsonWebHandler("/api/fleet/templates",
+        [](AsyncWebServerRequest *request, JsonVariant &json) {
+            JsonObject jsonObj = json.as<JsonObject>();
+            ConfigTemplates* templates = ConfigTemplates::getInstance();
+            const char* name = jsonObj["name"].as<const char*>();
+            
+            AsyncResponseStream *response = request->beginResponseStream("application/json");
+            if (jsonObj["delete"].as<bool>()) {
+                bool removed = templates->remove(name);
+                response->printf("{\"success\":%s}", removed ? "true" : "false");
+            } else {
+                String error;
+                if (templates->save(name, jsonObj["config"], error)) {
+                    response->print("{\"success\":true}");
+                } else {
+                    JsonDocument doc;
+                    doc["success"] = false;
+                    doc["error"] = error;
+                    serializeJson(doc, *response);
+                }
+            }
+            request->send(response);
+        }
+    );
+    server->addHandler(templateHandler);
+    
+    // Apply a template: {"template":"eco","ids":[1,2]} or {"template":"eco","all":true}
+    // Chaque mineur ne reçoit que les champs qui diffèrent ; avancement via GET /api/fleet/command
+    AsyncCallbackJsonWebHandler* applyHandler = new AsyncCallbackJsonWebHandler("/api/fleet/apply",
+        [](AsyncWebServerRequest *request, JsonVariant &json) {
+            JsonObject jsonObj = json.as<JsonObject>();
+            FleetCommandQueue* queue = FleetCommandQueue::getInstance();
+            
+            AsyncResponseStream *response = request->beginResponseStream("application/json");
+            
+            JsonDocument config;
+            if (!ConfigTemplates::getInstance()->get(jsonObj["template"].as<const char*>(), config)) {
+                response->print("{\"success\":false,\"error\":\"Unknown template\"}");
+                request->send(response);
+                return;
+            }
+            
+            // Sans "all" ni "ids", rien n'est mis en file
+            JsonArrayConst ids = jsonObj["ids"].as<JsonArrayConst>();
+            int queued = queue->submitConfig(config.as<JsonVariantConst>(), ids, jsonObj["all"].as<bool>());
+            
+            if (queued < 0) {
+                response->print("{\"success\":false,\"error\":\"Another template is being applied\"}");
+            } else {
+                FleetProgress progress;
+                queue->getProgress(progress);
+                response->printf("{\"success\":%s,\"queued\":%d,\"batch\":%u}",
+                                 queued > 0 ? "true" : "false", queued, progress.batch);
+            }
+            request->send(response);
+        }
+    );
+    server->addHandler(applyHandler);
+    
+    // Fleet firmware rollout: {"url":"https://...","all":true,"waveSize":4,"recovery":0.8}
+    // or {"abort":true}. L'image est téléchargée une fois puis servie par FIRMWARE_LOCAL_PATH
+    AsyncCallbackJsonWebHandler* firmwareHandler = new AsyncCallbackJsonWebHandler("/api/fleet/firmware",
+        [](AsyncWebServerRequest *request, JsonVariant &json) {
+            JsonObject jsonObj = json.as<JsonObject>();
+            FirmwareRollout* rollout = FirmwareRollout::getInstance();
+            
+            if (jsonObj["abort"].as<bool>()) {
+                rollout->abort();
+                request->send(200, "application/json", "{\"success\":true}");
+                return;
+            }
+            
+            String error;
+            bool started = rollout->start(jsonObj["url"].as<const char*>(),
+                                          jsonObj["ids"].as<JsonArrayConst>(),
+                                          jsonObj["all"].as<bool>(),
+                                          jsonObj["waveSize"] | FIRMWARE_DEFAULT_WAVE_SIZE,
+                                          jsonObj["recovery"] | FIRMWARE_DEFAULT_RECOVERY,
+                                          error);
+            JsonDocument doc;
+            doc["success"] = started;
+            if (!started) {
+                doc["error"] = error;
+            }
+            String output;
+            serializeJson(doc, output);
+            request->send(started ? 200 : 409, "application/json", output);
+        }
+    );
+    server->addHandler(firmwareHandler);
+    
+    server->on("/api/fleet/firmware", HTTP_GET, [](AsyncWebServerRequest *request) {
+        FirmwareRollout* rollout = FirmwareRollout::getInstance();
+        FirmwareRolloutStatus status;
+        if (!rollout->getStatus(status)) {
+            request->send(503, "application/json", "{\"success\":false,\"error\":\"Busy\"}");
+            return;
+        }
+        
+        JsonDocument doc;
+        doc["state"] = FirmwareRollout::stateName(status.state);
+        doc["imageSize"] = status.imageSize;
+        doc["downloaded"] = status.downloaded;
+        doc["wave"] = status.wave;
+        doc["waveCount"] = status.waveCount;
+        doc["total"] = status.total;
+        doc["recovered"] = status.recovered;
+        doc["failed"] = status.failed;
+        doc["served"] = status.served;
+        if (status.error[0] != '\0') {
+            doc["error"] = status.error;
+        }
+        JsonArray targets = doc["targets"].to<JsonArray>();
+        for (int i = 0; i < status.total; i++) {
+            FirmwareTarget target;
+            if (!rollout->getTarget(i, target)) break;
+            JsonObject obj = targets.add<JsonObject>();
+            obj["id"] = target.id;
+            obj["state"] = FirmwareRollout::targetStateName(target.state);
+        }
+        
+        String output;
+        serializeJson(doc, output);
+        request->send(200, "application/json", output);
+    });
+    
+    // Image servie aux mineurs depuis la flash
+    server->on(FIRMWARE_LOCAL_PATH, HTTP_GET, [](AsyncWebServerRequest *request) {
+        FirmwareRollout::getInstance()->handleImageRequest(request);
+    });
+    
+    // Test Bitaxe connection: asynchrone, le worker de découverte interroge le
+    // mineur. Réponse 202 {"pending":true} tant que la mesure n'est pas finie,
+    // le portail rappelle la même URL.
     server->on("/api/bitaxe/test", HTTP_GET, [](AsyncWebServerRequest *request) {
-        AsyncResponseStream *response = request->beginResponseStream("application/json");
+        IPAddress ip;
+        if (!request->hasParam("ip") || !ip.fromString(request->getParam("ip")->value())) {
+            request->send(400, "application/json", "{\"success\":false,\"error\":\"IP required\"}");
+            return;
+        }
         
-        if (request->hasParam("ip")) {
-            String ip = request->getParam("ip")->value();
-            // TODO: Implement actual API test
-            response->print("{\"success\":true,\"hashrate\":\"420 GH/s\",\"temp\":\"65\",\"power\":\"15\"}");
+        MinerProbe probe;
+        MinerProbeState state = MinerDiscovery::getInstance()->probe((uint32_t)ip, probe);
+        if (state == PROBE_FREE) {
+            request->send(503, "application/json", "{\"success\":false,\"error\":\"Too many tests in progress\"}");
+            return;
+        }
+        if (state == PROBE_PENDING) {
+            request->send(202, "application/json", "{\"success\":true,\"pending\":true}");
+            return;
+        }
+        
+        JsonDocument doc;
+        doc["success"] = probe.ok;
+        doc["latency"] = probe.latencyMs;
+        if (probe.ok) {
+            doc["hostname"] = probe.stats.hostname.c_str();
+            doc["version"] = probe.stats.version.c_str();
+            doc["hashrate"] = probe.stats.hashrate;
+            doc["temp"] = probe.stats.temp;
+            doc["power"] = probe.stats.power;
         } else {
-            response->print("{\"success\":false,\"error\":\"IP required\"}");
+            doc["error"] = "No AxeOS response";
+        }
+        String output;
+        serializeJson(doc, output);
+        request->send(200, "application/json", output);
+    });
+    
+    // Pool-side worker stats: {"url":"https://solo.ckpool.org/users/{address}"}, "" disables
+    AsyncCallbackJsonWebHandler* poolSourceHandler = new AsyncCallbackJsonWebHandler("/api/pool-source",
+        [](AsyncWebServerRequest *request, JsonVariant &json) {
+            String url = json["url"] | "";
+            bool saved = PoolStatsSource::getInstance()->setUrlTemplate(url);
+            request->send(saved ? 200 : 400, "application/json",
+                          saved ? "{\"success\":true}" : "{\"success\":false,\"error\":\"URL must be http(s) and contain {address}\"}");
+        }
+    );
+    server->addHandler(poolSourceHandler);
+    
+    server->on("/api/pool-source", HTTP_GET, [](AsyncWebServerRequest *request) {
+        PoolStatsSource* source = PoolStatsSource::getInstance();
+        PoolSourceStatus status;
+        if (!source->getStatus(status)) {
+            request->send(503, "application/json", "{\"success\":false,\"error\":\"Busy\"}");
+            return;
+        }
+        JsonDocument doc;
+        doc["url"] = source->getUrlTemplate();
+        doc["enabled"] = status.enabled;
+        doc["fetches"] = status.fetches;
+        doc["errors"] = status.errors;
+        doc["workers"] = status.workers;
+        doc["matched"] = status.matched;
+        if (status.lastFetchAt != 0) {
+            doc["ageMs"] = millis() - status.lastFetchAt;
+        }
+        String output;
+        serializeJson(doc, output);
+        request->send(200, "application/json", output);
+    });
+    
+    // Push telemetry: one WebSocket per miner (AxeOS /api/ws), polling as fallback
+    AsyncCallbackJsonWebHandler* telemetryHandler = new AsyncCallbackJsonWebHandler("/api/telemetry",
+        [](AsyncWebServerRequest *request, JsonVariant &json) {
+            if (!json["enabled"].is<bool>()) {
+                request->send(400, "application/json", "{\"success\":false,\"error\":\"Missing enabled\"}");
+                return;
+            }
+            MinerTelemetry::getInstance()->setEnabled(json["enabled"].as<bool>());
+            request->send(200, "application/json", "{\"success\":true}");
+        }
+    );
+    server->addHandler(telemetryHandler);
+    
+    server->on("/api/telemetry", HTTP_GET, [](AsyncWebServerRequest *request) {
+        TelemetryStatus status;
+        if (!MinerTelemetry::getInstance()->getStatus(status)) {
+            request->send(503, "application/json", "{\"success\":false,\"error\":\"Busy\"}");
+            return;
+        }
+        JsonDocument doc;
+        doc["enabled"] = status.enabled;
+        doc["live"] = status.live;
+        doc["maxSockets"] = TELEMETRY_MAX_SOCKETS;
+        doc["messages"] = status.messages;
+        doc["shares"] = status.shares;
+        doc["reconnects"] = status.reconnects;
+        String output;
+        serializeJson(doc, output);
+        request->send(200, "application/json", output);
+    });
+    
+    // Push chain/price feeds: WebSockets to mempool.space and Coinbase, polling as fallback
+    AsyncCallbackJsonWebHandler* chainFeedHandler = new AsyncCallbackJsonWebHandler("/api/chain-feed",
+        [](AsyncWebServerRequest *request, JsonVariant &json) {
+            if (!json["enabled"].is<bool>()) {
+                request->send(400, "application/json", "{\"success\":false,\"error\":\"Missing enabled\"}");
+                return;
+            }
+            ChainFeed::getInstance()->setEnabled(json["enabled"].as<bool>());
+            request->send(200, "application/json", "{\"success\":true}");
+        }
+    );
+    server->addHandler(chainFeedHandler);
+    
+    server->on("/api/chain-feed", HTTP_GET, [](AsyncWebServerRequest *request) {
+        ChainFeedStatus status;
+        if (!ChainFeed::getInstance()->getStatus(status)) {
+            request->send(503, "application/json", "{\"success\":false,\"error\":\"Busy\"}");
+            return;
+        }
+        JsonDocument doc;
+        doc["enabled"] = status.enabled;
+        doc["chainLive"] = status.chainLive;
+        doc["priceLive"] = status.priceLive;
+        doc["chainMessages"] = status.chainMessages;
+        doc["priceMessages"] = status.priceMessages;
+        doc["blocks"] = status.blocks;
+        doc["dropped"] = status.dropped;
+        doc["reconnects"] = status.reconnects;
+        String output;
+        serializeJson(doc, output);
+        request->send(200, "application/json", output);
+    });
+    
+    // LAN discovery: POST lance un balayage, les résultats arrivent en SSE
+    // ("progress", "found", "done") et restent lisibles en GET
+    server->on("/api/discovery/start", HTTP_POST, [](AsyncWebServerRequest *request) {
+        bool started = MinerDiscovery::getInstance()->start();
+        request->send(started ? 200 : 409, "application/json",
+                      started ? "{\"success\":true}" : "{\"success\":false,\"error\":\"Scan already running or WiFi offline\"}");
+    });
+    
+    server->on("/api/discovery", HTTP_GET, [](AsyncWebServerRequest *request) {
+        MinerDiscovery* discovery = MinerDiscovery::getInstance();
+        DiscoveryProgress progress;
+        if (!discovery->getProgress(progress)) {
+            request->send(503, "application/json", "{\"success\":false,\"error\":\"Busy\"}");
+            return;
+        }
+        
+        JsonDocument doc;
+        doc["running"] = progress.running;
+        doc["scan"] = progress.scan;
+        doc["scanned"] = progress.scanned;
+        doc["total"] = progress.total;
+        doc["responders"] = progress.responders;
+        doc["ms"] = progress.durationMs;
+        JsonArray miners = doc["miners"].to<JsonArray>();
+        for (int i = 0; i < progress.found; i++) {
+            DiscoveredMiner miner;
+            if (!discovery->getFound(i, miner)) break;
+            JsonObject obj = miners.add<JsonObject>();
+            obj["ip"] = IPAddress(miner.ip).toString();
+            obj["hostname"] = miner.hostname.c_str();
+            obj["version"] = miner.version.c_str();
+            obj["hashrate"] = miner.hashrate;
+            obj["connectMs"] = miner.connectMs;
         }
         
-        request->send(response);
+        String output;
+        serializeJson(doc, output);
+        request->send(200, "application/json", output);
     });
     
+    AsyncEventSource* discoveryEvents = new AsyncEventSource(DISCOVERY_EVENTS_PATH);
+    server->addHandler(discoveryEvents);
+    MinerDiscovery::getInstance()->setEventSource(discoveryEvents);
+    
     // Reset WiFi config and restart in AP mode
     server->on("/api/config/reset", HTTP_GET, [this](AsyncWebServerRequest *request) {
         Serial.println("[WiFi] Resetting WiFi config...");
@@ -292,27 +695,16 @@ void WifiManager::setupWebServer() {
     
     // Clear all Bitaxe devices
     server->on("/api/bitaxe/clear", HTTP_GET, [this](AsyncWebServerRequest *request) {
-        Serial.println("[WiFi] =================================");
-        Serial.println("[WiFi] Clearing all Bitaxe devices...");
-        Serial.printf("[WiFi] Current count: %d\n", bitaxeCount);
-        
-        bitaxeCount = 0;
-        
-        // Clear all NVS data
-        prefs.begin("bitaxe", false);
-        prefs.clear();
-        prefs.end();
-        
-        Serial.println("[WiFi] All Bitaxe devices removed and NVS cleared");
-        Serial.println("[WiFi] =================================");
-        
+        clearAllBitaxes();
         request->send(200, "application/json", "{\"success\":true,\"message\":\"All Bitaxe devices cleared\"}");
     });
     
     // Clear everything (WiFi + Bitaxe + restart)
     server->on("/api/factory/reset", HTTP_GET, [this](AsyncWebServerRequest *request) {
         Serial.println("[WiFi] Factory reset - clearing all data...");
+        xSemaphoreTake(fleetMutex, portMAX_DELAY);
         bitaxeCount = 0;
+        xSemaphoreGive(fleetMutex);
         prefs.begin("wifi", false);
         prefs.clear();
         prefs.end();
@@ -360,63 +752,143 @@ void WifiManager::saveConfig() {
 
 void WifiManager::loadBitaxeConfig() {
     prefs.begin("bitaxe", true);
-    bitaxeCount = prefs.getInt("count", 0);
+    int storedCount = prefs.getInt("count", 0);
+    nextMinerId = prefs.getUShort("nextId", 1);
     
-    Serial.printf("[WiFi] Loading Bitaxe config - count: %d\n", bitaxeCount);
+    Serial.printf("[WiFi] Loading Bitaxe config - count: %d (capacity %d)\n", storedCount, bitaxeCapacity);
     
     // Validate count
-    if (bitaxeCount < 0 || bitaxeCount > MAX_BITAXE_DEVICES) {
-        Serial.printf("[WiFi] WARNING: Invalid bitaxe count %d, resetting to 0\n", bitaxeCount);
-        bitaxeCount = 0;
+    if (storedCount < 0 || storedCount > bitaxeCapacity) {
+        Serial.printf("[WiFi] WARNING: Invalid bitaxe count %d, resetting to 0\n", storedCount);
+        storedCount = 0;
     }
     
+    bool hasBlob = prefs.isKey("devices");
+    uint8_t format = prefs.getUChar("fmt", 0);
+    size_t blobSize = hasBlob ? prefs.getBytesLength("devices") : 0;
+    
+    bitaxeCount = 0;
+    if (storedCount > 0 && hasBlob) {
+        BitaxeRecord* records = nullptr;
+        if (format != BITAXE_RECORD_VERSION || blobSize != storedCount * sizeof(BitaxeRecord)) {
+            Serial.printf("[WiFi] WARNING: Unexpected devices blob (v%u, %u bytes), ignoring\n", format, blobSize);
+        } else {
+            records = (BitaxeRecord*)malloc(blobSize);
+        }
+        if (records != nullptr && prefs.getBytes("devices", records, blobSize) == blobSize) {
+            for (int i = 0; i < storedCount; i++) {
+                records[i].name[BITAXE_NAME_LEN - 1] = '\0';
+                records[i].ip[BITAXE_HOST_LEN - 1] = '\0';
+                bitaxes[i].id = records[i].id;
+                bitaxes[i].name = records[i].name;
+                bitaxes[i].ip = records[i].ip;
+            }
+            bitaxeCount = storedCount;
+        }
+        free(records);
+    }
+    prefs.end();
+    
+    bool migrated = false;
+    if (storedCount > 0 && !hasBlob) {
+        migrated = loadLegacyBitaxeConfig();
+    }
+    
+    // Au-delà, la liste complète reste disponible via la commande "status"
+    if (bitaxeCount <= 16) {
+        for (int i = 0; i < bitaxeCount; i++) {
+            Serial.printf("[WiFi]   [%d] %s - %s (#%u)\n", i, bitaxes[i].name.c_str(), bitaxes[i].ip.c_str(), bitaxes[i].id);
+        }
+    }
+    
+    // Config antérieure aux IDs stables : en attribuer puis sauvegarder
+    bool needsSave = migrated;
+    for (int i = 0; i < bitaxeCount; i++) {
+        if (bitaxes[i].id >= nextMinerId) {
+            nextMinerId = bitaxes[i].id + 1;
+        }
+    }
     for (int i = 0; i < bitaxeCount; i++) {
+        if (bitaxes[i].id == MINER_ID_NONE) {
+            bitaxes[i].id = nextMinerId++;
+            needsSave = true;
+        }
+    }
+    if (needsSave) {
+        saveBitaxeConfig();
+    }
+    
+    syncRegistry();
+    Serial.printf("[WiFi] Loaded %d Bitaxe device(s)\n", bitaxeCount);
+}
+
+// Ancien format (clés nameN/ipN/idN par mineur) : lu une fois puis réécrit en blob
+bool WifiManager::loadLegacyBitaxeConfig() {
+    prefs.begin("bitaxe", true);
+    int storedCount = prefs.getInt("count", 0);
+    if (storedCount > bitaxeCapacity) storedCount = bitaxeCapacity;
+    
+    for (int i = 0; i < storedCount; i++) {
         String nameKey = "name" + String(i);
         String ipKey = "ip" + String(i);
         
         bitaxes[i].name = prefs.getString(nameKey.c_str(), "");
         bitaxes[i].ip = prefs.getString(ipKey.c_str(), "");
-        bitaxes[i].online = false;
-        
-        Serial.printf("[WiFi]   [%d] %s - %s\n", i, bitaxes[i].name.c_str(), bitaxes[i].ip.c_str());
+        bitaxes[i].id = prefs.getUShort(("id" + String(i)).c_str(), MINER_ID_NONE);
     }
-    
+    bitaxeCount = storedCount;
     prefs.end();
-    Serial.printf("[WiFi] Loaded %d Bitaxe device(s)\n", bitaxeCount);
+    
+    Serial.printf("[WiFi] Migrating %d device(s) from per-key NVS layout\n", bitaxeCount);
+    return bitaxeCount > 0;
+}
+
+void WifiManager::syncRegistry() {
+    configGeneration++;
+    MinerRegistry::getInstance()->sync(bitaxes, bitaxeCount);
 }
 
 void WifiManager::saveBitaxeConfig() {
     Serial.printf("[WiFi] Saving Bitaxe config (%d devices)...\n", bitaxeCount);
     
+    BitaxeRecord* records = nullptr;
+    if (bitaxeCount > 0) {
+        records = (BitaxeRecord*)calloc(bitaxeCount, sizeof(BitaxeRecord));
+        if (records == nullptr) {
+            Serial.println("[WiFi] ERROR: Out of memory, config not saved");
+            return;
+        }
+        for (int i = 0; i < bitaxeCount; i++) {
+            records[i].id = bitaxes[i].id;
+            strncpy(records[i].name, bitaxes[i].name.c_str(), BITAXE_NAME_LEN - 1);
+            strncpy(records[i].ip, bitaxes[i].ip.c_str(), BITAXE_HOST_LEN - 1);
+        }
+    }
+    
     prefs.begin("bitaxe", false);
     
-    // Clear all existing keys first to avoid orphaned entries
+    // Clear all existing keys first to avoid orphaned entries (and the legacy per-device keys)
     prefs.clear();
-    Serial.println("[WiFi] NVS cleared");
     
-    // Save new count
     prefs.putInt("count", bitaxeCount);
-    Serial.printf("[WiFi] Saved count: %d\n", bitaxeCount);
-    
-    // Save all current bitaxes
-    for (int i = 0; i < bitaxeCount; i++) {
-        String nameKey = "name" + String(i);
-        String ipKey = "ip" + String(i);
-        
-        prefs.putString(nameKey.c_str(), bitaxes[i].name);
-        prefs.putString(ipKey.c_str(), bitaxes[i].ip);
-        
-        Serial.printf("[WiFi]   [%d] Saved: %s = %s\n", i, nameKey.c_str(), bitaxes[i].name.c_str());
-        Serial.printf("[WiFi]   [%d] Saved: %s = %s\n", i, ipKey.c_str(), bitaxes[i].ip.c_str());
+    prefs.putUShort("nextId", nextMinerId);
+    prefs.putUChar("fmt", BITAXE_RECORD_VERSION);
+    if (bitaxeCount > 0) {
+        size_t written = prefs.putBytes("devices", records, bitaxeCount * sizeof(BitaxeRecord));
+        if (written != bitaxeCount * sizeof(BitaxeRecord)) {
+            Serial.printf("[WiFi] ERROR: Devices blob not written (%u bytes)\n", written);
+        }
     }
     
     prefs.end();
-    Serial.printf("[WiFi] Bitaxe config saved successfully (%d devices)\n", bitaxeCount);
+    free(records);
+    Serial.printf("[WiFi] Bitaxe config saved successfully (%d devices, %u bytes)\n",
+                  bitaxeCount, bitaxeCount * sizeof(BitaxeRecord));
 }
 
 bool WifiManager::addBitaxe(String name, String ip) {
-    if (bitaxeCount >= MAX_BITAXE_DEVICES) {
-        Serial.printf("[WiFi] Cannot add Bitaxe: max limit reached (%d/%d)\n", bitaxeCount, MAX_BITAXE_DEVICES);
+    if (bitaxeCount >= bitaxeCapacity) {
+        Serial.printf("[WiFi] Cannot add Bitaxe: max limit reached (%d/%d)\n", bitaxeCount, bitaxeCapacity);
         return false;
     }
     
@@ -425,20 +897,30 @@ bool WifiManager::addBitaxe(String name, String ip) {
         Serial.println("[WiFi] Cannot add Bitaxe: name or IP is empty");
         return false;
     }
+    if (ip.length() > bitaxes[0].ip.capacity()) {
+        Serial.printf("[WiFi] Cannot add Bitaxe: address longer than %u characters\n", bitaxes[0].ip.capacity());
+        return false;
+    }
     
+    xSemaphoreTake(fleetMutex, portMAX_DELAY);
+    uint16_t id = nextMinerId++;
+    bitaxes[bitaxeCount].id = id;
     bitaxes[bitaxeCount].name = name;
     bitaxes[bitaxeCount].ip = ip;
-    bitaxes[bitaxeCount].online = false;
     bitaxeCount++;
     
     saveBitaxeConfig();
-    Serial.printf("[WiFi] Added Bitaxe [%d/%d]: %s (%s)\n", bitaxeCount, MAX_BITAXE_DEVICES, name.c_str(), ip.c_str());
+    syncRegistry();
+    xSemaphoreGive(fleetMutex);
+    Serial.printf("[WiFi] Added Bitaxe [%d/%d]: %s (%s, #%u)\n", bitaxeCount, bitaxeCapacity, name.c_str(), ip.c_str(), id);
     
     return true;
 }
 
 bool WifiManager::removeBitaxe(int index) {
+    xSemaphoreTake(fleetMutex, portMAX_DELAY);
     if (index < 0 || index >= bitaxeCount) {
+        xSemaphoreGive(fleetMutex);
         Serial.printf("[WiFi] Invalid index %d (count=%d)\n", index, bitaxeCount);
         return false;
     }
@@ -451,27 +933,55 @@ bool WifiManager::removeBitaxe(int index) {
     }
     
     // Clear the last entry
+    bitaxes[bitaxeCount - 1].id = MINER_ID_NONE;
     bitaxes[bitaxeCount - 1].name = "";
     bitaxes[bitaxeCount - 1].ip = "";
-    bitaxes[bitaxeCount - 1].online = false;
     
     bitaxeCount--;
     
     // Save the cleaned config (saveBitaxeConfig will clear and rewrite everything)
     saveBitaxeConfig();
+    syncRegistry();
+    xSemaphoreGive(fleetMutex);
     
     Serial.printf("[WiFi] Removed Bitaxe. New count: %d\n", bitaxeCount);
     return true;
 }
 
-BitaxeDevice* WifiManager::getBitaxe(int index) {
-    if (index >= 0 && index < bitaxeCount) {
-        return &bitaxes[index];
+bool WifiManager::copyBitaxe(int index, BitaxeDevice& out) {
+    xSemaphoreTake(fleetMutex, portMAX_DELAY);
+    bool found = index >= 0 && index < bitaxeCount;
+    if (found) {
+        out = bitaxes[index];
+    }
+    xSemaphoreGive(fleetMutex);
+    return found;
+}
+
+bool WifiManager::copyBitaxeById(uint16_t id, BitaxeDevice& out) {
+    bool found = false;
+    xSemaphoreTake(fleetMutex, portMAX_DELAY);
+    for (int i = 0; i < bitaxeCount; i++) {
+        if (bitaxes[i].id == id) {
+            out = bitaxes[i];
+            found = true;
+            break;
+        }
     }
-    return nullptr;
+    xSemaphoreGive(fleetMutex);
+    return found;
+}
+
+bool WifiManager::hasBitaxe(uint16_t id) {
+    BitaxeDevice device;
+    return id != MINER_ID_NONE && copyBitaxeById(id, device);
 }
 
 void WifiManager::update() {
+    if (connectFlow.running()) {
+        connectStep();
+    }
+
     // Détecter la première connexion WiFi et déclencher le callback
     bool nowConnected = isConnected();
     
@@ -502,12 +1012,17 @@ void WifiManager::clearAllBitaxes() {
     Serial.println("[WiFi] Clearing all Bitaxe devices...");
     Serial.printf("[WiFi] Current count: %d\n", bitaxeCount);
     
+    xSemaphoreTake(fleetMutex, portMAX_DELAY);
     bitaxeCount = 0;
     
-    // Clear all NVS data
+    // Clear all NVS data, sauf le compteur d'IDs : un ID déjà attribué ne doit
+    // pas revenir après un redémarrage (registre, télémétrie, planning)
     prefs.begin("bitaxe", false);
     prefs.clear();
+    prefs.putUShort("nextId", nextMinerId);
     prefs.end();
+    syncRegistry();
+    xSemaphoreGive(fleetMutex);
     
     Serial.println("[WiFi] All Bitaxe devices removed and NVS cleared");
     Serial.println("[WiFi] =================================");
@@ -515,25 +1030,30 @@ void WifiManager::clearAllBitaxes() {
 
 void WifiManager::printBitaxeConfig() {
     Serial.println("\n[WiFi] === Bitaxe Configuration ===");
-    Serial.printf("[WiFi] Total devices: %d/%d\n", bitaxeCount, MAX_BITAXE_DEVICES);
+    xSemaphoreTake(fleetMutex, portMAX_DELAY);
+    Serial.printf("[WiFi] Total devices: %d/%d\n", bitaxeCount, bitaxeCapacity);
     
     if (bitaxeCount == 0) {
         Serial.println("[WiFi] No devices configured");
     } else {
         for (int i = 0; i < bitaxeCount; i++) {
-            Serial.printf("[WiFi] [%d] %s - %s (online: %s)\n", 
+            Serial.printf("[WiFi] [%d] #%u %s - %s (online: %s)\n", 
                 i, 
+                bitaxes[i].id,
                 bitaxes[i].name.c_str(), 
                 bitaxes[i].ip.c_str(),
-                bitaxes[i].online ? "yes" : "no");
+                MinerRegistry::getInstance()->isOnline(bitaxes[i].id) ? "yes" : "no");
         }
     }
+    xSemaphoreGive(fleetMutex);
     Serial.println("[WiFi] ==============================\n");
 }
 
 void WifiManager::stopWebServer() {
     if (server) {
         Serial.println("[WiFi] Stopping web server to save resources...");
+        // La source SSE est détruite avec le serveur
+        MinerDiscovery::getInstance()->setEventSource(nullptr);
         server->end();
         delete server;
         server = nullptr;
@@ -0,0 +1,274 @@
+#include "ws_client.h"
+#include "mbedtls/base64.h"
+#include "mbedtls/sha1.h"
+
+#define WS_OPCODE_CONTINUATION  0x0
+#define WS_OPCODE_TEXT          0x1
+#define WS_OPCODE_BINARY        0x2
+#define WS_OPCODE_CLOSE         0x8
+#define WS_OPCODE_PING          0x9
+#define WS_OPCODE_PONG          0xA
+
+static const char* WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+WsClient::WsClient() {
+    client = &plain;
+    tls.setInsecure();  // Comme les autres API externes : pas de vérification du certificat
+    messageLen = 0;
+    streamStarted = false;
+    messageOpcode = WS_OPCODE_TEXT;
+    beginFrame();
+}
+
+bool WsClient::connect(const char* host, uint16_t port, const char* path, uint32_t timeoutMs, bool secure) {
+    close();
+    client = secure ? (WiFiClient*)&tls : &plain;
+    if (!client->connect(host, port, timeoutMs)) {
+        return false;
+    }
+    if (!handshake(host, path)) {
+        client->stop();
+        return false;
+    }
+    if (!secure) {
+        plain.setNoDelay(true);
+    }
+    messageLen = 0;
+    streamStarted = false;
+    beginFrame();
+    return true;
+}
+
+bool WsClient::handshake(const char* host, const char* path) {
+    // Clé aléatoire de 16 octets en base64
+    uint8_t nonce[16];
+    for (int i = 0; i < 16; i += 4) {
+        uint32_t r = esp_random();
+        memcpy(nonce + i, &r, 4);
+    }
+    unsigned char key[32];
+    size_t keyLen = 0;
+    mbedtls_base64_encode(key, sizeof(key), &keyLen, nonce, sizeof(nonce));
+    key[keyLen] = '\0';
+
+    client->printf("GET %s HTTP/1.1\r\nHost: %s\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                  "Sec-WebSocket-Key: %s\r\nSec-WebSocket-Version: 13\r\n\r\n",
+                  path, host, (const char*)key);
+
+    // Réponse attendue : Sec-WebSocket-Accept = base64(sha1(clé + GUID))
+    char expected[32];
+    size_t expectedLen = 0;
+    {
+        unsigned char digest[20];
+        String source = String((const char*)key) + WS_GUID;
+        mbedtls_sha1_ret((const unsigned char*)source.c_str(), source.length(), digest);
+        mbedtls_base64_encode((unsigned char*)expected, sizeof(expected) - 1, &expectedLen, digest, sizeof(digest));
+        expected[expectedLen] = '\0';
+    }
+
+    client->setTimeout(WS_HANDSHAKE_MS / 1000 + 1);
+    String status = client->readStringUntil('\n');
+    if (!status.startsWith("HTTP/1.1 101")) {
+        return false;
+    }
+    bool accepted = false;
+    for (;;) {
+        String line = client->readStringUntil('\n');
+        line.trim();
+        if (line.isEmpty()) {
+            break;  // Fin des en-têtes (ou timeout)
+        }
+        int colon = line.indexOf(':');
+        if (colon > 0 && line.substring(0, colon).equalsIgnoreCase("Sec-WebSocket-Accept")) {
+            String value = line.substring(colon + 1);
+            value.trim();
+            accepted = (value == expected);
+        }
+    }
+    return accepted;
+}
+
+void WsClient::close() {
+    if (client->connected()) {
+        sendFrame(WS_OPCODE_CLOSE, nullptr, 0);
+    }
+    client->stop();
+}
+
+void WsClient::beginFrame() {
+    state = WS_HEADER0;
+    extRead = 0;
+    extNeeded = 0;
+    maskRead = 0;
+    payloadLen = 0;
+    payloadRead = 0;
+    controlLen = 0;
+}
+
+bool WsClient::poll(MessageCallback onMessage, void* ctx) {
+    return pump(onMessage, nullptr, ctx);
+}
+
+bool WsClient::pollStream(FragmentCallback onFragment, void* ctx) {
+    return pump(nullptr, onFragment, ctx);
+}
+
+bool WsClient::pump(MessageCallback onMessage, FragmentCallback onFragment, void* ctx) {
+    if (!client->connected()) {
+        return false;
+    }
+
+    uint8_t buffer[256];
+    int available;
+    while ((available = client->available()) > 0) {
+        int count = client->read(buffer, min(available, (int)sizeof(buffer)));
+        if (count <= 0) {
+            break;
+        }
+        // En mode flux, les octets de charge utile sont démasqués sur place et
+        // passés par plages contiguës [runStart, runEnd)
+        int runStart = -1;
+        for (int i = 0; i < count; i++) {
+            uint8_t b = buffer[i];
+            switch (state) {
+                case WS_HEADER0:
+                    fin = (b & 0x80) != 0;
+                    opcode = b & 0x0F;
+                    state = WS_HEADER1;
+                    break;
+
+                case WS_HEADER1:
+                    masked = (b & 0x80) != 0;
+                    payloadLen = b & 0x7F;
+                    if (payloadLen == 126 || payloadLen == 127) {
+                        extNeeded = (payloadLen == 126) ? 2 : 8;
+                        payloadLen = 0;
+                        state = WS_EXT_LEN;
+                    } else {
+                        state = masked ? WS_MASK_KEY : WS_PAYLOAD;
+                    }
+                    break;
+
+                case WS_EXT_LEN:
+                    // Longueur 64 bits : les 4 octets de poids fort doivent être nuls
+                    if (extNeeded == 8 && extRead < 4 && b != 0) {
+                        return false;
+                    }
+                    payloadLen = (payloadLen << 8) | b;
+                    if (++extRead == extNeeded) {
+                        state = masked ? WS_MASK_KEY : WS_PAYLOAD;
+                    }
+                    break;
+
+                case WS_MASK_KEY:
+                    mask[maskRead++] = b;
+                    if (maskRead == 4) {
+                        state = WS_PAYLOAD;
+                    }
+                    break;
+
+                case WS_PAYLOAD:
+                    if (masked) {
+                        b ^= mask[payloadRead & 3];
+                    }
+                    if (opcode >= WS_OPCODE_CLOSE) {
+                        if (controlLen < sizeof(control)) control[controlLen++] = b;
+                    } else if (onFragment != nullptr) {
+                        buffer[i] = b;
+                        if (runStart < 0) runStart = i;
+                    } else if (messageLen < WS_MAX_MESSAGE) {
+                        message[messageLen++] = (char)b;
+                    }
+                    payloadRead++;
+                    break;
+            }
+
+            // Trame complète (y compris une trame vide juste après l'en-tête)
+            if (state == WS_PAYLOAD && payloadRead == payloadLen) {
+                if (runStart >= 0) {
+                    deliverRun(onFragment, ctx, buffer + runStart, i + 1 - runStart);
+                    runStart = -1;
+                }
+                if (!endFrame(onMessage, onFragment, ctx)) {
+                    return false;
+                }
+                beginFrame();
+            }
+        }
+        if (runStart >= 0) {
+            deliverRun(onFragment, ctx, buffer + runStart, count - runStart);
+        }
+    }
+    return true;
+}
+
+void WsClient::deliverRun(FragmentCallback onFragment, void* ctx, const uint8_t* data, size_t len) {
+    // Les messages binaires ne sont pas transmis (comme en mode message)
+    if (messageOpcodeOf(opcode) != WS_OPCODE_TEXT) {
+        return;
+    }
+    onFragment(ctx, data, len, !streamStarted, false);
+    streamStarted = true;
+}
+
+uint8_t WsClient::messageOpcodeOf(uint8_t frameOpcode) const {
+    return frameOpcode == WS_OPCODE_CONTINUATION ? messageOpcode : frameOpcode;
+}
+
+bool WsClient::endFrame(MessageCallback onMessage, FragmentCallback onFragment, void* ctx) {
+    switch (opcode) {
+        case WS_OPCODE_PING:
+            sendFrame(WS_OPCODE_PONG, control, controlLen);
+            return true;
+        case WS_OPCODE_PONG:
+            return true;
+        case WS_OPCODE_CLOSE:
+            sendFrame(WS_OPCODE_CLOSE, control, min(controlLen, (size_t)2));
+            client->stop();
+            return false;
+        case WS_OPCODE_TEXT:
+        case WS_OPCODE_BINARY:
+            messageOpcode = opcode;
+            break;
+        case WS_OPCODE_CONTINUATION:
+            break;
+        default:
+            return false;  // Opcode réservé : protocole non respecté
+    }
+
+    if (fin) {
+        if (messageOpcode == WS_OPCODE_TEXT) {
+            if (onFragment != nullptr) {
+                onFragment(ctx, nullptr, 0, !streamStarted, true);
+            } else if (onMessage != nullptr) {
+                message[messageLen] = '\0';
+                onMessage(ctx, message, messageLen);
+            }
+        }
+        messageLen = 0;
+        streamStarted = false;
+    }
+    return true;
+}
+
+bool WsClient::sendText(const char* text) {
+    size_t len = strlen(text);
+    if (len > 125 || !client->connected()) {
+        return false;
+    }
+    sendFrame(WS_OPCODE_TEXT, (const uint8_t*)text, len);
+    return true;
+}
+
+void WsClient::sendFrame(uint8_t code, const uint8_t* data, size_t len) {
+    // Les trames du client sont toujours masquées
+    uint8_t frame[2 + 4 + 125];
+    uint32_t key = esp_random();
+    frame[0] = 0x80 | code;
+    frame[1] = 0x80 | (uint8_t)len;
+    memcpy(frame + 2, &key, 4);
+    for (size_t i = 0; i < len; i++) {
+        frame[6 + i] = data[i] ^ frame[2 + (i & 3)];
+    }
+    client->write(frame, 6 + len);
+}
@@ -0,0 +1,50 @@
+#pragma once
+// Allocator ArduinoJson des tests natifs : compte les allocations, les
+// octets en vie et leur pic, pour mesurer ce que coûte un JsonDocument.
+#include <ArduinoJson.h>
+#include <map>
+#include <stdlib.h>
+
+class CountingAllocator : public ArduinoJson::Allocator {
+public:
+    size_t live = 0;
+    size_t peak = 0;
+    size_t allocations = 0;   // allocate() et reallocate() réussis
+    std::map<void*, size_t> sizes;
+
+    void* allocate(size_t size) override {
+        void* ptr = malloc(size);
+        track(ptr, size);
+        return ptr;
+    }
+    void deallocate(void* ptr) override {
+        untrack(ptr);
+        free(ptr);
+    }
+    void* reallocate(void* ptr, size_t newSize) override {
+        untrack(ptr);
+        void* moved = realloc(ptr, newSize);
+        track(moved, newSize);
+        return moved;
+    }
+    // Nouvelle mesure : le pic repart des octets encore en vie
+    void reset() {
+        peak = live;
+        allocations = 0;
+    }
+
+private:
+    void track(void* ptr, size_t size) {
+        if (ptr == nullptr) return;
+        sizes[ptr] = size;
+        live += size;
+        allocations++;
+        if (live > peak) peak = live;
+    }
+    void untrack(void* ptr) {
+        auto it = sizes.find(ptr);
+        if (it == sizes.end()) return;
+        live -= it->second;
+        sizes.erase(it);
+    }
+};
@@ -0,0 +1,72 @@
+#pragma once
+// Réponses mempool.space enregistrées pour les tests et benchmarks natifs
+// du décodage des blocs. /v1/blocks renvoie 15 blocs de ce format ; le
+// benchmark les reproduit à partir de MEMPOOL_BLOCK en changeant
+// "{height}" et "{index}".
+
+// Un élément de /api/v1/blocks (~2 Ko, dont extras presque entièrement ignoré)
+static const char MEMPOOL_BLOCK[] = R"JSON({
+  "id": "00000000000000000001c2f4a8d6e7b3f0a9c8d7e6f5a4b3c2d1e0f9a8b7c6{index}",
+  "height": {height},
+  "version": 612368384,
+  "timestamp": 1719846512,
+  "bits": 386089497,
+  "nonce": 3581239041,
+  "difficulty": 83148355189239.77,
+  "merkle_root": "7f3c2b1a0e9d8c7b6a5f4e3d2c1b0a9f8e7d6c5b4a3f2e1d0c9b8a7f6e5d4c3b",
+  "tx_count": 3872,
+  "size": 1620934,
+  "weight": 3993262,
+  "previousblockhash": "00000000000000000002a1b3c5d7e9f1a3b5c7d9e1f3a5b7c9d1e3f5a7b9c1d3",
+  "mediantime": 1719843216,
+  "stale": false,
+  "extras": {
+    "reward": 315748923,
+    "coinbaseRaw": "03a1fc0c04a8d3826604fabe6d6d8c1e5b2a7f9d3c6e0b4a8f2d7c1e9b5a3f6d0c8e2b4a6f9d1c3e7b5a01000000000000000f0bf8c1a3000000000000",
+    "orphans": [],
+    "medianFee": 6.02,
+    "feeRange": [3.01, 4.5, 5.2, 6.02, 8.1, 12.4, 302.5],
+    "totalFees": 3248923,
+    "avgFee": 839,
+    "avgFeeRate": 7.82,
+    "utxoSetChange": 2187,
+    "avgTxSize": 418.53,
+    "totalInputs": 8214,
+    "totalOutputs": 10401,
+    "totalOutputAmt": 543219876543,
+    "segwitTotalTxs": 3548,
+    "segwitTotalSize": 1389203,
+    "segwitTotalWeight": 3067432,
+    "feePercentiles": null,
+    "virtualSize": 998315.5,
+    "coinbaseAddress": "bc1qxhmdufsvnuaaaer4ynz88fspdsxq2h9e9cetdj",
+    "coinbaseAddresses": ["bc1qxhmdufsvnuaaaer4ynz88fspdsxq2h9e9cetdj"],
+    "coinbaseSignature": "OP_0 OP_PUSHBYTES_20 35f6de260c9f3bdee47524c473a6016c0c055cb9",
+    "coinbaseSignatureAscii": "\u0003¡ü\f\u0004¨Ó\u0082f/Foundry USA Pool #dropgold/",
+    "header": "00608024d3c1b9a7f5e3d1c9b7a5f3e1d9c7b5a3f1e9d7c5b3a1020000000000000000003b4c5d6e7f8a9b0c1d2e3f4a5b6c7d8e9f0a1b2c3d4e5f6a7b8c9d0e1f2a3b4c5d6e7f7082a662198f0317018b7ed5",
+    "utxoSetSize": null,
+    "totalInputAmt": null,
+    "pool": {
+      "id": 111,
+      "name": "Foundry USA",
+      "slug": "foundryusa",
+      "minerNames": null
+    },
+    "matchRate": 100,
+    "expectedFees": 3301234,
+    "expectedWeight": 3991832,
+    "similarity": 0.9871
+  }
+})JSON";
+
+// /api/v1/fees/mempool-blocks : 8 blocs projetés
+static const char MEMPOOL_PROJECTED[] = R"JSON([
+  {"blockSize": 1712345, "blockVSize": 997961.25, "nTx": 3208, "totalFees": 9123456, "medianFee": 8.12, "feeRange": [6.01, 6.5, 7.2, 8.12, 10.3, 15.8, 501.2]},
+  {"blockSize": 1603210, "blockVSize": 998012.5, "nTx": 2987, "totalFees": 5321098, "medianFee": 5.21, "feeRange": [4.8, 5.0, 5.1, 5.21, 5.5, 5.9, 6.01]},
+  {"blockSize": 1589012, "blockVSize": 997845.0, "nTx": 3011, "totalFees": 4512345, "medianFee": 4.5, "feeRange": [4.2, 4.3, 4.4, 4.5, 4.6, 4.7, 4.8]},
+  {"blockSize": 1623456, "blockVSize": 998123.75, "nTx": 3402, "totalFees": 4012345, "medianFee": 4.01, "feeRange": [3.9, 3.95, 4.0, 4.01, 4.05, 4.1, 4.2]},
+  {"blockSize": 1598765, "blockVSize": 997654.25, "nTx": 3198, "totalFees": 3612345, "medianFee": 3.6, "feeRange": [3.3, 3.4, 3.5, 3.6, 3.7, 3.8, 3.9]},
+  {"blockSize": 1634567, "blockVSize": 998234.0, "nTx": 3567, "totalFees": 3112345, "medianFee": 3.1, "feeRange": [3.01, 3.02, 3.05, 3.1, 3.15, 3.2, 3.3]},
+  {"blockSize": 1576543, "blockVSize": 997432.5, "nTx": 3321, "totalFees": 3012345, "medianFee": 3.01, "feeRange": [3.0, 3.0, 3.0, 3.01, 3.01, 3.01, 3.01]},
+  {"blockSize": 9876543, "blockVSize": 5432109.75, "nTx": 21432, "totalFees": 12345678, "medianFee": 2.01, "feeRange": [1.0, 1.01, 1.5, 2.01, 2.5, 2.9, 3.0]}
+])JSON";
@@ -0,0 +1,117 @@
+#pragma once
+// Réponses /api/system/info enregistrées (valeurs anonymisées) pour les
+// tests et benchmarks natifs du parsing des mineurs.
+
+// AxeOS v2.4 (Bitaxe Gamma) : ~2,7 Ko, dont une grande partie que
+// getStats() ne lit pas (ASIC, ventilateur, Wi-Fi, réglages...)
+static const char AXEOS_INFO[] = R"JSON({
+  "power": 15.468750953674316,
+  "voltage": 5137.5,
+  "current": 3023.4375,
+  "temp": 57.25,
+  "temp2": 0,
+  "vrTemp": 49,
+  "maxPower": 40,
+  "nominalVoltage": 5,
+  "hashRate": 1108.8193231531093,
+  "expectedHashrate": 1096,
+  "errorPercentage": 0.31,
+  "bestDiff": "4.29G",
+  "bestSessionDiff": "72.6M",
+  "poolDifficulty": 1000,
+  "responseTime": 34.81,
+  "isUsingFallbackStratum": 0,
+  "isPSRAMAvailable": 1,
+  "freeHeap": 8435768,
+  "coreVoltage": 1150,
+  "coreVoltageActual": 1143,
+  "frequency": 525,
+  "ssid": "mining-lan",
+  "macAddr": "AA:BB:CC:DD:EE:01",
+  "hostname": "bitaxe-gamma-01",
+  "wifiStatus": "Connected!",
+  "wifiRSSI": -58,
+  "apEnabled": 0,
+  "sharesAccepted": 18423,
+  "sharesRejected": 21,
+  "sharesRejectedReasons": [
+    {"message": "Above target", "count": 17},
+    {"message": "Stale", "count": 4}
+  ],
+  "uptimeSeconds": 864311,
+  "smallCoreCount": 2040,
+  "ASICModel": "BM1370",
+  "stratumURL": "public-pool.io",
+  "stratumPort": 21496,
+  "stratumUser": "bc1qxyz0anonymizedaddress0000000000000000.gamma01",
+  "stratumSuggestedDifficulty": 1000,
+  "stratumExtranonceSubscribe": 0,
+  "fallbackStratumURL": "solo.ckpool.org",
+  "fallbackStratumPort": 3333,
+  "fallbackStratumUser": "bc1qxyz0anonymizedaddress0000000000000000.gamma01",
+  "fallbackStratumSuggestedDifficulty": 1000,
+  "fallbackStratumExtranonceSubscribe": 0,
+  "version": "v2.4.2",
+  "axeOSVersion": "v2.4.2",
+  "idfVersion": "v5.3.1",
+  "boardVersion": "601",
+  "runningPartition": "ota_1",
+  "overheat_mode": 0,
+  "overclockEnabled": 0,
+  "display": "SSD1306 (128x32)",
+  "rotation": 0,
+  "invertscreen": 0,
+  "displayTimeout": -1,
+  "autofanspeed": 1,
+  "fanspeed": 44,
+  "manualFanSpeed": 100,
+  "temptarget": 60,
+  "fanrpm": 4135,
+  "fan2rpm": 0,
+  "statsFrequency": 0,
+  "blockFound": 0,
+  "blockHeight": 871204,
+  "scriptsig": "/public-pool.io/",
+  "networkDifficulty": 110451907374649,
+  "hashrateMonitor": {"asics": [{"total": 1108.81, "domains": [277.1, 276.9, 277.5, 277.3], "errorCount": 3}]},
+  "history": {
+    "hashrate_10m": 1101.42,
+    "hashrate_1h": 1097.86,
+    "hashrate_1d": 1099.03,
+    "timestamps": [1731000000, 1731000600, 1731001200, 1731001800, 1731002400, 1731003000],
+    "hashrate": [1102.5, 1096.1, 1100.8, 1094.3, 1103.7, 1099.9]
+  }
+})JSON";
+
+// ESP-Miner ancien : hashrate en H/s, clés en snake_case
+static const char LEGACY_INFO[] = R"JSON({
+  "hostname": "esp-miner-07",
+  "version": "2.0.3",
+  "temperature": 48.5,
+  "voltage": 5.02,
+  "current": 1.9,
+  "currentHashrate": 487000000000,
+  "best_diff": 912445120,
+  "shares_accepted": 5120,
+  "shares_rejected": 3,
+  "pool_url": "solo.ckpool.org:3333",
+  "pool_user": "bc1qlegacy0anonymized00000000000000000000.esp07",
+  "uptime": 43210,
+  "wifi_rssi": -61,
+  "free_heap": 142336
+})JSON";
+
+// Variante mixte (build AxeOS modifié) : clés pool de l'ancien firmware,
+// bestSessionDiff numérique, shares sous "accepted"
+static const char MIXED_INFO[] = R"JSON({
+  "ASICModel": "BM1366",
+  "version": "v2.1.0-custom",
+  "temp": 61.0,
+  "power": 12.75,
+  "hashRate": 512.4,
+  "bestSessionDiff": 18500000,
+  "accepted": 774,
+  "pool_url": "pool.example.net",
+  "pool_user": "worker.mixed",
+  "uptimeSeconds": 3600
+})JSON";
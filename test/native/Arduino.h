@@ -0,0 +1,231 @@
+#pragma once
+// Doublure minimale du cœur Arduino-ESP32 pour l'environnement [env:native] :
+// juste ce qu'utilisent les modules compilés sur la machine hôte.
+//
+// millis() suit une horloge virtuelle que les tests avancent eux-mêmes
+// (nativeAdvance) ; les benchmarks mesurent le temps réel avec std::chrono.
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <math.h>
+#include <string>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+// ===== Temps virtuel =====
+inline uint32_t nativeNowMs = 0;
+
+inline uint32_t millis() { return nativeNowMs; }
+inline void delay(uint32_t ms) { nativeNowMs += ms; }
+inline void nativeAdvance(uint32_t ms) { nativeNowMs += ms; }
+inline void nativeSetMillis(uint32_t ms) { nativeNowMs = ms; }
+
+// ===== Aléatoire reproductible =====
+inline uint32_t nativeRandomState = 0x12345678;
+
+inline uint32_t esp_random() {
+    // xorshift32 : même suite à chaque exécution des tests
+    uint32_t x = nativeRandomState;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    nativeRandomState = x;
+    return x;
+}
+inline void randomSeed(uint32_t seed) { nativeRandomState = seed != 0 ? seed : 1; }
+inline long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) return howsmall;
+    return howsmall + (long)(esp_random() % (uint32_t)(howbig - howsmall));
+}
+inline long random(long howbig) { return random(0, howbig); }
+
+inline bool psramFound() { return true; }
+
+// glibc < 2.38 n'a pas strlcpy
+inline size_t native_strlcpy(char* dst, const char* src, size_t size) {
+    size_t len = strlen(src);
+    if (size > 0) {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+#define strlcpy native_strlcpy
+
+// ===== String (sous-ensemble de WString) =====
+class String {
+private:
+    std::string s;
+
+public:
+    String() {}
+    String(const char* value) : s(value != nullptr ? value : "") {}
+    String(const char* value, size_t len) : s(value, len) {}
+    String(const std::string& value) : s(value) {}
+    String(char c) : s(1, c) {}
+    explicit String(int value) : s(std::to_string(value)) {}
+    explicit String(unsigned int value) : s(std::to_string(value)) {}
+    explicit String(long value) : s(std::to_string(value)) {}
+    explicit String(unsigned long value) : s(std::to_string(value)) {}
+    explicit String(float value, unsigned int decimals = 2) { *this = format(value, decimals); }
+    explicit String(double value, unsigned int decimals = 2) { *this = format(value, decimals); }
+
+    String& operator=(const char* value) { s = value != nullptr ? value : ""; return *this; }
+
+    const char* c_str() const { return s.c_str(); }
+    unsigned int length() const { return (unsigned int)s.size(); }
+    bool isEmpty() const { return s.empty(); }
+    bool reserve(unsigned int size) { s.reserve(size); return true; }
+    char operator[](unsigned int index) const { return index < s.size() ? s[index] : '\0'; }
+    char charAt(unsigned int index) const { return (*this)[index]; }
+
+    bool concat(const char* value) { if (value != nullptr) s += value; return true; }
+    bool concat(const char* value, unsigned int len) { s.append(value, len); return true; }
+    bool concat(const String& value) { s += value.s; return true; }
+    bool concat(char c) { s += c; return true; }
+    String& operator+=(const char* value) { concat(value); return *this; }
+    String& operator+=(const String& value) { concat(value); return *this; }
+    String& operator+=(char c) { concat(c); return *this; }
+
+    bool operator==(const char* other) const { return s == (other != nullptr ? other : ""); }
+    bool operator==(const String& other) const { return s == other.s; }
+    bool operator!=(const char* other) const { return !(*this == other); }
+    bool operator!=(const String& other) const { return !(*this == other); }
+    bool equals(const String& other) const { return s == other.s; }
+    bool equalsIgnoreCase(const String& other) const {
+        if (s.size() != other.s.size()) return false;
+        for (size_t i = 0; i < s.size(); i++) {
+            if (tolower((unsigned char)s[i]) != tolower((unsigned char)other.s[i])) return false;
+        }
+        return true;
+    }
+    bool startsWith(const String& prefix) const { return s.compare(0, prefix.s.size(), prefix.s) == 0; }
+    bool endsWith(const String& suffix) const {
+        return s.size() >= suffix.s.size() && s.compare(s.size() - suffix.s.size(), suffix.s.size(), suffix.s) == 0;
+    }
+
+    int indexOf(char c, unsigned int from = 0) const {
+        size_t pos = s.find(c, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    int indexOf(const String& str, unsigned int from = 0) const {
+        size_t pos = s.find(str.s, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+    String substring(unsigned int from) const { return from < s.size() ? String(s.substr(from)) : String(); }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) std::swap(from, to);
+        if (from >= s.size()) return String();
+        return String(s.substr(from, to - from));
+    }
+    void remove(unsigned int index) { if (index < s.size()) s.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < s.size()) s.erase(index, count); }
+    void replace(const String& find, const String& with) {
+        if (find.s.empty()) return;
+        size_t pos = 0;
+        while ((pos = s.find(find.s, pos)) != std::string::npos) {
+            s.replace(pos, find.s.size(), with.s);
+            pos += with.s.size();
+        }
+    }
+    void trim() {
+        size_t start = 0;
+        while (start < s.size() && isspace((unsigned char)s[start])) start++;
+        size_t end = s.size();
+        while (end > start && isspace((unsigned char)s[end - 1])) end--;
+        s = s.substr(start, end - start);
+    }
+    void toLowerCase() { for (char& c : s) c = (char)tolower((unsigned char)c); }
+    void toUpperCase() { for (char& c : s) c = (char)toupper((unsigned char)c); }
+    long toInt() const { return strtol(s.c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(s.c_str(), nullptr); }
+
+    friend String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+    friend String operator+(const String& a, const char* b) { return String(a.s + (b != nullptr ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String(std::string(a != nullptr ? a : "") + b.s); }
+
+private:
+    static String format(double value, unsigned int decimals) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", (int)decimals, value);
+        return String(buf);
+    }
+};
+
+// ArduinoJson reconnaît aussi ce type (résultat d'une concaténation)
+class StringSumHelper : public String {
+public:
+    StringSumHelper(const String& value) : String(value) {}
+    StringSumHelper(const char* value) : String(value) {}
+};
+
+// ===== Stream (sous-ensemble) =====
+// Pas d'attente en temps virtuel : timedRead() renvoie -1 tout de suite
+// quand la source n'a plus rien, comme après un timeout.
+class Stream {
+protected:
+    unsigned long timeoutMs = 1000;
+
+public:
+    virtual ~Stream() {}
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual size_t write(uint8_t) = 0;
+    virtual void flush() {}
+
+    void setTimeout(unsigned long ms) { timeoutMs = ms; }
+    unsigned long getTimeout() const { return timeoutMs; }
+
+    int timedRead() { return read(); }
+    size_t readBytes(char* buffer, size_t length) {
+        size_t count = 0;
+        while (count < length) {
+            int c = timedRead();
+            if (c < 0) break;
+            buffer[count++] = (char)c;
+        }
+        return count;
+    }
+    bool find(char target) {
+        int c;
+        while ((c = timedRead()) >= 0) {
+            if (c == (unsigned char)target) return true;
+        }
+        return false;
+    }
+};
+
+// ===== Serial =====
+class NativeSerial {
+public:
+    bool quiet = false;   // Les benchmarks coupent les logs de leurs boucles
+
+    void begin(unsigned long) {}
+    int printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        if (quiet) return 0;
+        va_list args;
+        va_start(args, format);
+        int written = vprintf(format, args);
+        va_end(args);
+        return written;
+    }
+    size_t print(const char* text) { return quiet ? 0 : (size_t)::printf("%s", text); }
+    size_t print(const String& text) { return print(text.c_str()); }
+    size_t println(const char* text = "") { return quiet ? 0 : (size_t)::printf("%s\n", text); }
+    size_t println(const String& text) { return println(text.c_str()); }
+};
+
+inline NativeSerial Serial;
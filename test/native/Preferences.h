@@ -0,0 +1,70 @@
+#pragma once
+// Doublure de la NVS pour [env:native] : espaces de noms gardés en mémoire
+// pour toute la durée du test.
+#include <Arduino.h>
+#include <map>
+
+class Preferences {
+private:
+    static std::map<std::string, std::map<std::string, std::string>>& store() {
+        static std::map<std::string, std::map<std::string, std::string>> namespaces;
+        return namespaces;
+    }
+    std::string name;
+    bool readOnly = true;
+    bool opened = false;
+
+    const std::string* find(const char* key) const {
+        auto ns = store().find(name);
+        if (!opened || ns == store().end()) return nullptr;
+        auto entry = ns->second.find(key);
+        return entry == ns->second.end() ? nullptr : &entry->second;
+    }
+    size_t put(const char* key, const std::string& value) {
+        if (!opened || readOnly) return 0;
+        store()[name][key] = value;
+        return value.size() > 0 ? value.size() : 1;
+    }
+
+public:
+    bool begin(const char* ns, bool ro = false) {
+        name = ns;
+        readOnly = ro;
+        opened = true;
+        return true;
+    }
+    void end() { opened = false; }
+    bool clear() {
+        if (!opened || readOnly) return false;
+        store().erase(name);
+        return true;
+    }
+    bool remove(const char* key) {
+        if (!opened || readOnly) return false;
+        return store()[name].erase(key) > 0;
+    }
+    bool isKey(const char* key) const { return find(key) != nullptr; }
+
+    size_t putString(const char* key, const String& value) { return put(key, value.c_str()); }
+    size_t putString(const char* key, const char* value) { return put(key, value); }
+    size_t putBool(const char* key, bool value) { return put(key, value ? "1" : "0") ? 1 : 0; }
+    size_t putUInt(const char* key, uint32_t value) { return put(key, std::to_string(value)) ? 4 : 0; }
+    size_t putInt(const char* key, int32_t value) { return put(key, std::to_string(value)) ? 4 : 0; }
+
+    String getString(const char* key, const String& fallback = String()) const {
+        const std::string* value = find(key);
+        return value != nullptr ? String(*value) : fallback;
+    }
+    bool getBool(const char* key, bool fallback = false) const {
+        const std::string* value = find(key);
+        return value != nullptr ? *value == "1" : fallback;
+    }
+    uint32_t getUInt(const char* key, uint32_t fallback = 0) const {
+        const std::string* value = find(key);
+        return value != nullptr ? (uint32_t)strtoul(value->c_str(), nullptr, 10) : fallback;
+    }
+    int32_t getInt(const char* key, int32_t fallback = 0) const {
+        const std::string* value = find(key);
+        return value != nullptr ? (int32_t)strtol(value->c_str(), nullptr, 10) : fallback;
+    }
+};
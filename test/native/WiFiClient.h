@@ -0,0 +1,77 @@
+#pragma once
+// Doublure de WiFiClient pour [env:native] : pas de réseau. Les octets
+// écrits par le client s'accumulent dans tx ; le test joue le serveur en
+// ajoutant des octets à rx, directement ou depuis nativeServer (appelé
+// après chaque écriture du client, pour répondre à une poignée de main).
+#include <Arduino.h>
+#include <functional>
+
+class WiFiClient;
+
+inline std::function<void(WiFiClient&)> nativeServer;
+inline bool nativeConnectOk = true;
+
+class WiFiClient {
+public:
+    std::string rx;           // Serveur -> client
+    size_t rxPos = 0;
+    std::string tx;           // Client -> serveur
+    size_t readChunk = 0;     // Octets max par read() (0 = tout) : découpage des trames
+    bool open = false;
+    bool noDelay = false;
+    uint32_t timeoutSec = 0;
+
+    // Dernière connexion ouverte, pour que le test retrouve le socket
+    static inline WiFiClient* last = nullptr;
+
+    virtual ~WiFiClient() {}
+
+    int connect(const char* host, uint16_t port, int32_t timeoutMs) {
+        rx.clear();
+        tx.clear();
+        rxPos = 0;
+        open = nativeConnectOk;
+        last = this;
+        return open ? 1 : 0;
+    }
+    uint8_t connected() { return open ? 1 : 0; }
+    void stop() { open = false; }
+    void setNoDelay(bool value) { noDelay = value; }
+    int setTimeout(uint32_t seconds) { timeoutSec = seconds; return 0; }
+
+    // Côté serveur
+    void serverSend(const std::string& data) { rx += data; }
+    void serverSend(const uint8_t* data, size_t len) { rx.append((const char*)data, len); }
+
+    int available() { return open ? (int)(rx.size() - rxPos) : 0; }
+    int read(uint8_t* buf, size_t size) {
+        size_t count = std::min(size, rx.size() - rxPos);
+        if (readChunk > 0) count = std::min(count, readChunk);
+        memcpy(buf, rx.data() + rxPos, count);
+        rxPos += count;
+        return (int)count;
+    }
+    // Pas d'attente : sans données, renvoie ce qui a été lu (comme un timeout)
+    String readStringUntil(char terminator) {
+        std::string line;
+        while (rxPos < rx.size() && rx[rxPos] != terminator) line += rx[rxPos++];
+        if (rxPos < rx.size()) rxPos++;
+        return String(line);
+    }
+
+    size_t write(const uint8_t* data, size_t len) {
+        if (!open) return 0;
+        tx.append((const char*)data, len);
+        if (nativeServer) nativeServer(*this);
+        return len;
+    }
+    int printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char buf[1024];
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        write((const uint8_t*)buf, std::min((size_t)len, sizeof(buf) - 1));
+        return len;
+    }
+};
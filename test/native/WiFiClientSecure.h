@@ -0,0 +1,8 @@
+#pragma once
+// Doublure pour [env:native] : TLS absent, même comportement que WiFiClient
+#include "WiFiClient.h"
+
+class WiFiClientSecure : public WiFiClient {
+public:
+    void setInsecure() {}
+};
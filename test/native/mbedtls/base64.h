@@ -0,0 +1,27 @@
+#pragma once
+// Doublure mbedTLS pour [env:native] : encodage base64 seul
+#include <stddef.h>
+
+#define MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL  -0x002A
+
+inline int mbedtls_base64_encode(unsigned char* dst, size_t dlen, size_t* olen, const unsigned char* src, size_t slen) {
+    static const char* const ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t needed = (slen + 2) / 3 * 4;
+    *olen = needed + 1;
+    if (dlen < needed + 1) {
+        return MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL;
+    }
+    size_t out = 0;
+    for (size_t i = 0; i < slen; i += 3) {
+        unsigned int n = src[i] << 16;
+        if (i + 1 < slen) n |= src[i + 1] << 8;
+        if (i + 2 < slen) n |= src[i + 2];
+        dst[out++] = ALPHABET[(n >> 18) & 63];
+        dst[out++] = ALPHABET[(n >> 12) & 63];
+        dst[out++] = i + 1 < slen ? ALPHABET[(n >> 6) & 63] : '=';
+        dst[out++] = i + 2 < slen ? ALPHABET[n & 63] : '=';
+    }
+    dst[out] = '\0';
+    *olen = out;
+    return 0;
+}
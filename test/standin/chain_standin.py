@@ -0,0 +1,293 @@
+#!/usr/bin/env python3
+"""Flux WebSocket simulés pour ChainFeed (écran Clock), sans TLS.
+
+    mempool  ws://<poste>:8998/api/v1/ws   (messages façon mempool.space)
+    ticker   ws://<poste>:8999/            (ticker_batch façon Coinbase)
+
+Compilez le firmware avec les hôtes, ports et TLS remplacés
+(build_flags de l'environnement de l'appareil) :
+
+    -D CHAIN_FEED_MEMPOOL_HOST=\\"192.168.1.10\\" -D CHAIN_FEED_MEMPOOL_PORT=8998
+    -D CHAIN_FEED_TICKER_HOST=\\"192.168.1.10\\" -D CHAIN_FEED_TICKER_PORT=8999
+    -D CHAIN_FEED_TLS=false
+
+    python3 test/standin/chain_standin.py --block-interval 60
+
+Après {"action":"want",...} le serveur envoie le message initial (15 blocs,
+blocs projetés, fees : une quinzaine de Ko), puis un nouveau bloc toutes les
+--block-interval secondes et des fees toutes les --stats-interval secondes.
+--oversize N rend le N-ième bloc plus gros que CHAIN_FEED_CAPTURE_MAX (le
+rattrapage REST doit prendre le relais) ; --drop-after coupe les flux pour
+vérifier le retour au polling puis la reconnexion.
+"""
+import argparse
+import base64
+import hashlib
+import json
+import random
+import select
+import socketserver
+import struct
+import sys
+import threading
+import time
+
+GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+
+class Chain:
+    """Tip simulé, partagé par toutes les connexions."""
+
+    def __init__(self, height):
+        self.lock = threading.Lock()
+        self.height = height
+        self.mined = 0
+        self.price = 67000.0
+
+    def block(self, height, padding=0):
+        fees = sorted(round(random.uniform(1.0, 40.0), 2) for _ in range(7))
+        block = {
+            "id": "%064x" % random.getrandbits(256),
+            "height": height,
+            "version": 612368384,
+            "timestamp": int(time.time()) - (self.height - height) * 600,
+            "bits": 386089497,
+            "nonce": random.getrandbits(32),
+            "difficulty": 83148355189239.77,
+            "merkle_root": "%064x" % random.getrandbits(256),
+            "tx_count": random.randint(1500, 5000),
+            "size": random.randint(1200000, 1800000),
+            "weight": 3993262,
+            "previousblockhash": "%064x" % random.getrandbits(256),
+            "mediantime": int(time.time()) - 3600,
+            "extras": {
+                "reward": 315748923,
+                "coinbaseRaw": "%0128x" % random.getrandbits(512),
+                "medianFee": fees[3],
+                "feeRange": fees,
+                "totalFees": random.randint(1000000, 9000000),
+                "avgFeeRate": round(sum(fees) / len(fees), 2),
+                "avgTxSize": 418.53,
+                "virtualSize": 998315.5,
+                "coinbaseAddress": "bc1qxhmdufsvnuaaaer4ynz88fspdsxq2h9e9cetdj",
+                "pool": {"id": 111, "name": random.choice(["Foundry USA", "AntPool", "OCEAN", "ViaBTC", "F2Pool"]),
+                         "slug": "pool"},
+                "matchRate": 100,
+            },
+        }
+        if padding > 0:
+            block["extras"]["coinbaseSignatureAscii"] = "x" * padding
+        return block
+
+    @staticmethod
+    def projected():
+        blocks = []
+        median = random.uniform(8.0, 20.0)
+        for i in range(8):
+            fees = sorted(round(median * random.uniform(0.6, 1.6), 2) for _ in range(7))
+            blocks.append({"blockSize": 1600000, "blockVSize": round(random.uniform(997000, 998500), 2),
+                           "nTx": random.randint(2500, 4000), "totalFees": random.randint(2000000, 9000000),
+                           "medianFee": fees[3], "feeRange": fees})
+            median *= 0.8
+        return blocks
+
+    @staticmethod
+    def fees(projected):
+        return {"fastestFee": round(projected[0]["medianFee"]), "halfHourFee": round(projected[1]["medianFee"]),
+                "hourFee": round(projected[2]["medianFee"]), "economyFee": round(projected[4]["medianFee"]),
+                "minimumFee": 1}
+
+
+class WebSocket(socketserver.StreamRequestHandler):
+    """Poignée de main et trames serveur (RFC 6455), sans extension."""
+
+    def handshake(self):
+        request = self.rfile.readline().decode(errors="replace")
+        headers = {}
+        while True:
+            line = self.rfile.readline().decode(errors="replace").strip()
+            if not line:
+                break
+            name, _, value = line.partition(":")
+            headers[name.strip().lower()] = value.strip()
+        key = headers.get("sec-websocket-key")
+        if not request.startswith("GET ") or key is None:
+            self.wfile.write(b"HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n")
+            return None
+        accept = base64.b64encode(hashlib.sha1((key + GUID).encode()).digest()).decode()
+        self.wfile.write(("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                          "Sec-WebSocket-Accept: %s\r\n\r\n" % accept).encode())
+        return request.split(" ")[1]
+
+    def send(self, opcode, payload):
+        header = bytes([0x80 | opcode])
+        if len(payload) < 126:
+            header += bytes([len(payload)])
+        elif len(payload) < 65536:
+            header += bytes([126]) + struct.pack(">H", len(payload))
+        else:
+            header += bytes([127]) + struct.pack(">Q", len(payload))
+        self.wfile.write(header + payload)
+        self.wfile.flush()
+
+    def send_json(self, payload):
+        self.send(0x1, json.dumps(payload, separators=(",", ":")).encode())
+
+    def receive(self, timeout):
+        # Trame du client (masquée) : (opcode, charge), (None, None) sans données, None si fermé
+        readable, _, _ = select.select([self.connection], [], [], timeout)
+        if not readable:
+            return None, None
+        head = self.rfile.read(2)
+        if len(head) < 2:
+            return None
+        length = head[1] & 0x7F
+        if length == 126:
+            length = struct.unpack(">H", self.rfile.read(2))[0]
+        elif length == 127:
+            length = struct.unpack(">Q", self.rfile.read(8))[0]
+        key = self.rfile.read(4) if head[1] & 0x80 else b"\0\0\0\0"
+        data = self.rfile.read(length)
+        payload = bytes(b ^ key[i & 3] for i, b in enumerate(data))
+        if head[0] & 0x0F == 0x9:
+            self.send(0xA, payload)
+        return head[0] & 0x0F, payload
+
+    def serve(self, name, on_message, on_tick, args):
+        if self.handshake() is None:
+            return
+        print("[Chain] %s: %s connected" % (name, self.client_address[0]))
+        sys.stdout.flush()
+        opened = time.time()
+        try:
+            while args.drop_after <= 0 or time.time() - opened < args.drop_after:
+                frame = self.receive(0.2)
+                if frame is None or frame[0] == 0x8:
+                    break
+                if frame[0] == 0x1:
+                    on_message(frame[1])
+                on_tick()
+            else:
+                self.send(0x8, struct.pack(">H", 1001))
+        except (BrokenPipeError, ConnectionResetError):
+            pass
+        print("[Chain] %s: %s closed after %.0f s" % (name, self.client_address[0], time.time() - opened))
+        sys.stdout.flush()
+
+
+def mempool_handler(chain, args):
+    class Handler(WebSocket):
+        def handle(self):
+            state = {"want": False, "next_block": 0, "next_stats": 0}
+
+            def on_message(payload):
+                message = json.loads(payload)
+                if message.get("action") != "want" or state["want"]:
+                    return
+                state["want"] = True
+                projected = Chain.projected()
+                with chain.lock:
+                    blocks = [chain.block(chain.height - i) for i in range(15)]
+                initial = {"blocks": blocks, "mempool-blocks": projected, "fees": Chain.fees(projected),
+                           "mempoolInfo": {"size": random.randint(50000, 150000), "bytes": 60000000}}
+                self.send_json(initial)
+                print("[Chain] mempool: initial message %d bytes" % len(json.dumps(initial)))
+                now = time.time()
+                state["next_block"] = now + args.block_interval
+                state["next_stats"] = now + args.stats_interval
+
+            def on_tick():
+                if not state["want"]:
+                    return
+                now = time.time()
+                if now >= state["next_block"]:
+                    with chain.lock:
+                        chain.height += 1
+                        chain.mined += 1
+                        oversize = args.oversize > 0 and chain.mined % args.oversize == 0
+                        block = chain.block(chain.height, 5000 if oversize else 0)
+                    projected = Chain.projected()
+                    self.send_json({"block": block, "mempool-blocks": projected, "fees": Chain.fees(projected)})
+                    print("[Chain] mempool: block %d%s" % (block["height"], " (oversize)" if oversize else ""))
+                    state["next_block"] = now + args.block_interval
+                if now >= state["next_stats"]:
+                    projected = Chain.projected()
+                    self.send_json({"mempool-blocks": projected, "fees": Chain.fees(projected),
+                                    "vBytesPerSecond": random.randint(1000, 3000)})
+                    state["next_stats"] = now + args.stats_interval
+                sys.stdout.flush()
+
+            self.serve("mempool", on_message, on_tick, args)
+
+    return Handler
+
+
+def ticker_handler(chain, args):
+    class Handler(WebSocket):
+        def handle(self):
+            state = {"subscribed": False, "next": 0, "sequence": 1}
+
+            def on_message(payload):
+                message = json.loads(payload)
+                if message.get("type") != "subscribe":
+                    self.send_json({"type": "error", "message": "Failed to subscribe", "reason": "type is required"})
+                    return
+                state["subscribed"] = True
+                self.send_json({"type": "subscriptions",
+                                "channels": [{"name": "ticker_batch", "product_ids": ["BTC-USD"]}]})
+
+            def on_tick():
+                if not state["subscribed"] or time.time() < state["next"]:
+                    return
+                with chain.lock:
+                    chain.price *= random.uniform(0.998, 1.002)
+                    price = chain.price
+                state["sequence"] += random.randint(10, 200)
+                self.send_json({"type": "ticker", "sequence": state["sequence"], "product_id": "BTC-USD",
+                                "price": "%.2f" % price, "open_24h": "66012.10", "volume_24h": "8123.4567",
+                                "best_bid": "%.2f" % (price - 0.01), "best_ask": "%.2f" % price,
+                                "side": random.choice(["buy", "sell"]),
+                                "time": time.strftime("%Y-%m-%dT%H:%M:%S.000000Z", time.gmtime()),
+                                "trade_id": state["sequence"], "last_size": "0.0123"})
+                state["next"] = time.time() + 5  # ticker_batch
+
+            self.serve("ticker", on_message, on_tick, args)
+
+    return Handler
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--bind", default="0.0.0.0")
+    parser.add_argument("--mempool-port", type=int, default=8998)
+    parser.add_argument("--ticker-port", type=int, default=8999)
+    parser.add_argument("--height", type=int, default=850000, help="hauteur du tip au démarrage")
+    parser.add_argument("--block-interval", type=float, default=600, help="secondes entre deux blocs")
+    parser.add_argument("--stats-interval", type=float, default=30, help="secondes entre deux messages de fees")
+    parser.add_argument("--oversize", type=int, default=0, help="un bloc sur N dépasse CHAIN_FEED_CAPTURE_MAX")
+    parser.add_argument("--drop-after", type=float, default=0, help="ferme chaque flux après N secondes")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    random.seed(args.seed)
+    chain = Chain(args.height)
+    socketserver.ThreadingTCPServer.allow_reuse_address = True
+    socketserver.ThreadingTCPServer.daemon_threads = True
+    servers = [
+        socketserver.ThreadingTCPServer((args.bind, args.mempool_port), mempool_handler(chain, args)),
+        socketserver.ThreadingTCPServer((args.bind, args.ticker_port), ticker_handler(chain, args)),
+    ]
+    for server in servers:
+        threading.Thread(target=server.serve_forever, daemon=True).start()
+    print("[Chain] mempool on %s:%d, ticker on %s:%d" % (args.bind, args.mempool_port, args.bind, args.ticker_port))
+    sys.stdout.flush()
+    try:
+        while True:
+            time.sleep(3600)
+    except KeyboardInterrupt:
+        for server in servers:
+            server.shutdown()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,410 @@
+#!/usr/bin/env python3
+"""Mineurs AxeOS simulés pour tester l'appareil sans flotte réelle.
+
+Chaque mineur écoute sur son adresse, port 80 par défaut (BitaxeAPI ne
+sait pas viser un autre port). Sous Linux toutes les adresses 127.x.y.z
+répondent en local ; pour l'appareil, ajoutez des alias IP sur le poste et
+passez-les avec --addresses.
+
+    sudo python3 test/standin/mock_miners.py --count 10 --offline 3 --latency 80
+    sudo python3 test/standin/mock_miners.py --addresses 192.168.1.201-210
+
+Un mineur "offline" accepte la connexion TCP puis ne répond jamais : la
+requête coûte un timeout complet côté appareil. À chaque passe complète
+(chaque mineur en ligne interrogé une fois), le serveur affiche sa durée.
+
+Toutes les --report secondes, le serveur affiche les connexions TCP
+ouvertes et les requêtes servies. Pour comparer avec et sans keep-alive
+sur le même firmware, lancez une fois normalement puis avec --no-keepalive
+(chaque réponse ferme la connexion, comme avant le pool de connexions) :
+
+    sudo python3 test/standin/mock_miners.py --count 10 --report 60 --connect-delay 30
+    sudo python3 test/standin/mock_miners.py --count 10 --report 60 --connect-delay 30 --no-keepalive
+
+La latence vue par l'appareil s'affiche avec la commande série "sched"
+(colonne srtt) ; --idle-close coupe les connexions inactives pour tester
+la reconnexion du pool.
+
+POST /api/system/update {"url": ...} télécharge l'image depuis l'URL donnée
+(le cache local de TouchAxe), puis le mineur redémarre : il refuse les
+requêtes pendant --reboot secondes et son hashrate remonte progressivement
+sur --recovery secondes. Les --bad-update derniers mineurs en ligne ne
+retrouvent que 50 % de leur hashrate, pour vérifier que le déploiement par
+vagues s'arrête :
+
+    sudo python3 test/standin/mock_miners.py --count 12 --reboot 20 --recovery 60 --bad-update 1
+
+GET /api/ws ouvre le WebSocket du journal comme AxeOS : une ligne
+asic_result (nonce et difficulté) toutes les --ws-interval secondes en
+moyenne et une ligne de hashrate toutes les 5 s, avec les codes couleur
+d'ESP-Miner. --ws-drop coupe chaque WebSocket au bout de N secondes pour
+vérifier que le polling reprend puis que l'abonnement revient.
+"""
+import argparse
+import base64
+import hashlib
+import ipaddress
+import json
+import random
+import select
+import socket
+import socketserver
+import struct
+import sys
+import threading
+import time
+import urllib.request
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+
+class MockMiner:
+    def __init__(self, index, address, offline, latency_ms):
+        self.index = index
+        self.address = address
+        self.offline = offline
+        self.latency_ms = latency_ms
+        self.started = time.time()
+        self.hashrate = random.uniform(400.0, 1200.0)
+        self.shares = random.randint(0, 5000)
+        self.requests = 0
+        self.connections = 0
+        self.version = "v2.4.0-mock"
+        self.rebooting_until = 0.0
+        self.recovery_seconds = 0.0
+        self.recovered_ratio = 1.0   # Part du hashrate retrouvée après la mise à jour
+
+    def rebooting(self):
+        return time.time() < self.rebooting_until
+
+    def reboot(self, seconds, recovery_seconds):
+        self.rebooting_until = time.time() + seconds
+        self.recovery_seconds = recovery_seconds
+        self.started = self.rebooting_until
+
+    def update(self, url, reboot_seconds, recovery_seconds, bad):
+        # Téléchargement complet comme esp_https_ota, puis redémarrage
+        begun = time.time()
+        try:
+            with urllib.request.urlopen(url, timeout=30) as response:
+                size = len(response.read())
+        except Exception as error:
+            print("[Mock] %s: firmware download from %s failed (%s)" % (self.address, url, error))
+            sys.stdout.flush()
+            return
+        print("[Mock] %s: downloaded %d bytes in %.1f s, rebooting" % (self.address, size, time.time() - begun))
+        sys.stdout.flush()
+        self.version = "v2.5.0-mock"
+        self.recovered_ratio = 0.5 if bad else 1.0
+        self.reboot(reboot_seconds, recovery_seconds)
+
+    def current_hashrate(self):
+        # Remontée linéaire après le redémarrage (réglage de l'ASIC)
+        uptime = time.time() - self.started
+        ramp = min(1.0, uptime / self.recovery_seconds) if self.recovery_seconds > 0 else 1.0
+        return self.hashrate * ramp * self.recovered_ratio
+
+    def system_info(self):
+        # Le hashrate et les shares bougent pour déclencher la cadence rapide
+        self.hashrate *= random.uniform(0.97, 1.03)
+        self.shares += random.randint(0, 3)
+        return {
+            "ASICModel": "BM1366",
+            "hostname": "mock-%02d" % self.index,
+            "version": self.version,
+            "temp": round(random.uniform(52.0, 64.0), 1),
+            "power": round(random.uniform(12.0, 16.0), 2),
+            "voltage": 5100,
+            "current": 2800,
+            "hashRate": round(self.current_hashrate(), 2),
+            "bestDiff": "%.2fM" % random.uniform(10.0, 900.0),
+            "sharesAccepted": self.shares,
+            "sharesRejected": 0,
+            "stratumURL": "public-pool.io",
+            "stratumPort": 21496,
+            "stratumUser": "bc1qmockaddress.mock%02d" % self.index,
+            "uptimeSeconds": int(time.time() - self.started),
+            "frequency": 485,
+            "coreVoltage": 1200,
+            "fanspeed": 100,
+            "fanrpm": 5200,
+            "boardVersion": "204",
+            "runningPartition": "ota_0",
+        }
+
+
+class PassTracker:
+    """Durée d'une passe : de la première à la dernière réponse quand chaque
+    mineur en ligne a été interrogé une fois."""
+
+    def __init__(self, online):
+        self.online = online
+        self.lock = threading.Lock()
+        self.pending = set(online)
+        self.started = None
+        self.passes = 0
+
+    def record(self, index, begun, finished):
+        with self.lock:
+            if self.started is None:
+                self.started = begun
+            self.pending.discard(index)
+            if self.pending:
+                return
+            self.passes += 1
+            print("[Mock] pass %d: %d miner(s) in %.0f ms" %
+                  (self.passes, len(self.online), (finished - self.started) * 1000.0))
+            sys.stdout.flush()
+            self.pending = set(self.online)
+            self.started = None
+
+
+class TrafficStats:
+    """Connexions ouvertes et requêtes servies depuis le dernier rapport."""
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.connections = 0
+        self.requests = 0
+        self.service_ms = 0.0
+
+    def connection(self):
+        with self.lock:
+            self.connections += 1
+
+    def request(self, service_ms):
+        with self.lock:
+            self.requests += 1
+            self.service_ms += service_ms
+
+    def report(self, period):
+        with self.lock:
+            connections, requests, service_ms = self.connections, self.requests, self.service_ms
+            self.connections = self.requests = 0
+            self.service_ms = 0.0
+        per_connection = requests / connections if connections else 0.0
+        mean_ms = service_ms / requests if requests else 0.0
+        print("[Mock] last %d s: %d connection(s) opened for %d request(s) (%.1f req/conn), %.0f ms mean service time" %
+              (period, connections, requests, per_connection, mean_ms))
+        sys.stdout.flush()
+
+
+def make_handler(miner, tracker, traffic, keepalive, idle_close, connect_delay_ms, args):
+    class Handler(BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.1"  # Keep-alive comme AxeOS
+        timeout = idle_close if idle_close > 0 else None
+
+        def setup(self):
+            super().setup()
+            # En-têtes et body partent en deux écritures : sans TCP_NODELAY,
+            # Nagle + ACK retardé ajoutent ~40 ms aux requêtes keep-alive
+            self.connection.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+            miner.connections += 1
+            traffic.connection()
+            # Coût d'établissement d'une connexion sur un Wi-Fi chargé (la
+            # poignée de main en local est quasi gratuite)
+            time.sleep(connect_delay_ms / 1000.0)
+
+        def log_message(self, fmt, *args):
+            pass
+
+        def send_json(self, code, payload):
+            body = json.dumps(payload).encode()
+            self.send_response(code)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(body)))
+            if not keepalive:
+                self.send_header("Connection", "close")
+                self.close_connection = True
+            self.end_headers()
+            self.wfile.write(body)
+
+        def unavailable(self):
+            if miner.offline:
+                # Connexion acceptée, réponse jamais envoyée
+                time.sleep(3600)
+                return True
+            if miner.rebooting():
+                # Redémarrage : connexion coupée sans réponse
+                self.close_connection = True
+                return True
+            return False
+
+        def send_frame(self, opcode, payload):
+            header = bytes([0x80 | opcode])
+            if len(payload) < 126:
+                header += bytes([len(payload)])
+            elif len(payload) < 65536:
+                header += bytes([126]) + struct.pack(">H", len(payload))
+            else:
+                header += bytes([127]) + struct.pack(">Q", len(payload))
+            self.wfile.write(header + payload)
+            self.wfile.flush()
+
+        def read_frame(self):
+            # Trame du client (masquée) : (opcode, charge) ou None si fermé
+            head = self.rfile.read(2)
+            if len(head) < 2:
+                return None
+            length = head[1] & 0x7F
+            if length == 126:
+                length = struct.unpack(">H", self.rfile.read(2))[0]
+            elif length == 127:
+                length = struct.unpack(">Q", self.rfile.read(8))[0]
+            key = self.rfile.read(4) if head[1] & 0x80 else b"\0\0\0\0"
+            data = self.rfile.read(length)
+            return head[0] & 0x0F, bytes(b ^ key[i & 3] for i, b in enumerate(data))
+
+        def log_stream(self):
+            key = self.headers.get("Sec-WebSocket-Key", "")
+            accept = base64.b64encode(hashlib.sha1((key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11").encode()).digest())
+            self.send_response(101, "Switching Protocols")
+            self.send_header("Upgrade", "websocket")
+            self.send_header("Connection", "Upgrade")
+            self.send_header("Sec-WebSocket-Accept", accept.decode())
+            self.end_headers()
+            self.wfile.flush()
+            self.close_connection = True
+            print("[Mock] %s: log WebSocket opened" % miner.address)
+            sys.stdout.flush()
+
+            opened = time.time()
+            next_share = opened + random.expovariate(1.0 / args.ws_interval)
+            next_hashrate = opened
+            while not miner.rebooting():
+                now = time.time()
+                if args.ws_drop > 0 and now - opened >= args.ws_drop:
+                    self.send_frame(0x8, struct.pack(">H", 1001))
+                    break
+                if now >= next_share:
+                    diff = random.expovariate(1.0 / 2000.0)
+                    line = "\x1b[0;32mI (%d) asic_result: Ver: 20000000 Nonce %08X diff %.1f of 1000.\x1b[0m" % (
+                        int((now - miner.started) * 1000), random.getrandbits(32), diff)
+                    self.send_frame(0x1, line.encode())
+                    if diff >= 1000:
+                        miner.shares += 1
+                    next_share = now + random.expovariate(1.0 / args.ws_interval)
+                if now >= next_hashrate:
+                    line = "\x1b[0;32mI (%d) power_management: %.1f GH/s\x1b[0m" % (
+                        int((now - miner.started) * 1000), miner.current_hashrate())
+                    self.send_frame(0x1, line.encode())
+                    next_hashrate = now + 5
+                # Trames du client : pong, close
+                readable, _, _ = select.select([self.connection], [], [], 0.05)
+                if readable:
+                    frame = self.read_frame()
+                    if frame is None or frame[0] == 0x8:
+                        break
+                    if frame[0] == 0x9:
+                        self.send_frame(0xA, frame[1])
+            print("[Mock] %s: log WebSocket closed after %.0f s" % (miner.address, time.time() - opened))
+            sys.stdout.flush()
+
+        def do_GET(self):
+            begun = time.time()
+            if self.unavailable():
+                return
+            if self.path == "/api/ws" and self.headers.get("Upgrade", "").lower() == "websocket":
+                self.log_stream()
+                return
+            time.sleep(miner.latency_ms / 1000.0)
+            if self.path == "/api/system/info":
+                miner.requests += 1
+                self.send_json(200, miner.system_info())
+                finished = time.time()
+                traffic.request((finished - begun) * 1000.0)
+                tracker.record(miner.index, begun, finished)
+            else:
+                self.send_json(404, {"error": "not found"})
+
+        def do_POST(self):
+            if self.unavailable():
+                return
+            length = int(self.headers.get("Content-Length", 0))
+            body = self.rfile.read(length) if length > 0 else b""
+            time.sleep(miner.latency_ms / 1000.0)
+            if self.path == "/api/system/update":
+                try:
+                    url = json.loads(body)["url"]
+                except (ValueError, KeyError):
+                    self.send_json(400, {"error": "missing url"})
+                    return
+                self.send_json(200, {"message": "update started"})
+                threading.Thread(target=miner.update, daemon=True,
+                                 args=(url, args.reboot, args.recovery, miner.index in args.bad_indexes)).start()
+            elif self.path in ("/api/system/restart", "/api/system/reboot"):
+                self.send_json(200, {"message": "restarting"})
+                miner.reboot(args.reboot, args.recovery)
+            else:
+                self.send_json(404, {"error": "not found"})
+
+    return Handler
+
+
+def parse_addresses(spec, count):
+    if spec is None:
+        return ["127.0.0.%d" % (i + 1) for i in range(count)]
+    addresses = []
+    for part in spec.split(","):
+        if "-" in part:
+            # 192.168.1.201-210 : plage sur le dernier octet
+            first, last = part.split("-")
+            start = ipaddress.ip_address(first)
+            for offset in range(int(last) - int(first.rsplit(".", 1)[1]) + 1):
+                addresses.append(str(start + offset))
+        else:
+            addresses.append(part)
+    return addresses
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--count", type=int, default=10, help="nombre de mineurs (adresses 127.0.0.1...)")
+    parser.add_argument("--addresses", help="liste d'adresses, ex. 192.168.1.201-210,192.168.1.220")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--offline", type=int, default=0, help="les N derniers mineurs ne répondent jamais")
+    parser.add_argument("--latency", type=int, default=50, help="latence de réponse en ms")
+    parser.add_argument("--no-keepalive", action="store_true", help="ferme la connexion après chaque réponse")
+    parser.add_argument("--connect-delay", type=int, default=0, help="délai ajouté à chaque nouvelle connexion (ms)")
+    parser.add_argument("--idle-close", type=float, default=0, help="ferme une connexion inactive après N secondes")
+    parser.add_argument("--report", type=int, default=30, help="période du rapport connexions/requêtes (s)")
+    parser.add_argument("--reboot", type=float, default=15, help="durée d'un redémarrage (s)")
+    parser.add_argument("--recovery", type=float, default=30, help="remontée du hashrate après redémarrage (s)")
+    parser.add_argument("--bad-update", type=int, default=0, help="les N derniers mineurs en ligne restent à 50 %% après mise à jour")
+    parser.add_argument("--ws-interval", type=float, default=2.0, help="intervalle moyen des lignes asic_result sur /api/ws (s)")
+    parser.add_argument("--ws-drop", type=float, default=0, help="ferme chaque WebSocket après N secondes")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    random.seed(args.seed)
+    addresses = parse_addresses(args.addresses, args.count)
+    miners = []
+    for index, address in enumerate(addresses):
+        offline = index >= len(addresses) - args.offline
+        miners.append(MockMiner(index, address, offline, args.latency))
+    online = [m.index for m in miners if not m.offline]
+    args.bad_indexes = set(online[len(online) - args.bad_update:]) if args.bad_update > 0 else set()
+    tracker = PassTracker(online)
+    traffic = TrafficStats()
+
+    ThreadingHTTPServer.daemon_threads = True
+    socketserver.TCPServer.allow_reuse_address = True
+    servers = []
+    for miner in miners:
+        server = ThreadingHTTPServer((miner.address, args.port), make_handler(miner, tracker, traffic, not args.no_keepalive, args.idle_close, args.connect_delay, args))
+        threading.Thread(target=server.serve_forever, daemon=True).start()
+        servers.append(server)
+        print("[Mock] %s:%d %s" % (miner.address, args.port, "offline" if miner.offline else "online"))
+
+    try:
+        while True:
+            time.sleep(args.report)
+            traffic.report(args.report)
+    except KeyboardInterrupt:
+        for miner in miners:
+            print("[Mock] %s: %d request(s) over %d connection(s)" % (miner.address, miner.requests, miner.connections))
+        for server in servers:
+            server.shutdown()
+
+
+if __name__ == "__main__":
+    main()
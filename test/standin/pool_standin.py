@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""API de pool simulée pour la source PoolStatsSource.
+
+Sert les workers d'une adresse aux deux formats reconnus :
+
+    ckpool       GET /users/<adresse>
+    public-pool  GET /api/client/<adresse>
+
+Les noms de workers suivent ceux de mock_miners.py ("<adresse>.mockNN"),
+pour que les deux stand-ins se complètent :
+
+    sudo python3 test/standin/mock_miners.py --count 10
+    python3 test/standin/pool_standin.py --workers 10 --port 8081
+
+puis, sur l'appareil, l'URL de la source : http://<poste>:8081/users/{address}
+Chaque requête est affichée ; en régime établi il en arrive une par
+POOL_SOURCE_INTERVAL_MS et le polling direct des mineurs couverts s'espace
+(commande série "sched"). --idle rapporte les N derniers workers à 0 H/s
+(polling direct maintenu) ; --error-rate fait échouer une part des requêtes
+(HTTP 503) pour vérifier que le polling direct reprend.
+"""
+import argparse
+import json
+import random
+import re
+import socketserver
+import sys
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+
+def si(value):
+    # "1.21T" comme ckpool
+    for suffix, scale in (("P", 1e15), ("T", 1e12), ("G", 1e9), ("M", 1e6), ("K", 1e3)):
+        if value >= scale:
+            return "%.3g%s" % (value / scale, suffix)
+    return "%.3g" % value
+
+
+class Worker:
+    def __init__(self, index, address, idle):
+        self.name = "mock%02d" % index
+        self.address = address
+        self.idle = idle
+        self.hashrate = random.uniform(400e9, 1200e9)  # H/s
+        self.best = random.uniform(1e6, 9e8)
+        self.session = "%08x" % random.getrandbits(32)
+
+    def tick(self):
+        self.hashrate *= random.uniform(0.97, 1.03)
+        self.best = max(self.best, random.uniform(1e5, 1e9) if random.random() < 0.05 else 0)
+
+    def current(self):
+        return 0.0 if self.idle else self.hashrate
+
+
+def ckpool(workers):
+    total = sum(w.current() for w in workers)
+    return {
+        "hashrate1m": si(total),
+        "hashrate5m": si(total),
+        "workers": len(workers),
+        "bestshare": max(w.best for w in workers),
+        "worker": [{
+            "workername": "%s.%s" % (w.address, w.name),
+            "hashrate1m": si(w.current()),
+            "hashrate5m": si(w.current()),
+            "lastshare": int(time.time()),
+            "bestshare": round(w.best, 1),
+        } for w in workers],
+    }
+
+
+def public_pool(workers):
+    return {
+        "bestDifficulty": "%.2f" % max(w.best for w in workers),
+        "workersCount": len(workers),
+        "workers": [{
+            "sessionId": w.session,
+            "name": w.name,
+            "bestDifficulty": "%.2f" % w.best,
+            "hashRate": w.current(),
+            "lastSeen": time.strftime("%Y-%m-%dT%H:%M:%S.000Z", time.gmtime()),
+        } for w in workers],
+    }
+
+
+def make_handler(address, workers, args):
+    routes = (
+        (re.compile(r"^/users/([^/?]+)$"), ckpool),
+        (re.compile(r"^/api/client/([^/?]+)$"), public_pool),
+    )
+
+    class Handler(BaseHTTPRequestHandler):
+        def log_message(self, fmt, *args):
+            pass
+
+        def send_json(self, code, payload):
+            body = json.dumps(payload).encode()
+            self.send_response(code)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+
+        def do_GET(self):
+            time.sleep(args.latency / 1000.0)
+            for pattern, render in routes:
+                match = pattern.match(self.path)
+                if match is None:
+                    continue
+                if random.random() < args.error_rate:
+                    print("[Pool] %s -> 503" % self.path)
+                    self.send_json(503, {"error": "unavailable"})
+                elif match.group(1) != address:
+                    print("[Pool] %s -> unknown address" % self.path)
+                    self.send_json(404, {"error": "user not found"})
+                else:
+                    for worker in workers:
+                        worker.tick()
+                    print("[Pool] %s -> %d worker(s)" % (self.path, len(workers)))
+                    self.send_json(200, render(workers))
+                sys.stdout.flush()
+                return
+            self.send_json(404, {"error": "not found"})
+
+    return Handler
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--address", default="bc1qmockaddress", help="adresse de paiement servie")
+    parser.add_argument("--workers", type=int, default=10)
+    parser.add_argument("--idle", type=int, default=0, help="les N derniers workers sont à 0 H/s")
+    parser.add_argument("--error-rate", type=float, default=0.0, help="part des requêtes en HTTP 503")
+    parser.add_argument("--latency", type=int, default=300, help="latence de réponse en ms")
+    parser.add_argument("--bind", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=8081)
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    random.seed(args.seed)
+    workers = [Worker(i, args.address, i >= args.workers - args.idle) for i in range(args.workers)]
+
+    socketserver.TCPServer.allow_reuse_address = True
+    server = ThreadingHTTPServer((args.bind, args.port), make_handler(args.address, workers, args))
+    print("[Pool] %s:%d, %d worker(s) for %s" % (args.bind, args.port, len(workers), args.address))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        server.shutdown()
+
+
+if __name__ == "__main__":
+    main()
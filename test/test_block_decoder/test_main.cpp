@@ -0,0 +1,208 @@
+// Décodage des blocs mempool.space dans des structs fixes, et benchmark du
+// parsing de /v1/blocks : un élément filtré à la fois depuis le flux (comme
+// ExternalHttp::getJsonArray) contre le document complet lu pour doc[0].
+#include <unity.h>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include "block_decoder.h"
+#include "../fixtures/mempool_payloads.h"
+#include "../fixtures/counting_allocator.h"
+
+#define MEMPOOL_BLOCKS_PER_PAGE  15
+#define BENCH_ITERATIONS         300
+
+static std::string replaceAll(std::string text, const std::string& from, const std::string& to) {
+    for (size_t pos = 0; (pos = text.find(from, pos)) != std::string::npos; pos += to.size()) {
+        text.replace(pos, from.size(), to);
+    }
+    return text;
+}
+
+// Page de /v1/blocks : tip en premier, hauteurs décroissantes
+static std::string blocksPage(int count, uint32_t tipHeight) {
+    std::string page = "[";
+    for (int i = 0; i < count; i++) {
+        char index[12];
+        snprintf(index, sizeof(index), "%02x", (unsigned)i);
+        std::string block = replaceAll(MEMPOOL_BLOCK, "{index}", index);
+        page += replaceAll(block, "{height}", std::to_string(tipHeight - i));
+        if (i + 1 < count) page += ",";
+    }
+    return page + "]";
+}
+
+// Boucle de readJsonArray() sur un std::istream : un élément filtré dans
+// un document réutilisé, puis ',' ou ']'
+template <typename Handler>
+static bool readArray(std::istream& stream, JsonDocument& element, const JsonDocument& filter, Handler handler) {
+    char c;
+    while (stream.get(c) && c != '[') {}
+    if (!stream) return false;
+    int index = 0;
+    for (;;) {
+        if (deserializeJson(element, stream, DeserializationOption::Filter(filter))) return false;
+        handler(element.as<JsonVariantConst>(), index++);
+        while (stream.get(c) && c != ',' && c != ']') {}
+        if (!stream) return false;
+        if (c == ']') return true;
+    }
+}
+
+struct StreamResult {
+    BlockInfo blocks[RECENT_BLOCKS_COUNT];
+    int read;
+};
+
+static bool streamBlocks(const std::string& page, JsonDocument& element, StreamResult& result) {
+    std::istringstream stream(page);
+    result.read = 0;
+    return readArray(stream, element, BlockDecoder::blockFilter(), [&](JsonVariantConst block, int index) {
+        result.read++;
+        if (index < RECENT_BLOCKS_COUNT) {
+            BlockDecoder::decodeBlock(block, result.blocks[index]);
+        }
+    });
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_decode_block() {
+    JsonDocument doc;
+    std::string page = blocksPage(1, 850123);
+    TEST_ASSERT_FALSE(deserializeJson(doc, page.substr(1, page.size() - 2), DeserializationOption::Filter(BlockDecoder::blockFilter())));
+    BlockInfo block;
+    BlockDecoder::decodeBlock(doc.as<JsonVariantConst>(), block);
+
+    TEST_ASSERT_EQUAL_UINT(64, strlen(block.hash));
+    TEST_ASSERT_EQUAL_UINT32(850123, block.height);
+    TEST_ASSERT_EQUAL_UINT32(1719846512, block.timestamp);
+    TEST_ASSERT_EQUAL_UINT32(3872, block.txCount);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 7.82f, block.avgFee);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 3.01f, block.feeMin);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 302.5f, block.feeMax);
+    TEST_ASSERT_EQUAL_STRING("Foundry USA", block.poolName);
+}
+
+static void test_decode_missing_fields_and_long_pool_name() {
+    JsonDocument doc;
+    deserializeJson(doc, R"({"height": 1, "extras": {"pool": {"name": "A pool name much longer than thirty-one characters"}}})");
+    BlockInfo block;
+    memset(&block, 0x5A, sizeof(block));
+    BlockDecoder::decodeBlock(doc.as<JsonVariantConst>(), block);
+    TEST_ASSERT_EQUAL_STRING("", block.hash);
+    TEST_ASSERT_EQUAL_UINT32(0, block.txCount);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, block.feeMax);
+    TEST_ASSERT_EQUAL_UINT(BLOCK_POOL_NAME_LEN - 1, strlen(block.poolName));
+}
+
+static void test_decode_projected_blocks() {
+    std::istringstream stream(MEMPOOL_PROJECTED);
+    JsonDocument element;
+    ProjectedBlock projected[PROJECTED_BLOCKS_COUNT];
+    int count = 0;
+    TEST_ASSERT_TRUE(readArray(stream, element, BlockDecoder::projectedFilter(), [&](JsonVariantConst block, int index) {
+        if (index < PROJECTED_BLOCKS_COUNT) BlockDecoder::decodeProjectedBlock(block, projected[count++]);
+    }));
+    TEST_ASSERT_EQUAL_INT(PROJECTED_BLOCKS_COUNT, count);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 8.12f, projected[0].medianFee);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 6.01f, projected[0].feeMin);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 501.2f, projected[0].feeMax);
+    TEST_ASSERT_EQUAL_UINT32(3208, projected[0].txCount);
+    TEST_ASSERT_EQUAL_UINT32(997961, projected[0].vsize);
+    // Dernier bloc projeté : tout le reste du mempool
+    TEST_ASSERT_EQUAL_UINT32(21432, projected[7].txCount);
+}
+
+static void test_stream_reads_whole_page_keeps_recent() {
+    JsonDocument element;
+    StreamResult result;
+    TEST_ASSERT_TRUE(streamBlocks(blocksPage(MEMPOOL_BLOCKS_PER_PAGE, 850123), element, result));
+    // Tout le tableau est lu (connexion réutilisable), seuls les premiers sont gardés
+    TEST_ASSERT_EQUAL_INT(MEMPOOL_BLOCKS_PER_PAGE, result.read);
+    for (int i = 0; i < RECENT_BLOCKS_COUNT; i++) {
+        TEST_ASSERT_EQUAL_UINT32(850123 - i, result.blocks[i].height);
+    }
+    TEST_ASSERT_TRUE(strcmp(result.blocks[0].hash, result.blocks[1].hash) != 0);
+
+    // Tableau tronqué : erreur, pas de bloc à moitié décodé gardé en silence
+    std::string page = blocksPage(3, 850123);
+    TEST_ASSERT_FALSE(streamBlocks(page.substr(0, page.size() - 100), element, result));
+}
+
+struct ParseCost {
+    size_t peakBytes;
+    double usPerParse;
+};
+
+static ParseCost measureFull(const std::string& page) {
+    ParseCost cost = {0, 0};
+    CountingAllocator counter;
+    {
+        JsonDocument doc(&counter);
+        std::istringstream stream(page);
+        TEST_ASSERT_FALSE(deserializeJson(doc, stream));
+        BlockInfo tip;
+        BlockDecoder::decodeBlock(doc[0], tip);
+        TEST_ASSERT_EQUAL_UINT32(850123, tip.height);
+        cost.peakBytes = counter.peak;
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        JsonDocument doc;
+        std::istringstream stream(page);
+        deserializeJson(doc, stream);
+        BlockInfo tip;
+        BlockDecoder::decodeBlock(doc[0], tip);
+    }
+    cost.usPerParse = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / BENCH_ITERATIONS;
+    return cost;
+}
+
+static ParseCost measureStream(const std::string& page) {
+    ParseCost cost = {0, 0};
+    CountingAllocator counter;
+    StreamResult result;
+    {
+        JsonDocument element(&counter);
+        TEST_ASSERT_TRUE(streamBlocks(page, element, result));
+        cost.peakBytes = counter.peak;
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        JsonDocument element;
+        streamBlocks(page, element, result);
+    }
+    cost.usPerParse = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / BENCH_ITERATIONS;
+    return cost;
+}
+
+static void test_bench_stream_vs_full_document() {
+    std::string page = blocksPage(MEMPOOL_BLOCKS_PER_PAGE, 850123);
+    ParseCost full = measureFull(page);
+    ParseCost streamed = measureStream(page);
+
+    char message[200];
+    snprintf(message, sizeof(message),
+             "/v1/blocks %u bytes: full document %u B peak, %.0f us | element stream %u B peak, %.0f us (%d blocks kept, %u B)",
+             (unsigned)page.size(), (unsigned)full.peakBytes, full.usPerParse,
+             (unsigned)streamed.peakBytes, streamed.usPerParse,
+             RECENT_BLOCKS_COUNT, (unsigned)(sizeof(BlockInfo) * RECENT_BLOCKS_COUNT));
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(streamed.peakBytes * 5 < full.peakBytes);
+
+    // Mémoire du flux indépendante du nombre de blocs renvoyés
+    ParseCost longer = measureStream(blocksPage(MEMPOOL_BLOCKS_PER_PAGE * 4, 850123));
+    TEST_ASSERT_EQUAL_UINT(streamed.peakBytes, longer.peakBytes);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_decode_block);
+    RUN_TEST(test_decode_missing_fields_and_long_pool_name);
+    RUN_TEST(test_decode_projected_blocks);
+    RUN_TEST(test_stream_reads_whole_page_keeps_recent);
+    RUN_TEST(test_bench_stream_vs_full_document);
+    return UNITY_END();
+}
@@ -0,0 +1,137 @@
+// Décodage "Transfer-Encoding: chunked" au fil du flux (ChunkedStream) :
+// découpages arbitraires, extensions et trailer, connexion laissée propre
+// pour la requête suivante, limite de taille et flux invalides.
+#include <unity.h>
+#include <string>
+#include "chunked_stream.h"
+#include "../fixtures/miner_payloads.h"
+
+// Socket simulé : octets reçus, dont seuls les `ready` premiers sont arrivés
+class FakeSocket : public Stream {
+public:
+    std::string data;
+    size_t pos = 0;
+    size_t ready = std::string::npos;
+
+    explicit FakeSocket(const std::string& bytes) : data(bytes) {}
+    int available() override { return (int)(std::min(ready, data.size()) - pos); }
+    int read() override { return available() > 0 ? (uint8_t)data[pos++] : -1; }
+    int peek() override { return available() > 0 ? (uint8_t)data[pos] : -1; }
+    size_t write(uint8_t) override { return 0; }
+};
+
+// Corps découpé en chunks de `size` octets (taille en hexa, comme esp_http_server)
+static std::string chunked(const std::string& body, size_t size, const char* extension = "") {
+    std::string out;
+    for (size_t pos = 0; pos < body.size(); pos += size) {
+        std::string part = body.substr(pos, size);
+        char header[32];
+        snprintf(header, sizeof(header), "%zx%s\r\n", part.size(), extension);
+        out += header;
+        out += part;
+        out += "\r\n";
+    }
+    return out + "0\r\n\r\n";
+}
+
+static std::string readAll(ChunkedStream& stream) {
+    std::string out;
+    int c;
+    while ((c = stream.read()) >= 0) out += (char)c;
+    return out;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_decodes_any_chunk_size() {
+    std::string body = AXEOS_INFO;
+    size_t sizes[] = { 1, 7, 64, 512, body.size(), body.size() + 10 };
+    for (size_t size : sizes) {
+        FakeSocket socket(chunked(body, size));
+        ChunkedStream stream(socket);
+        TEST_ASSERT_TRUE(readAll(stream) == body);
+        TEST_ASSERT_TRUE(stream.finished());
+        TEST_ASSERT_FALSE(stream.failed());
+        TEST_ASSERT_EQUAL_UINT(body.size(), stream.bodyBytes());
+        TEST_ASSERT_EQUAL_UINT(socket.data.size(), socket.pos);
+    }
+}
+
+static void test_extensions_and_trailer_are_skipped() {
+    FakeSocket socket(chunked("{\"temp\":57.25}", 5, ";name=value"));
+    socket.data.replace(socket.data.size() - 2, 2, "X-Checksum: abc\r\n\r\n");
+    ChunkedStream stream(socket);
+    TEST_ASSERT_EQUAL_STRING("{\"temp\":57.25}", readAll(stream).c_str());
+    TEST_ASSERT_TRUE(stream.finished());
+    TEST_ASSERT_EQUAL_UINT(socket.data.size(), socket.pos);
+}
+
+static void test_drain_leaves_the_next_response_intact() {
+    // Le lecteur s'arrête à la fin du JSON, avant le chunk final
+    std::string next = "HTTP/1.1 200 OK\r\n";
+    FakeSocket socket(chunked("{\"a\":1}   \n", 4) + next);
+    ChunkedStream stream(socket);
+    for (int i = 0; i < 7; i++) stream.read();
+    TEST_ASSERT_FALSE(stream.finished());
+    TEST_ASSERT_TRUE(stream.drain());
+    TEST_ASSERT_EQUAL_STRING(next.c_str(), socket.data.substr(socket.pos).c_str());
+    TEST_ASSERT_EQUAL_INT(-1, stream.read());
+}
+
+static void test_read_waits_for_data_not_yet_received() {
+    FakeSocket socket(chunked("hashrate", 8));
+    socket.ready = 5;   // "8\r\n" + 2 octets de données
+    ChunkedStream stream(socket);
+    TEST_ASSERT_EQUAL_INT('h', stream.read());
+    TEST_ASSERT_EQUAL_INT('a', stream.read());
+    // Pas encore arrivé : -1 sans erreur, Stream::timedRead() réessaie
+    TEST_ASSERT_EQUAL_INT(0, stream.available());
+    TEST_ASSERT_EQUAL_INT(-1, stream.read());
+    TEST_ASSERT_FALSE(stream.failed());
+    socket.ready = std::string::npos;
+    TEST_ASSERT_EQUAL_INT(6, stream.available());
+    TEST_ASSERT_EQUAL_STRING("shrate", readAll(stream).c_str());
+    TEST_ASSERT_TRUE(stream.finished());
+}
+
+static void test_limit_stops_an_oversized_body() {
+    std::string body(5000, 'x');
+    FakeSocket socket(chunked(body, 1024));
+    ChunkedStream stream(socket, 4096);
+    TEST_ASSERT_EQUAL_UINT(4096, readAll(stream).size());
+    TEST_ASSERT_TRUE(stream.overflowed());
+    TEST_ASSERT_FALSE(stream.finished());
+}
+
+static void test_invalid_or_truncated_streams_fail() {
+    FakeSocket garbage("zz\r\nhello\r\n0\r\n\r\n");
+    ChunkedStream invalid(garbage);
+    TEST_ASSERT_EQUAL_INT(-1, invalid.read());
+    TEST_ASSERT_TRUE(invalid.failed());
+
+    // Données d'un chunk sans le CRLF qui doit les suivre
+    FakeSocket overrun("3\r\nabcdef\r\n0\r\n\r\n");
+    ChunkedStream desync(overrun);
+    TEST_ASSERT_EQUAL_STRING("abc", readAll(desync).c_str());
+    TEST_ASSERT_TRUE(desync.failed());
+
+    // Connexion coupée avant le chunk final
+    std::string full = chunked("{\"temp\":57}", 4);
+    FakeSocket cut(full.substr(0, full.size() - 5));
+    ChunkedStream truncated(cut);
+    TEST_ASSERT_EQUAL_STRING("{\"temp\":57}", readAll(truncated).c_str());
+    TEST_ASSERT_FALSE(truncated.drain());
+    TEST_ASSERT_TRUE(truncated.failed());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_decodes_any_chunk_size);
+    RUN_TEST(test_extensions_and_trailer_are_skipped);
+    RUN_TEST(test_drain_leaves_the_next_response_intact);
+    RUN_TEST(test_read_waits_for_data_not_yet_received);
+    RUN_TEST(test_limit_stops_an_oversized_body);
+    RUN_TEST(test_invalid_or_truncated_streams_fail);
+    return UNITY_END();
+}
@@ -0,0 +1,178 @@
+// Modèles de configuration : diff minimal contre la config d'un mineur et
+// enregistrement en NVS (doublure en mémoire).
+#include <unity.h>
+#include "config_templates.h"
+#include "../fixtures/miner_payloads.h"
+
+static void parse(JsonDocument& doc, const char* json) {
+    TEST_ASSERT_FALSE(deserializeJson(doc, json));
+}
+
+// Config actuelle telle que FLEET_CMD_APPLY_CONFIG la lit : filtrée
+static void loadCurrent(JsonDocument& doc, const char* payload) {
+    DeserializationError error = deserializeJson(doc, payload, DeserializationOption::Filter(ConfigTemplates::configFilter()));
+    TEST_ASSERT_FALSE(error);
+}
+
+void setUp() {
+    Serial.quiet = true;
+}
+void tearDown() {
+    Serial.quiet = false;
+}
+
+static void test_conforming_miner_gets_nothing() {
+    JsonDocument tpl, current, out;
+    parse(tpl, "{\"frequency\":525,\"coreVoltage\":1150,\"stratumURL\":\"public-pool.io\"}");
+    parse(current, "{\"frequency\":525,\"coreVoltage\":1150,\"stratumURL\":\"public-pool.io\",\"fanspeed\":100}");
+    TEST_ASSERT_EQUAL_INT(0, ConfigTemplates::diff(tpl.as<JsonVariantConst>(), current.as<JsonVariantConst>(), out));
+    TEST_ASSERT_EQUAL_UINT(0, out.size());
+}
+
+static void test_only_changed_fields_are_sent() {
+    JsonDocument tpl, current, out;
+    parse(tpl, "{\"frequency\":575,\"coreVoltage\":1150,\"fanspeed\":80}");
+    parse(current, "{\"frequency\":525,\"coreVoltage\":1150,\"fanspeed\":100}");
+    TEST_ASSERT_EQUAL_INT(2, ConfigTemplates::diff(tpl.as<JsonVariantConst>(), current.as<JsonVariantConst>(), out));
+    TEST_ASSERT_EQUAL_INT(575, out["frequency"].as<int>());
+    TEST_ASSERT_EQUAL_INT(80, out["fanspeed"].as<int>());
+    TEST_ASSERT_TRUE(out["coreVoltage"].isNull());
+}
+
+static void test_missing_field_is_sent() {
+    JsonDocument tpl, current, out;
+    parse(tpl, "{\"temptarget\":60}");
+    parse(current, "{\"frequency\":525}");
+    TEST_ASSERT_EQUAL_INT(1, ConfigTemplates::diff(tpl.as<JsonVariantConst>(), current.as<JsonVariantConst>(), out));
+    TEST_ASSERT_EQUAL_INT(60, out["temptarget"].as<int>());
+}
+
+static void test_numeric_representations_compare_equal() {
+    JsonDocument tpl, current, out;
+    // 525 == 525.0, true == 1
+    parse(tpl, "{\"frequency\":525,\"autofanspeed\":true}");
+    parse(current, "{\"frequency\":525.0,\"autofanspeed\":1}");
+    TEST_ASSERT_EQUAL_INT(0, ConfigTemplates::diff(tpl.as<JsonVariantConst>(), current.as<JsonVariantConst>(), out));
+
+    parse(current, "{\"frequency\":525.0,\"autofanspeed\":0}");
+    // false != true
+    TEST_ASSERT_EQUAL_INT(1, ConfigTemplates::diff(tpl.as<JsonVariantConst>(), current.as<JsonVariantConst>(), out));
+}
+
+static void test_password_only_sent_with_pool_change() {
+    JsonDocument tpl, current, out;
+    parse(tpl, "{\"stratumURL\":\"public-pool.io\",\"stratumUser\":\"bc1q.w1\",\"stratumPassword\":\"x\"}");
+
+    // Le mineur ne renvoie jamais le mot de passe : pas de redémarrage pour rien
+    parse(current, "{\"stratumURL\":\"public-pool.io\",\"stratumUser\":\"bc1q.w1\"}");
+    TEST_ASSERT_EQUAL_INT(0, ConfigTemplates::diff(tpl.as<JsonVariantConst>(), current.as<JsonVariantConst>(), out));
+
+    parse(current, "{\"stratumURL\":\"public-pool.io\",\"stratumUser\":\"bc1q.other\"}");
+    TEST_ASSERT_EQUAL_INT(2, ConfigTemplates::diff(tpl.as<JsonVariantConst>(), current.as<JsonVariantConst>(), out));
+    TEST_ASSERT_EQUAL_STRING("bc1q.w1", out["stratumUser"].as<const char*>());
+    TEST_ASSERT_EQUAL_STRING("x", out["stratumPassword"].as<const char*>());
+}
+
+static void test_password_not_sent_for_non_pool_change() {
+    JsonDocument tpl, current, out;
+    parse(tpl, "{\"frequency\":600,\"stratumURL\":\"public-pool.io\",\"stratumPassword\":\"x\"}");
+    parse(current, "{\"frequency\":525,\"stratumURL\":\"public-pool.io\"}");
+    TEST_ASSERT_EQUAL_INT(1, ConfigTemplates::diff(tpl.as<JsonVariantConst>(), current.as<JsonVariantConst>(), out));
+    TEST_ASSERT_TRUE(out["stratumPassword"].isNull());
+}
+
+static void test_diff_against_real_payload() {
+    JsonDocument tpl, current, out;
+    loadCurrent(current, AXEOS_INFO);
+    // Le filtre ne garde que les clés de modèle
+    TEST_ASSERT_TRUE(current["hashRate"].isNull());
+    TEST_ASSERT_FALSE(current["frequency"].isNull());
+
+    JsonDocument same;
+    same["frequency"] = current["frequency"];
+    same["stratumURL"] = current["stratumURL"];
+    TEST_ASSERT_EQUAL_INT(0, ConfigTemplates::diff(same.as<JsonVariantConst>(), current.as<JsonVariantConst>(), out));
+
+    parse(tpl, "{\"frequency\":1,\"stratumURL\":\"pool.example\"}");
+    TEST_ASSERT_EQUAL_INT(2, ConfigTemplates::diff(tpl.as<JsonVariantConst>(), current.as<JsonVariantConst>(), out));
+}
+
+static void test_save_keeps_known_keys_and_persists() {
+    ConfigTemplates* templates = ConfigTemplates::getInstance();
+    JsonDocument config;
+    parse(config, "{\"frequency\":550,\"hashRate\":900,\"stratumPort\":3333}");
+    String error;
+    TEST_ASSERT_TRUE(templates->save("eco", config.as<JsonVariantConst>(), error));
+
+    JsonDocument stored;
+    TEST_ASSERT_TRUE(templates->get("eco", stored));
+    TEST_ASSERT_EQUAL_UINT(2, stored.size());
+    TEST_ASSERT_TRUE(stored["hashRate"].isNull());
+
+    // Écrit dans la NVS sous "templates/all"
+    Preferences prefs;
+    prefs.begin("templates", true);
+    String json = prefs.getString("all", "");
+    prefs.end();
+    TEST_ASSERT_TRUE(json.indexOf("\"eco\"") >= 0);
+
+    TEST_ASSERT_TRUE(templates->remove("eco"));
+    TEST_ASSERT_FALSE(templates->get("eco", stored));
+}
+
+static void test_save_rejects_bad_input() {
+    ConfigTemplates* templates = ConfigTemplates::getInstance();
+    JsonDocument config;
+    String error;
+
+    parse(config, "{\"hashRate\":900}");
+    TEST_ASSERT_FALSE(templates->save("nothing", config.as<JsonVariantConst>(), error));
+    TEST_ASSERT_EQUAL_STRING("No known config field", error.c_str());
+
+    parse(config, "{\"frequency\":550}");
+    TEST_ASSERT_FALSE(templates->save("a-name-that-is-far-too-long", config.as<JsonVariantConst>(), error));
+    TEST_ASSERT_FALSE(templates->save("", config.as<JsonVariantConst>(), error));
+
+    char name[8];
+    for (int i = 0; i < CONFIG_TEMPLATE_MAX; i++) {
+        snprintf(name, sizeof(name), "t%d", i);
+        TEST_ASSERT_TRUE(templates->save(name, config.as<JsonVariantConst>(), error));
+    }
+    TEST_ASSERT_FALSE(templates->save("one-more", config.as<JsonVariantConst>(), error));
+    TEST_ASSERT_EQUAL_STRING("Too many templates", error.c_str());
+    // Remplacer un modèle existant reste possible
+    TEST_ASSERT_TRUE(templates->save("t0", config.as<JsonVariantConst>(), error));
+}
+
+static void test_invalid_update_keeps_existing_template() {
+    ConfigTemplates* templates = ConfigTemplates::getInstance();
+    JsonDocument config;
+    String error;
+    parse(config, "{\"frequency\":600,\"coreVoltage\":1150}");
+    TEST_ASSERT_TRUE(templates->save("keep", config.as<JsonVariantConst>(), error));
+
+    // Aucun champ connu : refusé, et l'ancien template reste intact
+    parse(config, "{\"hashRate\":900}");
+    TEST_ASSERT_FALSE(templates->save("keep", config.as<JsonVariantConst>(), error));
+    TEST_ASSERT_EQUAL_STRING("No known config field", error.c_str());
+    JsonDocument stored;
+    TEST_ASSERT_TRUE(templates->get("keep", stored));
+    TEST_ASSERT_EQUAL_UINT(2, stored.size());
+    TEST_ASSERT_EQUAL_INT(600, stored["frequency"].as<int>());
+    TEST_ASSERT_TRUE(templates->remove("keep"));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_conforming_miner_gets_nothing);
+    RUN_TEST(test_only_changed_fields_are_sent);
+    RUN_TEST(test_missing_field_is_sent);
+    RUN_TEST(test_numeric_representations_compare_equal);
+    RUN_TEST(test_password_only_sent_with_pool_change);
+    RUN_TEST(test_password_not_sent_for_non_pool_change);
+    RUN_TEST(test_diff_against_real_payload);
+    RUN_TEST(test_save_keeps_known_keys_and_persists);
+    RUN_TEST(test_invalid_update_keeps_existing_template);
+    RUN_TEST(test_save_rejects_bad_input);
+    return UNITY_END();
+}
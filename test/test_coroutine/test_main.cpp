@@ -0,0 +1,225 @@
+// Macros CO_* de coroutine.h reprises depuis une fausse loop() en temps
+// virtuel : reprise au bon point, attentes sans bloquer, délais, sortie
+// anticipée, et plusieurs flux entrelacés comme dans main.cpp.
+#include <unity.h>
+#include <string>
+#include "coroutine.h"
+
+// Flux en plusieurs étapes, état gardé en membres comme BitcoinAPI
+class Flow {
+public:
+    CoState co;
+    std::string log;
+    int i;
+    bool ready;
+    bool bail;
+
+    Flow() : i(0), ready(false), bail(false) {}
+
+    CoStatus steps() {
+        CO_BEGIN(co);
+        log += 'a';
+        CO_YIELD();
+        log += 'b';
+        for (i = 0; i < 3; i++) {
+            log += '0' + i;
+            CO_YIELD();
+        }
+        if (bail) {
+            log += '!';
+            CO_EXIT();
+        }
+        CO_AWAIT(ready);
+        log += 'c';
+        CO_END();
+    }
+
+    CoStatus sleeper(uint32_t ms) {
+        CO_BEGIN(co);
+        log += 's';
+        CO_SLEEP(ms);
+        log += 'w';
+        CO_END();
+    }
+
+    CoStatus awaitWithTimeout(uint32_t ms) {
+        CO_BEGIN(co);
+        CO_AWAIT_TIMEOUT(ready, ms);
+        log += ready ? "ok" : "timeout";
+        CO_END();
+    }
+};
+
+// Tâche du cœur 0 simulée : l'indicateur de fin passe à true après latency ms
+struct FakeWorker {
+    bool done;
+    uint32_t finishAt;
+
+    void post(uint32_t latency) {
+        done = false;
+        finishAt = millis() + latency;
+    }
+    void tick() {
+        if (!done && (int32_t)(millis() - finishAt) >= 0) done = true;
+    }
+};
+
+class Fetcher {
+public:
+    CoState co;
+    FakeWorker& worker;
+    int fetched;
+    int timeouts;
+
+    explicit Fetcher(FakeWorker& worker) : worker(worker), fetched(0), timeouts(0) {}
+
+    // Comme BitcoinAPI::stepPrice : requête confiée au worker, attente bornée, pause
+    CoStatus step() {
+        CO_BEGIN(co);
+        worker.post(300);
+        CO_AWAIT_TIMEOUT(worker.done, 1000);
+        if (!worker.done) {
+            timeouts++;
+            CO_EXIT();
+        }
+        fetched++;
+        CO_SLEEP(5000);
+        CO_END();
+    }
+};
+
+void setUp() {
+    nativeSetMillis(1000);
+}
+void tearDown() {}
+
+static void test_resumes_after_each_yield() {
+    Flow flow;
+    flow.ready = true;
+    const char* expected[] = {"a", "ab0", "ab01", "ab012", "ab012c"};
+    for (int call = 0; call < 5; call++) {
+        CoStatus status = flow.steps();
+        TEST_ASSERT_EQUAL_STRING(expected[call], flow.log.c_str());
+        TEST_ASSERT_EQUAL_INT(call < 4 ? CO_RUNNING : CO_DONE, status);
+    }
+    TEST_ASSERT_FALSE(flow.co.running());
+
+    // Terminé : l'appel suivant repart du début
+    flow.steps();
+    TEST_ASSERT_EQUAL_STRING("ab012ca", flow.log.c_str());
+}
+
+static void test_await_holds_until_condition() {
+    Flow flow;
+    for (int call = 0; call < 4; call++) flow.steps();
+    TEST_ASSERT_EQUAL_STRING("ab012", flow.log.c_str());
+    for (int call = 0; call < 10; call++) {
+        TEST_ASSERT_EQUAL_INT(CO_RUNNING, flow.steps());
+    }
+    TEST_ASSERT_EQUAL_STRING("ab012", flow.log.c_str());
+    flow.ready = true;
+    TEST_ASSERT_EQUAL_INT(CO_DONE, flow.steps());
+    TEST_ASSERT_EQUAL_STRING("ab012c", flow.log.c_str());
+}
+
+static void test_exit_resets_state() {
+    Flow flow;
+    flow.bail = true;
+    CoStatus status = CO_RUNNING;
+    int calls = 0;
+    while (status == CO_RUNNING && calls < 10) {
+        status = flow.steps();
+        calls++;
+    }
+    TEST_ASSERT_EQUAL_INT(CO_DONE, status);
+    TEST_ASSERT_EQUAL_INT(5, calls);
+    TEST_ASSERT_EQUAL_STRING("ab012!", flow.log.c_str());
+    TEST_ASSERT_FALSE(flow.co.running());
+
+    flow.bail = false;
+    flow.log.clear();
+    flow.steps();
+    TEST_ASSERT_EQUAL_STRING("a", flow.log.c_str());
+}
+
+static void test_sleep_does_not_block() {
+    Flow flow;
+    int calls = 0;
+    uint32_t start = millis();
+    while (flow.sleeper(250) == CO_RUNNING) {
+        calls++;
+        nativeAdvance(10);   // Un tour de loop() (LVGL, tactile)
+    }
+    // Rendu la main à chaque tour pendant l'attente
+    TEST_ASSERT_EQUAL_INT(25, calls);
+    TEST_ASSERT_EQUAL_UINT32(start + 250, millis());
+    TEST_ASSERT_EQUAL_STRING("sw", flow.log.c_str());
+}
+
+static void test_sleep_across_millis_wraparound() {
+    nativeSetMillis(0xFFFFFF9Cu);   // 100 ms avant le passage à zéro
+    Flow flow;
+    flow.sleeper(300);
+    nativeAdvance(299);
+    TEST_ASSERT_EQUAL_INT(CO_RUNNING, flow.sleeper(300));
+    nativeAdvance(1);
+    TEST_ASSERT_EQUAL_INT(CO_DONE, flow.sleeper(300));
+}
+
+static void test_await_timeout_both_outcomes() {
+    Flow flow;
+    flow.awaitWithTimeout(500);
+    nativeAdvance(200);
+    flow.ready = true;
+    TEST_ASSERT_EQUAL_INT(CO_DONE, flow.awaitWithTimeout(500));
+    TEST_ASSERT_EQUAL_STRING("ok", flow.log.c_str());
+
+    flow.ready = false;
+    flow.log.clear();
+    int calls = 0;
+    while (flow.awaitWithTimeout(500) == CO_RUNNING) {
+        calls++;
+        nativeAdvance(50);
+    }
+    TEST_ASSERT_EQUAL_INT(10, calls);
+    TEST_ASSERT_EQUAL_STRING("timeout", flow.log.c_str());
+}
+
+static void test_interleaved_flows_in_fake_loop() {
+    FakeWorker fast = {true, 0};
+    FakeWorker stuck = {true, 0};
+    Fetcher price(fast);
+    Fetcher blocks(stuck);
+    Flow ui;
+
+    // 30 s de loop() à 5 ms par tour : les deux flux avancent, l'UI aussi
+    uint32_t end = millis() + 30000;
+    int uiSteps = 0;
+    while ((int32_t)(millis() - end) < 0) {
+        fast.tick();   // stuck n'est jamais servi
+        price.step();
+        blocks.step();
+        ui.ready = true;
+        if (ui.steps() == CO_DONE) uiSteps++;
+        nativeAdvance(5);
+    }
+    // Une requête de 300 ms puis 5 s de pause : 6 cycles en 30 s
+    TEST_ASSERT_INT_WITHIN(1, 6, price.fetched);
+    TEST_ASSERT_EQUAL_INT(0, price.timeouts);
+    // Le flux bloqué abandonne au bout d'1 s et recommence, sans gêner les autres
+    TEST_ASSERT_EQUAL_INT(0, blocks.fetched);
+    TEST_ASSERT_INT_WITHIN(1, 30, blocks.timeouts);
+    TEST_ASSERT_TRUE(uiSteps > 1000);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_resumes_after_each_yield);
+    RUN_TEST(test_await_holds_until_condition);
+    RUN_TEST(test_exit_resets_state);
+    RUN_TEST(test_sleep_does_not_block);
+    RUN_TEST(test_sleep_across_millis_wraparound);
+    RUN_TEST(test_await_timeout_both_outcomes);
+    RUN_TEST(test_interleaved_flows_in_fake_loop);
+    return UNITY_END();
+}
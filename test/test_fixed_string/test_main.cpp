@@ -0,0 +1,187 @@
+// FixedString et modèle de données des mineurs : un poll (parse dans le
+// document du worker, extraction des stats, copie du snapshot) ne doit rien
+// allouer.
+#include <unity.h>
+#include <new>
+#include "fixed_string.h"
+#include "miner_schema.h"
+#include "json_arena.h"
+#include "../fixtures/miner_payloads.h"
+#include "../fixtures/counting_allocator.h"
+
+// Compteur global des allocations C++ (String, std::string, new...)
+static bool countingNew = false;
+static size_t newCalls = 0;
+
+void* operator new(size_t size) {
+    if (countingNew) newCalls++;
+    void* ptr = malloc(size > 0 ? size : 1);
+    if (ptr == nullptr) throw std::bad_alloc();
+    return ptr;
+}
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+void operator delete[](void* ptr) noexcept {
+    free(ptr);
+}
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+void operator delete[](void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+static void startCounting() {
+    newCalls = 0;
+    countingNew = true;
+}
+static size_t stopCounting() {
+    countingNew = false;
+    return newCalls;
+}
+
+void setUp() {
+    Serial.quiet = true;
+}
+void tearDown() {
+    countingNew = false;
+    Serial.quiet = false;
+}
+
+static void test_empty_by_default() {
+    FixedString<8> s;
+    TEST_ASSERT_TRUE(s.isEmpty());
+    TEST_ASSERT_EQUAL_size_t(0, s.length());
+    TEST_ASSERT_EQUAL_STRING("", s.c_str());
+    TEST_ASSERT_EQUAL_size_t(7, FixedString<8>::capacity());
+}
+
+static void test_assign_and_compare() {
+    FixedString<16> s("bitaxe-01");
+    TEST_ASSERT_EQUAL_size_t(9, s.length());
+    TEST_ASSERT_TRUE(s == "bitaxe-01");
+    TEST_ASSERT_TRUE(s != "bitaxe-02");
+    FixedString<16> copy = s;
+    TEST_ASSERT_TRUE(copy == s);
+    s = "other";
+    TEST_ASSERT_TRUE(copy != s);
+    s = (const char*)nullptr;
+    TEST_ASSERT_TRUE(s.isEmpty());
+    TEST_ASSERT_TRUE(s == nullptr);
+}
+
+static void test_exact_fit_and_truncation() {
+    FixedString<6> s;
+    TEST_ASSERT_TRUE(s.assign("12345"));
+    TEST_ASSERT_EQUAL_STRING("12345", s.c_str());
+    TEST_ASSERT_FALSE(s.assign("123456789"));
+    TEST_ASSERT_EQUAL_STRING("12345", s.c_str());
+    TEST_ASSERT_EQUAL_size_t(5, s.length());
+}
+
+static void test_truncation_keeps_utf8_whole() {
+    // "abcé" : é = 2 octets (0xC3 0xA9), coupé au milieu avec 4 caractères de place
+    FixedString<5> s;
+    TEST_ASSERT_FALSE(s.assign("abc\xC3\xA9"));
+    TEST_ASSERT_EQUAL_STRING("abc", s.c_str());
+    // "€" = 3 octets : rien ne tient après "a" avec 3 octets de place
+    FixedString<4> euro;
+    TEST_ASSERT_FALSE(euro.assign("a\xE2\x82\xAC"));
+    TEST_ASSERT_EQUAL_STRING("a", euro.c_str());
+}
+
+static void test_assign_from_string_and_self() {
+    FixedString<16> s;
+    s = String("from String");
+    TEST_ASSERT_EQUAL_STRING("from String", s.c_str());
+    // assign() depuis son propre buffer (memmove)
+    s.assign(s.c_str() + 5, 6);
+    TEST_ASSERT_EQUAL_STRING("String", s.c_str());
+}
+
+static void test_copy_is_allocation_free() {
+    FixedString<BITAXE_POOL_USER_LEN> user("bc1qxyz0anonymizedaddress0000000000000000.gamma01");
+    startCounting();
+    FixedString<BITAXE_POOL_USER_LEN> copy = user;
+    copy = "worker.two";
+    bool same = copy == user;
+    size_t calls = stopCounting();
+    TEST_ASSERT_FALSE(same);
+    TEST_ASSERT_EQUAL_size_t(0, calls);
+}
+
+// Ce que fait un worker du poller pour chaque réponse, hors réseau : lecture
+// des stats avec le plan mémorisé, puis copie du snapshot (MinerRegistry::read)
+static void test_poll_extract_and_snapshot_allocate_nothing() {
+    JsonDocument doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, AXEOS_INFO, DeserializationOption::Filter(MinerSchema::infoFilter())));
+    BitaxeFieldMap plan;
+    BitaxeStats stats;
+    TEST_ASSERT_TRUE(MinerSchema::parse(doc, &plan, stats, "alloc"));
+
+    BitaxeStats snapshots[8];
+    startCounting();
+    for (int poll = 0; poll < 100; poll++) {
+        MinerSchema::parse(doc, &plan, stats, "alloc");
+        snapshots[poll % 8] = stats;
+    }
+    size_t calls = stopCounting();
+
+    TEST_ASSERT_EQUAL_size_t(0, calls);
+    TEST_ASSERT_EQUAL_STRING("BM1370", snapshots[7].hostname.c_str());
+    TEST_ASSERT_EQUAL_STRING("bc1qxyz0anonymizedaddress0000000000000000.gamma01", snapshots[7].poolUser.c_str());
+}
+
+// Poll complet d'un worker, hors réseau : parse filtré dans son document sur
+// arène, extraction avec le plan mémorisé, copie du snapshot. Rien ne doit
+// passer par le tas, ni par new ni par l'Allocator du document.
+static void test_full_poll_allocates_nothing() {
+    static uint8_t buffer[MINER_JSON_ARENA_BYTES];
+    JsonArena arena(buffer, sizeof(buffer));
+    JsonDocument doc(&arena);
+    BitaxeFieldMap plan;
+    BitaxeStats stats;
+    BitaxeStats snapshots[8];
+    TEST_ASSERT_FALSE(deserializeJson(doc, AXEOS_INFO, DeserializationOption::Filter(MinerSchema::infoFilter())));
+    TEST_ASSERT_TRUE(MinerSchema::parse(doc, &plan, stats, "alloc"));
+
+    startCounting();
+    for (int poll = 0; poll < 100; poll++) {
+        DeserializationError error = deserializeJson(doc, AXEOS_INFO, DeserializationOption::Filter(MinerSchema::infoFilter()));
+        if (error || !MinerSchema::parse(doc, &plan, stats, "alloc")) break;
+        snapshots[poll % 8] = stats;
+    }
+    size_t calls = stopCounting();
+
+    TEST_ASSERT_EQUAL_size_t(0, calls);
+    TEST_ASSERT_EQUAL_UINT32(0, arena.failures());
+    TEST_ASSERT_EQUAL_STRING("bc1qxyz0anonymizedaddress0000000000000000.gamma01", snapshots[7].poolUser.c_str());
+
+    // Même parse avec l'Allocator par défaut, pour comparaison
+    CountingAllocator counter;
+    JsonDocument heapDoc(&counter);
+    for (int poll = 0; poll < 10; poll++) {
+        deserializeJson(heapDoc, AXEOS_INFO, DeserializationOption::Filter(MinerSchema::infoFilter()));
+    }
+    char message[128];
+    snprintf(message, sizeof(message), "per poll: heap document %.1f allocation(s), arena document 0 (peak %u of %u B)",
+             counter.allocations / 10.0, (unsigned)arena.peak(), (unsigned)arena.capacity());
+    TEST_MESSAGE(message);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_by_default);
+    RUN_TEST(test_assign_and_compare);
+    RUN_TEST(test_exact_fit_and_truncation);
+    RUN_TEST(test_truncation_keeps_utf8_whole);
+    RUN_TEST(test_assign_from_string_and_self);
+    RUN_TEST(test_copy_is_allocation_free);
+    RUN_TEST(test_poll_extract_and_snapshot_allocate_nothing);
+    RUN_TEST(test_full_poll_allocates_nothing);
+    return UNITY_END();
+}
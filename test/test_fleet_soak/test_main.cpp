@@ -0,0 +1,198 @@
+// Soak de 128 mineurs simulés : empreinte mémoire des tableaux par mineur
+// et durée d'un cycle de polling avec le budget global, en temps virtuel.
+// Le vrai PollScheduler est piloté comme par MinerPoller : dispatchDue() au
+// tick ou à la fin d'une requête, complete() quand le faux mineur répond.
+#include <unity.h>
+#include <chrono>
+#include "fleet_storage.h"
+#include "poll_scheduler.h"
+#include "rtt_estimator.h"
+
+#define SOAK_MINERS        MAX_BITAXE_DEVICES
+#define SOAK_OFFLINE       8        // Mineurs éteints (sonde TCP en échec)
+#define SOAK_DURATION_MS   (30UL * 60 * 1000)
+#define SOAK_WARMUP_MS     (5UL * 60 * 1000)   // Démarrage : tout le monde est échu d'un coup
+
+struct SoakStats {
+    uint32_t requests;
+    uint32_t maxGapMs;        // Plus long écart entre deux polls d'un mineur en ligne
+    double meanGapMs;
+    uint32_t maxLagMs;        // Retard max d'un départ sur son échéance
+    uint32_t minOfflineInterval;
+    double offlineShare;      // Part du temps de polling prise par un mineur éteint
+    uint32_t cycles;          // Cycles complets mesurés par le PollScheduler
+    uint32_t lastCycleMs;
+    uint32_t avgCycleMs;
+    double dispatchUsPerTick; // Coût hôte de hasDue() + dispatchDue() à chaque tick
+};
+
+static bool isDue(uint32_t now, uint32_t deadline) {
+    return (int32_t)(now - deadline) >= 0;
+}
+
+static SoakStats runSoak(MinerSchedule* schedule, int count) {
+    SoakStats result = {0, 0, 0, 0, UINT32_MAX, 0, 0, 0, 0, 0};
+    PollScheduler scheduler;
+    uint32_t latency[SOAK_MINERS];
+    uint32_t lastStart[SOAK_MINERS];
+    uint32_t finishAt[SOAK_MINERS];
+    RttEstimator offlineRtt[SOAK_OFFLINE];   // Sonde des mineurs éteints (backoff)
+    double gapSum = 0;
+    uint32_t gapCount = 0;
+    uint32_t ticks = 0;
+    double dispatchUs = 0;
+
+    randomSeed(42);
+    uint32_t now = 0;
+    scheduler.begin(schedule, count, POLLER_DEFAULT_IN_FLIGHT, now);
+    for (int i = 0; i < count; i++) {
+        char ip[16];
+        snprintf(ip, sizeof(ip), "10.0.%d.%d", i / 250, i % 250 + 1);
+        scheduler.add(i + 1, ip, now);
+        latency[i] = 30 + random(0, 90);   // LAN : 30 à 120 ms
+        lastStart[i] = 0;
+    }
+    scheduler.updateNormalInterval();
+
+    while (now < SOAK_DURATION_MS) {
+        // Fins de requête (pollOne) ; slot i = mineur i + 1
+        for (int i = 0; i < count; i++) {
+            MinerSchedule& entry = scheduler.at(i);
+            if (!entry.inFlight || !isDue(now, finishAt[i])) continue;
+            bool offline = i >= count - SOAK_OFFLINE;
+            PollOutcome outcome = {};
+            outcome.success = !offline;
+            outcome.hashrate = offline ? 0.0f : 1200.0f;
+            outcome.temp = offline ? 0.0f : 55.0f;
+            outcome.latencyMs = now - lastStart[i];
+            scheduler.complete(i, outcome, now);
+            if (offline && now > SOAK_WARMUP_MS) {
+                result.minOfflineInterval = min(result.minOfflineInterval, entry.interval);
+            }
+        }
+
+        // Tick du planificateur (dispatchDue)
+        auto start = std::chrono::steady_clock::now();
+        int launch[POLLER_MAX_IN_FLIGHT];
+        int launched = scheduler.hasDue(now) ? scheduler.dispatchDue(now, false, launch, POLLER_MAX_IN_FLIGHT) : 0;
+        dispatchUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        ticks++;
+
+        for (int k = 0; k < launched; k++) {
+            int i = launch[k];
+            const MinerSchedule& entry = scheduler.at(i);
+            bool offline = i >= count - SOAK_OFFLINE;
+            result.requests++;
+            // Mineur éteint : la sonde TCP échoue au bout de son délai, qui
+            // s'allonge à chaque échec (BitaxeAPI::probe())
+            if (offline) {
+                RttEstimator& rtt = offlineRtt[i - (count - SOAK_OFFLINE)];
+                finishAt[i] = now + rtt.probeTimeout();
+                rtt.onTimeout();
+            } else {
+                finishAt[i] = now + latency[i];
+            }
+            if (now > SOAK_WARMUP_MS) {
+                result.maxLagMs = max(result.maxLagMs, now - entry.nextDue);
+                if (!offline && entry.polls > 0) {
+                    uint32_t gap = now - lastStart[i];
+                    result.maxGapMs = max(result.maxGapMs, gap);
+                    gapSum += gap;
+                    gapCount++;
+                }
+            }
+            lastStart[i] = now;
+        }
+
+        // Prochain réveil : tick ou première fin de requête
+        uint32_t wake = now + POLLER_TICK_MS;
+        for (int i = 0; i < count; i++) {
+            if (scheduler.at(i).inFlight) wake = max(now + 1, min(wake, finishAt[i]));
+        }
+        now = wake;
+    }
+
+    result.meanGapMs = gapCount > 0 ? gapSum / gapCount : 0;
+    uint32_t totalBusy = scheduler.getTotalBusyMs();
+    result.offlineShare = totalBusy > 0 ? scheduler.at(count - 1).busyMs * 100.0 / totalBusy : 0;
+    result.cycles = scheduler.getCycles();
+    result.lastCycleMs = scheduler.getLastCycle();
+    result.avgCycleMs = scheduler.getAvgCycle();
+    result.dispatchUsPerTick = ticks > 0 ? dispatchUs / ticks : 0;
+    return result;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_footprint_of_128_miners() {
+    size_t config = sizeof(BitaxeDevice) * SOAK_MINERS;
+    size_t nvs = sizeof(BitaxeRecord) * SOAK_MINERS;
+    size_t poller = sizeof(MinerSchedule) * SOAK_MINERS;
+    size_t snapshot = sizeof(BitaxeStats) * SOAK_MINERS;
+
+    char message[200];
+    snprintf(message, sizeof(message),
+             "%d miners: config %u B, NVS blob %u B, poll schedule %u B, stats snapshots %u B (registry upper bound) = %u B",
+             SOAK_MINERS, (unsigned)config, (unsigned)nvs, (unsigned)poller, (unsigned)snapshot,
+             (unsigned)(config + poller + snapshot));
+    TEST_MESSAGE(message);
+
+    // Le blob NVS tient dans les ~9,5 Ko annoncés par fleet_storage.h
+    TEST_ASSERT_TRUE(nvs <= 9728);
+    // Les tableaux tiennent largement en PSRAM (8 Mo) et restent hors du tas interne
+    TEST_ASSERT_TRUE(config + poller + snapshot < 256 * 1024);
+}
+
+static void test_fleet_arrays_are_allocated_at_runtime() {
+    TEST_ASSERT_EQUAL_INT(MAX_BITAXE_DEVICES, fleetCapacity());
+    MinerSchedule* schedule = fleetAllocArray<MinerSchedule>(fleetCapacity());
+    BitaxeDevice* devices = fleetAllocArray<BitaxeDevice>(fleetCapacity());
+    TEST_ASSERT_NOT_NULL(schedule);
+    TEST_ASSERT_NOT_NULL(devices);
+    // Construits par défaut
+    TEST_ASSERT_FALSE(schedule[SOAK_MINERS - 1].fieldMap.resolved);
+    TEST_ASSERT_TRUE(devices[SOAK_MINERS - 1].name.isEmpty());
+    free(schedule);
+    free(devices);
+}
+
+static void test_poll_cycle_of_128_miners() {
+    MinerSchedule* schedule = fleetAllocArray<MinerSchedule>(SOAK_MINERS);
+    TEST_ASSERT_NOT_NULL(schedule);
+    SoakStats stats = runSoak(schedule, SOAK_MINERS);
+    free(schedule);
+
+    uint32_t normal = PollPacer::normalInterval(SOAK_MINERS);
+    double rps = stats.requests * 1000.0 / SOAK_DURATION_MS;
+    char message[320];
+    snprintf(message, sizeof(message),
+             "%d miners (%d offline), normal interval %u ms: cycle %u ms last, %u ms avg over %u; "
+             "poll gap %.0f ms mean, %u ms max, lag %u ms max, %.2f req/s, dispatch %.2f us/tick, one offline miner %.1f%% of polling time",
+             SOAK_MINERS, SOAK_OFFLINE, normal, stats.lastCycleMs, stats.avgCycleMs, stats.cycles,
+             stats.meanGapMs, stats.maxGapMs, stats.maxLagMs, rps, stats.dispatchUsPerTick, stats.offlineShare);
+    TEST_MESSAGE(message);
+
+    // Budget global respecté (la rafale initiale mise à part)
+    TEST_ASSERT_TRUE(rps <= POLL_MAX_RPS);
+    // Chaque mineur en ligne revient dans sa cadence normale (+ jitter), sans dérive
+    TEST_ASSERT_TRUE(stats.meanGapMs < normal * 1.05);
+    TEST_ASSERT_TRUE(stats.maxGapMs <= normal + normal * POLL_JITTER_PERCENT / 100 + 2000);
+    TEST_ASSERT_TRUE(stats.maxLagMs <= 2000);
+    // Cycle mesuré comme pour "sched" : la flotte joignable rafraîchie en une
+    // cadence normale, sans attendre les mineurs en backoff
+    TEST_ASSERT_TRUE(stats.cycles >= SOAK_DURATION_MS / POLL_BACKOFF_MAX_MS);
+    TEST_ASSERT_TRUE(stats.avgCycleMs <= normal + normal * POLL_JITTER_PERCENT / 100 + 2000);
+    // Les mineurs éteints ont atteint le plafond du backoff
+    TEST_ASSERT_TRUE(stats.minOfflineInterval >= POLL_BACKOFF_MAX_MS * (100 - POLL_JITTER_PERCENT) / 100);
+    // ...et la sonde au plafond de la sienne coûte moins de 5 % du polling
+    TEST_ASSERT_TRUE(stats.offlineShare < 5.0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_footprint_of_128_miners);
+    RUN_TEST(test_fleet_arrays_are_allocated_at_runtime);
+    RUN_TEST(test_poll_cycle_of_128_miners);
+    return UNITY_END();
+}
@@ -0,0 +1,119 @@
+// Benchmark du parsing de /api/system/info : filtré en flux (chemin de
+// BitaxeAPI::fetch()) contre document complet, sur des réponses
+// enregistrées. Affiche les octets alloués par le JsonDocument et le temps
+// par parse ; vérifie que la mémoire du chemin filtré ne dépend pas de la
+// taille du payload.
+#include <unity.h>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include "miner_schema.h"
+#include "../fixtures/miner_payloads.h"
+#include "../fixtures/counting_allocator.h"
+
+#define BENCH_ITERATIONS  2000
+
+struct ParseCost {
+    size_t peakBytes;
+    size_t allocations;
+    double usPerParse;
+};
+
+// filtered : comme fetch() avec Content-Length, parse direct depuis le flux
+static ParseCost measure(const std::string& payload, bool filtered) {
+    CountingAllocator counter;
+    ParseCost cost = {0, 0, 0};
+    {
+        JsonDocument doc(&counter);
+        std::istringstream stream(payload);
+        DeserializationError error = filtered
+            ? deserializeJson(doc, stream, DeserializationOption::Filter(MinerSchema::infoFilter()))
+            : deserializeJson(doc, stream);
+        TEST_ASSERT_FALSE(error);
+        cost.peakBytes = counter.peak;
+        cost.allocations = counter.allocations;
+    }
+
+    JsonDocument doc;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        std::istringstream stream(payload);
+        if (filtered) {
+            deserializeJson(doc, stream, DeserializationOption::Filter(MinerSchema::infoFilter()));
+        } else {
+            deserializeJson(doc, stream);
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    cost.usPerParse = std::chrono::duration<double, std::micro>(elapsed).count() / BENCH_ITERATIONS;
+    return cost;
+}
+
+static void report(const char* name, const std::string& payload) {
+    ParseCost full = measure(payload, false);
+    ParseCost filtered = measure(payload, true);
+    char message[200];
+    snprintf(message, sizeof(message),
+             "%-16s %5u B payload | full: %6u B peak, %4u allocs, %6.1f us | filtered: %5u B peak, %3u allocs, %6.1f us",
+             name, (unsigned)payload.size(),
+             (unsigned)full.peakBytes, (unsigned)full.allocations, full.usPerParse,
+             (unsigned)filtered.peakBytes, (unsigned)filtered.allocations, filtered.usPerParse);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(filtered.peakBytes <= full.peakBytes);
+}
+
+// Payload AxeOS gonflé d'un historique volumineux, au début comme en fin de
+// réponse : le filtre doit le jeter au fil du flux
+static std::string inflated(size_t samples) {
+    std::string history = "\"bulkHistory\": [";
+    for (size_t i = 0; i < samples; i++) {
+        if (i > 0) history += ",";
+        history += "{\"t\": " + std::to_string(1731000000 + i * 600) + ", \"hashrate\": 1101.42, \"label\": \"sample\"}";
+    }
+    history += "],\n";
+    std::string payload = AXEOS_INFO;
+    payload.insert(payload.find('{') + 1, "\n  " + history);
+    return payload;
+}
+
+void setUp() {
+    Serial.quiet = true;
+}
+void tearDown() {
+    Serial.quiet = false;
+}
+
+static void test_bench_recorded_payloads() {
+    report("AxeOS v2.4", AXEOS_INFO);
+    report("ESP-Miner legacy", LEGACY_INFO);
+    report("mixed", MIXED_INFO);
+}
+
+static void test_filtered_memory_is_independent_of_payload_size() {
+    ParseCost base = measure(AXEOS_INFO, true);
+    std::string big = inflated(400);
+    ParseCost bigCost = measure(big, true);
+    report("AxeOS + 400 rows", big);
+    TEST_ASSERT_TRUE(big.size() > 10 * sizeof(AXEOS_INFO));
+    TEST_ASSERT_EQUAL_UINT32(base.peakBytes, bigCost.peakBytes);
+}
+
+static void test_filtered_stream_still_yields_stats() {
+    std::string big = inflated(400);
+    std::istringstream stream(big);
+    JsonDocument doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, stream, DeserializationOption::Filter(MinerSchema::infoFilter())));
+    BitaxeStats stats;
+    TEST_ASSERT_TRUE(MinerSchema::parse(doc, nullptr, stats, "bench"));
+    TEST_ASSERT_EQUAL_STRING("BM1370", stats.hostname.c_str());
+    TEST_ASSERT_EQUAL_UINT32(18423, stats.shares);
+    TEST_ASSERT_FALSE(doc.containsKey("bulkHistory"));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bench_recorded_payloads);
+    RUN_TEST(test_filtered_memory_is_independent_of_payload_size);
+    RUN_TEST(test_filtered_stream_still_yields_stats);
+    return UNITY_END();
+}
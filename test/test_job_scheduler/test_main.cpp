@@ -0,0 +1,213 @@
+// Planificateur de loop() en temps virtuel : ordre du tas par échéance puis
+// priorité, espacement des trigger(), arrêt d'une passe au-delà de
+// SCHED_PASS_BUDGET_MS et passage à zéro de millis(). Le planificateur est
+// un singleton sans suppression de tâche : les tâches des premiers tests
+// sont réutilisées (désactivées ou relancées par trigger()) pour rester
+// sous SCHED_MAX_JOBS.
+#include <unity.h>
+#include <string>
+#include "job_scheduler.h"
+
+#define IDLE_PERIOD_MS  3600000UL
+
+struct TestJob {
+    char tag;
+    bool active;
+    uint32_t costMs;        // Durée simulée d'une exécution
+    uint32_t returnDelay;   // SCHED_USE_PERIOD ou délai explicite
+    uint32_t runs;
+    uint32_t lastRunAt;
+};
+
+static std::string runLog;
+
+static uint32_t runJob(void* ctx) {
+    TestJob* job = (TestJob*)ctx;
+    if (!job->active) return SCHED_USE_PERIOD;
+    runLog += job->tag;
+    job->runs++;
+    job->lastRunAt = millis();
+    nativeAdvance(job->costMs);
+    return job->returnDelay;
+}
+
+static TestJob orderJobs[4] = {
+    {'A', true, 0, SCHED_USE_PERIOD, 0, 0},
+    {'B', true, 0, SCHED_USE_PERIOD, 0, 0},
+    {'C', true, 0, SCHED_USE_PERIOD, 0, 0},
+    {'D', true, 0, SCHED_USE_PERIOD, 0, 0},
+};
+static int orderIds[4];
+static TestJob spacedJob = {'S', true, 0, SCHED_USE_PERIOD, 0, 0};
+static int spacedId;
+
+static void deactivate(TestJob* jobs, int count) {
+    for (int i = 0; i < count; i++) jobs[i].active = false;
+}
+
+// Avance le temps par pas de 1 ms en appelant runDue() comme loop()
+static void runFor(uint32_t ms) {
+    uint32_t end = millis() + ms;
+    while ((int32_t)(millis() - end) < 0) {
+        JobScheduler::getInstance()->runDue();
+        nativeAdvance(1);
+    }
+}
+
+void setUp() {
+    runLog.clear();
+}
+void tearDown() {}
+
+static void test_runs_in_deadline_order() {
+    JobScheduler* sched = JobScheduler::getInstance();
+    const uint32_t firstDelay[4] = {40, 10, 30, 20};
+    for (int i = 0; i < 4; i++) {
+        char name[8];
+        snprintf(name, sizeof(name), "order%c", orderJobs[i].tag);
+        orderIds[i] = sched->addJob(name, runJob, &orderJobs[i], IDLE_PERIOD_MS, 0, 50, 0, firstDelay[i]);
+        TEST_ASSERT_EQUAL_INT(i, orderIds[i]);
+    }
+    sched->runDue();
+    TEST_ASSERT_EQUAL_STRING("", runLog.c_str());
+
+    // Toutes échues d'un coup : l'ordre reste celui des échéances
+    nativeAdvance(50);
+    sched->runDue();
+    TEST_ASSERT_EQUAL_STRING("BDCA", runLog.c_str());
+    sched->runDue();
+    TEST_ASSERT_EQUAL_STRING("BDCA", runLog.c_str());
+}
+
+static void test_priority_breaks_ties() {
+    static TestJob jobs[3] = {
+        {'x', true, 0, SCHED_USE_PERIOD, 0, 0},
+        {'y', true, 0, SCHED_USE_PERIOD, 0, 0},
+        {'z', true, 0, SCHED_USE_PERIOD, 0, 0},
+    };
+    JobScheduler* sched = JobScheduler::getInstance();
+    sched->addJob("tieX", runJob, &jobs[0], 1000, 2, 50, 0, 100);
+    sched->addJob("tieY", runJob, &jobs[1], 1000, 0, 50, 0, 100);
+    sched->addJob("tieZ", runJob, &jobs[2], 1000, 1, 50, 0, 100);
+    nativeAdvance(100);
+    sched->runDue();
+    TEST_ASSERT_EQUAL_STRING("yzx", runLog.c_str());
+
+    // La période repart du début de chaque exécution : toujours à égalité
+    runLog.clear();
+    runFor(1001);
+    TEST_ASSERT_EQUAL_STRING("yzx", runLog.c_str());
+    deactivate(jobs, 3);
+}
+
+static void test_trigger_respects_min_spacing() {
+    JobScheduler* sched = JobScheduler::getInstance();
+    spacedId = sched->addJob("spaced", runJob, &spacedJob, 60000, 0, 50, 5000, 0);
+    sched->runDue();
+    TEST_ASSERT_EQUAL_UINT32(1, spacedJob.runs);
+    uint32_t firstRun = spacedJob.lastRunAt;
+
+    // Trigger juste après : reporté à lastRun + minSpacing, pas de rafale
+    nativeAdvance(100);
+    sched->trigger(spacedId);
+    sched->trigger(spacedId);
+    runFor(4800);
+    TEST_ASSERT_EQUAL_UINT32(1, spacedJob.runs);
+    runFor(200);
+    TEST_ASSERT_EQUAL_UINT32(2, spacedJob.runs);
+    TEST_ASSERT_EQUAL_UINT32(firstRun + 5000, spacedJob.lastRunAt);
+
+    // Espacement écoulé : exécution au tour suivant
+    nativeAdvance(10000);
+    sched->trigger(spacedId);
+    sched->runDue();
+    TEST_ASSERT_EQUAL_UINT32(3, spacedJob.runs);
+
+    // Identifiants invalides ignorés
+    sched->trigger(-1);
+    sched->trigger(SCHED_MAX_JOBS);
+}
+
+static void test_trigger_never_delays_a_job() {
+    JobScheduler* sched = JobScheduler::getInstance();
+    // La tâche demande à repasser dans 1 s, sous son espacement de 5 s
+    spacedJob.returnDelay = 1000;
+    nativeAdvance(10000);
+    sched->trigger(spacedId);
+    sched->runDue();
+    uint32_t lastRun = spacedJob.lastRunAt;
+    uint32_t before = spacedJob.runs;
+
+    // Un trigger ne la repousse pas à lastRun + 5 s
+    nativeAdvance(100);
+    sched->trigger(spacedId);
+    runFor(901);
+    TEST_ASSERT_EQUAL_UINT32(before + 1, spacedJob.runs);
+    TEST_ASSERT_EQUAL_UINT32(lastRun + 1000, spacedJob.lastRunAt);
+    spacedJob.active = false;
+}
+
+static void test_pass_is_cut_at_budget() {
+    JobScheduler* sched = JobScheduler::getInstance();
+    // Les quatre tâches du premier test, relancées : 12 ms chacune
+    for (int i = 0; i < 4; i++) {
+        orderJobs[i].costMs = 12;
+        sched->trigger(orderIds[i]);
+    }
+    sched->runDue();
+    // 12 ms < 20 : la deuxième part encore ; 24 ms : la passe s'arrête
+    TEST_ASSERT_EQUAL_UINT(2, runLog.size());
+    sched->runDue();
+    TEST_ASSERT_EQUAL_UINT(4, runLog.size());
+    // Chaque tâche exactement une fois (le tas n'ordonne pas les ex aequo)
+    std::sort(runLog.begin(), runLog.end());
+    TEST_ASSERT_EQUAL_STRING("ABCD", runLog.c_str());
+    deactivate(orderJobs, 4);
+}
+
+static void test_returned_delay_overrides_period() {
+    static TestJob job = {'R', true, 3, 250, 0, 0};
+    JobScheduler* sched = JobScheduler::getInstance();
+    sched->addJob("retry", runJob, &job, 10000, 0, 50, 0, 0);
+    runFor(1000);
+    // 0, 250, 500, 750 : mesuré depuis le début de l'exécution, pas de dérive de 3 ms
+    TEST_ASSERT_EQUAL_UINT32(4, job.runs);
+    job.active = false;
+}
+
+static void test_deadlines_survive_millis_wraparound() {
+    static TestJob job = {'W', true, 0, SCHED_USE_PERIOD, 0, 0};
+    JobScheduler* sched = JobScheduler::getInstance();
+    nativeSetMillis(0xFFFFFF00u);
+    int id = sched->addJob("wrap", runJob, &job, 1000, 0, 50, 0, 0x200);
+    TEST_ASSERT_EQUAL_INT(SCHED_MAX_JOBS - 1, id);
+    sched->runDue();
+    TEST_ASSERT_EQUAL_UINT32(0, job.runs);
+    runFor(0x1FF);
+    TEST_ASSERT_EQUAL_UINT32(0, job.runs);
+    runFor(2);
+    TEST_ASSERT_EQUAL_UINT32(1, job.runs);
+    TEST_ASSERT_EQUAL_UINT32(0x100, job.lastRunAt);
+    runFor(1000);
+    TEST_ASSERT_EQUAL_UINT32(2, job.runs);
+}
+
+static void test_table_full() {
+    static TestJob job = {'F', true, 0, SCHED_USE_PERIOD, 0, 0};
+    TEST_ASSERT_EQUAL_INT(-1, JobScheduler::getInstance()->addJob("full", runJob, &job, 1000, 0, 50));
+}
+
+int main(int argc, char** argv) {
+    Serial.quiet = true;
+    nativeSetMillis(1000);
+    UNITY_BEGIN();
+    RUN_TEST(test_runs_in_deadline_order);
+    RUN_TEST(test_priority_breaks_ties);
+    RUN_TEST(test_trigger_respects_min_spacing);
+    RUN_TEST(test_trigger_never_delays_a_job);
+    RUN_TEST(test_pass_is_cut_at_budget);
+    RUN_TEST(test_returned_delay_overrides_period);
+    RUN_TEST(test_deadlines_survive_millis_wraparound);
+    RUN_TEST(test_table_full);
+    return UNITY_END();
+}
@@ -0,0 +1,99 @@
+// JsonArena : blocs pris à la suite dans un tampon fixe, remis à zéro quand
+// le document est vidé, jamais de repli sur le tas.
+#include <unity.h>
+#include "json_arena.h"
+
+static uint8_t buffer[8192];   // Un pool ArduinoJson fait 4 Ko sur un hôte 64 bits
+
+void setUp() {}
+void tearDown() {}
+
+static void test_blocks_are_aligned_and_distinct() {
+    JsonArena arena(buffer + 1, sizeof(buffer) - 1);   // Tampon mal aligné
+    void* a = arena.allocate(3);
+    void* b = arena.allocate(10);
+    TEST_ASSERT_NOT_NULL(a);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_EQUAL_UINT32(0, (uintptr_t)a % JSON_ARENA_ALIGN);
+    TEST_ASSERT_EQUAL_UINT32(0, (uintptr_t)b % JSON_ARENA_ALIGN);
+    TEST_ASSERT_TRUE((uint8_t*)b >= (uint8_t*)a + 3);
+}
+
+static void test_resets_when_everything_is_freed() {
+    JsonArena arena(buffer, sizeof(buffer));
+    void* a = arena.allocate(100);
+    void* b = arena.allocate(100);
+    arena.deallocate(a);
+    TEST_ASSERT_TRUE(arena.used() > 0);
+    arena.deallocate(b);
+    TEST_ASSERT_EQUAL_size_t(0, arena.used());
+    // Même adresse au cycle suivant : le tampon est réutilisé tel quel
+    TEST_ASSERT_EQUAL_PTR(a, arena.allocate(100));
+}
+
+static void test_last_block_grows_and_shrinks_in_place() {
+    JsonArena arena(buffer, sizeof(buffer));
+    arena.allocate(16);
+    char* text = (char*)arena.allocate(8);
+    memcpy(text, "abcdefg", 8);
+    char* grown = (char*)arena.reallocate(text, 64);
+    TEST_ASSERT_EQUAL_PTR(text, grown);
+    TEST_ASSERT_EQUAL_STRING("abcdefg", grown);
+    size_t used = arena.used();
+    TEST_ASSERT_EQUAL_PTR(text, arena.reallocate(grown, 8));
+    TEST_ASSERT_TRUE(arena.used() < used);
+}
+
+static void test_inner_block_moves_with_its_content() {
+    JsonArena arena(buffer, sizeof(buffer));
+    char* first = (char*)arena.allocate(8);
+    memcpy(first, "pool-01", 8);
+    arena.allocate(8);
+    char* moved = (char*)arena.reallocate(first, 32);
+    TEST_ASSERT_NOT_NULL(moved);
+    TEST_ASSERT_TRUE(moved != first);
+    TEST_ASSERT_EQUAL_STRING("pool-01", moved);
+}
+
+static void test_full_arena_fails_without_heap() {
+    JsonArena arena(buffer, 64);
+    TEST_ASSERT_NOT_NULL(arena.allocate(24));
+    TEST_ASSERT_NULL(arena.allocate(64));
+    TEST_ASSERT_EQUAL_UINT32(1, arena.failures());
+    JsonArena empty;
+    TEST_ASSERT_NULL(empty.allocate(1));
+}
+
+static void test_document_reuses_the_arena() {
+    JsonArena arena(buffer, sizeof(buffer));
+    JsonDocument doc(&arena);
+    size_t first = 0;
+    for (int round = 0; round < 20; round++) {
+        TEST_ASSERT_FALSE(deserializeJson(doc, "{\"hostname\":\"bitaxe-gamma\",\"temp\":52.5,\"sharesAccepted\":1234}"));
+        TEST_ASSERT_EQUAL_STRING("bitaxe-gamma", doc["hostname"].as<const char*>());
+        if (round == 0) first = arena.used();
+        TEST_ASSERT_EQUAL_size_t(first, arena.used());
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, arena.failures());
+    doc.clear();
+}
+
+static void test_oversized_document_reports_no_memory() {
+    JsonArena arena(buffer, 64);
+    JsonDocument doc(&arena);
+    DeserializationError error = deserializeJson(doc, "{\"a\":\"0123456789012345678901234567890123456789\",\"b\":[1,2,3,4,5,6,7,8]}");
+    TEST_ASSERT_TRUE(error == DeserializationError::NoMemory);
+    TEST_ASSERT_TRUE(arena.failures() > 0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_blocks_are_aligned_and_distinct);
+    RUN_TEST(test_resets_when_everything_is_freed);
+    RUN_TEST(test_last_block_grows_and_shrinks_in_place);
+    RUN_TEST(test_inner_block_moves_with_its_content);
+    RUN_TEST(test_full_arena_fails_without_heap);
+    RUN_TEST(test_document_reuses_the_arena);
+    RUN_TEST(test_oversized_document_reports_no_memory);
+    return UNITY_END();
+}
@@ -0,0 +1,168 @@
+// Lecteur incrémental des messages mempool.space (JsonKeyScanner) : capture
+// des clés de premier niveau, chaînes et échappements, débordement, et
+// débit sur un message initial de plus de 20 Ko.
+#include <unity.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "json_key_scanner.h"
+#include "block_decoder.h"
+#include "../fixtures/mempool_payloads.h"
+
+#define SCAN_ITERATIONS  200
+
+static const char* const KEYS[] = { "block", "mempool-blocks", "fees" };
+static char buffer[4096];
+
+struct Capture {
+    int key;
+    std::string value;
+};
+
+static std::vector<Capture> scan(JsonKeyScanner& scanner, const std::string& message) {
+    std::vector<Capture> captures;
+    scanner.reset();
+    for (char c : message) {
+        int key = scanner.feed(c);
+        if (key >= 0) {
+            TEST_ASSERT_FALSE(scanner.overflowed());
+            TEST_ASSERT_EQUAL_UINT(strlen(buffer), scanner.valueLen());
+            captures.push_back({key, std::string(buffer, scanner.valueLen())});
+        }
+    }
+    return captures;
+}
+
+static std::string replaceAll(std::string text, const std::string& from, const std::string& to) {
+    for (size_t pos = 0; (pos = text.find(from, pos)) != std::string::npos; pos += to.size()) {
+        text.replace(pos, from.size(), to);
+    }
+    return text;
+}
+
+static std::string block(uint32_t height) {
+    return replaceAll(replaceAll(MEMPOOL_BLOCK, "{index}", "00"), "{height}", std::to_string(height));
+}
+
+void setUp() {
+    memset(buffer, 0, sizeof(buffer));
+}
+void tearDown() {}
+
+static void test_captures_wanted_top_level_values() {
+    JsonKeyScanner scanner(KEYS, 3, buffer, sizeof(buffer));
+    std::vector<Capture> captures = scan(scanner,
+        R"({"mempoolInfo":{"size":1234,"fees":{"x":1}},"fees":{"fastestFee":12,"minimumFee":1},"vBytesPerSecond":1520,"block":{"height":850124,"extras":{"pool":{"name":"OCEAN"}}}})");
+    TEST_ASSERT_EQUAL_UINT(2, captures.size());
+    // "fees" imbriqué dans mempoolInfo n'est pas capturé
+    TEST_ASSERT_EQUAL_INT(2, captures[0].key);
+    TEST_ASSERT_EQUAL_STRING(R"({"fastestFee":12,"minimumFee":1})", captures[0].value.c_str());
+    TEST_ASSERT_EQUAL_INT(0, captures[1].key);
+    TEST_ASSERT_EQUAL_STRING(R"({"height":850124,"extras":{"pool":{"name":"OCEAN"}}})", captures[1].value.c_str());
+}
+
+static void test_strings_and_escapes_do_not_confuse_depth() {
+    JsonKeyScanner scanner(KEYS, 3, buffer, sizeof(buffer));
+    std::vector<Capture> captures = scan(scanner,
+        R"({"note":"} ] { \"block\": [","block":{"pool":"a\"}b\\","tag":"[{"},"mempool-blocks":[{"nTx":1},{"nTx":2}]})");
+    TEST_ASSERT_EQUAL_UINT(2, captures.size());
+    TEST_ASSERT_EQUAL_STRING(R"({"pool":"a\"}b\\","tag":"[{"})", captures[0].value.c_str());
+    TEST_ASSERT_EQUAL_INT(1, captures[1].key);
+    TEST_ASSERT_EQUAL_STRING(R"([{"nTx":1},{"nTx":2}])", captures[1].value.c_str());
+}
+
+static void test_scalar_and_unknown_keys_are_skipped() {
+    JsonKeyScanner scanner(KEYS, 3, buffer, sizeof(buffer));
+    // Valeur scalaire, clé trop longue (tronquée) et clé au préfixe identique
+    std::vector<Capture> captures = scan(scanner,
+        R"({"fees":3,"mempool-blocks-and-more":[1],"blocks":[{"height":1}],"block":null,"fees":{"minimumFee":2}})");
+    TEST_ASSERT_EQUAL_UINT(1, captures.size());
+    TEST_ASSERT_EQUAL_INT(2, captures[0].key);
+    TEST_ASSERT_EQUAL_STRING(R"({"minimumFee":2})", captures[0].value.c_str());
+
+    // Pas un objet au premier niveau : rien
+    TEST_ASSERT_EQUAL_UINT(0, scan(scanner, R"([{"block":{"height":1}}])").size());
+}
+
+static void test_overflow_is_flagged_then_recovers() {
+    char small[32];
+    JsonKeyScanner scanner(KEYS, 3, small, sizeof(small));
+    scanner.reset();
+    std::string message = R"({"block":{"id":"0000000000000000000000000000000000000000"},"fees":{"minimumFee":1}})";
+    int overflowed = -1;
+    int fees = -1;
+    for (char c : message) {
+        int key = scanner.feed(c);
+        if (key == 0) {
+            overflowed = scanner.overflowed() ? 1 : 0;
+        } else if (key == 2) {
+            fees = scanner.overflowed() ? 1 : 0;
+            TEST_ASSERT_EQUAL_STRING(R"({"minimumFee":1})", small);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(1, overflowed);
+    // La valeur suivante du même message est lue normalement
+    TEST_ASSERT_EQUAL_INT(0, fees);
+}
+
+static void test_reset_between_messages() {
+    JsonKeyScanner scanner(KEYS, 3, buffer, sizeof(buffer));
+    // Message coupé au milieu d'une chaîne (connexion perdue)
+    scan(scanner, R"({"block":{"id":"abc)");
+    std::vector<Capture> captures = scan(scanner, R"({"fees":{"minimumFee":4}})");
+    TEST_ASSERT_EQUAL_UINT(1, captures.size());
+    TEST_ASSERT_EQUAL_STRING(R"({"minimumFee":4})", captures[0].value.c_str());
+}
+
+static void test_initial_message_throughput() {
+    // Premier message après "want" : 15 blocs (ignorés), blocs projetés et fees
+    std::string message = "{\"blocks\":[";
+    for (int i = 0; i < 15; i++) {
+        message += block(850123 - i);
+        if (i < 14) message += ",";
+    }
+    message += "],\"mempool-blocks\":";
+    message += MEMPOOL_PROJECTED;
+    message += ",\"fees\":{\"fastestFee\":9,\"halfHourFee\":7,\"hourFee\":6,\"economyFee\":4,\"minimumFee\":3},\"block\":";
+    message += block(850124);
+    message += "}";
+
+    JsonKeyScanner scanner(KEYS, 3, buffer, sizeof(buffer));
+    std::vector<Capture> captures = scan(scanner, message);
+    TEST_ASSERT_EQUAL_UINT(3, captures.size());
+
+    // Les captures se décodent comme les réponses REST
+    JsonDocument doc;
+    TEST_ASSERT_FALSE(deserializeJson(doc, captures[2].value, DeserializationOption::Filter(BlockDecoder::blockFilter())));
+    BlockInfo tip;
+    BlockDecoder::decodeBlock(doc.as<JsonVariantConst>(), tip);
+    TEST_ASSERT_EQUAL_UINT32(850124, tip.height);
+
+    auto start = std::chrono::steady_clock::now();
+    size_t found = 0;
+    for (int i = 0; i < SCAN_ITERATIONS; i++) {
+        scanner.reset();
+        for (char c : message) {
+            if (scanner.feed(c) >= 0) found++;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_EQUAL_UINT(3 * SCAN_ITERATIONS, found);
+
+    char text[160];
+    snprintf(text, sizeof(text), "initial message %u bytes: %.1f MB/s scanned, %u B captured at most (buffer %u B)",
+             (unsigned)message.size(), message.size() * SCAN_ITERATIONS / seconds / 1e6,
+             (unsigned)captures[2].value.size(), (unsigned)sizeof(buffer));
+    TEST_MESSAGE(text);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_captures_wanted_top_level_values);
+    RUN_TEST(test_strings_and_escapes_do_not_confuse_depth);
+    RUN_TEST(test_scalar_and_unknown_keys_are_skipped);
+    RUN_TEST(test_overflow_is_flagged_then_recovers);
+    RUN_TEST(test_reset_between_messages);
+    RUN_TEST(test_initial_message_throughput);
+    return UNITY_END();
+}
@@ -0,0 +1,200 @@
+// Détection du schéma de firmware et plan d'extraction (MinerSchema), plus
+// le coût par poll avec et sans plan mémorisé.
+#include <unity.h>
+#include <chrono>
+#include "miner_schema.h"
+#include "../fixtures/miner_payloads.h"
+
+#define BENCH_ITERATIONS  20000
+
+// Document tel que fetch() le produit : filtré
+static void load(JsonDocument& doc, const char* payload) {
+    DeserializationError error = deserializeJson(doc, payload, DeserializationOption::Filter(MinerSchema::infoFilter()));
+    TEST_ASSERT_FALSE(error);
+}
+
+void setUp() {
+    Serial.quiet = true;
+}
+void tearDown() {
+    Serial.quiet = false;
+}
+
+static void test_detects_axeos() {
+    JsonDocument doc;
+    load(doc, AXEOS_INFO);
+    BitaxeFieldMap plan;
+    BitaxeStats stats;
+    TEST_ASSERT_TRUE(MinerSchema::parse(doc, &plan, stats, "axeos"));
+
+    TEST_ASSERT_TRUE(plan.resolved);
+    TEST_ASSERT_EQUAL_STRING("AxeOS", plan.schemaName);
+    TEST_ASSERT_EQUAL_STRING("hashRate", plan.hashrate);
+    TEST_ASSERT_FALSE(plan.hashrateInHs);
+    TEST_ASSERT_EQUAL_STRING("bestDiff", plan.bestDiff);
+    TEST_ASSERT_TRUE(plan.bestDiffIsString);
+    TEST_ASSERT_EQUAL_STRING("sharesAccepted", plan.shares);
+    TEST_ASSERT_FALSE(plan.powerFromVoltageCurrent);
+
+    TEST_ASSERT_TRUE(stats.valid);
+    TEST_ASSERT_EQUAL_STRING("BM1370", stats.hostname.c_str());  // ASICModel passe avant hostname
+    TEST_ASSERT_EQUAL_STRING("v2.4.2", stats.version.c_str());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 57.25f, stats.temp);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1108.82f, stats.hashrate);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 15.47f, stats.power);
+    TEST_ASSERT_UINT32_WITHIN(1000, 4290000000u, stats.bestDiff);
+    TEST_ASSERT_EQUAL_UINT32(18423, stats.shares);
+    TEST_ASSERT_EQUAL_STRING("public-pool.io", stats.poolUrl.c_str());
+    TEST_ASSERT_EQUAL_UINT32(864311, stats.uptimeSeconds);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 15.468751f / 1108.8193f * 1000.0f, stats.efficiency);
+    TEST_ASSERT_TRUE(stats.poolConnected);
+}
+
+static void test_detects_legacy_esp_miner() {
+    JsonDocument doc;
+    load(doc, LEGACY_INFO);
+    BitaxeFieldMap plan;
+    BitaxeStats stats;
+    TEST_ASSERT_TRUE(MinerSchema::parse(doc, &plan, stats, "legacy"));
+
+    TEST_ASSERT_EQUAL_STRING("ESP-Miner (legacy)", plan.schemaName);
+    TEST_ASSERT_TRUE(plan.hashrateInHs);
+    TEST_ASSERT_TRUE(plan.powerFromVoltageCurrent);
+    TEST_ASSERT_FALSE(plan.bestDiffIsString);
+
+    TEST_ASSERT_EQUAL_STRING("esp-miner-07", stats.hostname.c_str());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 48.5f, stats.temp);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 487.0f, stats.hashrate);      // H/s -> GH/s
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 5.02f * 1.9f, stats.power);    // voltage x current
+    TEST_ASSERT_EQUAL_UINT32(912445120, stats.bestDiff);
+    TEST_ASSERT_EQUAL_UINT32(5120, stats.shares);
+    TEST_ASSERT_EQUAL_STRING("solo.ckpool.org:3333", stats.poolUrl.c_str());
+    TEST_ASSERT_EQUAL_UINT32(43210, stats.uptimeSeconds);
+}
+
+static void test_detects_mixed_variant() {
+    JsonDocument doc;
+    load(doc, MIXED_INFO);
+    BitaxeFieldMap plan;
+    BitaxeStats stats;
+    TEST_ASSERT_TRUE(MinerSchema::parse(doc, &plan, stats, "mixed"));
+
+    TEST_ASSERT_EQUAL_STRING("mixed", plan.schemaName);
+    TEST_ASSERT_EQUAL_STRING("bestSessionDiff", plan.bestDiff);
+    TEST_ASSERT_EQUAL_STRING("accepted", plan.shares);
+    TEST_ASSERT_EQUAL_UINT32(18500000, stats.bestDiff);
+    TEST_ASSERT_EQUAL_UINT32(774, stats.shares);
+}
+
+static void test_missing_fields_take_defaults() {
+    JsonDocument doc;
+    load(doc, "{\"hashRate\": 500.5, \"power\": 10}");
+    BitaxeFieldMap plan;
+    BitaxeStats stats;
+    TEST_ASSERT_TRUE(MinerSchema::parse(doc, &plan, stats, "bare"));
+
+    TEST_ASSERT_NULL(plan.hostname);
+    TEST_ASSERT_NULL(plan.bestDiff);
+    TEST_ASSERT_EQUAL_STRING("Bitaxe", stats.hostname.c_str());
+    TEST_ASSERT_EQUAL_STRING("Unknown", stats.version.c_str());
+    TEST_ASSERT_EQUAL_UINT32(0, stats.bestDiff);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.shares);
+}
+
+static void test_resolved_plan_is_reused() {
+    JsonDocument doc;
+    load(doc, AXEOS_INFO);
+    BitaxeFieldMap plan;
+    BitaxeStats stats;
+    TEST_ASSERT_TRUE(MinerSchema::parse(doc, &plan, stats, "axeos"));
+
+    // Plan déjà résolu : extract() seul suffit, sans nouvelle détection
+    const char* hashrateKey = plan.hashrate;
+    doc["hashRate"] = 900.0f;
+    TEST_ASSERT_TRUE(MinerSchema::extract(doc, plan, stats));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 900.0f, stats.hashrate);
+    TEST_ASSERT_EQUAL_PTR(hashrateKey, plan.hashrate);
+}
+
+static void test_missing_expected_field_triggers_redetection() {
+    JsonDocument doc;
+    load(doc, AXEOS_INFO);
+    BitaxeFieldMap plan;
+    BitaxeStats stats;
+    TEST_ASSERT_TRUE(MinerSchema::parse(doc, &plan, stats, "swap"));
+
+    // Le mineur a été reflashé avec l'ancien firmware : hashRate disparaît
+    JsonDocument legacy;
+    load(legacy, LEGACY_INFO);
+    TEST_ASSERT_FALSE(MinerSchema::extract(legacy, plan, stats));
+    TEST_ASSERT_TRUE(MinerSchema::parse(legacy, &plan, stats, "swap"));
+    TEST_ASSERT_EQUAL_STRING("ESP-Miner (legacy)", plan.schemaName);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 487.0f, stats.hashrate);
+}
+
+static void test_best_diff_format_change_triggers_redetection() {
+    JsonDocument doc;
+    load(doc, AXEOS_INFO);
+    BitaxeFieldMap plan;
+    BitaxeStats stats;
+    TEST_ASSERT_TRUE(MinerSchema::parse(doc, &plan, stats, "format"));
+    TEST_ASSERT_TRUE(plan.bestDiffIsString);
+
+    // Même clé, mais nombre brut : le plan ne correspond plus
+    doc["bestDiff"] = 123456;
+    TEST_ASSERT_FALSE(MinerSchema::extract(doc, plan, stats));
+    TEST_ASSERT_TRUE(MinerSchema::parse(doc, &plan, stats, "format"));
+    TEST_ASSERT_FALSE(plan.bestDiffIsString);
+    TEST_ASSERT_EQUAL_UINT32(123456, stats.bestDiff);
+}
+
+static void test_parse_diff_units() {
+    TEST_ASSERT_EQUAL_UINT32(0, MinerSchema::parseDiff(nullptr));
+    TEST_ASSERT_EQUAL_UINT32(0, MinerSchema::parseDiff("n/a"));
+    TEST_ASSERT_EQUAL_UINT32(1500, MinerSchema::parseDiff("1500"));
+    TEST_ASSERT_EQUAL_UINT32(12000, MinerSchema::parseDiff("12k"));
+    TEST_ASSERT_UINT32_WITHIN(100, 997300000u, MinerSchema::parseDiff("997.30 M"));
+    TEST_ASSERT_UINT32_WITHIN(1000, 4290000000u, MinerSchema::parseDiff("4.29G"));
+}
+
+// Coût par poll : ancienne méthode (toutes les variantes sondées à chaque
+// fois) contre lectures directes avec le plan mémorisé
+static void test_bench_detect_vs_cached_plan() {
+    JsonDocument doc;
+    load(doc, AXEOS_INFO);
+    BitaxeStats stats;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        MinerSchema::parse(doc, nullptr, stats, "bench");
+    }
+    double detectUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / BENCH_ITERATIONS;
+
+    BitaxeFieldMap plan;
+    MinerSchema::parse(doc, &plan, stats, "bench");
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+        MinerSchema::parse(doc, &plan, stats, "bench");
+    }
+    double cachedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / BENCH_ITERATIONS;
+
+    char message[128];
+    snprintf(message, sizeof(message), "per poll: detect + extract %.3f us, cached plan %.3f us (x%.1f)",
+             detectUs, cachedUs, cachedUs > 0 ? detectUs / cachedUs : 0.0);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(stats.valid);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_detects_axeos);
+    RUN_TEST(test_detects_legacy_esp_miner);
+    RUN_TEST(test_detects_mixed_variant);
+    RUN_TEST(test_missing_fields_take_defaults);
+    RUN_TEST(test_resolved_plan_is_reused);
+    RUN_TEST(test_missing_expected_field_triggers_redetection);
+    RUN_TEST(test_best_diff_format_change_triggers_redetection);
+    RUN_TEST(test_parse_diff_units);
+    RUN_TEST(test_bench_detect_vs_cached_plan);
+    return UNITY_END();
+}
@@ -0,0 +1,83 @@
+// Budget global et intervalles du MinerPoller. Les passes sur la flotte
+// sont testées avec le PollScheduler (test_poll_scheduler).
+#include <unity.h>
+#include "poll_pacer.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void test_bucket_starts_full_and_drains() {
+    PollPacer pacer;
+    pacer.begin(4, 0);
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(pacer.take());
+    }
+    TEST_ASSERT_FALSE(pacer.take());
+}
+
+static void test_bucket_refills_at_budget_rate() {
+    PollPacer pacer;
+    pacer.begin(4, 1000);
+    while (pacer.take()) {}
+    // POLL_MAX_RPS = 4 : un jeton toutes les 250 ms
+    pacer.refill(1000 + 1000 / POLL_MAX_RPS);
+    TEST_ASSERT_TRUE(pacer.take());
+    TEST_ASSERT_FALSE(pacer.take());
+}
+
+static void test_bucket_caps_burst() {
+    PollPacer pacer;
+    pacer.begin(3, 0);
+    pacer.refill(60000);
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, pacer.available());
+}
+
+static void test_bucket_survives_millis_wrap() {
+    PollPacer pacer;
+    pacer.begin(2, 0xFFFFFF00u);
+    while (pacer.take()) {}
+    pacer.refill(0x00000100u);  // 512 ms plus tard
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, pacer.available());
+}
+
+static void test_normal_interval_stretches_with_fleet() {
+    TEST_ASSERT_EQUAL_UINT32(POLL_INTERVAL_MS, PollPacer::normalInterval(0));
+    TEST_ASSERT_EQUAL_UINT32(POLL_INTERVAL_MS, PollPacer::normalInterval(10));
+    // 200 mineurs à 3 req/s (75 % de 4) : un tour toutes les 66 s
+    TEST_ASSERT_EQUAL_UINT32(66666, PollPacer::normalInterval(200));
+}
+
+static void test_backoff_doubles_then_caps() {
+    TEST_ASSERT_EQUAL_UINT32(30000, PollPacer::backoffInterval(30000, 0));
+    TEST_ASSERT_EQUAL_UINT32(30000, PollPacer::backoffInterval(30000, 1));
+    TEST_ASSERT_EQUAL_UINT32(60000, PollPacer::backoffInterval(30000, 2));
+    TEST_ASSERT_EQUAL_UINT32(240000, PollPacer::backoffInterval(30000, 4));
+    TEST_ASSERT_EQUAL_UINT32(POLL_BACKOFF_MAX_MS, PollPacer::backoffInterval(30000, 5));
+    TEST_ASSERT_EQUAL_UINT32(POLL_BACKOFF_MAX_MS, PollPacer::backoffInterval(30000, 255));
+}
+
+static void test_jitter_stays_in_range() {
+    uint32_t low = POLL_INTERVAL_MS - POLL_INTERVAL_MS * POLL_JITTER_PERCENT / 100;
+    uint32_t high = POLL_INTERVAL_MS + POLL_INTERVAL_MS * POLL_JITTER_PERCENT / 100;
+    bool below = false;
+    bool above = false;
+    for (int i = 0; i < 1000; i++) {
+        uint32_t interval = PollPacer::withJitter(POLL_INTERVAL_MS);
+        TEST_ASSERT_TRUE(interval >= low && interval <= high);
+        below |= interval < POLL_INTERVAL_MS;
+        above |= interval > POLL_INTERVAL_MS;
+    }
+    TEST_ASSERT_TRUE(below && above);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_bucket_starts_full_and_drains);
+    RUN_TEST(test_bucket_refills_at_budget_rate);
+    RUN_TEST(test_bucket_caps_burst);
+    RUN_TEST(test_bucket_survives_millis_wrap);
+    RUN_TEST(test_normal_interval_stretches_with_fleet);
+    RUN_TEST(test_backoff_doubles_then_caps);
+    RUN_TEST(test_jitter_stays_in_range);
+    return UNITY_END();
+}
@@ -0,0 +1,229 @@
+// PollScheduler (planification du MinerPoller) piloté par un faux transport
+// en temps virtuel : même boucle que les tâches du poller, un réveil au tick
+// ou à la fin d'une requête, puis dispatchDue(). Les faux mineurs répondent
+// après leur latence, ou au bout d'un timeout complet s'ils sont éteints.
+#include <unity.h>
+#include "poll_scheduler.h"
+
+#define SIM_TIMEOUT_MS    2000   // Ancien timeout de BitaxeAPI::makeRequest()
+#define SIM_LIVE_MS       60     // Réponse d'un mineur sur le LAN
+#define SIM_MINERS        10
+
+struct MockMiner {
+    bool online;
+    bool busy;
+    uint32_t startedAt;
+    uint32_t finishAt;
+    uint32_t polls;
+};
+
+class MockFleet {
+public:
+    PollScheduler scheduler;
+    MinerSchedule slots[SIM_MINERS];
+    MockMiner miners[SIM_MINERS];
+    int count;
+    uint32_t now;
+    uint32_t launches;
+
+    void begin(int total, int offline, uint8_t inFlight) {
+        count = total;
+        now = 1000;
+        launches = 0;
+        scheduler.begin(slots, SIM_MINERS, inFlight, now);
+        for (int i = 0; i < count; i++) {
+            miners[i] = {i < total - offline, false, 0, 0, 0};
+            char ip[16];
+            snprintf(ip, sizeof(ip), "10.0.0.%d", i + 1);
+            scheduler.add(i + 1, ip, now);
+        }
+        scheduler.updateNormalInterval();
+    }
+
+    // Un tour de pollerTaskEntry() : fins de requête (workers) puis dispatch
+    void step(bool pollAll) {
+        for (int slot = 0; slot < SIM_MINERS; slot++) {
+            const MinerSchedule& entry = scheduler.at(slot);
+            if (entry.id == MINER_ID_NONE) continue;
+            MockMiner& miner = miners[entry.id - 1];
+            if (!miner.busy || (int32_t)(now - miner.finishAt) < 0) continue;
+            miner.busy = false;
+            miner.polls++;
+            PollOutcome outcome = {};
+            outcome.success = miner.online;
+            outcome.hashrate = miner.online ? 1200.0f : 0.0f;
+            outcome.temp = miner.online ? 55.0f : 0.0f;
+            outcome.latencyMs = now - miner.startedAt;
+            scheduler.complete(slot, outcome, now);
+        }
+
+        if (!pollAll && !scheduler.hasDue(now)) return;
+        int launch[POLLER_MAX_IN_FLIGHT];
+        int launched = scheduler.dispatchDue(now, pollAll, launch, POLLER_MAX_IN_FLIGHT);
+        for (int i = 0; i < launched; i++) {
+            MockMiner& miner = miners[scheduler.at(launch[i]).id - 1];
+            miner.busy = true;
+            miner.startedAt = now;
+            miner.finishAt = now + (miner.online ? SIM_LIVE_MS : SIM_TIMEOUT_MS);
+            launches++;
+        }
+    }
+
+    // Prochain réveil : tick ou première fin de requête (xTaskNotifyGive du worker)
+    void advance() {
+        uint32_t wake = now + POLLER_TICK_MS;
+        for (int i = 0; i < count; i++) {
+            if (miners[i].busy && (int32_t)(miners[i].finishAt - wake) < 0) wake = miners[i].finishAt;
+        }
+        now = wake;
+    }
+
+    // Bouton refresh : durée jusqu'à ce que chaque mineur ait répondu une fois
+    uint32_t pass() {
+        uint32_t start = now;
+        uint32_t before[SIM_MINERS];
+        for (int i = 0; i < count; i++) before[i] = miners[i].polls;
+        bool pollAll = true;
+        for (;;) {
+            step(pollAll);
+            pollAll = false;
+            bool done = true;
+            for (int i = 0; i < count; i++) done &= miners[i].polls > before[i];
+            if (done) return now - start;
+            advance();
+        }
+    }
+
+    void runFor(uint32_t ms) {
+        uint32_t end = now + ms;
+        while ((int32_t)(now - end) < 0) {
+            step(false);
+            advance();
+        }
+    }
+};
+
+static MockFleet fleet;
+
+void setUp() {
+    randomSeed(7);
+}
+void tearDown() {}
+
+static void test_unreachable_pass_costs_one_timeout() {
+    fleet.begin(SIM_MINERS, SIM_MINERS, 1);
+    uint32_t sequential = fleet.pass();
+    fleet.begin(SIM_MINERS, SIM_MINERS, 4);
+    uint32_t four = fleet.pass();
+    fleet.begin(SIM_MINERS, SIM_MINERS, POLLER_DEFAULT_IN_FLIGHT);
+    uint32_t device = fleet.pass();
+
+    char message[160];
+    snprintf(message, sizeof(message), "%d unreachable miners x %d ms: 1 in flight %u ms, 4 in flight %u ms, default (%d) %u ms",
+             SIM_MINERS, SIM_TIMEOUT_MS, sequential, four, POLLER_DEFAULT_IN_FLIGHT, device);
+    TEST_MESSAGE(message);
+
+    TEST_ASSERT_EQUAL_UINT32(SIM_MINERS * SIM_TIMEOUT_MS, sequential);
+    TEST_ASSERT_EQUAL_UINT32(3 * SIM_TIMEOUT_MS, four);
+    // Réglage de l'appareil : toute la flotte part d'un coup, un seul timeout
+    TEST_ASSERT_EQUAL_UINT32(SIM_TIMEOUT_MS, device);
+}
+
+static void test_live_miners_do_not_wait_for_dead_ones() {
+    fleet.begin(SIM_MINERS, 3, POLLER_DEFAULT_IN_FLIGHT);
+    uint32_t pass = fleet.pass();
+    TEST_ASSERT_EQUAL_UINT32(SIM_TIMEOUT_MS, pass);
+    for (int i = 0; i < SIM_MINERS - 3; i++) {
+        // Réponses publiées à leur latence, pas à la fin de la passe
+        TEST_ASSERT_EQUAL_UINT32(SIM_LIVE_MS, fleet.scheduler.at(i).busyMs);
+    }
+    TEST_ASSERT_EQUAL_UINT8(0, fleet.scheduler.getInFlight());
+}
+
+static void test_budget_limits_refills_after_burst() {
+    fleet.begin(SIM_MINERS, 0, POLLER_DEFAULT_IN_FLIGHT);
+    fleet.pass();
+    // Seau vidé par la rafale : le pass suivant est rythmé par POLL_MAX_RPS,
+    // au tick près
+    uint32_t second = fleet.pass();
+    char message[64];
+    snprintf(message, sizeof(message), "second pass right after a burst: %u ms", second);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(second >= (SIM_MINERS - 1) * 1000 / POLL_MAX_RPS);
+    TEST_ASSERT_TRUE(second <= SIM_MINERS * 1000 / POLL_MAX_RPS + POLLER_TICK_MS + SIM_LIVE_MS);
+}
+
+static void test_unreachable_miners_back_off() {
+    fleet.begin(SIM_MINERS, 2, POLLER_DEFAULT_IN_FLIGHT);
+    fleet.runFor(30UL * 60 * 1000);
+    uint32_t livePolls = fleet.miners[0].polls;
+    uint32_t deadPolls = fleet.miners[SIM_MINERS - 1].polls;
+    // 30 s de cadence normale (±20 %) contre 30 s, 60 s... plafonné à 5 min
+    TEST_ASSERT_TRUE(livePolls >= 50);
+    TEST_ASSERT_TRUE(deadPolls <= 12);
+    TEST_ASSERT_TRUE(fleet.scheduler.at(SIM_MINERS - 1).interval >= POLL_BACKOFF_MAX_MS * (100 - POLL_JITTER_PERCENT) / 100);
+}
+
+static void test_idle_ticks_skip_the_fleet() {
+    fleet.begin(SIM_MINERS, 0, POLLER_DEFAULT_IN_FLIGHT);
+    fleet.pass();
+    fleet.runFor(2000);
+    // Prochaine échéance dans ~30 s : hasDue() suffit, dispatchDue() n'est pas appelé
+    TEST_ASSERT_FALSE(fleet.scheduler.hasDue(fleet.now));
+    fleet.scheduler.requestPoll(3, fleet.now);
+    TEST_ASSERT_TRUE(fleet.scheduler.hasDue(fleet.now));
+    uint32_t before = fleet.launches;
+    fleet.step(false);
+    TEST_ASSERT_EQUAL_UINT32(before + 1, fleet.launches);
+    TEST_ASSERT_TRUE(fleet.miners[2].busy);
+}
+
+static void test_removed_miner_is_freed_after_its_request() {
+    fleet.begin(SIM_MINERS, 0, POLLER_DEFAULT_IN_FLIGHT);
+    fleet.step(true);
+    int slot = fleet.scheduler.find(4);
+    TEST_ASSERT_TRUE(fleet.scheduler.at(slot).inFlight);
+    fleet.scheduler.remove(slot);
+    TEST_ASSERT_EQUAL_INT(-1, fleet.scheduler.find(4));
+    TEST_ASSERT_EQUAL_UINT16(4, fleet.scheduler.at(slot).id);   // Encore tenu par le worker
+    fleet.runFor(SIM_LIVE_MS + 1);
+    TEST_ASSERT_EQUAL_UINT16(MINER_ID_NONE, fleet.scheduler.at(slot).id);
+}
+
+static void test_cycle_time_is_recorded() {
+    // Refresh : le cycle couvre toute la passe, mineurs éteints compris
+    fleet.begin(SIM_MINERS, 2, POLLER_DEFAULT_IN_FLIGHT);
+    uint32_t pass = fleet.pass();
+    TEST_ASSERT_EQUAL_UINT32(pass, fleet.scheduler.getLastCycle());
+
+    // En régime normal, les mineurs en backoff ne rallongent pas le cycle :
+    // une cadence normale (±20 %) et le retard au tick près
+    fleet.runFor(10UL * 60 * 1000);
+    char message[96];
+    snprintf(message, sizeof(message), "steady cycle: %u ms last, %u ms avg over %u cycle(s)",
+             fleet.scheduler.getLastCycle(), fleet.scheduler.getAvgCycle(), fleet.scheduler.getCycles());
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(fleet.scheduler.getCycles() >= 10);
+    uint32_t normal = fleet.scheduler.getNormalInterval();
+    TEST_ASSERT_TRUE(fleet.scheduler.getAvgCycle() <= normal * (100 + POLL_JITTER_PERCENT) / 100 + POLLER_TICK_MS + SIM_LIVE_MS);
+    TEST_ASSERT_TRUE(fleet.scheduler.getLastCycle() < POLL_BACKOFF_MAX_MS);
+
+    // Mineur retiré avant sa réponse : le cycle se ferme sans lui
+    uint32_t before = fleet.scheduler.getCycles();
+    fleet.scheduler.requestPoll(1, fleet.now);
+    for (int id = 2; id <= SIM_MINERS; id++) fleet.scheduler.remove(fleet.scheduler.find(id));
+    fleet.runFor(SIM_LIVE_MS + POLLER_TICK_MS);
+    TEST_ASSERT_TRUE(fleet.scheduler.getCycles() > before);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_unreachable_pass_costs_one_timeout);
+    RUN_TEST(test_live_miners_do_not_wait_for_dead_ones);
+    RUN_TEST(test_budget_limits_refills_after_burst);
+    RUN_TEST(test_unreachable_miners_back_off);
+    RUN_TEST(test_idle_ticks_skip_the_fleet);
+    RUN_TEST(test_removed_miner_is_freed_after_its_request);
+    RUN_TEST(test_cycle_time_is_recorded);
+    return UNITY_END();
+}
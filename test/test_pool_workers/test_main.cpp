@@ -0,0 +1,134 @@
+// Réponses de pool (ckpool, public-pool) : format, association des workers
+// aux mineurs par poolUser et nombres à suffixe SI.
+#include <unity.h>
+#include "pool_workers.h"
+
+static const char* CKPOOL_USERS = R"({
+  "hashrate1m": "2.41T", "hashrate5m": "2.38T", "lastshare": 1719000000,
+  "workers": 3, "shares": 123456, "bestshare": 98765432.1, "bestever": 123456789,
+  "worker": [
+    {"workername": "bc1qmockaddress.mock00", "hashrate1m": "1.21T", "hashrate5m": "1.2T", "lastshare": 1719000000, "shares": 4567, "bestshare": 12345678.9, "bestever": 23456789},
+    {"workername": "bc1qmockaddress.mock01", "hashrate1m": "1.2T", "hashrate5m": "1.19T", "lastshare": 1719000000, "shares": 4321, "bestshare": 9876543210.5, "bestever": 9876543210},
+    {"workername": "bc1qmockaddress.mock02", "hashrate1m": "0", "hashrate5m": "512G", "lastshare": 1718990000, "shares": 12, "bestshare": 1234.5, "bestever": 5678}
+  ]
+})";
+
+static const char* PUBLIC_POOL_CLIENT = R"({
+  "bestDifficulty": "98765432.10", "workersCount": 2,
+  "workers": [
+    {"sessionId": "a1b2", "name": "mock00", "bestDifficulty": "12345678.90", "hashRate": 1210000000000, "startTime": "2024-06-21T10:00:00.000Z", "lastSeen": "2024-06-21T12:00:00.000Z"},
+    {"sessionId": "c3d4", "name": "mock01", "bestDifficulty": "2.5M", "hashRate": "1.2 T", "startTime": "2024-06-21T10:00:00.000Z", "lastSeen": "2024-06-21T12:00:00.000Z"}
+  ]
+})";
+
+static void load(JsonDocument& doc, const char* payload) {
+    DeserializationError error = deserializeJson(doc, payload, DeserializationOption::Filter(PoolWorkers::filter()));
+    TEST_ASSERT_FALSE(error);
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_parse_scaled() {
+    JsonDocument doc;
+    deserializeJson(doc, R"(["1.21T", "345.6 G", "12k", "7", 42.5, "2P", "1.5E", "0"])");
+    TEST_ASSERT_FLOAT_WITHIN(1e6, 1.21e12, PoolWorkers::parseScaled(doc[0]));
+    TEST_ASSERT_FLOAT_WITHIN(1e3, 345.6e9, PoolWorkers::parseScaled(doc[1]));
+    TEST_ASSERT_FLOAT_WITHIN(1e-3, 12e3, PoolWorkers::parseScaled(doc[2]));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 7.0, PoolWorkers::parseScaled(doc[3]));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 42.5, PoolWorkers::parseScaled(doc[4]));
+    TEST_ASSERT_FLOAT_WITHIN(1e9, 2e15, PoolWorkers::parseScaled(doc[5]));
+    // "1.5E" : strtod ne lit pas un exposant incomplet, le E reste un suffixe
+    TEST_ASSERT_FLOAT_WITHIN(1e12, 1.5e18, PoolWorkers::parseScaled(doc[6]));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 0.0, PoolWorkers::parseScaled(doc[7]));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 0.0, PoolWorkers::parseScaled(doc[8]));  // Absent
+}
+
+static void test_worker_matches() {
+    // ckpool : nom complet
+    TEST_ASSERT_TRUE(PoolWorkers::workerMatches("bc1qaddr.bitaxe1", "bc1qaddr.bitaxe1"));
+    // public-pool : seulement le worker
+    TEST_ASSERT_TRUE(PoolWorkers::workerMatches("bitaxe1", "bc1qaddr.bitaxe1"));
+    TEST_ASSERT_FALSE(PoolWorkers::workerMatches("bitaxe2", "bc1qaddr.bitaxe1"));
+    TEST_ASSERT_FALSE(PoolWorkers::workerMatches("bitaxe1", "bc1qaddr.bitaxe10"));
+    // Mineur sans nom de worker : seul le nom exact convient
+    TEST_ASSERT_TRUE(PoolWorkers::workerMatches("bc1qaddr", "bc1qaddr"));
+    TEST_ASSERT_FALSE(PoolWorkers::workerMatches("bc1qaddr.bitaxe1", "bc1qaddr"));
+    TEST_ASSERT_FALSE(PoolWorkers::workerMatches("bitaxe1", "bc1qaddr."));
+    // Même worker sur une autre adresse (ckpool garde l'adresse dans le nom)
+    TEST_ASSERT_TRUE(PoolWorkers::workerMatches("bc1qother.bitaxe1", "bc1qaddr.bitaxe1"));
+}
+
+static void test_ckpool_response() {
+    JsonDocument doc;
+    load(doc, CKPOOL_USERS);
+    // Le filtre ne garde que les workers
+    TEST_ASSERT_TRUE(doc["hashrate5m"].isNull());
+    TEST_ASSERT_TRUE(doc["worker"][0]["hashrate5m"].isNull());
+
+    PoolWorkerList workers;
+    TEST_ASSERT_TRUE(PoolWorkers::open(doc.as<JsonVariantConst>(), workers));
+    TEST_ASSERT_EQUAL_UINT(3, workers.list.size());
+
+    float hashrate;
+    uint32_t best;
+    TEST_ASSERT_TRUE(PoolWorkers::find(workers, "bc1qmockaddress.mock00", hashrate, best));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1210.0f, hashrate);
+    TEST_ASSERT_EQUAL_UINT32(12345678, best);
+
+    // Meilleure share au-delà de 32 bits : saturée
+    TEST_ASSERT_TRUE(PoolWorkers::find(workers, "bc1qmockaddress.mock01", hashrate, best));
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, best);
+
+    // Worker connu à 0 H/s : trouvé, le poller ne le considère pas couvert
+    TEST_ASSERT_TRUE(PoolWorkers::find(workers, "bc1qmockaddress.mock02", hashrate, best));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, hashrate);
+
+    TEST_ASSERT_FALSE(PoolWorkers::find(workers, "bc1qmockaddress.mock03", hashrate, best));
+}
+
+static void test_public_pool_response() {
+    JsonDocument doc;
+    load(doc, PUBLIC_POOL_CLIENT);
+    TEST_ASSERT_TRUE(doc["workers"][0]["sessionId"].isNull());
+
+    PoolWorkerList workers;
+    TEST_ASSERT_TRUE(PoolWorkers::open(doc.as<JsonVariantConst>(), workers));
+
+    float hashrate;
+    uint32_t best;
+    TEST_ASSERT_TRUE(PoolWorkers::find(workers, "bc1qmockaddress.mock00", hashrate, best));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1210.0f, hashrate);
+    TEST_ASSERT_EQUAL_UINT32(12345678, best);
+
+    TEST_ASSERT_TRUE(PoolWorkers::find(workers, "bc1qmockaddress.mock01", hashrate, best));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1200.0f, hashrate);
+    TEST_ASSERT_EQUAL_UINT32(2500000, best);
+
+    // Sans nom de worker, impossible de distinguer les mineurs
+    TEST_ASSERT_FALSE(PoolWorkers::find(workers, "bc1qmockaddress", hashrate, best));
+}
+
+static void test_unknown_format() {
+    JsonDocument doc;
+    load(doc, R"({"error": "user not found"})");
+    PoolWorkerList workers;
+    TEST_ASSERT_FALSE(PoolWorkers::open(doc.as<JsonVariantConst>(), workers));
+
+    // Liste vide : format reconnu, aucun worker
+    load(doc, R"({"worker": []})");
+    TEST_ASSERT_TRUE(PoolWorkers::open(doc.as<JsonVariantConst>(), workers));
+    float hashrate;
+    uint32_t best;
+    TEST_ASSERT_FALSE(PoolWorkers::find(workers, "bc1qaddr.bitaxe1", hashrate, best));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_parse_scaled);
+    RUN_TEST(test_worker_matches);
+    RUN_TEST(test_ckpool_response);
+    RUN_TEST(test_public_pool_response);
+    RUN_TEST(test_unknown_format);
+    return UNITY_END();
+}
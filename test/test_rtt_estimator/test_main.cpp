@@ -0,0 +1,137 @@
+// Estimation du RTT façon RFC 6298 et délais qui en découlent
+#include <unity.h>
+#include "rtt_estimator.h"
+
+void setUp() {}
+void tearDown() {}
+
+static void test_initial_rto_before_any_sample() {
+    RttEstimator rtt;
+    TEST_ASSERT_EQUAL_UINT32(BITAXE_RTO_INITIAL_MS, rtt.rto);
+    TEST_ASSERT_EQUAL_UINT32(BITAXE_PROBE_MAX_MS, rtt.probeTimeout());
+    TEST_ASSERT_EQUAL_UINT32(1000, rtt.deadline(1.0f, BITAXE_REQUEST_MIN_MS, BITAXE_REQUEST_MAX_MS));
+}
+
+static void test_first_sample_sets_srtt_and_half_variance() {
+    RttEstimator rtt;
+    rtt.addSample(40);
+    TEST_ASSERT_EQUAL_FLOAT(40.0f, rtt.srtt);
+    TEST_ASSERT_EQUAL_FLOAT(20.0f, rtt.rttvar);
+    TEST_ASSERT_EQUAL_UINT32(120, rtt.rto);  // 40 + 4 x 20
+    TEST_ASSERT_EQUAL_UINT32(1, rtt.samples);
+}
+
+static void test_smoothing_follows_rfc6298() {
+    RttEstimator rtt;
+    rtt.addSample(100);
+    rtt.addSample(60);
+    // rttvar = 3/4 x 50 + 1/4 x |100 - 60| ; srtt = 7/8 x 100 + 1/8 x 60
+    TEST_ASSERT_EQUAL_FLOAT(47.5f, rtt.rttvar);
+    TEST_ASSERT_EQUAL_FLOAT(95.0f, rtt.srtt);
+    TEST_ASSERT_EQUAL_UINT32(285, rtt.rto);
+}
+
+static void test_stable_lan_miner_converges_low() {
+    RttEstimator rtt;
+    for (int i = 0; i < 50; i++) {
+        rtt.addSample(30);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 30.0f, rtt.srtt);
+    TEST_ASSERT_TRUE(rtt.rto >= 30 && rtt.rto <= 32);
+    // Les planchers gardent une marge sur les délais socket du core
+    TEST_ASSERT_EQUAL_UINT32(BITAXE_REQUEST_MIN_MS, rtt.deadline(1.0f, BITAXE_REQUEST_MIN_MS, BITAXE_REQUEST_MAX_MS));
+    TEST_ASSERT_EQUAL_UINT32(BITAXE_ACTION_MIN_MS, rtt.deadline(2.0f, BITAXE_ACTION_MIN_MS, BITAXE_ACTION_MAX_MS));
+    TEST_ASSERT_EQUAL_UINT32(BITAXE_PROBE_MIN_MS, rtt.probeTimeout());
+}
+
+static void test_jittery_miner_gets_wider_deadline() {
+    RttEstimator steady;
+    RttEstimator jittery;
+    for (int i = 0; i < 20; i++) {
+        steady.addSample(200);
+        jittery.addSample(i % 2 == 0 ? 50 : 350);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(20.0f, 200.0f, jittery.srtt);
+    TEST_ASSERT_TRUE(jittery.rto > steady.rto + 300);
+}
+
+static void test_timeout_doubles_and_caps() {
+    RttEstimator rtt;
+    rtt.addSample(500);           // rto = 1500
+    rtt.onTimeout();
+    TEST_ASSERT_EQUAL_UINT32(3000, rtt.rto);
+    rtt.onTimeout();
+    TEST_ASSERT_EQUAL_UINT32(6000, rtt.rto);
+    rtt.onTimeout();
+    TEST_ASSERT_EQUAL_UINT32(BITAXE_RTO_MAX_MS, rtt.rto);
+    rtt.onTimeout();
+    TEST_ASSERT_EQUAL_UINT32(BITAXE_RTO_MAX_MS, rtt.rto);
+    // Le délai des requêtes reste borné même après backoff
+    TEST_ASSERT_EQUAL_UINT32(BITAXE_REQUEST_MAX_MS, rtt.deadline(1.0f, BITAXE_REQUEST_MIN_MS, BITAXE_REQUEST_MAX_MS));
+    TEST_ASSERT_EQUAL_UINT32(BITAXE_PROBE_BACKOFF_MS, rtt.probeTimeout());
+}
+
+static void test_probe_deadline_grows_with_timeouts() {
+    RttEstimator rtt;
+    for (int i = 0; i < 10; i++) {
+        rtt.addSample(30);
+    }
+    TEST_ASSERT_EQUAL_UINT32(BITAXE_PROBE_MIN_MS, rtt.probeTimeout());
+    // Mineur qui met ~1 s à accepter la connexion : 600 puis 1200 ms
+    uint32_t expected[] = {600, 1200, 2400, BITAXE_PROBE_BACKOFF_MS, BITAXE_PROBE_BACKOFF_MS, BITAXE_PROBE_BACKOFF_MS};
+    int connectedAfter = -1;
+    for (int i = 0; i < 6; i++) {
+        rtt.onTimeout();
+        TEST_ASSERT_EQUAL_UINT32(expected[i], rtt.probeTimeout());
+        if (connectedAfter < 0 && rtt.probeTimeout() >= 1000) connectedAfter = i + 1;
+    }
+    TEST_ASSERT_EQUAL_INT(2, connectedAfter);
+    // Première réponse : la sonde revient au RTT mesuré
+    rtt.addSample(900);
+    TEST_ASSERT_EQUAL_UINT8(0, rtt.timeouts);
+    TEST_ASSERT_EQUAL_UINT32(BITAXE_PROBE_MAX_MS, rtt.probeTimeout());
+}
+
+static void test_unmeasured_miner_probe_grows_too() {
+    RttEstimator rtt;
+    rtt.onTimeout();
+    TEST_ASSERT_EQUAL_UINT32(2 * BITAXE_PROBE_MAX_MS, rtt.probeTimeout());
+    for (int i = 0; i < 300; i++) {
+        rtt.onTimeout();
+    }
+    TEST_ASSERT_EQUAL_UINT8(255, rtt.timeouts);
+    TEST_ASSERT_EQUAL_UINT32(BITAXE_PROBE_BACKOFF_MS, rtt.probeTimeout());
+}
+
+static void test_sample_after_timeout_recomputes_rto() {
+    RttEstimator rtt;
+    rtt.addSample(40);
+    rtt.onTimeout();
+    rtt.onTimeout();
+    TEST_ASSERT_EQUAL_UINT32(480, rtt.rto);
+    rtt.addSample(40);
+    TEST_ASSERT_TRUE(rtt.rto < 120);
+}
+
+static void test_zero_rtt_keeps_rto_positive() {
+    RttEstimator rtt;
+    rtt.addSample(0);
+    TEST_ASSERT_EQUAL_UINT32(1, rtt.rto);
+    rtt.onTimeout();
+    TEST_ASSERT_EQUAL_UINT32(2, rtt.rto);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_initial_rto_before_any_sample);
+    RUN_TEST(test_first_sample_sets_srtt_and_half_variance);
+    RUN_TEST(test_smoothing_follows_rfc6298);
+    RUN_TEST(test_stable_lan_miner_converges_low);
+    RUN_TEST(test_jittery_miner_gets_wider_deadline);
+    RUN_TEST(test_timeout_doubles_and_caps);
+    RUN_TEST(test_probe_deadline_grows_with_timeouts);
+    RUN_TEST(test_unmeasured_miner_probe_grows_too);
+    RUN_TEST(test_sample_after_timeout_recomputes_rto);
+    RUN_TEST(test_zero_rtt_keeps_rto_positive);
+    return UNITY_END();
+}
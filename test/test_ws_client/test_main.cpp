@@ -0,0 +1,286 @@
+// Client WebSocket : poignée de main, décodage des trames du serveur
+// (longueurs étendues, fragmentation, contrôle) et mode flux. Le serveur
+// est joué par le test à travers la doublure WiFiClient.
+#include <unity.h>
+#include <vector>
+#include "ws_client.h"
+#include "mbedtls/base64.h"
+#include "mbedtls/sha1.h"
+
+static bool handshakeDone;
+static bool corruptAccept;
+
+static std::string acceptFor(const std::string& key) {
+    std::string source = key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    unsigned char digest[20];
+    mbedtls_sha1_ret((const unsigned char*)source.data(), source.size(), digest);
+    unsigned char encoded[32];
+    size_t len = 0;
+    mbedtls_base64_encode(encoded, sizeof(encoded), &len, digest, sizeof(digest));
+    return std::string((const char*)encoded, len);
+}
+
+// Serveur AxeOS : répond 101 dès que la requête d'upgrade est complète
+static void server(WiFiClient& socket) {
+    if (handshakeDone || socket.tx.find("\r\n\r\n") == std::string::npos) return;
+    handshakeDone = true;
+    size_t at = socket.tx.find("Sec-WebSocket-Key: ");
+    std::string key = socket.tx.substr(at + 19, socket.tx.find("\r\n", at) - at - 19);
+    std::string accept = corruptAccept ? "AAAAAAAAAAAAAAAAAAAAAAAAAAA=" : acceptFor(key);
+    socket.serverSend("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                      "Sec-WebSocket-Accept: " + accept + "\r\n\r\n");
+    socket.tx.clear();
+}
+
+// Trame serveur (non masquée sauf mask != 0)
+static std::string frame(uint8_t opcode, const std::string& payload, bool fin = true, uint32_t mask = 0) {
+    std::string out;
+    out += (char)((fin ? 0x80 : 0) | opcode);
+    uint8_t maskBit = mask != 0 ? 0x80 : 0;
+    if (payload.size() < 126) {
+        out += (char)(maskBit | payload.size());
+    } else if (payload.size() < 65536) {
+        out += (char)(maskBit | 126);
+        out += (char)(payload.size() >> 8);
+        out += (char)(payload.size() & 0xFF);
+    } else {
+        out += (char)(maskBit | 127);
+        for (int i = 7; i >= 0; i--) out += (char)((uint64_t)payload.size() >> (8 * i));
+    }
+    if (mask == 0) return out + payload;
+    uint8_t key[4] = {(uint8_t)(mask >> 24), (uint8_t)(mask >> 16), (uint8_t)(mask >> 8), (uint8_t)mask};
+    out.append((const char*)key, 4);
+    for (size_t i = 0; i < payload.size(); i++) out += (char)(payload[i] ^ key[i & 3]);
+    return out;
+}
+
+// Trame client décodée (toujours masquée)
+struct ClientFrame {
+    uint8_t opcode;
+    std::string payload;
+};
+static std::vector<ClientFrame> clientFrames(const std::string& tx) {
+    std::vector<ClientFrame> frames;
+    size_t pos = 0;
+    while (pos + 6 <= tx.size()) {
+        uint8_t b0 = tx[pos], b1 = tx[pos + 1];
+        TEST_ASSERT_TRUE(b0 & 0x80);
+        TEST_ASSERT_TRUE(b1 & 0x80);
+        size_t len = b1 & 0x7F;
+        const uint8_t* key = (const uint8_t*)tx.data() + pos + 2;
+        ClientFrame frame = {(uint8_t)(b0 & 0x0F), std::string()};
+        for (size_t i = 0; i < len; i++) frame.payload += (char)(tx[pos + 6 + i] ^ key[i & 3]);
+        frames.push_back(frame);
+        pos += 6 + len;
+    }
+    TEST_ASSERT_EQUAL_UINT(tx.size(), pos);
+    return frames;
+}
+
+static std::vector<std::string> messages;
+static void onMessage(void* ctx, const char* data, size_t len) {
+    TEST_ASSERT_EQUAL_UINT(strlen(data), len);
+    messages.push_back(std::string(data, len));
+}
+
+struct StreamCapture {
+    std::string data;
+    int starts;
+    int ends;
+    int calls;
+};
+static void onFragment(void* ctx, const uint8_t* data, size_t len, bool start, bool end) {
+    StreamCapture* stream = (StreamCapture*)ctx;
+    if (start) {
+        TEST_ASSERT_EQUAL_INT(stream->ends, stream->starts);  // Pas de début sans fin du précédent
+        stream->starts++;
+    }
+    if (end) stream->ends++;
+    stream->data.append((const char*)data, len);
+    stream->calls++;
+}
+
+static WiFiClient* open(WsClient& ws) {
+    TEST_ASSERT_TRUE(ws.connect("10.0.0.2", 80, "/api/ws", 1000));
+    return WiFiClient::last;
+}
+
+void setUp() {
+    handshakeDone = false;
+    corruptAccept = false;
+    nativeServer = server;
+    messages.clear();
+}
+void tearDown() {
+    nativeServer = nullptr;
+}
+
+static void test_accept_key_matches_rfc_example() {
+    // RFC 6455 section 1.3
+    TEST_ASSERT_EQUAL_STRING("s3pPLMBiTxaQ9kYGzzhZRbK+xOo=", acceptFor("dGhlIHNhbXBsZSBub25jZQ==").c_str());
+}
+
+static void test_handshake() {
+    WsClient ws;
+    WiFiClient* socket = open(ws);
+    TEST_ASSERT_TRUE(ws.connected());
+    TEST_ASSERT_TRUE(socket->noDelay);
+
+    corruptAccept = true;
+    handshakeDone = false;
+    TEST_ASSERT_FALSE(ws.connect("10.0.0.2", 80, "/api/ws", 1000));
+    TEST_ASSERT_FALSE(ws.connected());
+}
+
+static void test_handshake_rejects_http_error() {
+    nativeServer = [](WiFiClient& socket) {
+        if (socket.tx.find("\r\n\r\n") != std::string::npos && socket.rx.empty()) {
+            socket.serverSend("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+        }
+    };
+    WsClient ws;
+    TEST_ASSERT_FALSE(ws.connect("10.0.0.2", 80, "/api/ws", 1000));
+}
+
+static void test_short_text_frames() {
+    WsClient ws;
+    WiFiClient* socket = open(ws);
+    socket->serverSend(frame(0x1, "asic_result: Ver: 20000000 Nonce 1A2B3C4D diff 1234.5 of 1000."));
+    socket->serverSend(frame(0x1, ""));
+    TEST_ASSERT_TRUE(ws.poll(onMessage, nullptr));
+    TEST_ASSERT_EQUAL_UINT(2, messages.size());
+    TEST_ASSERT_EQUAL_STRING("asic_result: Ver: 20000000 Nonce 1A2B3C4D diff 1234.5 of 1000.", messages[0].c_str());
+    TEST_ASSERT_EQUAL_STRING("", messages[1].c_str());
+}
+
+static void test_extended_length_and_truncation() {
+    WsClient ws;
+    WiFiClient* socket = open(ws);
+    std::string medium(300, 'a');
+    std::string large(WS_MAX_MESSAGE + 200, 'b');
+    socket->serverSend(frame(0x1, medium));
+    socket->serverSend(frame(0x1, large));
+    socket->serverSend(frame(0x1, "after"));
+    TEST_ASSERT_TRUE(ws.poll(onMessage, nullptr));
+    TEST_ASSERT_EQUAL_UINT(3, messages.size());
+    TEST_ASSERT_EQUAL_UINT(300, messages[0].size());
+    // Tronqué, mais la trame suivante reste alignée
+    TEST_ASSERT_EQUAL_UINT(WS_MAX_MESSAGE, messages[1].size());
+    TEST_ASSERT_EQUAL_STRING("after", messages[2].c_str());
+}
+
+static void test_64bit_length() {
+    WsClient ws;
+    WiFiClient* socket = open(ws);
+    socket->serverSend(frame(0x1, std::string(70000, 'c')));
+    TEST_ASSERT_TRUE(ws.poll(onMessage, nullptr));
+    TEST_ASSERT_EQUAL_UINT(1, messages.size());
+
+    // Plus de 4 Go annoncés : protocole refusé
+    const uint8_t huge[] = {0x81, 127, 0, 0, 0, 1, 0, 0, 0, 0};
+    socket->serverSend(huge, sizeof(huge));
+    TEST_ASSERT_FALSE(ws.poll(onMessage, nullptr));
+}
+
+static void test_fragmented_message_with_interleaved_ping() {
+    WsClient ws;
+    WiFiClient* socket = open(ws);
+    socket->serverSend(frame(0x1, "512.3 ", false));
+    socket->serverSend(frame(0x9, "hb"));            // Ping entre deux fragments
+    socket->serverSend(frame(0x0, "GH/s", false));
+    socket->serverSend(frame(0x0, " total", true));
+    TEST_ASSERT_TRUE(ws.poll(onMessage, nullptr));
+    TEST_ASSERT_EQUAL_UINT(1, messages.size());
+    TEST_ASSERT_EQUAL_STRING("512.3 GH/s total", messages[0].c_str());
+
+    std::vector<ClientFrame> sent = clientFrames(socket->tx);
+    TEST_ASSERT_EQUAL_UINT(1, sent.size());
+    TEST_ASSERT_EQUAL_UINT8(0xA, sent[0].opcode);
+    TEST_ASSERT_EQUAL_STRING("hb", sent[0].payload.c_str());
+}
+
+static void test_split_reads_give_same_messages() {
+    WsClient ws;
+    WiFiClient* socket = open(ws);
+    socket->readChunk = 1;   // Un octet par read() : chaque état est coupé
+    socket->serverSend(frame(0x1, std::string(200, 'x')));
+    socket->serverSend(frame(0x1, "masked", true, 0x11223344));
+    socket->serverSend(frame(0x2, "binary"));        // Ignoré
+    socket->serverSend(frame(0x1, "last"));
+    TEST_ASSERT_TRUE(ws.poll(onMessage, nullptr));
+    TEST_ASSERT_EQUAL_UINT(3, messages.size());
+    TEST_ASSERT_EQUAL_UINT(200, messages[0].size());
+    TEST_ASSERT_EQUAL_STRING("masked", messages[1].c_str());
+    TEST_ASSERT_EQUAL_STRING("last", messages[2].c_str());
+}
+
+static void test_close_frame() {
+    WsClient ws;
+    WiFiClient* socket = open(ws);
+    socket->serverSend(frame(0x1, "bye"));
+    socket->serverSend(std::string("\x88\x02\x03\xE8", 4));   // Close 1000
+    TEST_ASSERT_FALSE(ws.poll(onMessage, nullptr));
+    TEST_ASSERT_EQUAL_UINT(1, messages.size());
+    TEST_ASSERT_FALSE(ws.connected());
+
+    std::vector<ClientFrame> sent = clientFrames(socket->tx);
+    TEST_ASSERT_EQUAL_UINT(1, sent.size());
+    TEST_ASSERT_EQUAL_UINT8(0x8, sent[0].opcode);
+    TEST_ASSERT_EQUAL_STRING("\x03\xE8", sent[0].payload.c_str());
+}
+
+static void test_reserved_opcode_is_rejected() {
+    WsClient ws;
+    WiFiClient* socket = open(ws);
+    socket->serverSend(frame(0x3, "?"));
+    TEST_ASSERT_FALSE(ws.poll(onMessage, nullptr));
+}
+
+static void test_send_text_is_masked() {
+    WsClient ws;
+    WiFiClient* socket = open(ws);
+    TEST_ASSERT_TRUE(ws.sendText("{\"op\":\"ping\"}"));
+    TEST_ASSERT_FALSE(ws.sendText(std::string(126, 'x').c_str()));
+    std::vector<ClientFrame> sent = clientFrames(socket->tx);
+    TEST_ASSERT_EQUAL_UINT(1, sent.size());
+    TEST_ASSERT_EQUAL_UINT8(0x1, sent[0].opcode);
+    TEST_ASSERT_EQUAL_STRING("{\"op\":\"ping\"}", sent[0].payload.c_str());
+}
+
+static void test_stream_mode_has_no_size_limit() {
+    WsClient ws;
+    WiFiClient* socket = open(ws);
+    socket->readChunk = 100;
+    std::string big;
+    for (int i = 0; big.size() < 5000; i++) big += "{\"height\":" + std::to_string(850000 + i) + "},";
+    socket->serverSend(frame(0x1, big.substr(0, 3000), false));
+    socket->serverSend(frame(0x9, ""));
+    socket->serverSend(frame(0x0, big.substr(3000), true));
+    socket->serverSend(frame(0x2, "binary"));
+    socket->serverSend(frame(0x1, ""));
+
+    StreamCapture stream = {std::string(), 0, 0, 0};
+    TEST_ASSERT_TRUE(ws.pollStream(onFragment, &stream));
+    // Deux messages texte : le gros puis le vide (start et end dans le même appel)
+    TEST_ASSERT_EQUAL_INT(2, stream.starts);
+    TEST_ASSERT_EQUAL_INT(2, stream.ends);
+    TEST_ASSERT_TRUE(stream.calls > 2);
+    TEST_ASSERT_TRUE(stream.data == big);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_accept_key_matches_rfc_example);
+    RUN_TEST(test_handshake);
+    RUN_TEST(test_handshake_rejects_http_error);
+    RUN_TEST(test_short_text_frames);
+    RUN_TEST(test_extended_length_and_truncation);
+    RUN_TEST(test_64bit_length);
+    RUN_TEST(test_fragmented_message_with_interleaved_ping);
+    RUN_TEST(test_split_reads_give_same_messages);
+    RUN_TEST(test_close_frame);
+    RUN_TEST(test_reserved_opcode_is_rejected);
+    RUN_TEST(test_send_text_is_masked);
+    RUN_TEST(test_stream_mode_has_no_size_limit);
+    return UNITY_END();
+}